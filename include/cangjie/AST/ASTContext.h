@@ -40,16 +40,18 @@ struct InvertedIndex {
     std::unordered_map<uint32_t, std::set<AST::Symbol*>> scopeLevelIndexes;
     /** Inverted index of Symbol's ast kind. */
     std::unordered_map<std::string, std::set<AST::Symbol*>> astKindIndexes;
-    /** Put @c name into a trie, easy to do prefix search. */
-    std::unique_ptr<Trie> nameTrie = std::make_unique<Trie>();
-    /** Put @c scopeName into a trie, easy to do prefix search. */
-    std::unique_ptr<Trie> scopeNameTrie = std::make_unique<Trie>();
-    /** Put @c astKind into a trie, easy to do suffix search. */
-    std::unique_ptr<Trie> astKindTrie = std::make_unique<Trie>();
-    /** Put the begin position of a symbol into a trie, easy to do range search. */
-    std::unique_ptr<Trie> posBeginTrie = std::make_unique<Trie>();
-    /** Put the begin position of a symbol into a trie, easy to do range search. */
-    std::unique_ptr<Trie> posEndTrie = std::make_unique<Trie>();
+    /** Sorted @c name strings, easy to do prefix and suffix search. */
+    StringIndex nameIndex;
+    /** Sorted @c scopeName strings, easy to do prefix search. */
+    StringIndex scopeNameIndex;
+    /** Sorted @c astKind strings, easy to do suffix search. */
+    StringIndex astKindIndex;
+    /** The begin positions of symbols, easy to do range search. */
+    PosIndex posBeginIndex;
+    /** The end positions of symbols, easy to do range search. */
+    PosIndex posEndIndex;
+    /** All indexed symbols, indexed by their @c indexID. */
+    std::vector<AST::Symbol*> indexedSymbols;
     /** The minimum possible position. */
     Position minPos = BEGIN_POSITION;
     /** The maximum possible position. */
@@ -58,11 +60,20 @@ struct InvertedIndex {
     /** Clear all indexes. */
     void Reset();
 
-    /** Build inverted index. */
-    void Index(AST::Symbol* symbol, bool withTrie = true);
+    /**
+     * Build inverted index.
+     * @param withSearchIndex whether to put the symbol into the name and position indexes as well.
+     */
+    void Index(AST::Symbol* symbol, bool withSearchIndex = true);
+
+    /** Sort the strings and positions indexed so far, done in bulk once all symbols are collected. */
+    void Build();
 
     /** Delete inverted index. */
     void Delete(AST::Symbol* symbol);
+
+    /** Get the symbols of @p ids, the deleted ones are skipped. */
+    std::set<AST::Symbol*> GetSymbols(const std::vector<uint32_t>& ids) const;
 };
 
 // Names is constructed with 'declaration name, scopeName'
@@ -0,0 +1,187 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the AST walker which keeps its visited nodes outside of the AST.
+ */
+
+#ifndef CANGJIE_AST_CONCURRENTWALKER_H
+#define CANGJIE_AST_CONCURRENTWALKER_H
+
+#include <bitset>
+#include <cstddef>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "cangjie/AST/Node.h"
+#include "cangjie/AST/WalkChildren.h"
+#include "cangjie/AST/Walker.h"
+
+namespace Cangjie::AST {
+/**
+ * Set of the nodes visited by one walk, indexed by node id. Nodes created together have close ids, so the set is a
+ * bitmap split into pages, and the page of the last lookup is cached.
+ */
+class VisitedNodeSet {
+public:
+    /**
+     * Mark @p node as visited.
+     * @return false if it was already visited.
+     */
+    bool Insert(const Node& node)
+    {
+        uint64_t id = node.nodeID.Get();
+        uint64_t pageIdx = id / PAGE_BITS;
+        if (lastPage == nullptr || pageIdx != lastPageIdx) {
+            // Elements of an unordered_map are never moved, the cached page stays valid.
+            lastPage = &pages[pageIdx];
+            lastPageIdx = pageIdx;
+        }
+        auto bit = static_cast<size_t>(id % PAGE_BITS);
+        if (lastPage->test(bit)) {
+            return false;
+        }
+        lastPage->set(bit);
+        return true;
+    }
+
+    void Clear()
+    {
+        pages.clear();
+        lastPage = nullptr;
+    }
+
+private:
+    static constexpr uint64_t PAGE_BITS = 4096;
+    using Page = std::bitset<PAGE_BITS>;
+    std::unordered_map<uint64_t, Page> pages;
+    uint64_t lastPageIdx{0};
+    Page* lastPage{nullptr};
+};
+
+/**
+ * AST walker which does not write the AST: the visited nodes are kept in the walker, so walkers on different threads
+ * can walk shared subtrees at the same time. The visit functions are template parameters and are called directly,
+ * `nullptr` means no function. The traversal and the meaning of VisitAction are the same as WalkerT.
+ */
+template <class NodeT, class PreFunc, class PostFunc = std::nullptr_t> class ConcurrentWalkerT {
+public:
+    /**
+     * The constructor to create an AST walker.
+     * @param node The AST node being visited.
+     * @param visitPre The function executed before walking into its children.
+     * @param visitPost The function executed after walking into its children.
+     */
+    ConcurrentWalkerT(Ptr<NodeT> node, PreFunc visitPre, PostFunc visitPost = nullptr)
+        : node(node), visitPre(std::move(visitPre)), visitPost(std::move(visitPost))
+    {
+    }
+
+    /**
+     * The constructor to create an AST walker which records its visits in @p visitedNodes. Nodes visited by earlier
+     * walks with the same set are skipped, as if those walks and this one were a single walk.
+     */
+    ConcurrentWalkerT(Ptr<NodeT> node, VisitedNodeSet& visitedNodes, PreFunc visitPre, PostFunc visitPost = nullptr)
+        : node(node), visitPre(std::move(visitPre)), visitPost(std::move(visitPost)), visited(&visitedNodes)
+    {
+    }
+    // Not copyable, 'visited' may point into the walker.
+    ConcurrentWalkerT(const ConcurrentWalkerT&) = delete;
+    ConcurrentWalkerT& operator=(const ConcurrentWalkerT&) = delete;
+
+    /**
+     * The function starts an AST walking. A walker can be run again, each run starts with nothing visited unless the
+     * visited set was given to the constructor.
+     */
+    void Walk()
+    {
+        if (visited == &ownVisited) {
+            visited->Clear();
+        }
+        (void)Walk(node);
+    }
+
+private:
+    VisitAction Walk(Ptr<NodeT> curNode)
+    {
+        if (!curNode) {
+            return VisitAction::WALK_CHILDREN;
+        }
+        // Modifiers are usually stored in a std::set<Modifier>, and are walked through copies.
+        if (curNode->astKind != ASTKind::MODIFIER && !visited->Insert(*curNode)) {
+            return VisitAction::WALK_CHILDREN;
+        }
+        VisitAction action = VisitAction::WALK_CHILDREN;
+        if constexpr (!std::is_null_pointer_v<PreFunc>) {
+            action = visitPre(curNode);
+        }
+        if (action == VisitAction::STOP_NOW) {
+            return action;
+        }
+        if (action == VisitAction::WALK_CHILDREN) {
+            action = WalkChildren(curNode, [this](Ptr<NodeT> child) { return Walk(child); });
+            if (action == VisitAction::STOP_NOW) {
+                return action;
+            }
+        }
+        if constexpr (!std::is_null_pointer_v<PostFunc>) {
+            auto optionalAction = visitPost(curNode);
+            if (optionalAction != VisitAction::KEEP_DECISION) {
+                action = optionalAction;
+            }
+        }
+        CJC_ASSERT(action != VisitAction::KEEP_DECISION);
+        return action;
+    }
+
+    Ptr<NodeT> node;
+    PreFunc visitPre;
+    PostFunc visitPost;
+    VisitedNodeSet ownVisited;
+    VisitedNodeSet* visited{&ownVisited};
+};
+
+/**
+ * Walk @p node with a ConcurrentWalkerT, const nodes are walked as `const Node`.
+ * @param node The AST node being visited.
+ * @param visitPre The function executed before walking into its children.
+ * @param visitPost The function executed after walking into its children.
+ */
+template <class T, class PreFunc, class PostFunc = std::nullptr_t>
+void ConcurrentWalk(T* node, PreFunc visitPre, PostFunc visitPost = nullptr)
+{
+    using NodeT = std::conditional_t<std::is_const_v<T>, const Node, Node>;
+    ConcurrentWalkerT<NodeT, PreFunc, PostFunc>(node, std::move(visitPre), std::move(visitPost)).Walk();
+}
+
+template <class T, class PreFunc, class PostFunc = std::nullptr_t>
+void ConcurrentWalk(Ptr<T> node, PreFunc visitPre, PostFunc visitPost = nullptr)
+{
+    ConcurrentWalk(node.get(), std::move(visitPre), std::move(visitPost));
+}
+
+/**
+ * Walk @p node with a ConcurrentWalkerT which records its visits in @p visited, see the constructor of
+ * ConcurrentWalkerT.
+ */
+template <class T, class PreFunc, class PostFunc = std::nullptr_t>
+void ConcurrentWalkWith(VisitedNodeSet& visited, T* node, PreFunc visitPre, PostFunc visitPost = nullptr)
+{
+    using NodeT = std::conditional_t<std::is_const_v<T>, const Node, Node>;
+    ConcurrentWalkerT<NodeT, PreFunc, PostFunc>(node, visited, std::move(visitPre), std::move(visitPost)).Walk();
+}
+
+template <class T, class PreFunc, class PostFunc = std::nullptr_t>
+void ConcurrentWalkWith(VisitedNodeSet& visited, Ptr<T> node, PreFunc visitPre, PostFunc visitPost = nullptr)
+{
+    ConcurrentWalkWith(visited, node.get(), std::move(visitPre), std::move(visitPost));
+}
+} // namespace Cangjie::AST
+
+#endif // CANGJIE_AST_CONCURRENTWALKER_H
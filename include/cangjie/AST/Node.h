@@ -14,6 +14,7 @@
 #ifndef CANGJIE_AST_NODE_H
 #define CANGJIE_AST_NODE_H
 
+#include <atomic>
 #include <bitset>
 #include <limits>
 #include <memory>
@@ -29,6 +30,7 @@
 #include "cangjie/AST/Comment.h"
 #include "cangjie/AST/Identifier.h"
 #include "cangjie/AST/IntLiteral.h"
+#include "cangjie/AST/PooledString.h"
 #include "cangjie/AST/Types.h"
 #include "cangjie/Basic/Linkage.h"
 #include "cangjie/Basic/Position.h"
@@ -96,6 +98,33 @@ template <typename T> std::vector<Ptr<T>> ConverVector(const std::vector<OwnedPt
     return result;
 }
 
+/**
+ * Id of a node, unique in the process. A copied node gets a new id, so that walkers keeping the visited nodes outside
+ * of the AST do not take the copy for the original. Ids are 64-bit so they never wrap around, even in long-running
+ * processes such as the LSP server and the compiler daemon.
+ */
+class NodeID {
+public:
+    NodeID() : value(nextID.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+    NodeID(const NodeID&) : NodeID()
+    {
+    }
+    NodeID& operator=(const NodeID&)
+    {
+        return *this;
+    }
+    uint64_t Get() const
+    {
+        return value;
+    }
+
+private:
+    uint64_t value;
+    static std::atomic_uint64_t nextID;
+};
+
 /**
  * Base struct for all nodes of the abstract syntax tree. All nodes contain position information marking the beginning
  * of the corresponding source text segment.
@@ -127,7 +156,7 @@ struct Node {
      * R: PreCheck, ScopeManager, AST2CHIR, Assumption, TypeChecker, CheckInitialization (Sema), CodeGenHLIR,
      * CheckTypeCompatible, Collector, Desugar, PrintNode.
      */
-    std::string scopeName{""};
+    PooledString scopeName;
     /**
      * Id used for export and import, should be unique value for each decl in single package.
      * NOTE: For cjo's compatibility of different version, the exportId must be decl's signature.
@@ -160,6 +189,12 @@ struct Node {
      * R: Walker.
      */
     mutable unsigned visitedByWalkerID{0};
+    /**
+     * Unique id of the node, indexing the visited sets of ConcurrentWalker.
+     * W: On construction.
+     * R: ConcurrentWalker.
+     */
+    NodeID nodeID;
 
     /**
      * A flag set by Walker, indicating this node is in macrocall for lsp.
@@ -2936,6 +2971,8 @@ struct Package : Node {
 
 private:
     std::vector<std::string> allDependentStdPkgs; /**< Record all dependent standard packages. */
+    /** Instantiations exported by an imported package, from the exportId of the generic decl to mangled names. */
+    std::unordered_map<std::string, std::unordered_set<std::string>> sharedInstantiations;
 
 public:
     Package() : Node(ASTKind::PACKAGE)
@@ -2978,6 +3015,16 @@ public:
     {
         return allDependentStdPkgs;
     }
+    void AddSharedInstantiation(const std::string& genericId, const std::string& mangledName)
+    {
+        sharedInstantiations[genericId].emplace(mangledName);
+    }
+    /** Whether the package exports the instantiation @p mangledName of the generic decl @p genericId. */
+    bool HasSharedInstantiation(const std::string& genericId, const std::string& mangledName) const
+    {
+        auto found = sharedInstantiations.find(genericId);
+        return found != sharedInstantiations.end() && found->second.count(mangledName) != 0;
+    }
 };
 
 /**
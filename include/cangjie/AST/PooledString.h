@@ -0,0 +1,174 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the PooledString class, a compact string field of AST nodes.
+ */
+
+#ifndef CANGJIE_AST_POOLEDSTRING_H
+#define CANGJIE_AST_POOLEDSTRING_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "cangjie/Basic/StringPool.h"
+
+namespace Cangjie::AST {
+/**
+ * A string field whose value is interned in StringPool. It is as large as a pointer and is meant for AST fields
+ * which take few distinct values over millions of nodes, such as scope names. It reads like a const std::string.
+ * The value is freed with the last field or token referring to it.
+ */
+class PooledString {
+public:
+    PooledString() = default;
+    PooledString(std::string_view value) : v(StringPool::Intern(value))
+    {
+    }
+    PooledString(const std::string& value) : PooledString(std::string_view(value))
+    {
+    }
+    PooledString(const char* value) : PooledString(std::string_view(value))
+    {
+    }
+
+    const std::string& Val() const
+    {
+        return v.Val();
+    }
+    operator const std::string&() const
+    {
+        return v.Val();
+    }
+
+    bool empty() const
+    {
+        return v.Val().empty();
+    }
+    size_t size() const
+    {
+        return v.Val().size();
+    }
+    size_t length() const
+    {
+        return v.Val().length();
+    }
+    const char* c_str() const
+    {
+        return v.Val().c_str();
+    }
+    char operator[](size_t pos) const
+    {
+        return v.Val()[pos];
+    }
+    size_t find(std::string_view str, size_t pos = 0) const
+    {
+        return v.Val().find(str, pos);
+    }
+    size_t find(char ch, size_t pos = 0) const
+    {
+        return v.Val().find(ch, pos);
+    }
+    size_t rfind(std::string_view str, size_t pos = std::string::npos) const
+    {
+        return v.Val().rfind(str, pos);
+    }
+    size_t find_last_of(std::string_view str, size_t pos = std::string::npos) const
+    {
+        return v.Val().find_last_of(str, pos);
+    }
+    std::string substr(size_t pos = 0, size_t count = std::string::npos) const
+    {
+        return v.Val().substr(pos, count);
+    }
+    std::string::const_iterator begin() const
+    {
+        return v.Val().begin();
+    }
+    std::string::const_iterator end() const
+    {
+        return v.Val().end();
+    }
+
+    /// Pooled values are unique, so equal strings are the same string.
+    friend bool operator==(const PooledString& lhs, const PooledString& rhs)
+    {
+        return lhs.v.IsSame(rhs.v);
+    }
+    friend bool operator!=(const PooledString& lhs, const PooledString& rhs)
+    {
+        return !lhs.v.IsSame(rhs.v);
+    }
+    friend bool operator==(const PooledString& lhs, std::string_view rhs)
+    {
+        return lhs.v.Val() == rhs;
+    }
+    friend bool operator!=(const PooledString& lhs, std::string_view rhs)
+    {
+        return lhs.v.Val() != rhs;
+    }
+    friend bool operator==(std::string_view lhs, const PooledString& rhs)
+    {
+        return lhs == rhs.v.Val();
+    }
+    friend bool operator!=(std::string_view lhs, const PooledString& rhs)
+    {
+        return lhs != rhs.v.Val();
+    }
+    friend bool operator==(const PooledString& lhs, const std::string& rhs)
+    {
+        return lhs.v.Val() == rhs;
+    }
+    friend bool operator!=(const PooledString& lhs, const std::string& rhs)
+    {
+        return lhs.v.Val() != rhs;
+    }
+    friend bool operator==(const std::string& lhs, const PooledString& rhs)
+    {
+        return lhs == rhs.v.Val();
+    }
+    friend bool operator!=(const std::string& lhs, const PooledString& rhs)
+    {
+        return lhs != rhs.v.Val();
+    }
+    friend bool operator==(const PooledString& lhs, const char* rhs)
+    {
+        return lhs.v.Val() == rhs;
+    }
+    friend bool operator!=(const PooledString& lhs, const char* rhs)
+    {
+        return lhs.v.Val() != rhs;
+    }
+    friend bool operator==(const char* lhs, const PooledString& rhs)
+    {
+        return lhs == rhs.v.Val();
+    }
+    friend bool operator!=(const char* lhs, const PooledString& rhs)
+    {
+        return lhs != rhs.v.Val();
+    }
+    friend std::string operator+(const PooledString& lhs, std::string_view rhs)
+    {
+        return lhs.v.Val() + std::string(rhs);
+    }
+    friend std::string operator+(std::string_view lhs, const PooledString& rhs)
+    {
+        return std::string(lhs) + rhs.v.Val();
+    }
+    friend std::ostream& operator<<(std::ostream& out, const PooledString& str)
+    {
+        return out << str.v.Val();
+    }
+
+private:
+    SharedString v;
+};
+} // namespace Cangjie::AST
+
+#endif // CANGJIE_AST_POOLEDSTRING_H
@@ -13,9 +13,12 @@
 #ifndef CANGJIE_AST_SEACHER_H
 #define CANGJIE_AST_SEACHER_H
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cangjie/AST/Query.h"
 #include "cangjie/AST/Symbol.h"
@@ -24,133 +27,131 @@ namespace Cangjie {
 class ASTContext;
 
 /**
- * The Node of @p Trie tree, which contains the information of the next node and the value, prefix, suffix of current
- * node. If current node is the end of a path which represents a string, the @p rawValue contains the value of the
- * string.
+ * Set of strings answering prefix and suffix matches by binary search. The strings are kept sorted in a flat array,
+ * and the strings inserted since the last @c Build are kept in an unsorted tail, which is scanned by the queries.
+ * The index is built in bulk once all symbols are collected, so the tail only holds the few strings added later.
  */
-class TrieNode {
+class StringIndex {
 public:
-    using Next = std::map<char, std::unique_ptr<TrieNode>>;
-    Next next;                      /**< Next trie node map. */
-    char c;                         /**< Trie node's value. */
-    std::string value;              /**< Store string value at the leaf node. */
-    std::string prefix;             /**< Store prefix string of current node. */
-    std::set<std::string> suffixes; /**< Store suffix strings of current node. */
-    std::set<AST::Symbol*> ids;     /**< Symbol ID set. */
-    uint32_t depth = 0;             /**< Depth of the node in the tree. */
-    TrieNode* parent{nullptr};      /**< Pointer to the parent node. */
-    explicit TrieNode(char c) : c(c)
+    StringIndex() = default;
+    explicit StringIndex(const std::string& value)
     {
-    }
-};
-
-/**
- * @p Trie is a class which contains a tree whose single path represents a string. Trie tree is used to do prefix and
- * suffix string pattern match.
- */
-class Trie {
-public:
-    std::unique_ptr<TrieNode> root;
-    Trie()
-    {
-        root = std::make_unique<TrieNode>('R');
-    }
-    explicit Trie(const std::string& value)
-    {
-        root = std::make_unique<TrieNode>('R');
         Insert(value);
     }
 
     void Reset()
     {
-        root = std::make_unique<TrieNode>('R');
+        values.clear();
+        sortedNum = 0;
+        suffixOrder.clear();
     }
     void Reset(const std::string& value)
     {
-        root = std::make_unique<TrieNode>('R');
+        Reset();
         Insert(value);
     }
     /**
-     * Insert a string, the prefix string and the suffix strings of current
-     * node are stored in @c prefix and @c suffixes.
-     * The value of the given string is stored in @c value at the leaf node.
-     * @param value String value to be inserted.
-     */
-    void Insert(const std::string& value);
-    /**
-     * Insert a string, the prefix string and the suffix strings of current
-     * node are stored in @c prefix and @c suffixes.
-     * The value of the given string is stored in @c value at the leaf node.
+     * Insert a string, which is visible to the queries at once.
      * @param value String value to be inserted.
-     * @param id Symbol id.
      */
-    void Insert(const std::string& value, AST::Symbol& id);
-    /**
-     * Delete the node that has been inserted by insert method above.
-     */
-    void Delete(const std::string& value, AST::Symbol& id);
+    void Insert(const std::string& value)
+    {
+        values.push_back(value);
+    }
     /**
-     * Get the root node to begin traverse for prefix search.
-     * @param prefix Prefix search string.
-     * @return The last node of the @p prefix string, when input @a0b, will point to the node of b.
+     * Sort the strings inserted since the last build into the sorted part.
      */
-    TrieNode* GetPrefixRootNode(const std::string& prefix) const;
+    void Build();
     /**
-     * Traverse from the prefix root node to the bottom, get value from the leaf and add to match results.
+     * Get all strings starting with @p prefix, in ascending order.
      * @param prefix Prefix search string.
      */
     std::vector<std::string> PrefixMatch(const std::string& prefix) const;
     /**
-     * Traverse from the root node to the bottom, when suffix value matched, concatenate the prefix and suffix, add to
-     * match results.
+     * Get all strings ending with @p suffix and longer than it, in ascending order.
      * @param suffix Suffix search string.
      */
     std::vector<std::string> SuffixMatch(const std::string& suffix) const;
+
+private:
+    std::vector<std::string> values;   /**< Sorted unique strings, followed by the unsorted tail. */
+    size_t sortedNum{0};               /**< Number of strings in the sorted part. */
+    std::vector<uint32_t> suffixOrder; /**< Indexes of the sorted part, ordered by the reversed strings. */
 };
 
 /**
- * Simplified range query realization.
+ * Positions of symbols, sorted by line and column in each file, so that range queries are binary searches. A symbol
+ * is referred to by its integer id in the @c InvertedIndex. As in @c StringIndex, the positions inserted since the
+ * last @c Build are kept in an unsorted tail.
  */
-class PosSearchApi {
+class PosIndex {
 public:
+    void Reset()
+    {
+        files.clear();
+    }
+    void Insert(const Position& pos, uint32_t symbolID)
+    {
+        files[pos.fileID].entries.push_back({pos.line, pos.column, symbolID});
+    }
     /**
-     * Cast position to a string monotonously.
+     * Sort the positions inserted since the last build into the sorted part.
      */
-    static std::string PosToStr(const Position& pos);
-
+    void Build();
     /**
-     * Find the common root TrieNode of the given position in PosTrie.
+     * Get ids of symbols in the file of @p pos, whose position is less than @p pos.
+     * @param isClose Default is true, (..., pos].
      */
-    static TrieNode* FindCommonRootInPosTrie(const Trie& posTrie, const Position& pos);
-
+    std::vector<uint32_t> GetIDsLessThanPos(const Position& pos, bool isClose = true) const;
     /**
-     * Find the common root TrieNode of the given position string in PosTrie.
+     * Get ids of symbols in the file of @p pos, whose position is greater than @p pos.
+     * @param isClose Default is true, [pos, ...).
      */
-    static TrieNode* FindCommonRootInPosTrie(const Trie& posTrie, const std::string& pos);
-
+    std::vector<uint32_t> GetIDsGreaterThanPos(const Position& pos, bool isClose = true) const;
     /**
-     * Get IDs of symbols which is within a position range.
+     * Get ids of symbols whose position is within the range from @p startPos to @p endPos in one file.
      */
-    static std::set<AST::Symbol*> GetIDsWithinPosXByRange(const Trie& posTrie, const Position& startPos,
-        const Position& endPos, bool isLeftClose = true, bool isRightClose = false);
+    std::vector<uint32_t> GetIDsWithinRange(const Position& startPos, const Position& endPos,
+        bool isLeftClose = true, bool isRightClose = false) const;
 
-    /**
-     * Get IDs of symbols which is greater than the @p pos.
-     * @param pos The position to compare.
-     * @param isClose Default is true, [pos, ...).
-     * @return Symbol IDs which are greater than @p pos.
-     */
-    static std::set<AST::Symbol*> GetIDsGreaterThanPos(const Trie& posTrie, const Position& pos, bool isClose = true);
+private:
+    struct Entry {
+        int line;
+        int column;
+        uint32_t symbolID;
+        bool operator<(const Entry& rhs) const
+        {
+            return line < rhs.line || (line == rhs.line && column < rhs.column);
+        }
+    };
+    struct FileEntries {
+        std::vector<Entry> entries; /**< Sorted entries, followed by the unsorted tail. */
+        size_t sortedNum{0};        /**< Number of entries in the sorted part. */
+    };
+    static bool IsBefore(const Entry& entry, const Position& pos)
+    {
+        return entry.line < pos.line || (entry.line == pos.line && entry.column < pos.column);
+    }
+    static bool IsAfter(const Entry& entry, const Position& pos)
+    {
+        return entry.line > pos.line || (entry.line == pos.line && entry.column > pos.column);
+    }
+    /** Get ids of symbols between the bounds in one file, a null bound is unlimited. */
+    std::vector<uint32_t> GetIDs(
+        const Position* lower, bool isLowerClose, const Position* upper, bool isUpperClose) const;
 
+    std::unordered_map<unsigned int, FileEntries> files;
+};
+
+/**
+ * Position string conversion, the strings of positions compare as the positions do.
+ */
+class PosSearchApi {
+public:
     /**
-     * Get IDs of symbols which is less than the @p pos.
-     * @param pos The position to compare.
-     * @param isClose Default is true, (..., pos].
-     * @return Symbol IDs which are less than @p pos.
+     * Cast position to a string monotonously.
      */
-    static std::set<AST::Symbol*> GetIDsLessThanPos(const Trie& posTrie, const Position& pos, bool isClose = true);
-    static void GetIDsLessThanPosOfDepth(
-        TrieNode& n, const std::string& posStr, std::set<AST::Symbol*>& ids, bool& isClose);
+    static std::string PosToStr(const Position& pos);
 
     static void UpdatePosLimit(unsigned int fileId, int line, int column);
 
@@ -158,15 +159,6 @@ public:
     static uint32_t MAX_DIGITS_LINE;   // Max num of source code line number digits.
     static uint32_t MAX_DIGITS_COLUMN; // Max num of source code column number digits.
 
-    /**
-     * Get the max digits of position string.
-     * @return the max digits of position string.
-     */
-    static uint32_t GetMaxDigitsPostion()
-    {
-        return MAX_DIGITS_FILE + MAX_DIGITS_LINE + MAX_DIGITS_COLUMN;
-    }
-
     constexpr static int MAX_LINE = static_cast<int>(10e5);
     const static int MAX_COLUMN = static_cast<int>(10e3);
 };
@@ -187,6 +179,81 @@ struct Sort {
     static Order posDesc;
 };
 
+/**
+ * Set of symbols of an @c InvertedIndex, as a bitmap over the ids of the symbols. The set operations of the searcher
+ * are done a word at a time, and the symbols are visited in the order they were indexed.
+ */
+class SymbolBitmap {
+public:
+    void Insert(uint32_t id)
+    {
+        size_t word = id / WORD_BITS;
+        if (word >= words.size()) {
+            words.resize(word + 1);
+        }
+        words[word] |= uint64_t{1} << (id % WORD_BITS);
+    }
+    bool Empty() const
+    {
+        return std::all_of(words.cbegin(), words.cend(), [](uint64_t word) { return word == 0; });
+    }
+    SymbolBitmap& operator&=(const SymbolBitmap& other)
+    {
+        words.resize(std::min(words.size(), other.words.size()));
+        for (size_t i = 0; i < words.size(); ++i) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+    SymbolBitmap& operator|=(const SymbolBitmap& other)
+    {
+        words.resize(std::max(words.size(), other.words.size()));
+        for (size_t i = 0; i < other.words.size(); ++i) {
+            words[i] |= other.words[i];
+        }
+        return *this;
+    }
+    /** Remove the symbols of @p other. */
+    SymbolBitmap& operator-=(const SymbolBitmap& other)
+    {
+        for (size_t i = 0; i < std::min(words.size(), other.words.size()); ++i) {
+            words[i] &= ~other.words[i];
+        }
+        return *this;
+    }
+    /** Call @p func with the id of each symbol, in ascending order. */
+    template <typename Func> void ForEach(Func&& func) const
+    {
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+                func(static_cast<uint32_t>(i * WORD_BITS) + static_cast<uint32_t>(__builtin_ctzll(word)));
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t WORD_BITS = 64;
+    std::vector<uint64_t> words;
+};
+
+/**
+ * A @c Query compiled for evaluation: the keys and signs are resolved to enums and the numbers are parsed once, so
+ * the plan of a query string is kept and evaluated again by later searches. The strings and positions matched are
+ * looked up in the index at each evaluation, so a plan stays valid while symbols are added and deleted.
+ */
+struct QueryPlan {
+    enum class Kind : uint8_t { AND, OR, NOT, NAME, SCOPE_NAME, SCOPE_LEVEL, AST_KIND, POS, EMPTY };
+    enum class Sign : uint8_t { EQ, LT, LE, GT, GE };
+    Kind kind{Kind::EMPTY};
+    Sign sign{Sign::EQ};
+    MatchKind matchKind{MatchKind::PRECISE};
+    std::string value;      /**< Name, scope name or AST kind to match. */
+    uint64_t scopeLevel{0}; /**< Parsed scope level. */
+    Position pos;
+    std::unique_ptr<QueryPlan> left;
+    std::unique_ptr<QueryPlan> right;
+};
+
 /**
  * AST Searcher will find the AST node by Query.
  */
@@ -217,40 +284,38 @@ public:
     }
 
 private:
+    /** A compiled query with the key of its results in the cache, the file hashes and the order are not in the key. */
+    struct CompiledQuery {
+        std::unique_ptr<QueryPlan> plan;
+        std::string normalizedQuery;
+    };
     unsigned long StrToUint(const ASTContext& ctx, const std::string& queryVal) const;
+    /**
+     * Compile @p query into a plan. @p isValid is set to false if a diagnostic is reported, such a plan is not kept
+     * so that the diagnostic is reported by each search.
+     */
+    std::unique_ptr<QueryPlan> Compile(const ASTContext& ctx, const Query& query, bool& isValid) const;
+    std::vector<AST::Symbol*> Search(const ASTContext& ctx, const CompiledQuery& query,
+        const std::unordered_set<uint64_t>& fileHashes, const Order& order);
+    SymbolBitmap Evaluate(const ASTContext& ctx, const QueryPlan& plan) const;
+    SymbolBitmap EvaluatePos(const ASTContext& ctx, const QueryPlan& plan) const;
     // Get the IDS of symbols in symbol tables whose position equal to the given @p pos.
-    std::set<AST::Symbol*> GetIDsByPosEQ(
+    SymbolBitmap GetIDsByPosEQ(
         const ASTContext& ctx, const Position& pos, bool isLeftClose = true, bool isRightClose = true) const;
     // Get the IDS of symbols in symbol tables whose position is less than the given @p pos. If @contain is true, also
     // return the symbols contain the @p pos.
-    std::set<AST::Symbol*> GetIDsByPosLT(const ASTContext& ctx, const Position& pos, bool contain = false) const;
+    SymbolBitmap GetIDsByPosLT(const ASTContext& ctx, const Position& pos, bool contain = false) const;
     // Get the IDS of symbols in symbol tables whose position is greater than the given @p pos. If @contain is true,
     // also return the symbols contain the @p pos.
-    std::set<AST::Symbol*> GetIDsByPosGT(const ASTContext& ctx, const Position& pos, bool contain = false) const;
-    std::set<AST::Symbol*> GetIDsByName(const ASTContext& ctx, const std::string& name) const;
-    std::set<AST::Symbol*> GetIDsByNamePrefix(const ASTContext& ctx, const std::string& prefix) const;
-    std::set<AST::Symbol*> GetIDsByNameSuffix(const ASTContext& ctx, const std::string& suffix) const;
-    std::set<AST::Symbol*> GetIDsByScopeName(const ASTContext& ctx, const std::string& scopeName) const;
-    std::set<AST::Symbol*> GetIDsByScopeLevel(const ASTContext& ctx, uint32_t scopeLevel) const;
-    std::set<AST::Symbol*> GetIDsByASTKind(const ASTContext& ctx, const std::string& astKind) const;
-    std::vector<std::string> GetAstKindsBySuffix(const ASTContext& ctx, const std::string& suffix) const;
-    std::set<AST::Symbol*> PerformSearch(const ASTContext& ctx, const Query& query);
-    std::set<AST::Symbol*> GetIDs(const ASTContext& ctx, const Query& query) const;
-    std::set<AST::Symbol*> GetIDsByPos(const ASTContext& ctx, const Query& query) const;
-    std::set<AST::Symbol*> GetIDsByName(const ASTContext& ctx, const Query& query) const;
-    std::set<AST::Symbol*> GetIDsByScopeLevel(const ASTContext& ctx, const Query& query) const;
-    std::set<AST::Symbol*> GetIDsByScopeName(const ASTContext& ctx, const Query& query) const;
-    std::set<AST::Symbol*> GetIDsByASTKind(const ASTContext& ctx, const Query& query) const;
-    static std::set<AST::Symbol*> Intersection(const std::set<AST::Symbol*>& set1, const std::set<AST::Symbol*>& set2);
-    static std::set<AST::Symbol*> Union(const std::set<AST::Symbol*>& set1, const std::set<AST::Symbol*>& set2);
-    std::set<AST::Symbol*> Difference(const std::set<AST::Symbol*>& set1, const std::set<AST::Symbol*>& set2) const;
+    SymbolBitmap GetIDsByPosGT(const ASTContext& ctx, const Position& pos, bool contain = false) const;
     bool InFiles(const std::unordered_set<uint64_t>& files, const AST::Symbol& id) const;
     std::pair<std::vector<AST::Symbol*>, bool> FindInSearchCache(
-        const Query& query, const std::string& normalizedQuery);
-    std::vector<AST::Symbol*> FilterAndSortSearchResult(
-        const std::set<AST::Symbol*>& ids, const Query& query, const Order& order) const;
+        const std::unordered_set<uint64_t>& fileHashes, const std::string& normalizedQuery);
+    std::vector<AST::Symbol*> FilterAndSortSearchResult(const ASTContext& ctx, const SymbolBitmap& ids,
+        const std::unordered_set<uint64_t>& fileHashes, const Order& order) const;
     std::unordered_map<std::string, std::vector<AST::Symbol*>> cache;
-    friend class PosSearchApi;
+    /** Compiled plans of the query strings searched. */
+    std::unordered_map<std::string, CompiledQuery> plans;
 };
 } // namespace Cangjie
 
@@ -70,6 +70,7 @@ struct Symbol {
     const ASTKind astKind{ASTKind::NODE}; /**< AST kind, for quick filter. */
     Ptr<Decl> target{nullptr};                /**< Target for all ref symbol. */
     bool invertedIndexBeenDeleted{false}; /**< Mark whether inverted index has been deleted. */
+    uint32_t indexID{0};                  /**< Id in the inverted index, its bit in the search bitmaps. */
     void UnbindTarget()
     {
         target = nullptr;
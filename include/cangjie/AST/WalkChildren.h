@@ -0,0 +1,1091 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file defines the traversal of the children of an AST node, shared by all AST walkers.
+ */
+
+#ifndef CANGJIE_AST_WALKCHILDREN_H
+#define CANGJIE_AST_WALKCHILDREN_H
+
+#include "cangjie/AST/Match.h"
+#include "cangjie/AST/Node.h"
+#include "cangjie/AST/Walker.h"
+
+namespace Cangjie::AST {
+/**
+ * Call @p walk on each child of @p curNode, in the order the walkers visit them.
+ * @param curNode The node whose children are walked.
+ * @param walk Callable taking a `Ptr<NodeT>` and returning the VisitAction of walking it.
+ * @return STOP_NOW as soon as one child returns it, WALK_CHILDREN otherwise.
+ */
+template <class NodeT, class WalkFunc> VisitAction WalkChildren(Ptr<NodeT> curNode, WalkFunc&& walk)
+{
+    if (Is<Expr>(curNode)) {
+        auto expr = StaticAs<ASTKind::EXPR>(curNode);
+        if (walk(expr->desugarExpr.get()) == VisitAction::STOP_NOW) {
+            return VisitAction::STOP_NOW;
+        }
+    } else if (Is<Decl>(curNode)) {
+        auto decl = StaticCast<Decl*>(curNode);
+        for (auto& it : decl->annotations) {
+            if (walk(it.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+        }
+        if (walk(decl->annotationsArray.get()) == VisitAction::STOP_NOW) {
+            return VisitAction::STOP_NOW;
+        }
+    }
+    switch (curNode->astKind) {
+        case ASTKind::PACKAGE: {
+            auto package = StaticAs<ASTKind::PACKAGE>(curNode);
+            // In mock process, genericInstantiatedDecls may change during iteration, so don't using iterator
+            for (size_t i = 0; i < package->genericInstantiatedDecls.size(); ++i) {
+                if (walk(package->genericInstantiatedDecls[i].get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& it : package->files) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            // Source imported decls also should be walked.
+            for (auto& srcFunc : package->srcImportedNonGenericDecls) {
+                if (walk(srcFunc) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::FILE: {
+            auto file = StaticAs<ASTKind::FILE>(curNode);
+            if (walk(file->package.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : file->imports) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& decl : file->exportedInternalDecls) {
+                if (walk(decl.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& it : file->decls) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::PRIMARY_CTOR_DECL: {
+            auto pcd = StaticAs<ASTKind::PRIMARY_CTOR_DECL>(curNode);
+            for (auto modifier : pcd->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(pcd->funcBody.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::MACRO_DECL: {
+            auto md = StaticAs<ASTKind::MACRO_DECL>(curNode);
+            for (auto modifier : md->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (!md->desugarDecl) {
+                if (walk(md->funcBody.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            } else {
+                if (walk(md->desugarDecl.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::MAIN_DECL: {
+            auto md = StaticAs<ASTKind::MAIN_DECL>(curNode);
+            if (md->desugarDecl) {
+                if (walk(md->desugarDecl.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            } else {
+                if (walk(md->funcBody.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::FUNC_DECL: {
+            auto fd = StaticAs<ASTKind::FUNC_DECL>(curNode);
+            for (auto modifier : fd->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(fd->funcBody.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::FUNC_BODY: {
+            auto fb = StaticAs<ASTKind::FUNC_BODY>(curNode);
+            if (walk(fb->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& paramList : fb->paramLists) {
+                if (walk(paramList.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(fb->retType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(fb->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::FUNC_PARAM_LIST: {
+            auto fpl = StaticAs<ASTKind::FUNC_PARAM_LIST>(curNode);
+            for (auto& param : fpl->params) {
+                if (walk(param.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::FUNC_PARAM: {
+            auto fp = StaticAs<ASTKind::FUNC_PARAM>(curNode);
+            if (walk(fp->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(fp->assignment.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(fp->desugarDecl.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::MACRO_EXPAND_PARAM: {
+            auto mep = StaticAs<ASTKind::MACRO_EXPAND_PARAM>(curNode);
+            if (walk(mep->invocation.decl.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::PROP_DECL: {
+            auto pd = StaticAs<ASTKind::PROP_DECL>(curNode);
+            for (auto modifier : pd->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(pd->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : pd->getters) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& it : pd->setters) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::VAR_WITH_PATTERN_DECL: {
+            auto vpd = StaticAs<ASTKind::VAR_WITH_PATTERN_DECL>(curNode);
+            if (walk(vpd->irrefutablePattern.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(vpd->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(vpd->initializer.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::VAR_DECL: {
+            auto vd = StaticAs<ASTKind::VAR_DECL>(curNode);
+            for (auto modifier : vd->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(vd->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(vd->initializer.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::TYPE_ALIAS_DECL: {
+            auto ta = StaticAs<ASTKind::TYPE_ALIAS_DECL>(curNode);
+            if (walk(ta->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ta->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::CLASS_DECL: {
+            auto cd = StaticAs<ASTKind::CLASS_DECL>(curNode);
+            for (auto modifier : cd->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(cd->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& refType : cd->inheritedTypes) {
+                if (walk(refType.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(cd->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::INTERFACE_DECL: {
+            auto id = StaticAs<ASTKind::INTERFACE_DECL>(curNode);
+            for (auto modifier : id->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(id->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : id->inheritedTypes) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(id->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::ENUM_DECL: {
+            auto ed = StaticAs<ASTKind::ENUM_DECL>(curNode);
+            if (walk(ed->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : ed->inheritedTypes) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& it : ed->constructors) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& it : ed->members) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::STRUCT_DECL: {
+            auto sd = StaticAs<ASTKind::STRUCT_DECL>(curNode);
+            for (auto modifier : sd->modifiers) {
+                if (walk(&modifier) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(sd->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : sd->inheritedTypes) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(sd->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::STRUCT_BODY: {
+            auto rb = StaticAs<ASTKind::STRUCT_BODY>(curNode);
+            for (auto& it : rb->decls) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::EXTEND_DECL: {
+            auto ed = StaticAs<ASTKind::EXTEND_DECL>(curNode);
+            if (walk(ed->extendedType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : ed->inheritedTypes) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(ed->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : ed->members) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::CLASS_BODY: {
+            auto cb = StaticAs<ASTKind::CLASS_BODY>(curNode);
+            for (auto& it : cb->decls) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::INTERFACE_BODY: {
+            auto ib = StaticAs<ASTKind::INTERFACE_BODY>(curNode);
+            for (auto& it : ib->decls) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::MACRO_EXPAND_DECL: {
+            auto med = StaticAs<ASTKind::MACRO_EXPAND_DECL>(curNode);
+            if (walk(med->invocation.decl.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::MACRO_EXPAND_EXPR: {
+            auto mee = StaticAs<ASTKind::MACRO_EXPAND_EXPR>(curNode);
+            if (walk(mee->invocation.decl.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::IF_EXPR: {
+            auto ie = StaticAs<ASTKind::IF_EXPR>(curNode);
+            if (walk(ie->condExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ie->thenBody.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (ie->hasElse) {
+                if (walk(ie->elseBody.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::LET_PATTERN_DESTRUCTOR: {
+            auto lpd = StaticAs<ASTKind::LET_PATTERN_DESTRUCTOR>(curNode);
+            for (auto& p : lpd->patterns) {
+                if (walk(p.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(lpd->initializer.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::MATCH_CASE: {
+            auto mc = StaticAs<ASTKind::MATCH_CASE>(curNode);
+            for (auto& it : mc->patterns) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(mc->patternGuard.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(mc->exprOrDecls.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::MATCH_CASE_OTHER: {
+            auto mco = StaticAs<ASTKind::MATCH_CASE_OTHER>(curNode);
+            if (walk(mco->matchExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(mco->exprOrDecls.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::MATCH_EXPR: {
+            auto me = StaticAs<ASTKind::MATCH_EXPR>(curNode);
+            if (me->matchMode) {
+                if (walk(me->selector.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+                for (auto& it : me->matchCases) {
+                    if (walk(it.get()) == VisitAction::STOP_NOW) {
+                        return VisitAction::STOP_NOW;
+                    }
+                }
+            } else {
+                for (auto& it : me->matchCaseOthers) {
+                    if (walk(it.get()) == VisitAction::STOP_NOW) {
+                        return VisitAction::STOP_NOW;
+                    }
+                }
+            }
+            break;
+        }
+        case ASTKind::TRY_EXPR: {
+            auto te = StaticAs<ASTKind::TRY_EXPR>(curNode);
+            for (auto& it : te->resourceSpec) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(te->tryBlock.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (uint32_t cnt = 0; cnt < te->catchPatterns.size(); ++cnt) {
+                if (walk(te->catchPatterns[cnt].get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (uint32_t cnt = 0; cnt < te->catchBlocks.size(); ++cnt) {
+                if (walk(te->catchBlocks[cnt].get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            // Once the try-handle block has been desugared, we do not want to visit
+            // the handle blocks again, since they have been turned into lambdas but
+            // they still contain old AST nodes.
+            for (const auto& handler : te->handlers) {
+                if (te->desugarExpr) {
+                    break;
+                }
+                if (walk(handler.commandPattern.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+                if (walk(handler.block.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+                if (handler.desugaredLambda && walk(handler.desugaredLambda.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(te->finallyBlock.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(te->tryLambda.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(te->finallyLambda.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::THROW_EXPR: {
+            auto te = StaticAs<ASTKind::THROW_EXPR>(curNode);
+            if (walk(te->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::PERFORM_EXPR: {
+            auto pe = StaticAs<ASTKind::PERFORM_EXPR>(curNode);
+            if (walk(pe->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::RESUME_EXPR: {
+            auto re = StaticAs<ASTKind::RESUME_EXPR>(curNode);
+            if (walk(re->withExpr.get()) == VisitAction::STOP_NOW ||
+                    walk(re->throwingExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::RETURN_EXPR: {
+            auto re = StaticAs<ASTKind::RETURN_EXPR>(curNode);
+            if (!re->desugarExpr) {
+                if (walk(re->expr.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::FOR_IN_EXPR: {
+            auto fie = StaticAs<ASTKind::FOR_IN_EXPR>(curNode);
+            if (walk(fie->pattern.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(fie->inExpression.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(fie->patternGuard.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(fie->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::WHILE_EXPR: {
+            auto we = StaticAs<ASTKind::WHILE_EXPR>(curNode);
+            if (walk(we->condExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(we->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::DO_WHILE_EXPR: {
+            auto dwe = StaticAs<ASTKind::DO_WHILE_EXPR>(curNode);
+            if (walk(dwe->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(dwe->condExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::ASSIGN_EXPR: {
+            auto ae = StaticAs<ASTKind::ASSIGN_EXPR>(curNode);
+            if (walk(ae->leftValue.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ae->rightExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::INC_OR_DEC_EXPR: {
+            auto expr = StaticAs<ASTKind::INC_OR_DEC_EXPR>(curNode);
+            if (walk(expr->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::UNARY_EXPR: {
+            auto ue = StaticAs<ASTKind::UNARY_EXPR>(curNode);
+            if (walk(ue->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::BINARY_EXPR: {
+            auto be = StaticAs<ASTKind::BINARY_EXPR>(curNode);
+            if (walk(be->leftExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(be->rightExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::RANGE_EXPR: {
+            auto re = StaticAs<ASTKind::RANGE_EXPR>(curNode);
+            if (walk(re->startExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(re->stopExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(re->stepExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::SUBSCRIPT_EXPR: {
+            auto se = StaticAs<ASTKind::SUBSCRIPT_EXPR>(curNode);
+            if (walk(se->baseExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : se->indexExprs) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::MEMBER_ACCESS: {
+            auto ma = StaticAs<ASTKind::MEMBER_ACCESS>(curNode);
+            if (walk(ma->baseExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : ma->typeArguments) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::FUNC_ARG: {
+            auto fa = StaticAs<ASTKind::FUNC_ARG>(curNode);
+            if (walk(fa->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::CALL_EXPR: {
+            auto ce = StaticAs<ASTKind::CALL_EXPR>(curNode);
+            if (walk(ce->baseFunc.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (ce->desugarArgs.has_value()) {
+                for (auto& it : ce->desugarArgs.value()) {
+                    if (walk(it) == VisitAction::STOP_NOW) {
+                        return VisitAction::STOP_NOW;
+                    }
+                }
+            } else { // 'desugarArgs' contains 'ce->args'.
+                for (auto& it : ce->args) {
+                    if (walk(it.get()) == VisitAction::STOP_NOW) {
+                        return VisitAction::STOP_NOW;
+                    }
+                }
+            }
+            break;
+        }
+        case ASTKind::PAREN_EXPR: {
+            auto pe = StaticAs<ASTKind::PAREN_EXPR>(curNode);
+            if (walk(pe->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::LAMBDA_EXPR: {
+            auto le = StaticAs<ASTKind::LAMBDA_EXPR>(curNode);
+            if (walk(le->funcBody.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::TRAIL_CLOSURE_EXPR: {
+            auto tce = StaticAs<ASTKind::TRAIL_CLOSURE_EXPR>(curNode);
+            if (walk(tce->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(tce->lambda.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::LIT_CONST_EXPR: {
+            auto lce = StaticAs<ASTKind::LIT_CONST_EXPR>(curNode);
+            if (walk(lce->ref.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (!lce->desugarExpr && walk(lce->siExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::STR_INTERPOLATION_EXPR: {
+            auto sie = StaticAs<ASTKind::STR_INTERPOLATION_EXPR>(curNode);
+            for (auto& it : sie->strPartExprs) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::INTERPOLATION_EXPR: {
+            auto ie = StaticAs<ASTKind::INTERPOLATION_EXPR>(curNode);
+            if (walk(ie->block.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::ARRAY_LIT: {
+            auto al = StaticAs<ASTKind::ARRAY_LIT>(curNode);
+            for (auto& it : al->children) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::ARRAY_EXPR: {
+            auto asl = StaticAs<ASTKind::ARRAY_EXPR>(curNode);
+            if (walk(asl->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : asl->args) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::POINTER_EXPR: {
+            auto ptrExpr = StaticAs<ASTKind::POINTER_EXPR>(curNode);
+            if (walk(ptrExpr->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ptrExpr->arg.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::TUPLE_LIT: {
+            auto tl = StaticAs<ASTKind::TUPLE_LIT>(curNode);
+            for (auto& it : tl->children) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::TYPE_CONV_EXPR: {
+            auto expr = StaticAs<ASTKind::TYPE_CONV_EXPR>(curNode);
+            if (walk(expr->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(expr->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::REF_EXPR: {
+            auto re = StaticAs<ASTKind::REF_EXPR>(curNode);
+            for (auto& it : re->typeArguments) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::IF_AVAILABLE_EXPR: {
+            auto ie = StaticCast<IfAvailableExpr>(curNode);
+            if (walk(ie->GetArg()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ie->GetLambda1()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ie->GetLambda2()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::BLOCK: {
+            auto block = StaticAs<ASTKind::BLOCK>(curNode);
+            for (auto& it : block->body) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::REF_TYPE: {
+            auto rt = StaticAs<ASTKind::REF_TYPE>(curNode);
+            for (auto& typeArg : rt->typeArguments) {
+                if (walk(typeArg.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::QUALIFIED_TYPE: {
+            auto qt = StaticAs<ASTKind::QUALIFIED_TYPE>(curNode);
+            if (walk(qt->baseType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& ta : qt->typeArguments) {
+                if (walk(ta.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::OPTION_TYPE: {
+            auto ot = StaticAs<ASTKind::OPTION_TYPE>(curNode);
+            if (walk(ot->desugarType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ot->componentType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::CONSTANT_TYPE: {
+            auto ct = StaticAs<ASTKind::CONSTANT_TYPE>(curNode);
+            if (walk(ct->constantExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::VARRAY_TYPE: {
+            auto vt = StaticAs<ASTKind::VARRAY_TYPE>(curNode);
+            if (walk(vt->typeArgument.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(vt->constantType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::PAREN_TYPE: {
+            auto pt = StaticAs<ASTKind::PAREN_TYPE>(curNode);
+            if (walk(pt->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::FUNC_TYPE: {
+            auto ft = StaticAs<ASTKind::FUNC_TYPE>(curNode);
+            for (auto& paramType : ft->paramTypes) {
+                if (walk(paramType.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            if (walk(ft->retType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::TUPLE_TYPE: {
+            auto tt = StaticAs<ASTKind::TUPLE_TYPE>(curNode);
+            for (auto& it : tt->fieldTypes) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::GENERIC_CONSTRAINT: {
+            auto gc = StaticAs<ASTKind::GENERIC_CONSTRAINT>(curNode);
+            if (walk(gc->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& upperBound : gc->upperBounds) {
+                if (walk(upperBound.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::CONST_PATTERN: {
+            auto cp = StaticAs<ASTKind::CONST_PATTERN>(curNode);
+            if (walk(cp->literal.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(cp->operatorCallExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::VAR_PATTERN: {
+            auto vp = StaticAs<ASTKind::VAR_PATTERN>(curNode);
+            if (walk(vp->varDecl.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::TUPLE_PATTERN: {
+            auto tp = StaticAs<ASTKind::TUPLE_PATTERN>(curNode);
+            for (auto& pattern : tp->patterns) {
+                if (walk(pattern.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::TYPE_PATTERN: {
+            auto tp = StaticAs<ASTKind::TYPE_PATTERN>(curNode);
+            if (walk(tp->pattern.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(tp->type.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::ENUM_PATTERN: {
+            auto ep = StaticAs<ASTKind::ENUM_PATTERN>(curNode);
+            if (walk(ep->constructor.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& pattern : ep->patterns) {
+                if (walk(pattern.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::VAR_OR_ENUM_PATTERN: {
+            auto vep = StaticAs<ASTKind::VAR_OR_ENUM_PATTERN>(curNode);
+            if (walk(vep->pattern.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::EXCEPT_TYPE_PATTERN: {
+            auto& exceptPattern = *StaticCast<ExceptTypePattern*>(curNode);
+            if (walk(exceptPattern.pattern.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& i : exceptPattern.types) {
+                if (walk(i.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::COMMAND_TYPE_PATTERN: {
+            auto& commandPattern = *StaticCast<CommandTypePattern*>(curNode);
+            if (walk(commandPattern.pattern.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& i : commandPattern.types) {
+                if (walk(i.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::ANNOTATION: {
+            auto anno = StaticAs<ASTKind::ANNOTATION>(curNode);
+            if (walk(anno->baseExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            for (auto& it : anno->args) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::SPAWN_EXPR: {
+            auto se = StaticAs<ASTKind::SPAWN_EXPR>(curNode);
+            if (se->arg && walk(se->arg.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(se->task.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (se->futureObj) {
+                if (walk(se->futureObj.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::SYNCHRONIZED_EXPR: {
+            auto se = StaticAs<ASTKind::SYNCHRONIZED_EXPR>(curNode);
+            // Notes: Seems that other part still needs information of se->mutex after desugar,
+            // which seems weird. If simply break when se->desugar is not null, there are test
+            // cases which fail.
+            if (walk(se->mutex.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            // If se is not desugared yet, we should be able to collect se->body.
+            if (!se->desugarExpr && walk(se->body.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::QUOTE_EXPR: {
+            auto qe = StaticAs<ASTKind::QUOTE_EXPR>(curNode);
+            for (auto& it : qe->exprs) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::IS_EXPR: {
+            auto ie = StaticAs<ASTKind::IS_EXPR>(curNode);
+            if (walk(ie->leftExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ie->isType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::AS_EXPR: {
+            auto ae = StaticAs<ASTKind::AS_EXPR>(curNode);
+            if (walk(ae->leftExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            if (walk(ae->asType.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::BUILTIN_DECL: {
+            auto bid = StaticAs<ASTKind::BUILTIN_DECL>(curNode);
+            if (walk(bid->generic.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::GENERIC: {
+            auto generic = StaticAs<ASTKind::GENERIC>(curNode);
+            for (auto& it : generic->typeParameters) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            for (auto& it : generic->genericConstraints) {
+                if (walk(it.get()) == VisitAction::STOP_NOW) {
+                    return VisitAction::STOP_NOW;
+                }
+            }
+            break;
+        }
+        case ASTKind::OPTIONAL_CHAIN_EXPR: {
+            auto oce = StaticAs<ASTKind::OPTIONAL_CHAIN_EXPR>(curNode);
+            // Only walk child when the optional chain is not desugared.
+            if (!oce->desugarExpr && walk(oce->expr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        case ASTKind::OPTIONAL_EXPR: {
+            auto oe = StaticAs<ASTKind::OPTIONAL_EXPR>(curNode);
+            if (walk(oe->baseExpr.get()) == VisitAction::STOP_NOW) {
+                return VisitAction::STOP_NOW;
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    return VisitAction::WALK_CHILDREN;
+}
+} // namespace Cangjie::AST
+
+#endif // CANGJIE_AST_WALKCHILDREN_H
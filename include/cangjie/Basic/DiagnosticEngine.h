@@ -792,6 +792,13 @@ public:
     void Prepare();
     void Commit();
     void ClearTransaction();
+    /**
+     * End the transaction of the current thread and return its diagnostics without reporting them. Used to collect
+     * the diagnostics of tasks running in parallel, which are then reported by @ref Commit in a fixed order.
+     */
+    std::vector<Diagnostic> TakeTransaction();
+    /** Report @p diags collected by @ref TakeTransaction, in the given order. */
+    void Commit(std::vector<Diagnostic>& diags);
 
     // use DiagEngineErrorCode rather than internal error message (for libast)
     void EnableCheckRangeErrorCodeRatherICE();
@@ -17,13 +17,18 @@
 #include <cstdint>
 
 namespace Cangjie {
-enum class PositionStatus {
+enum class PositionStatus : uint8_t {
     KEEP,   /**< Mark the position is valid and should be kept. */
     IGNORE, /**< Mark the position should be ignored when emitting debug info. */
 };
 
 /**
- * A position in a source file. Line and column start at 1 (byte count for column). */
+ * A position in a source file. Line and column start at 1 (byte count for column).
+ *
+ * Nodes keep their positions unpacked rather than as a 32-bit offset resolved through the SourceManager: the AST
+ * loader registers the files of imported packages without their content, so an offset into them could not be mapped
+ * back to a line and column, and positions are shifted by line and column arithmetic (see the operators below).
+ */
 struct Position {
     Position(unsigned int fileID, int line, int column) noexcept : fileID(fileID), line(line), column(column)
     {
@@ -84,8 +89,9 @@ struct Position {
     }
 
 private:
-    PositionStatus status{PositionStatus::KEEP};
+    PositionStatus status{PositionStatus::KEEP}; /**< Shares the padding word with isCurFile. */
 };
+static_assert(sizeof(Position) == 16, "every node holds several positions, keep them in 16 bytes");
 
 const Position INVALID_POSITION = Position{0, 0, 0};
 const Position BEGIN_POSITION = Position{0, 1, 1};
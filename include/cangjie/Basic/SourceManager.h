@@ -13,6 +13,8 @@
 #ifndef CANGJIE_BASIC_SOURCEMANAGER_H
 #define CANGJIE_BASIC_SOURCEMANAGER_H
 
+#include <deque>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -48,31 +50,34 @@ struct Source {
      */
     std::vector<size_t> lineOffsets{0}; /**< First offset of each line. */
     std::optional<std::string> packageName = std::nullopt;
+    /** Byte offset of @p pos, O(1) through lineOffsets. */
     size_t PosToOffset(const Position& pos) const;
+    /** Offset just past the last character of the line at @p index, not counting its line terminator. */
+    size_t GetLineContentEnd(size_t index) const;
 
     Source(unsigned int fileID, std::string path, std::string buffer, uint64_t fileHash = 0,
         const std::optional<std::string>& packageName = std::nullopt);
-    Position GetEndPos() const
-    {
-        auto sourceSplited = Utils::SplitLines(buffer);
-        if (sourceSplited.empty()) {
-            return Position{fileID, 1, 1};
-        }
-        auto sourceLine = static_cast<int>(sourceSplited.size());
-        auto column = static_cast<int>(sourceSplited.back().size()) + 1;
-        return Position{fileID, sourceLine, column};
-    }
+    Position GetEndPos() const;
     std::unordered_map<size_t, Token> offsetCommentsMap; /**< Offset->Comments map. */
 };
 
 /**
  * SourceManager manage all source files.
+ *
+ * Registering sources is thread-safe. Sources are never moved once registered, so a reference returned by GetSource
+ * stays valid while other sources are added. A reserved source is filled by SetBuffer, different sources may be
+ * filled concurrently. Only the functions registering sources lock: GetSource is on the hot path of diagnostics and
+ * code generation, so it must not run concurrently with registering a new source.
  */
 class SourceManager {
 private:
     std::unordered_map<std::string, int> filePathToFileIDMap;
-    std::vector<Source> sources{{0, "", ""}};
-    
+    std::deque<Source> sources{{0, "", ""}};
+    mutable std::mutex mtx;
+
+    void EmplaceSource(unsigned int fileID, std::string normalizedPath, std::string buffer, uint64_t fileHash,
+        std::optional<std::string> packageName = std::nullopt);
+
 public:
     SourceManager() = default;
     SourceManager(const SourceManager&) = delete;
@@ -90,7 +95,7 @@ public:
         }
     }
 
-    const std::vector<Source>& GetSources() const
+    const std::deque<Source>& GetSources() const
     {
         return sources;
     }
@@ -101,6 +106,7 @@ public:
      */
     int GetFileID(const std::string& path)
     {
+        std::lock_guard<std::mutex> lock(mtx);
         auto exist = filePathToFileIDMap.find(path);
         if (exist != filePathToFileIDMap.end()) {
             return exist->second;
@@ -114,6 +120,7 @@ public:
      */
     unsigned int GetNumberOfFiles()
     {
+        std::lock_guard<std::mutex> lock(mtx);
         return static_cast<unsigned int>(sources.size());
     }
     
@@ -142,6 +149,21 @@ public:
      */
     unsigned int AddSource(const std::string& path, const std::string& buffer,
         std::optional<std::string> packageName = std::nullopt);
+    /**
+     * Add a source whose content is not read yet, the content is set later by SetBuffer. Files reserved in a fixed
+     * order get the same ids however their contents are read.
+     * @param path File path.
+     */
+    unsigned int ReserveSource(const std::string& path, std::optional<std::string> packageName = std::nullopt);
+    /**
+     * Set the content of the source @p fileID, which is usually reserved by ReserveSource.
+     */
+    void SetBuffer(unsigned int fileID, std::string buffer);
+    /**
+     * Forget the path of the source @p fileID reserved by ReserveSource, e.g. because its content cannot be read.
+     * The id is not reused, its source stays empty.
+     */
+    void UnreserveSource(unsigned int fileID);
     /**
      * Add source to SourceManager. Package name default to null.
      */
@@ -152,6 +174,7 @@ public:
 
     void Clear()
     {
+        std::lock_guard<std::mutex> lock(mtx);
         sources.clear();
         filePathToFileIDMap.clear();
         sources.emplace_back(Source{0, "", ""});
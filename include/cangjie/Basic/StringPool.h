@@ -0,0 +1,128 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the SharedString class and the StringPool which interns them.
+ */
+
+#ifndef CANGJIE_BASIC_STRINGPOOL_H
+#define CANGJIE_BASIC_STRINGPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Cangjie {
+/**
+ * A handle to an immutable string shared by reference counting. Copying a handle does not copy the string, and the
+ * string is freed with its last handle. A handle is as large as a pointer.
+ *
+ * Strings interned by StringPool::Intern are unique while they are referenced, so two interned handles are equal
+ * iff they refer to the same string.
+ */
+class SharedString {
+public:
+    SharedString() noexcept : rep(EmptyRep())
+    {
+    }
+    /// An unpooled string, which is only shared by copies of the handle.
+    explicit SharedString(std::string value);
+    SharedString(const SharedString& other) noexcept : rep(other.rep)
+    {
+        Retain();
+    }
+    SharedString(SharedString&& other) noexcept : rep(other.rep)
+    {
+        other.rep = EmptyRep();
+    }
+    SharedString& operator=(const SharedString& other) noexcept
+    {
+        if (rep != other.rep) {
+            other.Retain();
+            Release();
+            rep = other.rep;
+        }
+        return *this;
+    }
+    SharedString& operator=(SharedString&& other) noexcept
+    {
+        if (this != &other) {
+            Release();
+            rep = other.rep;
+            other.rep = EmptyRep();
+        }
+        return *this;
+    }
+    ~SharedString()
+    {
+        Release();
+    }
+
+    const std::string& Val() const
+    {
+        return rep->value;
+    }
+    /// Whether both handles refer to the same string, which for interned strings means they are equal.
+    bool IsSame(const SharedString& other) const
+    {
+        return rep == other.rep;
+    }
+
+private:
+    friend class StringPool;
+    struct Rep {
+        Rep(std::string value, bool pooled) : value(std::move(value)), pooled(pooled)
+        {
+        }
+        std::atomic<uint32_t> refs{1};
+        std::string value;
+        bool pooled;
+    };
+    explicit SharedString(Rep* rep) noexcept : rep(rep)
+    {
+    }
+
+    static Rep* EmptyRep() noexcept
+    {
+        // Never destroyed, handles in static objects may be released after it would be.
+        static Rep* const empty = new Rep("", false);
+        return empty;
+    }
+    void Retain() const noexcept
+    {
+        // The empty string is never freed, its count is not maintained.
+        if (rep != EmptyRep()) {
+            rep->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void Release() noexcept;
+
+    Rep* rep;
+};
+
+/**
+ * Process-wide pool of interned strings, e.g. the values of identifiers and the scope names of AST nodes, which take
+ * few distinct values over many tokens and nodes. A pooled string is removed from the pool and freed when its last
+ * handle is destroyed, so long-running processes such as the LSP server and the compiler daemon only keep the
+ * strings still in use. It is thread-safe.
+ */
+class StringPool {
+public:
+    /// Return the interned string equal to @p value.
+    static SharedString Intern(std::string_view value);
+    /// The number of strings currently interned, for tests.
+    static size_t Size();
+
+private:
+    friend class SharedString;
+    static void Release(SharedString::Rep* rep) noexcept;
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_BASIC_STRINGPOOL_H
@@ -268,6 +268,8 @@ private:
     void CollectDeclsFromStructDecl(const AST::StructDecl& structDecl);
     void CollectMemberDecl(AST::Decl& decl);
     void CollectFuncDecl(AST::FuncDecl& funcDecl);
+    /** Whether an imported package defines the instantiation @p funcDecl, so that it is only declared here. */
+    bool IsInstantiationOfImportedPackage(const AST::FuncDecl& funcDecl) const;
     void CollectImportedFuncDeclAndDesugarParams(AST::FuncDecl& funcDecl);
     void CollectImportedGlobalOrStaticVarDecl(AST::VarDecl& varDecl);
 
@@ -13,7 +13,10 @@
 #include "cangjie/CHIR/Value.h"
 
 #include <deque>
+#include <functional>
+#include <queue>
 #include <unordered_set>
+#include <vector>
 
 namespace Cangjie::CHIR {
 
@@ -64,6 +67,13 @@ template <typename Domain> struct LambdaState {
         return *this;
     }
 };
+/**
+ * @brief Dense worklist solver of a dataflow analysis over one function and the lambdas in it.
+ *
+ * The state of every block entry is a complete Domain, and a changed state re-runs the whole successor block.
+ * Facts are not propagated along def-use edges: the domains keep the state of memory reached through Allocate,
+ * Load and Store, which has no def-use edges in CHIR.
+ */
 template <typename Domain, typename = std::enable_if_t<std::is_base_of<AbstractDomain<Domain>, Domain>::value>>
 class Engine {
     friend class Results<Domain>;
@@ -164,12 +174,35 @@ public:
      */
     void IterateSingleUnitToFixpoint(Block* entryBlock, std::unordered_map<Block*, Domain>* entryStates)
     {
-        std::deque<Block*> worklist = TopologicalSort(entryBlock);
-        std::unordered_set<Block*> worklistSet(worklist.begin(), worklist.end());
+        // Blocks are numbered in reverse post order and all per-block data lives in vectors indexed by that number,
+        // so the hot loop below does no hashing apart from mapping an explicit branch target back to its index.
+        std::deque<Block*> order = TopologicalSort(entryBlock);
+        std::vector<Block*> blocks(order.begin(), order.end());
+        std::unordered_map<Block*, size_t> blockIndex;
+        blockIndex.reserve(blocks.size());
+        std::vector<Domain*> states;
+        states.reserve(blocks.size());
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            blockIndex.emplace(blocks[i], i);
+            // entryStates is not modified structurally from now on, so the pointers stay valid.
+            states.emplace_back(&entryStates->at(blocks[i]));
+        }
+        std::vector<std::vector<size_t>> succIndices(blocks.size());
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            for (auto succ : blocks[i]->GetSuccessors()) {
+                succIndices[i].emplace_back(blockIndex.at(succ));
+            }
+        }
+        // Always pick the pending block which is earliest in reverse post order: predecessors are then handled
+        // before their successors and inner loops stabilise before the code after them is revisited.
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> worklist;
+        std::vector<bool> inWorklist(blocks.size(), true);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            worklist.push(i);
+        }
 #ifdef AnalysisDevDebug
-        std::vector<Block*> temp(worklist.begin(), worklist.end());
         std::cout << "=======initialized worklist=======" << std::endl;
-        for (auto bb : temp) {
+        for (auto bb : blocks) {
             std::cout << bb->GetIdentifier() << " ";
         }
         std::cout << std::endl;
@@ -177,16 +210,17 @@ public:
 #endif
         auto state = analysis->Bottom();
         while (!worklist.empty()) {
-            auto bb = worklist.front();
-            worklist.pop_front();
-            worklistSet.erase(bb);
+            auto idx = worklist.top();
+            worklist.pop();
+            inWorklist[idx] = false;
+            auto bb = blocks[idx];
 #ifdef AnalysisDevDebug
             std::cout << "processing " << bb->GetIdentifier() << std::endl;
 #endif
-            state = entryStates->at(bb); // should not have `&`
-            if (state.IsBottom()) {
+            if (states[idx]->IsBottom()) {
                 continue;
             }
+            state = *states[idx]; // should be a copy
 #ifdef AnalysisDevDebug
             std::cout << "entry: " << state.ToString() << std::endl;
 #endif
@@ -234,17 +268,24 @@ public:
                 //   then spread top state to its successors
                 targetSucc = std::nullopt;
             }
-            auto succs = targetSucc.has_value() ? std::vector<Block*>{targetSucc.value()} : bb->GetSuccessors();
-            for (auto succ : succs) {
+            auto joinInto = [&](size_t succIdx) {
 #ifdef AnalysisDevDebug
+                auto succ = blocks[succIdx];
                 std::cout << succ->GetIdentifier() << " is joining with " << bb->GetIdentifier() << std::endl;
-                std::cout << succ->GetIdentifier() << ":\n" << entryStates->at(succ).ToString() << std::endl;
+                std::cout << succ->GetIdentifier() << ":\n" << states[succIdx]->ToString() << std::endl;
                 std::cout << bb->GetIdentifier() << ":\n" << state.ToString() << std::endl;
 #endif
-                auto hasChanged = entryStates->at(succ).Join(state);
-                if (hasChanged && worklistSet.find(succ) == worklistSet.end()) {
-                    worklist.push_back(succ);
-                    worklistSet.insert(succ);
+                auto hasChanged = states[succIdx]->Join(state);
+                if (hasChanged && !inWorklist[succIdx]) {
+                    worklist.push(succIdx);
+                    inWorklist[succIdx] = true;
+                }
+            };
+            if (targetSucc.has_value()) {
+                joinInto(blockIndex.at(targetSucc.value()));
+            } else {
+                for (auto succIdx : succIndices[idx]) {
+                    joinInto(succIdx);
                 }
             }
         }
@@ -17,6 +17,7 @@
 #include "cangjie/CHIR/Analysis/ValueRangeAnalysis.h"
 #include "cangjie/CHIR/CHIRBuilder.h"
 #include "cangjie/CHIR/DiagAdapter.h"
+#include "cangjie/CHIR/Transformation/FuncPassManager.h"
 
 namespace Cangjie::CHIR {
 class ToCHIR {
@@ -140,10 +141,13 @@ private:
     void UselessExprElimination();
     void UnreachableBranchReporter();
     void UselessFuncElimination();
-    void RedundantLoadElimination();
-    void UselessAllocateElimination();
-    void RunGetRefToArrayElemOpt();
-    void RedundantGetOrThrowElimination();
+    /// Intra-procedural passes run by `RunFuncPasses`, with the names their results are dumped by.
+    using FuncPassList = std::vector<std::pair<std::string, FuncPassManager::FuncPass>>;
+    void RunFuncPasses(const std::string& stageName, const FuncPassList& passes);
+    void RedundantLoadElimination(FuncPassList& passes) const;
+    void UselessAllocateElimination(FuncPassList& passes) const;
+    void RunGetRefToArrayElemOpt(FuncPassList& passes) const;
+    void RedundantGetOrThrowElimination(FuncPassList& passes) const;
     void FlatForInExpr();
     void RunUnreachableMarkBlockRemoval();
     void RunMarkClassHasInited();
@@ -0,0 +1,89 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the bump pointer arena which CHIR nodes are allocated from.
+ */
+
+#ifndef CANGJIE_CHIR_CHIRARENA_H
+#define CANGJIE_CHIR_CHIRARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Cangjie::CHIR {
+/**
+ * Bump pointer arena for CHIR nodes. Nodes are placed in large chunks and are never freed one by one, all of them
+ * are released together once the package is done. Only the nodes whose type has a non-trivial destructor are
+ * recorded, so that their destructors can be run before the chunks are freed.
+ *
+ * An arena is not thread safe. Each CHIRBuilder owns one and constructs the nodes in it, so a sub builder used by a
+ * single thread allocates without any lock, and its arena is merged into the one of the CHIRContext afterwards.
+ */
+class CHIRArena {
+public:
+    CHIRArena() = default;
+    CHIRArena(const CHIRArena&) = delete;
+    CHIRArena& operator=(const CHIRArena&) = delete;
+    ~CHIRArena()
+    {
+        Release();
+    }
+
+    /** @brief Allocate the memory of a node of @p size bytes, aligned as any fundamental type.*/
+    void* Allocate(size_t size)
+    {
+        size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        if (static_cast<size_t>(end - cur) < size) {
+            NewChunk(size);
+        }
+        void* ptr = cur;
+        cur += size;
+        ++nodesNum;
+        return ptr;
+    }
+
+    /** @brief Record a node whose destructor @p destroy must be run before its memory is freed.*/
+    void AddFinalizer(void* node, void (*destroy)(void*))
+    {
+        finalizers.push_back({node, destroy});
+    }
+
+    /** @brief Move all nodes of @p other into this arena, @p other is empty afterwards.*/
+    void Merge(CHIRArena& other);
+
+    size_t GetNodesNum() const
+    {
+        return nodesNum;
+    }
+
+    /**
+     * @brief Run the destructors of all nodes and free the memory.
+     * @param threadsNum number of threads running the destructors, which only free the members of their own node,
+     * so they are run in any order.
+     */
+    void Release(size_t threadsNum = 1);
+
+private:
+    struct Finalizer {
+        void* node;
+        void (*destroy)(void*);
+    };
+
+    void NewChunk(size_t minSize);
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    std::byte* cur{nullptr};
+    std::byte* end{nullptr};
+    size_t nextChunkSize{0};
+    std::vector<Finalizer> finalizers;
+    size_t nodesNum{0};
+};
+} // namespace Cangjie::CHIR
+#endif // CANGJIE_CHIR_CHIRARENA_H
@@ -20,6 +20,9 @@
 #include "cangjie/CHIR/Value.h"
 #include "cangjie/CHIR/ConstantUtils.h"
 
+#include <new>
+#include <type_traits>
+
 namespace Cangjie::CHIR {
 class CHIRBuilder {
     friend class CHIRContext;
@@ -170,9 +173,7 @@ public:
     // Note: we should be able to automatically infer the `TArgVal` here
     template <typename TLitVal, typename... Args> TLitVal* CreateLiteralValue(Args&&... args)
     {
-        TLitVal* litVal = new TLitVal(std::forward<Args>(args)...);
-        this->allocatedValues.push_back(litVal);
-        return litVal;
+        return NewNode<TLitVal>(std::forward<Args>(args)...);
     }
     Parameter* CreateParameter(Type* ty, const DebugLocation& loc, Func& parentFunc);
     Parameter* CreateParameter(Type* ty, const DebugLocation& loc, Lambda& parentLambda);
@@ -184,12 +185,10 @@ public:
     /** @brief Return a Expression.*/
     template <typename TExpr, typename... Args> TExpr* CreateExpression(Type* resultTy, Args&&... args)
     {
-        TExpr* expr = new TExpr(std::forward<Args>(args)...);
-        this->allocatedExprs.push_back(expr);
+        TExpr* expr = NewNode<TExpr>(std::forward<Args>(args)...);
         CJC_NULLPTR_CHECK(expr->GetTopLevelFunc());
         std::string idStr = "%" + std::to_string(expr->GetTopLevelFunc()->GenerateLocalId());
-        LocalVar* res = new LocalVar(resultTy, idStr, expr);
-        this->allocatedValues.push_back(res);
+        (void)NewNode<LocalVar>(resultTy, idStr, expr);
         return expr;
     }
 
@@ -215,9 +214,7 @@ public:
     template <typename TExpr, typename... Args> TExpr* CreateTerminator(Args&&... args)
     {
         static_assert(std::is_base_of_v<Terminator, TExpr>);
-        TExpr* expr = new TExpr(std::forward<Args>(args)...);
-        this->allocatedExprs.push_back(expr);
-        return expr;
+        return NewNode<TExpr>(std::forward<Args>(args)...);
     }
 
     template <typename TExpr, typename... Args> TExpr* CreateTerminator(const DebugLocation& loc, Args&&... args)
@@ -241,12 +238,10 @@ public:
     Constant* CreateConstantExpression(Type* resultTy, Block* parentBlock, Args&&... args)
     {
         TLitVal* litVal = CreateLiteralValue<TLitVal>(resultTy, std::forward<Args>(args)...);
-        Constant* expr = new Constant(litVal, parentBlock);
-        this->allocatedExprs.push_back(expr);
+        Constant* expr = NewNode<Constant>(litVal, parentBlock);
         CJC_NULLPTR_CHECK(parentBlock->GetTopLevelFunc());
         std::string idStr = "%" + std::to_string(parentBlock->GetTopLevelFunc()->GenerateLocalId());
-        LocalVar* res = new LocalVar(resultTy, idStr, expr);
-        this->allocatedValues.push_back(res);
+        (void)NewNode<LocalVar>(resultTy, idStr, expr);
         return expr;
     }
 
@@ -296,15 +291,14 @@ public:
     {
         T* importDecl = nullptr;
         if constexpr (std::is_same_v<T, ImportedFunc>) {
-            importDecl = new ImportedFunc(ty, GLOBAL_VALUE_PREFIX + mangledName,
+            importDecl = NewNode<ImportedFunc>(ty, GLOBAL_VALUE_PREFIX + mangledName,
                 srcCodeIdentifier, rawMangledName, srcPackageName, genericTypeParams);
         } else {
-            importDecl = new ImportedVar(ty, GLOBAL_VALUE_PREFIX + mangledName,
+            importDecl = NewNode<ImportedVar>(ty, GLOBAL_VALUE_PREFIX + mangledName,
                 srcCodeIdentifier, rawMangledName, srcPackageName);
         }
         CJC_NULLPTR_CHECK(importDecl);
         importDecl->EnableAttr(Attribute::IMPORTED);
-        this->allocatedValues.push_back(importDecl);
         if (context.GetCurPackage() != nullptr && addToIR) {
             context.GetCurPackage()->AddImportedVarAndFunc(importDecl);
         }
@@ -338,30 +332,7 @@ public:
 
     void MergeAllocatedInstance()
     {
-        context.GetAllocatedExprs().insert(
-            context.GetAllocatedExprs().end(), allocatedExprs.begin(), allocatedExprs.end());
-        context.GetAllocatedValues().insert(
-            context.GetAllocatedValues().end(), allocatedValues.begin(), allocatedValues.end());
-        context.GetAllocatedBlockGroups().insert(context.GetAllocatedBlockGroups().end(),
-            allocatedBlockGroups.begin(), allocatedBlockGroups.end());
-        context.GetAllocatedBlocks().insert(
-            context.GetAllocatedBlocks().end(), allocatedBlocks.begin(), allocatedBlocks.end());
-        context.GetAllocatedStructs().insert(
-            context.GetAllocatedStructs().end(), allocatedStructs.begin(), allocatedStructs.end());
-        context.GetAllocatedClasses().insert(
-            context.GetAllocatedClasses().end(), allocatedClasses.begin(), allocatedClasses.end());
-        context.GetAllocatedEnums().insert(
-            context.GetAllocatedEnums().end(), allocatedEnums.begin(), allocatedEnums.end());
-        context.GetAllocatedExtends().insert(
-            context.GetAllocatedExtends().end(), allocatedExtends.begin(), allocatedExtends.end());
-        allocatedExprs.clear();
-        allocatedValues.clear();
-        allocatedBlockGroups.clear();
-        allocatedBlocks.clear();
-        allocatedStructs.clear();
-        allocatedClasses.clear();
-        allocatedEnums.clear();
-        allocatedExtends.clear();
+        context.MergeArena(arena);
     }
 
     std::unordered_set<CustomType*> GetAllCustomTypes() const;
@@ -372,20 +343,25 @@ public:
     bool IsEnableIRCheckerAfterPlugin() const;
 
 private:
+    /** @brief Construct a node in the arena, the constructors and destructors of nodes are private to the builder.*/
+    template <typename T, typename... Args> T* NewNode(Args&&... args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+        T* node = new (arena.Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            arena.AddFinalizer(node, [](void* ptr) { static_cast<T*>(ptr)->~T(); });
+        }
+        return node;
+    }
+
     CHIRContext& context;
 
     // A flag indicate if the created CHIR value/expression should be marked as compile time value for const evaluation
     bool markAsCompileTimeValue = false;
     bool enableIRCheckerAfterPlugin = true;
     size_t threadIdx;
-    std::vector<Expression*> allocatedExprs;
-    std::vector<Value*> allocatedValues;
-    std::vector<BlockGroup*> allocatedBlockGroups;
-    std::vector<Block*> allocatedBlocks;
-    std::vector<StructDef*> allocatedStructs;
-    std::vector<ClassDef*> allocatedClasses;
-    std::vector<EnumDef*> allocatedEnums;
-    std::vector<ExtendDef*> allocatedExtends;
+    // Nodes created by this builder, moved into the context by `MergeAllocatedInstance`.
+    CHIRArena arena;
 };
 } // namespace Cangjie::CHIR
 #endif // CANGJIE_CHIR_CHIRBUILDER_H
@@ -13,6 +13,7 @@
 #ifndef CANGJIE_CHIR_CHIRCONTEXT_H
 #define CANGJIE_CHIR_CHIRCONTEXT_H
 
+#include "cangjie/CHIR/CHIRArena.h"
 #include "cangjie/CHIR/Expression/Terminator.h"
 #include "cangjie/CHIR/Type/Type.h"
 #include "cangjie/CHIR/Value.h"
@@ -196,83 +197,19 @@ public:
 
     size_t GetAllNodesNum() const
     {
-        size_t num = 0;
-        for (auto& ele : allocatedExprs) {
-            (void)ele;
-            num++;
-        }
-        for (auto& ele : allocatedValues) {
-            (void)ele;
-            num++;
-        }
-        for (auto& ele : allocatedBlockGroups) {
-            (void)ele;
-            num++;
-        }
-        for (auto& ele : allocatedBlocks) {
-            (void)ele;
-            num++;
-        }
-        for (auto& ele : allocatedStructs) {
-            (void)ele;
-            num++;
-        }
-        for (auto& ele : allocatedClasses) {
-            (void)ele;
-            num++;
-        }
-        for (auto& ele : allocatedEnums) {
-            (void)ele;
-            num++;
-        }
-        return num;
+        return nodeArena.GetNodesNum();
     }
     size_t GetTypesNum() const
     {
         return dynamicAllocatedTys.size();
     }
 
-    std::vector<Expression*>& GetAllocatedExprs()
+    /** @brief Take over the CHIR nodes allocated by a CHIRBuilder.*/
+    void MergeArena(CHIRArena& arena)
     {
-        return allocatedExprs;
+        nodeArena.Merge(arena);
     }
 
-    std::vector<Value*>& GetAllocatedValues()
-    {
-        return allocatedValues;
-    }
-
-    std::vector<BlockGroup*>& GetAllocatedBlockGroups()
-    {
-        return allocatedBlockGroups;
-    }
-
-    std::vector<Block*>& GetAllocatedBlocks()
-    {
-        return allocatedBlocks;
-    }
-
-    std::vector<StructDef*>& GetAllocatedStructs()
-    {
-        return allocatedStructs;
-    }
-
-    std::vector<ClassDef*>& GetAllocatedClasses()
-    {
-        return allocatedClasses;
-    }
-
-    std::vector<EnumDef*>& GetAllocatedEnums()
-    {
-        return allocatedEnums;
-    }
-
-    std::vector<ExtendDef*>& GetAllocatedExtends()
-    {
-        return allocatedExtends;
-    }
-
-    void DeleteAllocatedInstance(std::vector<size_t>& idxs);
     void DeleteAllocatedTys();
 
 private:
@@ -284,18 +221,10 @@ private:
     /* The file name string pool for debug location: fileID map to source path */
     std::unordered_map<unsigned int, std::string>* fileNameMap;
     /*
-     * @brief Cached Pointer of allocated instance in CHIR.
+     * @brief All CHIR nodes: values, expressions, blocks, block groups and custom type definitions.
      */
-    std::vector<Expression*> allocatedExprs;
-    std::vector<Value*> allocatedValues;
-    std::vector<BlockGroup*> allocatedBlockGroups;
-    std::vector<Block*> allocatedBlocks;
-    std::vector<StructDef*> allocatedStructs;
-    std::vector<ClassDef*> allocatedClasses;
-    std::vector<EnumDef*> allocatedEnums;
-    std::vector<ExtendDef*> allocatedExtends;
+    CHIRArena nodeArena;
 
-    static std::mutex allocatedListMtx;
     UnitType* unitTy{nullptr};
     BooleanType* boolTy{nullptr};
     RuneType* runeTy{nullptr};
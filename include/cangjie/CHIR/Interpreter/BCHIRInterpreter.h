@@ -193,6 +193,10 @@ private:
     void InterpretGetRef();
     void InterpretFieldTpl();
     void InterpretReturn();
+    /** @brief Superinstruction LVAR :: FIELD. */
+    void InterpretLVarField();
+    /** @brief Superinstruction for comparison `op` followed by BRANCH. */
+    template <OpCode op> void InterpretCompareAndBranch();
 
     IVal* AllocateValue(IVal&& value);
 
@@ -56,6 +56,36 @@ constexpr bool inline OpHasExceptionHandler(OpCode opCode)
     return OpHandlesException[static_cast<size_t>(opCode)];
 }
 
+/**
+ * @brief Returns the superinstruction fusing `opCode` with the operation `next` that immediately follows it, or
+ * OpCode::INVALID if there is none.
+ */
+constexpr OpCode GetSuperInstruction(OpCode opCode, OpCode next)
+{
+    if (opCode == OpCode::LVAR && next == OpCode::FIELD) {
+        return OpCode::LVAR_FIELD;
+    }
+    if (next != OpCode::BRANCH) {
+        return OpCode::INVALID;
+    }
+    switch (opCode) {
+        case OpCode::BIN_LT:
+            return OpCode::BIN_LT_BRANCH;
+        case OpCode::BIN_GT:
+            return OpCode::BIN_GT_BRANCH;
+        case OpCode::BIN_LE:
+            return OpCode::BIN_LE_BRANCH;
+        case OpCode::BIN_GE:
+            return OpCode::BIN_GE_BRANCH;
+        case OpCode::BIN_NOTEQ:
+            return OpCode::BIN_NOTEQ_BRANCH;
+        case OpCode::BIN_EQUAL:
+            return OpCode::BIN_EQUAL_BRANCH;
+        default:
+            return OpCode::INVALID;
+    }
+}
+
 }; // namespace Cangjie::CHIR::Interpreter
 
 #endif // CANGJIE_CHIR_INTERPRETER_OPCODES_H
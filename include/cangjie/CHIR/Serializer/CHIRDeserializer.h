@@ -17,6 +17,13 @@ class CHIRDeserializer {
     class CHIRDeserializerImpl;
 
 public:
+    /**
+     * @brief Load the whole package serialized in the .chir file @p fileName into @p chirBuilder.
+     *
+     * Every function body is materialized, there is no per-function index to load bodies on demand. A .chir file
+     * is only read by --chir-deserialize, chir-dis and the platform part of a common/platform compilation, which
+     * all use every body. Imported packages reach CHIR through their .cjo files instead.
+     */
     static bool Deserialize(const std::string& fileName, Cangjie::CHIR::CHIRBuilder& chirBuilder, ToCHIR::Phase& phase,
         bool compilePlatform = false);
 
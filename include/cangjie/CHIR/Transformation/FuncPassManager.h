@@ -0,0 +1,64 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#ifndef CANGJIE_CHIR_TRANSFORMATION_FUNC_PASS_MANAGER_H
+#define CANGJIE_CHIR_TRANSFORMATION_FUNC_PASS_MANAGER_H
+
+#include <functional>
+#include <vector>
+
+#include "cangjie/CHIR/CHIRBuilder.h"
+#include "cangjie/CHIR/Package.h"
+#include "cangjie/CHIR/Value.h"
+
+namespace Cangjie::CHIR {
+/**
+ * Run a sequence of intra-procedural passes over every global function of a package. A pass must only read and
+ * modify the function it is given, so the functions are processed in parallel, each one running all the passes
+ * in the order they were added. Whole-package passes are barriers, they run between two `FuncPassManager`s.
+ *
+ * Each function is given its own sub builder, so the IR it creates is the same whatever the number of threads.
+ */
+class FuncPassManager {
+public:
+    using FuncPass = std::function<void(Func&, CHIRBuilder&)>;
+
+    /**
+     * @brief constructor of function pass manager.
+     * @param builder CHIR builder of the package, which takes over the IR allocated by the sub builders.
+     * @param threadNum number of threads, passes are run on the calling thread if it is 1.
+     */
+    FuncPassManager(CHIRBuilder& builder, size_t threadNum) : builder(builder), threadNum(threadNum)
+    {
+    }
+
+    /**
+     * @brief add an intra-procedural pass.
+     * @param pass pass to run on each function.
+     */
+    void AddPass(FuncPass pass)
+    {
+        passes.emplace_back(std::move(pass));
+    }
+
+    bool Empty() const
+    {
+        return passes.empty();
+    }
+
+    /**
+     * @brief run the passes added so far on all global functions of @p package.
+     */
+    void Run(const Package& package);
+
+private:
+    CHIRBuilder& builder;
+    size_t threadNum;
+    std::vector<FuncPass> passes;
+};
+} // namespace Cangjie::CHIR
+
+#endif
@@ -13,6 +13,9 @@
 #ifndef CANGJIE_CHIR_TRANSFORMATION_FUNCTION_INLINE_H
 #define CANGJIE_CHIR_TRANSFORMATION_FUNCTION_INLINE_H
 
+#include <optional>
+#include <ostream>
+
 #include "cangjie/CHIR/CHIRBuilder.h"
 #include "cangjie/CHIR/Expression/Terminator.h"
 #include "cangjie/CHIR/Package.h"
@@ -20,6 +23,33 @@
 #include "cangjie/Option/Option.h"
 
 namespace Cangjie::CHIR {
+/**
+ * Call-site execution counts for the inliner, keyed by the mangled names of the caller and the callee. The profile
+ * is a text file with one `<caller> <callee> <count>` entry per line, where the count is a decimal number. Empty
+ * lines and lines starting with '#' are skipped. CHIR has no stable id for a single call site, so counts of the same
+ * pair are summed.
+ */
+class InlineProfile {
+public:
+    /**
+     * @brief Read the profile, malformed lines are ignored.
+     * @param path path of the profile.
+     * @return false if the file cannot be read.
+     */
+    bool Load(const std::string& path);
+
+    std::optional<uint64_t> GetCount(const std::string& caller, const std::string& callee) const;
+
+    uint64_t GetMaxCount() const
+    {
+        return maxCount;
+    }
+
+private:
+    std::unordered_map<std::string, uint64_t> counts;
+    uint64_t maxCount{0};
+};
+
 /**
  * CHIR Opt Pass: do function inline for CHIR IR.
  */
@@ -55,8 +85,40 @@ public:
      */
     void DoFunctionInline(const Apply& apply, const std::string& name);
 
+    /**
+     * @brief Use call-site counts to raise the threshold of hot calls and lower the threshold of cold calls.
+     * @param inlineProfile profile which outlives this pass.
+     */
+    void SetProfile(const InlineProfile* inlineProfile)
+    {
+        profile = inlineProfile;
+    }
+
+    /**
+     * @brief Write every inline decision as a JSON object per line.
+     * @param out stream which outlives this pass.
+     */
+    void SetRemarkStream(std::ostream* out)
+    {
+        remarks = out;
+    }
+
 private:
+    /// Why a call site was inlined or not, and the numbers the decision was made from.
+    struct InlineRemark {
+        const char* reason{""};
+        std::optional<size_t> size;
+        std::optional<size_t> threshold;
+        size_t loopDepth{0};
+        std::optional<uint64_t> count;
+    };
+
     bool CheckCanRewrite(const Apply& apply);
+    bool ShouldInline(const Apply& apply, InlineRemark& remark);
+    size_t CalculateThreshold(const Apply& apply, const Func& callee, InlineRemark& remark) const;
+    void CollectLoopDepth(const BlockGroup& group, size_t baseDepth);
+    size_t GetLoopDepth(const Apply& apply) const;
+    void EmitRemark(const Apply& apply, bool inlined, const InlineRemark& remark) const;
     void RecordEffectMap(const Apply& apply);
     void ReplaceFuncResult(LocalVar* resNew, LocalVar* resOld);
 
@@ -73,6 +135,9 @@ private:
     Func* globalFunc{nullptr};
     std::unordered_map<Func*, size_t> inlinedCountMap;
     std::unordered_map<Func*, size_t> funcSizeMap;
+    std::unordered_map<const Apply*, size_t> loopDepthMap;
+    const InlineProfile* profile{nullptr};
+    std::ostream* remarks{nullptr};
     const std::string optName{"Function Inline"};
     OptEffectCHIRMap effectMap;
 };
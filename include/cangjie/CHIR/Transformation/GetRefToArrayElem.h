@@ -22,7 +22,12 @@ public:
      * @param builder CHIR builder for generating IR.
      */
     static void RunOnPackage(const Package& package, CHIRBuilder& builder);
-private:
+
+    /**
+     * @brief ARRAY_GET_UNCHECKED intrinsic optimization on a single function, it only modifies @p func.
+     * @param func function to do optimization.
+     * @param builder CHIR builder for generating IR.
+     */
     static void RunOnFunc(const Func& func, CHIRBuilder& builder);
 };
 } // namespace Cangjie::CHIR
@@ -28,7 +28,11 @@ public:
      */
     void RunOnPackage(const Ptr<const Package>& package, bool isDebug) const;
 
-private:
+    /**
+     * @brief GetOrThrow elimination on a single function, it only modifies @p func.
+     * @param func function to do optimization.
+     * @param isDebug flag whether print debug log.
+     */
     void RunOnFunc(const Ptr<const Func>& func, bool isDebug) const;
 };
 } // namespace Cangjie::CHIR
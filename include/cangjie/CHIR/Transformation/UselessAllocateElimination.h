@@ -22,7 +22,12 @@ public:
      * @param isDebug flag whether print debug log.
      */
     static void RunOnPackage(const Package& package, bool isDebug);
-private:
+
+    /**
+     * @brief Useless allocate elimination on a single function, it only modifies @p func.
+     * @param func function to do optimization.
+     * @param isDebug flag whether print debug log.
+     */
     static void RunOnFunc(const Func& func, bool isDebug);
 };
 } // namespace Cangjie::CHIR
@@ -0,0 +1,66 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the in-process code generation of the cjnative backend.
+ */
+
+#ifndef CANGJIE_DRIVER_BACKEND_CJNATIVE_IN_PROCESS_CODEGEN_H
+#define CANGJIE_DRIVER_BACKEND_CJNATIVE_IN_PROCESS_CODEGEN_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cangjie/Driver/DriverOptions.h"
+#include "cangjie/Driver/TempFileInfo.h"
+
+namespace llvm {
+class Module;
+}
+
+namespace Cangjie {
+/**
+ * CJNATIVEInProcessCodeGen does the work of the 'opt' and 'llc' stages of CJNATIVEBackend inside cjc. It takes
+ * the llvm::Modules generated by CodeGen, runs the new pass manager pipeline on them and emits one object file
+ * per module, so the bitcode is neither written to disk nor parsed again by separate processes.
+ * Every module owns its LLVMContext, so modules are compiled in parallel.
+ */
+class CJNATIVEInProcessCodeGen {
+public:
+    explicit CJNATIVEInProcessCodeGen(const DriverOptions& driverOptions) : driverOptions(driverOptions)
+    {
+    }
+
+    /**
+     * @brief Initialize the llvm targets and apply the command line options of 'opt' and 'llc'.
+     * Options are global in llvm, so this is done once per process.
+     *
+     * @return bool Return false if the options cannot be applied in process, the external tools must be used.
+     */
+    bool Initialize() const;
+
+    /**
+     * @brief Optimize the modules and write the object file of each of them.
+     *
+     * @param modules The modules generated by CodeGen, in the same order as bitCodeFiles.
+     * @param bitCodeFiles The frontend output files the modules stand for.
+     * @param objFiles The generated object files.
+     * @return bool Return true if all object files are written.
+     */
+    bool Compile(const std::vector<std::unique_ptr<llvm::Module>>& modules,
+        const std::vector<TempFileInfo>& bitCodeFiles, std::vector<TempFileInfo>& objFiles) const;
+
+private:
+    const DriverOptions& driverOptions;
+
+    bool CompileModule(llvm::Module& module, const std::string& objFilePath) const;
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_DRIVER_BACKEND_CJNATIVE_IN_PROCESS_CODEGEN_H
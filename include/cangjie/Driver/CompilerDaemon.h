@@ -0,0 +1,96 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the CompilerDaemon class, which serves compile requests over a local socket.
+ */
+
+#ifndef CANGJIE_DRIVER_COMPILERDAEMON_H
+#define CANGJIE_DRIVER_COMPILERDAEMON_H
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Cangjie {
+/// The environment variable naming the socket of a running daemon. When it is set, `cjc` forwards its compilation.
+inline const std::string CJC_DAEMON_SOCKET_ENV = "CJC_DAEMON_SOCKET";
+
+/**
+ * A compilation forwarded to the daemon. The standard streams of the client are passed along with it, so the
+ * compilation prints to the terminal of the client.
+ */
+struct CompileRequest {
+    std::string workingDirectory;
+    /// The `cjc` run by the client. The daemon compiles as this executable, so it finds the same SDK.
+    std::string exePath;
+    std::vector<std::string> args;
+    std::unordered_map<std::string, std::string> environmentVars;
+};
+
+/**
+ * A long-running compiler server. Each request is compiled in a child process forked from the daemon, so
+ * compilations are isolated from each other while sharing everything the daemon holds in memory. After each
+ * compilation, the daemon maps and verifies the .cjo files it imported (see `CjoFileCache`), so following
+ * compilations importing the same packages, which always include the std library, skip reading and verifying
+ * them as long as they are unchanged on disk.
+ *
+ * Only the mapped and verified .cjo files are kept across compilations. The ASTs loaded from them, the types of the
+ * `TypeManager` and the BCHIR of the interpreter belong to the `CompilerInstance` of a compilation, so every forked
+ * child still builds them anew.
+ *
+ * The daemon is only available on Unix-like systems.
+ */
+class CompilerDaemon {
+public:
+    /// Run one compilation in the forked child, return its exit code.
+    using CompileFunc = std::function<int(const CompileRequest&)>;
+
+    CompilerDaemon(const std::string& socketPath, CompileFunc compile)
+        : socketPath(socketPath), compile(std::move(compile))
+    {
+    }
+
+    /// Map and verify all .cjo files under @p dir ahead of the first request, e.g. the std library.
+    void PreloadDirectory(const std::string& dir) const;
+
+    /**
+     * @brief Listen on the socket and serve requests until the daemon receives SIGTERM or SIGINT.
+     *
+     * @return Whether the socket could be listened on.
+     */
+    bool Serve();
+
+    /**
+     * @brief Forward a compilation to the daemon listening on @p socketPath and wait for it to finish.
+     *
+     * @return The exit code of the compilation, or nothing if no daemon could be reached, in which case the
+     * caller should compile by itself.
+     */
+    static std::optional<int> Forward(const std::string& socketPath, const CompileRequest& request);
+
+private:
+    struct Client {
+        int clientFd{-1};
+        int reportFd{-1};
+        std::string report;
+    };
+
+    /// Accept a client and fork the child compiling its request. The child reads the request, not the daemon.
+    void Accept(int listenFd);
+    void Finish(int pid, Client& client) const;
+
+    std::string socketPath;
+    CompileFunc compile;
+    std::unordered_map<int, Client> clients; // Keyed by the pid of the child compiling the request.
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_DRIVER_COMPILERDAEMON_H
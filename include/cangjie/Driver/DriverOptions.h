@@ -80,6 +80,9 @@ public:
 
     bool incrementalCompileNoChange = false;
 
+    // Whether the frontend outputs were already compiled into object files inside the driver process.
+    bool frontendOutputsCompiled = false;
+
     // ---------- CODE OBFUSCATION OPTIONS ----------
     bool enableObfAll = false;
 
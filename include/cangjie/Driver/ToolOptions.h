@@ -26,6 +26,14 @@ using SetFuncType = const std::function<void(std::string)>;
 using ToolOptionType = std::function<void(SetFuncType, const DriverOptions&)>;
 
 namespace OPT {
+/**
+ * @brief Get the pass pipeline of the new pass manager, i.e. the value of the 'passes' option.
+ *
+ * @param driverOptions The data structure is obtained through parsing the compilation options.
+ * @return std::string The comma separated pass pipeline.
+ */
+std::string GetNewPassManagerPipeline(const DriverOptions& driverOptions);
+
 /**
  * @brief Set the new password manager opt options.
  *
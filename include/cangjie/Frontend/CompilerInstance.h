@@ -167,7 +167,7 @@ public:
      * Perform AST diff to get incremental compilation scope.
      */
     virtual bool PerformIncrementalScopeAnalysis();
-    bool CalculateASTCache();
+    bool CalculateASTCache(const CachedFileHashes* prevHashes = nullptr);
 
     /**
      * Perform typecheck and other semantic check jobs.
@@ -488,6 +488,7 @@ public:
     std::unordered_set<Ptr<const AST::Decl>> declsWithDuplicatedRawMangleName;
     std::unordered_map<RawMangledName, std::list<std::pair<Ptr<AST::ExtendDecl>, int>>> directExtends;
     FileMap fileMap;
+    FileContentHashMap fileContentHashes;
     std::vector<const AST::Decl*> order;
 
     /// Used by CJLint
@@ -522,7 +523,7 @@ protected:
     TypeChecker* typeChecker = nullptr;
     // Modularize compilation.
     bool ModularizeCompilation();
-    // Build Trie tree or not;
+    // Build the name and position indexes of the searcher or not.
     bool buildTrie = true;
 
     std::unordered_map<unsigned int, std::string> fileNameMap;
@@ -15,6 +15,10 @@
 
 #include "cangjie/Frontend/CompilerInstance.h"
 
+namespace llvm {
+class Module;
+}
+
 namespace Cangjie {
 namespace CodeGen {
     class CGModule;
@@ -37,6 +41,14 @@ public:
 
     bool PerformMangling() override;
     void DumpDepPackage();
+#ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
+    /**
+     * @brief Hand over the modules whose bitcode files were not written because the in-process backend is
+     * enabled. The modules are in the same order as the frontend output files, the caller is responsible for
+     * releasing them with `CodeGen::ClearPackageModules`.
+     */
+    std::vector<std::unique_ptr<llvm::Module>> ReleaseLLVMModules();
+#endif
 
 protected:
     bool SaveCjoAndBchir(AST::Package& pkg) const;
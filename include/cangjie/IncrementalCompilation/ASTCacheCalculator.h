@@ -10,13 +10,20 @@
 #include "cangjie/AST/Node.h"
 #include "cangjie/IncrementalCompilation/CompilationCache.h"
 
+namespace Cangjie {
+class SourceManager;
+}
+
 namespace Cangjie::IncrementalCompilation {
 
 /// a class that computes the information necessary to be kept for further incremental compilation, and also
 /// data that may later be used to analyse changed decls since last compilation.
 class ASTCacheCalculator {
 public:
-    ASTCacheCalculator(const AST::Package& p, const std::pair<bool, bool>& srcInfo);
+    /// The content of the files is hashed only if @p sourceManager is given. The decls of a file whose content hash
+    /// is the same as in @p prevHashes take their hashes from there.
+    ASTCacheCalculator(const AST::Package& p, const std::pair<bool, bool>& srcInfo,
+        const SourceManager* sourceManager = nullptr, const CachedFileHashes* prevHashes = nullptr);
     ~ASTCacheCalculator();
 
     void Walk() const;
@@ -32,6 +39,7 @@ public:
     std::vector<const AST::Decl*> order; // the order of global decls by which decls are written to the cache.
         // order of members need not record as they are recorded in the MemberCache struct
     FileMap fileMap;
+    FileContentHashMap fileContentHashes;
 
 private:
     OwnedPtr<class ASTCacheCalculatorImpl> impl;
@@ -138,6 +138,16 @@ using FileMap = std::unordered_map<std::string, std::vector<const AST::Decl*>>;
 using CachedFileMap = std::unordered_map<std::string, std::vector<RawMangledName>>;
     // the gvid value is not needed as they are sorted
 
+/// Hash of the content of each source file, by trimmed path.
+using FileContentHashMap = std::unordered_map<std::string, uint64_t>;
+
+/// Decl hashes of the last compilation. They are loaded before the AST cache is computed, so that the decls of a
+/// file whose content has not changed take their hashes from here instead of being hashed again.
+struct CachedFileHashes {
+    FileContentHashMap fileContentHashes;
+    ASTCache curPkgASTCache;
+};
+
 /// All cache info of an instance of incremental compilation. Some are to be stored for further compilations,
 /// and some are used for further analysis of this compilation.
 struct CompilationCache {
@@ -154,6 +164,7 @@ struct CompilationCache {
     SemanticInfo semaInfo;
     ASTCache curPkgASTCache;
     CachedFileMap fileMap;
+    FileContentHashMap fileContentHashes;
     ASTCache importedASTCache;
     std::vector<std::string> bitcodeFilesName;
 };
@@ -8,6 +8,7 @@
 #define CANGJIE_INCRE_SCOPE_ANALYSIS_H
 
 #include <list>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -46,5 +47,8 @@ struct IncrementalScopeAnalysisArgs {
 
 // Entry function of incremental scope analysis
 IncreResult IncrementalScopeAnalysis(IncrementalScopeAnalysisArgs&& args);
+
+// Load the decl hashes of the last compilation of the package, nullopt if there is no usable cache
+std::optional<CachedFileHashes> LoadCachedFileHashes(const GlobalOptions& op, const std::string& fullPackageName);
 } // namespace Cangjie
 #endif // CANGJIE_INCRE_SCOPE_ANALYSIS_H
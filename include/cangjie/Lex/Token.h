@@ -14,13 +14,16 @@
 #define CANGJIE_LEX_TOKEN_H
 
 #include <cstring>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
 
 #include "cangjie/Basic/Position.h"
+#include "cangjie/Basic/StringPool.h"
 #include "cangjie/Utils/CheckUtils.h"
 
 namespace Cangjie {
@@ -112,11 +115,6 @@ struct Token {
         SetValuePos(std::move(value), be, en);
     }
 
-    Token(const Token& other) = default;
-    Token(Token&& other) = default;
-    Token& operator=(const Token& other) = default;
-    Token& operator=(Token&& other) = default;
-
     bool operator<(const Token& ct) const
     {
         return Begin() < ct.Begin();
@@ -128,18 +126,15 @@ struct Token {
 
     bool IsBlockComment()
     {
-        return kind == TokenKind::COMMENT && v.rfind("/*", 0) != std::string::npos;
+        return kind == TokenKind::COMMENT && v.Val().rfind("/*", 0) != std::string::npos;
     }
 
-    const std::string& Value() const { return v; }
+    const std::string& Value() const { return v.Val(); }
 
     /// Sets the string value of the token.
     /// WARNING: Typically the begin and end position need to be set with the string value simultaneously. Only call
     /// this when you shall set the position somewhere later or the position does not matter.
-    void SetValue(std::string s)
-    {
-        v = std::move(s);
-    }
+    void SetValue(std::string s);
     void SetValuePos(std::string s, const Position& be, const Position& en)
     {
         SetValue(std::move(s));
@@ -156,11 +151,13 @@ struct Token {
 
     void SetCurFile(bool isCurFile) { begin.isCurFile = end.isCurFile = isCurFile; }
 
-    bool operator==(std::string_view other) const { return v == other; }
+    bool operator==(std::string_view other) const { return v.Val() == other; }
     bool operator!=(std::string_view other) const { return !(*this == other); }
 
 private:
-    std::string v;
+    /// The value is interned in StringPool, except for comments and string literals, which are long and rarely
+    /// repeated. Those are not pooled but still shared by the copies of the token.
+    SharedString v;
     Position begin{INVALID_POSITION};
     Position end{INVALID_POSITION};
 };
@@ -15,6 +15,7 @@
 
 #include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <atomic>
@@ -26,6 +27,8 @@
 #include <dlfcn.h>
 #endif
 
+#include "cangjie/Macro/MacroShmTransport.h"
+
 namespace Cangjie {
 namespace InvokeRuntime {
 // Declare 32-byte alignment to ensure c++ generate same function definition as cangjie IR in both x86 and arm64.
@@ -191,6 +194,8 @@ public:
     int pipefdP2C[2]{-1, -1}; // 0 for srv read from cli, 1 for cli write msg to srv
     int pipefdC2P[2]{-1, -1}; // 0 for cli read from srv, 1 for srv write msg to cli
 #endif
+    // Used instead of the pipes when it could be set up, see MacroShmTransport.
+    std::unique_ptr<MacroShmTransport> shm;
     // client
     void CloseMacroSrv();
     bool SendMsgToSrv(const std::vector<uint8_t>& msg);
@@ -205,6 +210,7 @@ public:
 #else
     void SetSrvPipeHandle(int hRead, int hWrite);
 #endif
+    bool SetSrvShm(int fd);
 private:
     MacroProcMsger(){};
     bool WriteToSrvPipe(const uint8_t* buf, size_t size) const;
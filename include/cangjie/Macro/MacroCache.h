@@ -0,0 +1,77 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the on-disk cache of macro expansion results.
+ */
+
+#ifndef CANGJIE_MACRO_MACROCACHE_H
+#define CANGJIE_MACRO_MACROCACHE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cangjie/Macro/MacroCall.h"
+
+namespace Cangjie {
+/**
+ * Content-addressed cache of macro call results, kept across builds in the incremental compilation cache directory.
+ * An entry is keyed by the content hashes of the macro library and of every other library loaded for evaluation, the
+ * macro method, and the serialized attribute and input tokens including their positions, so a hit returns exactly
+ * the tokens the macro returned last time. Entries neither read nor written by a build are removed by Prune.
+ *
+ * Only calls that do not talk to the compiler are cached: calls nested in or containing other macro calls may use
+ * the macro context, and calls which reported diagnostics would lose them on a hit. It is only used from the thread
+ * which drives macro evaluation.
+ */
+class MacroCache {
+public:
+    /**
+     * @param cacheDir The directory of the entries, owned by a single package.
+     * @param loadedLibs The libraries loaded for evaluation besides the macro libraries themselves, e.g. the ones of
+     * --macro-lib, whose code may be called by the macros.
+     */
+    MacroCache(std::string cacheDir, const std::unordered_set<std::string>& loadedLibs)
+        : cacheDir(std::move(cacheDir)), loadedLibs(loadedLibs.begin(), loadedLibs.end())
+    {
+    }
+
+    /** Whether the result of @p macCall may be read from or written to the cache. */
+    static bool IsCacheable(const MacroCall& macCall);
+    /** The tokens expanded from @p macCall by a previous build, if any. */
+    std::optional<std::vector<Token>> Lookup(const MacroCall& macCall);
+    /** Save the new tokens of the successfully evaluated @p macCall. */
+    void Store(const MacroCall& macCall);
+    /** Remove the entries which were neither hit nor stored since this cache was created. */
+    void Prune() const;
+
+    size_t GetHitCount() const
+    {
+        return hitCount;
+    }
+
+private:
+    std::optional<std::vector<uint8_t>> GetKey(const MacroCall& macCall);
+    std::string GetEntryPath(const std::vector<uint8_t>& key) const;
+    std::optional<uint64_t> GetLibHash(const std::string& libPath);
+    std::optional<uint64_t> GetLoadedLibsHash();
+
+    std::string cacheDir;
+    std::vector<std::string> loadedLibs;
+    std::unordered_map<std::string, std::optional<uint64_t>> libHashes;
+    std::optional<std::optional<uint64_t>> loadedLibsHash; // Computed on first use.
+    std::unordered_set<std::string> usedEntries;            // File names of the entries hit or stored.
+    size_t hitCount{0};
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_MACRO_MACROCACHE_H
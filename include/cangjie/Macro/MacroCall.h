@@ -224,6 +224,9 @@ public:
     std::vector<ItemInfo> items;                // MacroContext: setItem.
     std::vector<ChildMessage> childMessages;    // MacroContext: getChildMessages.
     std::vector<std::string> assertParents;     // MacroContext: assertParentContext failed parentName.
+    // Set when the macro reports diagnostics or uses the macro context, its result then depends on more than its
+    // tokens and is not cached.
+    mutable bool usedCompilerCallback{false};
 private:
     MacroKind kind;
     Ptr<AST::MacroInvocation> invocation{nullptr};
@@ -39,6 +39,7 @@
 #include <dlfcn.h>
 #endif
 #include "cangjie/Frontend/CompilerInstance.h"
+#include "cangjie/Macro/MacroCache.h"
 #include "cangjie/Macro/MacroCommon.h"
 #include "cangjie/Macro/MacroEvalMsgSerializer.h"
 namespace Cangjie {
@@ -53,6 +54,7 @@ public:
         if (useChildProcess) {
             CreateMacroSrvProcess();
         }
+        InitMacroCache();
     }
     ~MacroEvaluation()
     {
@@ -99,6 +101,8 @@ private:
     bool enableParallelMacro{false};
     std::unordered_map<std::string, bool> usedMacroPkgs;    // for compiled macro
     bool useChildProcess{false};
+    std::unique_ptr<MacroCache> macroCache;                 // Only for incremental compilation.
+    std::unordered_set<const MacroCall*> cachedCalls;       // Macrocalls expanded from macroCache.
 
     // Begin: for process isolation in lsp.
     static MacroEvalMsgSerializer msgSlzer;
@@ -143,6 +147,10 @@ private:
      */
     std::unordered_set<std::string> GetMacroDefDynamicFiles();
 
+    void InitMacroCache();
+    bool LoadFromMacroCache(MacroCall& macCall);
+    void SaveToMacroCache(const MacroCall& macCall);
+
     /**
      * Save used macros for unused import.
      */
@@ -0,0 +1,85 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the shared-memory transport between the compiler and the macro server.
+ */
+
+#ifndef CANGJIE_MACRO_MACROSHMTRANSPORT_H
+#define CANGJIE_MACRO_MACROSHMTRANSPORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Cangjie {
+/**
+ * Two single-producer single-consumer byte rings in a shared memory region, one for each direction. A side waiting
+ * for data or free space sleeps on a futex in the region, and the other side only wakes it up when it is actually
+ * waiting, so a message costs no system call while both sides are busy.
+ *
+ * The region is a memfd, which the compiler creates before forking the macro server and passes to it by fd number.
+ * The fd is close-on-exec, so only the macro server inherits it. It is only available on Linux, other platforms keep
+ * using the pipes.
+ */
+class MacroShmTransport {
+public:
+    enum class Direction : uint8_t { CLIENT_TO_SRV, SRV_TO_CLIENT };
+
+    /// Create a new region, return nullptr if shared memory is not available.
+    static std::unique_ptr<MacroShmTransport> Create();
+    /// Map the region created by the client, @p fd is closed.
+    static std::unique_ptr<MacroShmTransport> Open(int fd);
+
+    ~MacroShmTransport();
+
+    /// The fd of the region, to be inherited by the macro server. -1 once closed.
+    int GetFd() const
+    {
+        return fd;
+    }
+    void CloseFd();
+    /// Let the fd be inherited by the next exec, only called in the macro server child. Return false on failure.
+    bool InheritFdOnExec() const;
+
+    /**
+     * Set the flag telling whether the other side is alive. The client uses it to stop waiting for a server that
+     * has exited, it is checked each time a wait times out.
+     */
+    void SetPeerAlive(const std::atomic_bool* alive)
+    {
+        peerAlive = alive;
+    }
+
+    /// Write @p size bytes, blocking while the ring is full. Return false if the peer has gone.
+    bool Write(Direction dir, const uint8_t* buf, size_t size);
+    /// Read @p size bytes, blocking while the ring is empty. Return false if the peer has gone.
+    bool Read(Direction dir, uint8_t* buf, size_t size);
+    /// Whether there are bytes to read without blocking.
+    bool HasData(Direction dir) const;
+
+private:
+    struct Ring;
+    struct Region;
+
+    MacroShmTransport(int fd, Region* region) : fd(fd), region(region)
+    {
+    }
+    static size_t GetMappingSize();
+    Ring& GetRing(Direction dir) const;
+    bool Wait(std::atomic<uint32_t>& seq, uint32_t expected, std::atomic<uint32_t>& waiters) const;
+    static void Wake(std::atomic<uint32_t>& seq, const std::atomic<uint32_t>& waiters);
+
+    int fd{-1};
+    Region* region{nullptr};
+    const std::atomic_bool* peerAlive{nullptr};
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_MACRO_MACROSHMTRANSPORT_H
@@ -24,7 +24,9 @@
 #include "cangjie/AST/Node.h"
 #include "cangjie/Basic/DiagnosticEngine.h"
 #include "cangjie/Modules/ASTSerializationTypeDef.h"
+#include "cangjie/Modules/CjoFileCache.h"
 #include "cangjie/Sema/TypeManager.h"
+#include "cangjie/Utils/FileUtil.h"
 
 namespace Cangjie {
 constexpr FormattedIndex INVALID_FORMAT_INDEX = 0;
@@ -70,6 +72,8 @@ class ASTLoader {
 public:
     ASTLoader(std::vector<uint8_t>&& data, const std::string& fullPackageName, TypeManager& typeManager,
         const CjoManager& cjoManager, const GlobalOptions& opts);
+    ASTLoader(std::shared_ptr<const CjoFile> file, const std::string& fullPackageName, TypeManager& typeManager,
+        const CjoManager& cjoManager, const GlobalOptions& opts);
     // Not use default destructor because 'ASTLoaderImpl' is defined as forward decl in header.
     ~ASTLoader();
 
@@ -79,6 +83,21 @@ public:
         const AST::Package& sourcePackage, const std::map<std::string, Ptr<AST::Decl>>& mangledName2DeclMap);
     std::string LoadPackageDepInfo() const;
     void LoadRefs() const;
+    /**
+     * Defer the toplevel decls which can be found by name in the following 'LoadPackageDecls', they are indexed by
+     * identifier and export id, and materialized on first lookup or reference.
+     */
+    void SetLazyLoading(bool enable) const;
+    bool HasDeferredDecls() const;
+    /** Materialize the deferred toplevel decls named @p name, return whether any decl is loaded. */
+    bool LoadDeferredDecls(const std::string& name) const;
+    void LoadAllDeferredDecls() const;
+    /** Materialize the deferred toplevel decl which owns the decl of @p exportId. */
+    bool LoadDeferredDeclByExportId(const std::string& exportId) const;
+    /** Load references of the nodes materialized after 'LoadRefs', return whether any reference is loaded. */
+    bool LoadUnresolvedRefs() const;
+    /** Take the exported toplevel decls materialized after 'LoadPackageDecls'. */
+    std::vector<Ptr<AST::Decl>> TakeLazyLoadedDecls() const;
     std::string GetImportedPackageName() const;
     void SetImportSourceCode(bool enable) const;
     const std::vector<std::string> GetDependentPackageNames() const;
@@ -0,0 +1,106 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the process-wide cache of imported .cjo files.
+ */
+
+#ifndef CANGJIE_MODULES_CJOFILECACHE_H
+#define CANGJIE_MODULES_CJOFILECACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cangjie/Utils/FileUtil.h"
+
+namespace Cangjie {
+/**
+ * A mapped .cjo file together with the result of its flatbuffer verification, which is computed at most once.
+ */
+class CjoFile {
+public:
+    explicit CjoFile(std::unique_ptr<FileUtil::MappedFile>&& file) : file(std::move(file))
+    {
+    }
+
+    const uint8_t* Data() const
+    {
+        return file->Data();
+    }
+    size_t Size() const
+    {
+        return file->Size();
+    }
+    /// Verify the content is a well-formed serialized package. It is thread-safe.
+    bool IsVerified() const;
+
+private:
+    std::unique_ptr<FileUtil::MappedFile> file;
+    mutable std::once_flag verifyFlag;
+    mutable bool verified{false};
+};
+
+/**
+ * Process-wide cache of the .cjo files opened by the compiler, keyed by path. An entry is reused as long as the
+ * file on disk is unchanged, i.e. it has the same inode, size and modification time. Since .cjo files are always
+ * replaced by a rename (see `FileUtil::WriteBufferToASTFile`), a changed file never modifies a mapping in use.
+ *
+ * In a single compilation this avoids mapping and verifying a package more than once. The compiler daemon
+ * (see `CompilerDaemon`) preloads the files every compilation used, so the compilations it forks find the
+ * imported packages and the std library mapped and verified already.
+ */
+class CjoFileCache {
+public:
+    static CjoFileCache& Instance();
+
+    /**
+     * @brief Get the file at @p path, mapping it if it is not cached or was changed since it was cached.
+     *
+     * @param failedReason Why the file cannot be read, same reasons as `FileUtil::MappedFile::Open`.
+     * @return The file, or nullptr on failure.
+     */
+    std::shared_ptr<const CjoFile> Open(const std::string& path, std::string& failedReason);
+
+    /// Map and verify @p path ahead of time. Return false if it cannot be read or is not a valid .cjo file.
+    bool Preload(const std::string& path);
+
+    /// Paths of all files opened by this process so far, in the order they were first opened.
+    std::vector<std::string> GetOpenedPaths() const;
+
+private:
+    struct FileStamp {
+        uint64_t device{0};
+        uint64_t inode{0};
+        uint64_t size{0};
+        int64_t modifiedTime{0};
+        bool operator==(const FileStamp& other) const
+        {
+            return device == other.device && inode == other.inode && size == other.size &&
+                modifiedTime == other.modifiedTime;
+        }
+    };
+    struct Entry {
+        std::optional<FileStamp> stamp;
+        std::shared_ptr<const CjoFile> file;
+    };
+
+    CjoFileCache() = default;
+    static std::optional<FileStamp> GetStamp(const std::string& path);
+
+    mutable std::mutex mtx;
+    std::unordered_map<std::string, Entry> entries;
+    std::vector<std::string> openedPaths;
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_MODULES_CJOFILECACHE_H
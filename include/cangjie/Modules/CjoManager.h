@@ -44,10 +44,15 @@ public:
     bool NeedCollectDependency(std::string curName, bool isCurMacro, std::string depName) const;
     /**
      * Loads the declaration of each package in packages on demand.
-     * If @p fromLsp is false, only the dependent packages of each package in @p packages are loaded.
+     * If @p fromLsp is false, only the dependent packages of each package in @p packages are loaded, and the
+     * toplevel decls of the non-std packages which are not imported by wildcard are materialized on first lookup.
      * Otherwise, the packages in @p packages are also loaded.
      */
     void LoadPackageDeclsOnDemand(const std::vector<Ptr<AST::Package>>& packages, bool fromLsp = false) const;
+    /** Materialize the deferred decls of imported packages which are named in @p packages. */
+    void LoadDeclsUsedBy(const std::vector<Ptr<AST::Package>>& packages) const;
+    /** Materialize the deferred decl of @p exportId in package @p fullPackageName, return whether it is loaded. */
+    bool LoadDeferredDeclByExportId(const std::string& fullPackageName, const std::string& exportId) const;
     /**
      * Collect visible package of current 'fullPackageName'
      * @param importedPackage the package which imports 'fullPackageName'. Empty for source package.
@@ -68,10 +73,15 @@ public:
     Ptr<ASTLoader> GetCommonPartCjo(std::string expectedName) const;
     Ptr<AST::Package> GetPackage(const std::string& fullPackageName) const;
     std::vector<Ptr<AST::PackageDecl>> GetAllPackageDecls(bool includeMacroPkg = false) const;
+    /** Whether an imported package defines the instantiation @p mangledName of the generic decl @p genericId. */
+    bool IsSharedByImportedPackage(const std::string& genericId, const std::string& mangledName) const;
 
     void RemovePackage(const std::string& fullPkgName, const Ptr<AST::Package> package) const;
 
+    /** Decls which have been materialized, use 'GetPackageMembersByName' to look up a deferred decl. */
     const std::map<std::string, AST::OrderedDeclSet>& GetPackageMembers(const std::string& fullPackageName) const;
+    /** Load all deferred decls of @p fullPackageName, for the users which need all members of a package. */
+    void LoadAllPackageMembers(const std::string& fullPackageName) const;
     const AST::OrderedDeclSet& GetPackageMembersByName(
         const std::string& fullPackageName, const std::string& name) const;
     Ptr<AST::Decl> GetImplicitPackageMembersByName(const std::string& fullPackageName, const std::string& name) const;
@@ -104,6 +114,7 @@ public:
     void SetPackageCjoCache(const std::string& fullPackageName, const std::vector<uint8_t>& cjoData) const;
 
     void ClearCjoCache() const;
+    /** Delete the loaders which are not needed anymore, the loaders of packages with deferred decls are kept. */
     void DeleteASTLoaders() const noexcept;
 
     void ClearVisitedPkgs() const;
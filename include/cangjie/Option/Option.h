@@ -595,6 +595,8 @@ public:
 
     bool enableMemoryCollect = false; /**< Whether enable memory usage report. */
 
+    bool enableTrace = false; /**< Whether enable Chrome trace report. */
+
     std::optional<unsigned int> errorCountLimit = 8; /**< limits the amount of errors compiler prints */
 
 #ifdef CANGJIE_CHIR_WFC_OFF
@@ -782,6 +784,8 @@ public:
     bool disableDeserializer = false;
 
     bool chirDebugOptimizer = false;
+    std::string chirInlineProfile;  // --chir-inline-profile
+    std::string chirInlineRemarks;  // --chir-inline-remarks
 
     enum class CHIRMode : uint8_t { NA, STANDARD, WITH_ID, ALL };
 
@@ -834,6 +838,7 @@ public:
     std::optional<std::size_t> jobs; /* parallel compile jobs. */
     std::optional<std::size_t> aggressiveParallelCompile = std::nullopt;
     bool aggressiveParallelCompileWithoutArg = false;
+    bool inProcessBackend = false; /**< Run 'opt' and 'llc' stages inside cjc, set by '--in-process-backend'. */
     std::vector<std::string> bitcodeFilesName; /** < the name of packageMoudle.bc. */
     std::vector<std::string> symbolsNeedLocalized; /** < Symbols that need to be localized in the compiled binary. */
 
@@ -1129,6 +1134,17 @@ public:
         return emitCHIRPhase != CandidateEmitCHIRPhase::NA;
     }
 
+    /**
+     * @brief Checks whether the backend stages run inside cjc on the generated modules.
+     * LTO, incremental compilation and '--save-temps' need the bitcode files, so they keep the external tools.
+     *
+     * @return True if the in-process backend is enabled, false otherwise.
+     */
+    bool IsInProcessBackendEnabled() const
+    {
+        return inProcessBackend && !IsLTOEnabled() && !enIncrementalCompilation && !saveTemps;
+    }
+
     bool IsCompilingCJMP() const
     {
         return inputChirFiles.size() > 0;
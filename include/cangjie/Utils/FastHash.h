@@ -0,0 +1,146 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares a fast non-cryptographic hash used for fingerprints.
+ */
+
+#ifndef CANGJIE_UTILS_FASTHASH_H
+#define CANGJIE_UTILS_FASTHASH_H
+
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Cangjie::Utils {
+/**
+ * Multiply-mix hash in the style of wyhash. The state is two 64 bit lanes which take 16 bytes of each 32 byte block
+ * independently, so the compiler can interleave or vectorise them, and a 64 bit value costs a single 128 bit
+ * multiplication. The 128 bit state is folded into 64 bits at the end.
+ *
+ * The values only depend on the input: bytes are read as little endian, values by their numeric value, and the
+ * 128 bit multiplication has a portable fallback, so they are the same on every host, byte order and compiler. They
+ * are persisted, e.g. as the file content hashes of the incremental compilation cache, changing them invalidates
+ * such caches.
+ */
+class FastHash {
+public:
+    template <size_t N> static uint64_t GetHashValue(const std::bitset<N>& rawData)
+    {
+        return GetHashValue(static_cast<uint64_t>(rawData.to_ullong()));
+    }
+    template <typename T> static uint64_t GetHashValue(T data)
+    {
+        static_assert(std::is_arithmetic_v<T> && sizeof(T) <= sizeof(uint64_t));
+        uint64_t value{0};
+        if constexpr (std::is_floating_point_v<T>) {
+            // The bits of the value, through an unsigned integer of the same size.
+            std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t> bits{0};
+            static_assert(sizeof(bits) == sizeof(T));
+            (void)memcpy(&bits, &data, sizeof(T));
+            value = bits;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            value = data ? 1 : 0;
+        } else {
+            value = static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(data));
+        }
+        return Mix(value ^ SECRET0, SECRET1 ^ sizeof(T));
+    }
+    static uint64_t GetHashValue(std::string_view data)
+    {
+        return Hash(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+    static uint64_t GetHashValue(const std::string& data)
+    {
+        return GetHashValue(std::string_view{data});
+    }
+    static uint64_t GetHashValue(const char* data)
+    {
+        return GetHashValue(std::string_view{data});
+    }
+
+    static uint64_t Hash(const uint8_t* data, size_t size)
+    {
+        uint64_t lane0 = SECRET0 ^ size;
+        uint64_t lane1 = SECRET1;
+        constexpr size_t blockSize = 32;
+        constexpr size_t halfSize = 16;
+        size_t left = size;
+        for (; left >= blockSize; left -= blockSize, data += blockSize) {
+            lane0 = Mix(Read64(data) ^ SECRET2, Read64(data + 8) ^ lane0);                  // second word at 8
+            lane1 = Mix(Read64(data + halfSize) ^ SECRET3, Read64(data + halfSize + 8) ^ lane1); // second word at 24
+        }
+        if (left >= halfSize) {
+            lane0 = Mix(Read64(data) ^ SECRET2, Read64(data + 8) ^ lane0); // second word at 8
+            left -= halfSize;
+            data += halfSize;
+        }
+        uint64_t a{0};
+        uint64_t b{0};
+        if (left > sizeof(uint64_t)) {
+            a = Read64(data);
+            b = ReadPartial(data + sizeof(uint64_t), left - sizeof(uint64_t));
+        } else {
+            a = ReadPartial(data, left);
+        }
+        lane1 = Mix(a ^ SECRET2 ^ lane1, b ^ SECRET3 ^ left);
+        return Mix(lane0 ^ SECRET1, lane1 ^ SECRET0);
+    }
+
+private:
+    static constexpr uint64_t SECRET0 = 0xa0761d6478bd642full;
+    static constexpr uint64_t SECRET1 = 0xe7037ed1a0b428dbull;
+    static constexpr uint64_t SECRET2 = 0x8ebc6af09c88c6e3ull;
+    static constexpr uint64_t SECRET3 = 0x589965cc75374cc3ull;
+
+    /** Multiply to 128 bits and fold the two halves. */
+    static uint64_t Mix(uint64_t a, uint64_t b)
+    {
+#ifdef __SIZEOF_INT128__
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64); // 64 is the width of the low half
+#else
+        constexpr uint64_t lowMask = 0xffffffffull;
+        constexpr unsigned halfBits = 32;
+        uint64_t aHi = a >> halfBits;
+        uint64_t aLo = a & lowMask;
+        uint64_t bHi = b >> halfBits;
+        uint64_t bLo = b & lowMask;
+        uint64_t lo = aLo * bLo;
+        uint64_t mid1 = aHi * bLo;
+        uint64_t mid2 = aLo * bHi;
+        uint64_t hi = aHi * bHi;
+        uint64_t cross = (lo >> halfBits) + (mid1 & lowMask) + (mid2 & lowMask);
+        uint64_t low = (cross << halfBits) | (lo & lowMask);
+        uint64_t high = hi + (mid1 >> halfBits) + (mid2 >> halfBits) + (cross >> halfBits);
+        return low ^ high;
+#endif
+    }
+
+    /** Read @p size bytes as a little endian value, the compiler turns it into a single load on such hosts. */
+    static uint64_t ReadPartial(const uint8_t* p, size_t size)
+    {
+        constexpr unsigned byteBits = 8;
+        uint64_t v{0};
+        for (size_t i = 0; i < size; ++i) {
+            v |= static_cast<uint64_t>(p[i]) << (byteBits * i);
+        }
+        return v;
+    }
+
+    static uint64_t Read64(const uint8_t* p)
+    {
+        return ReadPartial(p, sizeof(uint64_t));
+    }
+};
+} // namespace Cangjie::Utils
+
+#endif // CANGJIE_UTILS_FASTHASH_H
@@ -14,6 +14,7 @@
 #define CANGJIE_UTILS_FILEUTIL_H
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -209,6 +210,39 @@ std::string Normalize(const std::string& input, const bool toUnix = false);
  */
 bool ReadBinaryFileToBuffer(const std::string& filePath, std::vector<uint8_t>& buffer, std::string& failedReason);
 
+/**
+ * Read-only content of a whole binary file. The file is mapped into memory on platforms supporting it, and read
+ * into an owned buffer otherwise. The content stays valid as long as the object lives.
+ */
+class MappedFile {
+public:
+    /**
+     * Map the file at @p filePath.
+     * @param[out] failedReason Why mapping the file failed, same reasons as `ReadBinaryFileToBuffer`.
+     * @return the mapped file, or nullptr on failure.
+     */
+    static std::unique_ptr<MappedFile> Open(const std::string& filePath, std::string& failedReason);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* Data() const
+    {
+        return data;
+    }
+    size_t Size() const
+    {
+        return size;
+    }
+
+private:
+    MappedFile() = default;
+    const uint8_t* data{nullptr};
+    size_t size{0};
+    bool isMapped{false};
+    std::vector<uint8_t> buffer; // Used when the file cannot be mapped.
+};
+
 /**
  * Get the size of the File.
  * @param Path to the file.
@@ -13,8 +13,10 @@
 #ifndef CANGJIE_UTILS_PROFILE_RECORDER_H
 #define CANGJIE_UTILS_PROFILE_RECORDER_H
 
+#include <atomic>
 #include <string>
 #include <functional>
+#include <vector>
 
 namespace Cangjie::Utils {
 
@@ -45,14 +47,54 @@ public:
      */
     static void RecordCodeInfo(const std::string& item, const std::function<int64_t(void)>& getData);
     static void RecordCodeInfo(const std::string& item, int64_t value);
+    /**
+     * @brief Record the imbalance of @p values, such as the times of tasks run in parallel: the ratio of the largest
+     * value to the average one, in percent, 100 means a perfect balance. Nothing is recorded unless enabled.
+     */
+    static void RecordImbalance(const std::string& item, const std::vector<int64_t>& values);
+    /** @brief Whether the timer or the memory recorder is enabled, i.e. whether code info is recorded. */
+    static bool IsEnabled();
 
     static std::string GetResult(const Type& type = Type::ALL);
 
+    /**
+     * @brief Enable the trace mode, which records nested spans per thread and writes them as a Chrome trace
+     * (`<package>.trace.json`). Start and Stop also record spans while it is enabled.
+     */
+    static void EnableTrace(bool en);
+    static bool IsTraceEnabled()
+    {
+        return traceEnabled.load(std::memory_order_relaxed);
+    }
+    /** @brief Get the recorded trace as Chrome trace JSON, empty if the trace mode is disabled. */
+    static std::string GetTraceResult();
+
 private:
+    static inline std::atomic<bool> traceEnabled{false};
     std::string title_;
     std::string subtitle_;
     std::string desc_;
 };
+
+/**
+ * Records a trace span for its lifetime when the trace mode is enabled, e.g. for a single decl or function. When the
+ * trace mode is disabled it costs a relaxed load, so the name should be built inside the span only if it is cheap, or
+ * be guarded by ProfileRecorder::IsTraceEnabled().
+ */
+class TraceScope {
+public:
+    /**
+     * @param category A string literal grouping the spans, such as "Sema" or "CodeGen".
+     * @param name The name of the span.
+     */
+    TraceScope(const char* category, const std::string& name);
+    ~TraceScope();
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    bool active;
+};
 } // namespace Cangjie::Utils
 
 #endif // CANGJIE_UTILS_PROFILE_RECORDER_H
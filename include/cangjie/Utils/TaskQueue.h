@@ -13,12 +13,17 @@
 #ifndef CANGJIE_UTILS_TASKQUEUE_H
 #define CANGJIE_UTILS_TASKQUEUE_H
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
+#include <optional>
+#include <vector>
 #include "cangjie/Utils/CheckUtils.h"
+#include "cangjie/Utils/ThreadPool.h"
 
 namespace Cangjie::Utils {
 
@@ -47,9 +52,16 @@ private:
 
 /**
  * A heuristic parallel task queue. Each task needs to be created with a
- * specified weight. Each available thread selects the task at the head
- * of the queue from the task queue to execute. This means tasks with
- * higher weights can always be executed with higher priority.
+ * specified weight. Tasks with higher weights are executed with higher
+ * priority.
+ *
+ * The queue does not own any thread. When it starts, the tasks are sorted by
+ * priority and dealt into `threadsNum` slots, and one runner per slot is
+ * submitted to the process-wide `ThreadPool`. A runner executes the tasks of
+ * its own slot and steals from the other slots once its slot is drained, so
+ * at most `threadsNum` tasks of the queue run at the same time. A task may
+ * create and wait for a nested TaskQueue, the waiting thread helps to execute
+ * the pending runners of the queue it waits for instead of blocking.
  *
  * Note that **adding tasks** and **executing tasks** are phased and it
  * is not allowed to add tasks again after TaskQueue starts to execute.
@@ -70,7 +82,8 @@ public:
 
     ~TaskQueue()
     {
-        threads.clear();
+        // Runners may still reference the tasks, which capture data owned by the creator of the queue.
+        WaitForAllTasksCompleted();
     }
 
     /**
@@ -85,38 +98,38 @@ public:
         CJC_ASSERT(!isStarted && "Do not add new tasks while executing.");
         auto task = std::make_shared<std::packaged_task<TRes()>>(fn);
         TaskResult<TRes> res = task->get_future();
-        tasks.emplace([task]() mutable { (*task)(); }, priority);
+        tasks.emplace_back([task]() mutable { (*task)(); }, priority);
         return res;
     }
 
     /**
-     * Create threads and start executing tasks in the queue asynchronously
-     * in the background.
+     * Start executing tasks in the queue asynchronously in the background.
      */
     void RunInBackground()
     {
         if (tasks.empty()) {
             return;
         }
-        CreateThreads();
+        Dispatch();
     }
 
     /**
-     * Waiting for all threads to complete the tasks.
+     * Waiting for all tasks to be completed, the current thread executes
+     * pending tasks of this queue meanwhile.
      */
     void WaitForAllTasksCompleted()
     {
-        for (auto& thread : threads) {
-            if (thread.joinable()) {
-                thread.join();
-            }
+        if (!state) {
+            return;
         }
-        threads.clear();
+        auto waited = state;
+        ThreadPool::Get().HelpUntil([waited]() { return waited->remaining.load() == 0; }, waited.get());
+        state.reset();
     }
 
     /**
-     * Create threads to start asynchronously executing tasks in the queue and
-     * waiting for all threads to complete the tasks.
+     * Start executing tasks in the queue and waiting for all tasks to be
+     * completed.
      * Note: it will block the main thread.
      */
     void RunAndWaitForAllTasksCompleted()
@@ -124,40 +137,70 @@ public:
         if (tasks.empty()) {
             return;
         }
-        CreateThreads();
+        Dispatch();
         WaitForAllTasksCompleted();
     }
 
 private:
-    void CreateThreads()
+    struct Slot {
+        std::mutex mtx;
+        std::deque<Task> tasks; /**< Sorted by priority in descending order. **/
+    };
+
+    struct State {
+        std::vector<std::unique_ptr<Slot>> slots;
+        std::atomic<size_t> remaining{0};
+    };
+
+    void Dispatch()
     {
         isStarted = true;
-        auto fixedThreadsNum = std::min(tasks.size(), threadsNum);
-        for (size_t threadIdx = 0; threadIdx < fixedThreadsNum; ++threadIdx) {
-            (void)threads.emplace_back([this] { DoTask(); });
+        // Stable sort keeps the adding order of tasks with the same priority.
+        std::stable_sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return b < a; });
+        auto slotsNum = std::min(tasks.size(), threadsNum);
+        state = std::make_shared<State>();
+        state->remaining = tasks.size();
+        for (size_t i = 0; i < slotsNum; ++i) {
+            (void)state->slots.emplace_back(std::make_unique<Slot>());
+        }
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            state->slots[i % slotsNum]->tasks.emplace_back(std::move(tasks[i]));
+        }
+        tasks.clear();
+        for (size_t i = 0; i < slotsNum; ++i) {
+            ThreadPool::Get().Submit([runState = state, i]() { RunSlot(*runState, i); }, state.get());
+        }
+    }
+
+    static std::optional<Task> PopTask(State& runState, size_t self)
+    {
+        auto slotsNum = runState.slots.size();
+        for (size_t i = 0; i < slotsNum; ++i) {
+            auto& slot = *runState.slots[(self + i) % slotsNum];
+            std::lock_guard<std::mutex> lock(slot.mtx);
+            if (!slot.tasks.empty()) {
+                std::optional<Task> task(std::move(slot.tasks.front()));
+                slot.tasks.pop_front();
+                return task;
+            }
         }
+        return std::nullopt;
     }
 
-    void DoTask()
+    static void RunSlot(State& runState, size_t self)
     {
-        // Once the thread is idle, it selects the task at the head of the queue to execute.
-        while (true) {
-            std::unique_lock<std::mutex> lock(mutex);
-            // No remaining tasks. Thread exits polling.
-            if (tasks.empty()) {
-                return;
+        // Once the runner is idle, it selects the task at the head of its own slot, then of the other slots.
+        while (auto task = PopTask(runState, self)) {
+            (*task)();
+            if (--runState.remaining == 0) {
+                ThreadPool::Get().NotifyAll();
             }
-            Task task = tasks.top();
-            tasks.pop();
-            lock.unlock();
-            task();
         }
     }
 
-    std::priority_queue<Task> tasks;
-    std::mutex mutex;
+    std::vector<Task> tasks;
     size_t threadsNum;
-    std::vector<std::thread> threads;
+    std::shared_ptr<State> state;
     bool isStarted = false;
 };
 } // namespace Cangjie::Utils
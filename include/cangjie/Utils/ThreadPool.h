@@ -0,0 +1,106 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares the process-wide work-stealing thread pool.
+ */
+
+#ifndef CANGJIE_UTILS_THREADPOOL_H
+#define CANGJIE_UTILS_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Cangjie::Utils {
+
+/**
+ * A process-wide pool of worker threads. Every worker owns a deque of jobs:
+ * the owner pushes and pops at the back, idle workers steal from the front of
+ * other deques. Jobs submitted from a worker go to its own deque, so nested
+ * work stays on the same thread unless somebody else is idle.
+ *
+ * Jobs may be tagged with a group. A thread that needs the result of the jobs
+ * of a group should call `HelpUntil` instead of blocking, it executes pending
+ * jobs of that group, and only of that group, until the condition holds. This
+ * keeps nested waits from exhausting the workers, and a waiter never gets
+ * stuck in an unrelated job.
+ *
+ * The pool is re-created in the child of a fork, whose copy of the pool has
+ * no workers.
+ */
+class ThreadPool {
+public:
+    using Job = std::function<void()>;
+
+    static ThreadPool& Get();
+
+    size_t GetWorkersNum() const
+    {
+        return workers.size();
+    }
+
+    /**
+     * Push a job of @p group into the deque of the current worker, or into the
+     * deques in round-robin order when called from a thread outside the pool.
+     */
+    void Submit(Job job, const void* group = nullptr);
+
+    /**
+     * Execute pending jobs of @p group on the current thread until @p done
+     * returns true. @p done is re-evaluated after every job and on every
+     * `NotifyAll`.
+     */
+    void HelpUntil(const std::function<bool()>& done, const void* group);
+
+    /**
+     * Wake all threads sleeping in `HelpUntil`, used to signal that the
+     * condition of some of them may have changed.
+     */
+    void NotifyAll();
+
+private:
+    struct GroupJob {
+        Job job;
+        const void* group;
+    };
+    struct WorkerDeque {
+        std::mutex mtx;
+        std::deque<GroupJob> jobs;
+    };
+
+    explicit ThreadPool(size_t workersNum);
+    ~ThreadPool() = default;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    void WorkerLoop(size_t index);
+    /** Pop a job from deque @p self, or steal one from other deques. */
+    bool TryRunOne(size_t self);
+    /** Run the oldest pending job of @p group. */
+    bool TryRunOneOf(const void* group);
+    bool PopBack(size_t index, Job& job);
+    bool StealFront(size_t index, Job& job);
+
+    std::vector<std::unique_ptr<WorkerDeque>> deques;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pendingJobs{0};
+    std::atomic<size_t> nextDeque{0};
+    std::mutex sleepMtx;
+    std::condition_variable sleepCv; // Idle workers wait for jobs.
+    std::condition_variable doneCv;  // Threads in `HelpUntil` wait for their condition.
+};
+} // namespace Cangjie::Utils
+#endif
@@ -246,36 +246,51 @@ void InvertedIndex::Reset()
     scopeGateMap.clear();
     scopeLevelIndexes.clear();
     astKindIndexes.clear();
-    nameTrie->Reset();
-    scopeNameTrie->Reset(TOPLEVEL_SCOPE_NAME);
-    astKindTrie->Reset();
+    nameIndex.Reset();
+    scopeNameIndex.Reset(TOPLEVEL_SCOPE_NAME);
+    astKindIndex.Reset();
     for (auto& kindString : AST::ASTKIND_TO_STRING_MAP) {
-        astKindTrie->Insert(kindString.second);
+        astKindIndex.Insert(kindString.second);
     }
-    posBeginTrie->Reset();
-    posEndTrie->Reset();
+    astKindIndex.Build();
+    posBeginIndex.Reset();
+    posEndIndex.Reset();
+    indexedSymbols.clear();
 }
 
-void InvertedIndex::Index(AST::Symbol* symbol, bool withTrie)
+void InvertedIndex::Index(AST::Symbol* symbol, bool withSearchIndex)
 {
     if (symbol == nullptr) {
         return;
     }
     std::string scopeName = ScopeManagerApi::GetScopeNameWithoutTail(symbol->scopeName);
-    nameIndexes[symbol->name].insert(symbol->id);
+    symbol->indexID = static_cast<uint32_t>(indexedSymbols.size());
+    indexedSymbols.push_back(symbol->id);
+    auto& symbolsOfName = nameIndexes[symbol->name];
+    if (withSearchIndex && symbolsOfName.empty()) {
+        nameIndex.Insert(symbol->name);
+    }
+    symbolsOfName.insert(symbol->id);
     scopeNameIndexes[scopeName].insert(symbol->id);
     if (symbol->scopeName.find(ScopeManagerApi::childScopeNameSplit) != std::string::npos) {
         scopeGateMap[symbol->scopeName] = symbol;
     }
     scopeLevelIndexes[symbol->scopeLevel].insert(symbol->id);
     astKindIndexes[AST::ASTKIND_TO_STRING_MAP[symbol->astKind]].insert(symbol->id);
-    if (withTrie) {
-        nameTrie->Insert(symbol->name, *symbol->id);
-        posBeginTrie->Insert(PosSearchApi::PosToStr(symbol->node->begin), *symbol->id);
-        posEndTrie->Insert(PosSearchApi::PosToStr(symbol->node->end), *symbol->id);
+    if (withSearchIndex) {
+        posBeginIndex.Insert(symbol->node->begin, symbol->indexID);
+        posEndIndex.Insert(symbol->node->end, symbol->indexID);
     }
 }
 
+void InvertedIndex::Build()
+{
+    nameIndex.Build();
+    scopeNameIndex.Build();
+    posBeginIndex.Build();
+    posEndIndex.Build();
+}
+
 void InvertedIndex::Delete(AST::Symbol* symbol)
 {
     if (symbol == nullptr) {
@@ -292,12 +307,22 @@ void InvertedIndex::Delete(AST::Symbol* symbol)
     }
     scopeLevelIndexes[symbol->scopeLevel].erase(symbol);
     astKindIndexes[AST::ASTKIND_TO_STRING_MAP[symbol->astKind]].erase(symbol);
-    nameTrie->Delete(symbol->name, *symbol);
-    posBeginTrie->Delete(PosSearchApi::PosToStr(symbol->node->begin), *symbol);
-    posEndTrie->Delete(PosSearchApi::PosToStr(symbol->node->end), *symbol);
+    // Names and positions stay in the search indexes, they are filtered out by the flag.
     symbol->invertedIndexBeenDeleted = true;
 }
 
+std::set<AST::Symbol*> InvertedIndex::GetSymbols(const std::vector<uint32_t>& ids) const
+{
+    std::set<AST::Symbol*> symbols;
+    for (auto id : ids) {
+        auto symbol = indexedSymbols[id];
+        if (!symbol->invertedIndexBeenDeleted) {
+            symbols.insert(symbol);
+        }
+    }
+    return symbols;
+}
+
 std::set<Ptr<Decl>> ASTContext::Mem2Decls(const AST::MemSig& memSig)
 {
     auto decls = mem2Decls[memSig];
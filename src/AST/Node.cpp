@@ -34,6 +34,8 @@
 namespace Cangjie {
 using namespace AST;
 
+std::atomic_uint64_t AST::NodeID::nextID{0};
+
 namespace {
 const std::string EMPTY_PACKAGE_NAME = "";
 
@@ -12,7 +12,10 @@
 
 #include "cangjie/AST/Searcher.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -32,241 +35,224 @@ using namespace Utils;
 using namespace FileUtil;
 
 namespace {
-std::string NormalizeQuery(const Query& query, const Order& order)
+std::string NormalizeQuery(const Query& query)
 {
     std::string normalizedQuery;
     query.PrettyPrint(normalizedQuery);
-    std::for_each(query.fileHashes.cbegin(), query.fileHashes.cend(), [&normalizedQuery](auto fileHash) {
-        normalizedQuery.append("|fileHash:").append(FileUtil::GetShortHash(fileHash));
+    return normalizedQuery;
+}
+
+std::string GetCacheKey(
+    const std::string& normalizedQuery, const std::unordered_set<uint64_t>& fileHashes, const Order& order)
+{
+    std::string key = normalizedQuery;
+    std::for_each(fileHashes.cbegin(), fileHashes.cend(), [&key](auto fileHash) {
+        key.append("|fileHash:").append(FileUtil::GetShortHash(fileHash));
     });
     if (&order == &Sort::posAsc) {
-        normalizedQuery.append("|sort:asc");
+        key.append("|sort:asc");
     } else if (&order == &Sort::posDesc) {
-        normalizedQuery.append("|sort:desc");
+        key.append("|sort:desc");
     }
-    return normalizedQuery;
+    return key;
 }
-} // namespace
 
-void Trie::Insert(const std::string& value)
+void InsertSymbols(SymbolBitmap& ids, const std::set<Symbol*>& symbols)
 {
-    TrieNode* n = root.get();
-    for (unsigned i = 0; i < value.size(); ++i) {
-        if (n->next.find(value[i]) == n->next.end()) {
-            n->next.emplace(value[i], std::make_unique<TrieNode>(value[i]));
-        }
-        n = n->next[value[i]].get();
-        n->prefix = value.substr(0, i + 1);
-        n->suffixes.insert(value.substr(i + 1));
+    for (auto symbol : symbols) {
+        ids.Insert(symbol->indexID);
     }
-    n->value = value;
 }
 
-void Trie::Insert(const std::string& value, Symbol& id)
+template <typename Indexes, typename Key>
+void InsertSymbols(SymbolBitmap& ids, const Indexes& indexes, const Key& key)
 {
-    TrieNode* n = root.get();
-    for (unsigned i = 0; i < value.size(); ++i) {
-        if (n->next.find(value[i]) == n->next.end()) {
-            n->next.emplace(value[i], std::make_unique<TrieNode>(value[i]));
-        }
-        auto next = n->next[value[i]].get();
-        next->depth = n->depth + 1;
-        next->parent = n;
-        next->ids.insert(&id);
-        n = next;
-        n->prefix = value.substr(0, i + 1);
-        n->suffixes.insert(value.substr(i + 1));
+    if (auto found = indexes.find(key); found != indexes.cend()) {
+        InsertSymbols(ids, found->second);
     }
-    n->value = value;
 }
 
-void Trie::Delete(const std::string& value, Symbol& id)
+SymbolBitmap ToBitmap(const InvertedIndex& index, const std::vector<uint32_t>& indexIDs)
 {
-    TrieNode* n = root.get();
-    for (char i : value) {
-        if (n->next.empty()) {
-            return;
+    SymbolBitmap ids;
+    for (auto id : indexIDs) {
+        if (!index.indexedSymbols[id]->invertedIndexBeenDeleted) {
+            ids.Insert(id);
         }
-        auto next = n->next[i].get();
-        next->ids.erase(&id);
-        n = next;
     }
+    return ids;
 }
 
-TrieNode* Trie::GetPrefixRootNode(const std::string& prefix) const
+bool StartsWith(const std::string& value, const std::string& prefix)
 {
-    TrieNode* n = root.get();
-    for (auto c : prefix) {
-        TrieNode::Next::const_iterator found = n->next.find(c);
-        if (found == n->next.end()) {
-            return nullptr;
-        }
-        n = found->second.get();
-    }
-    return n;
+    return value.compare(0, prefix.size(), prefix) == 0;
 }
 
-std::vector<std::string> Trie::PrefixMatch(const std::string& prefix) const
+bool EndsWith(const std::string& value, const std::string& suffix)
 {
-    std::vector<std::string> matches;
-    auto prefixRoot = GetPrefixRootNode(prefix);
-    std::function<void(TrieNode*)> walk = [&matches, &walk](TrieNode* n) {
-        if (!n) {
-            return;
-        }
-        if (!n->value.empty()) {
-            matches.push_back(n->value);
-        }
-        for (auto& i : std::as_const(n->next)) {
-            walk(i.second.get());
-        }
-    };
-    walk(prefixRoot);
-    return matches;
+    return value.size() >= suffix.size() &&
+        value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
 }
 
-std::vector<std::string> Trie::SuffixMatch(const std::string& suffix) const
+// Order of the strings read from the end, the strings with a common suffix are adjacent in it.
+bool ReversedLess(const std::string& lhs, const std::string& rhs)
 {
-    std::vector<std::string> matches;
-    std::function<void(TrieNode*)> walk = [&suffix, &matches, &walk](TrieNode* n) {
-        if (!n) {
-            return;
-        }
-        if (n->suffixes.find(suffix) != n->suffixes.cend()) {
-            matches.push_back(n->prefix + suffix);
-        }
-        for (auto& i : std::as_const(n->next)) {
-            walk(i.second.get());
-        }
-    };
-    walk(root.get());
-    return matches;
+    return std::lexicographical_compare(lhs.crbegin(), lhs.crend(), rhs.crbegin(), rhs.crend());
 }
 
-uint32_t PosSearchApi::MAX_DIGITS_FILE = 4;   /**< Max num of files to compile once is 9999. */
-uint32_t PosSearchApi::MAX_DIGITS_LINE = 5;   /**< Max num of lines of a file is 99999. */
-uint32_t PosSearchApi::MAX_DIGITS_COLUMN = 5; /**< Max column width is 99999. */
+void SortAndUnique(std::vector<std::string>& values)
+{
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+} // namespace
 
-void PosSearchApi::UpdatePosLimit(unsigned int fileId, int line, int column)
+void StringIndex::Build()
 {
-    uint32_t digitsFile = static_cast<uint32_t>(FillZero(static_cast<int>(fileId), 0).size());
-    uint32_t digitsLine = static_cast<uint32_t>(FillZero(line, 0).size());
-    uint32_t digitsColumn = static_cast<uint32_t>(FillZero(column, 0).size());
-    if (digitsFile > MAX_DIGITS_FILE) {
-        MAX_DIGITS_FILE = digitsFile;
-    }
-    if (digitsLine > MAX_DIGITS_LINE) {
-        MAX_DIGITS_LINE = digitsLine;
-    }
-    if (digitsColumn > MAX_DIGITS_COLUMN) {
-        MAX_DIGITS_COLUMN = digitsColumn;
+    if (sortedNum == values.size()) {
+        return;
     }
+    auto tail = values.begin() + static_cast<std::ptrdiff_t>(sortedNum);
+    std::sort(tail, values.end());
+    std::inplace_merge(values.begin(), tail, values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    sortedNum = values.size();
+    suffixOrder.resize(sortedNum);
+    std::iota(suffixOrder.begin(), suffixOrder.end(), 0);
+    std::sort(suffixOrder.begin(), suffixOrder.end(),
+        [this](uint32_t lhs, uint32_t rhs) { return ReversedLess(values[lhs], values[rhs]); });
 }
 
-std::string PosSearchApi::PosToStr(const Position& pos)
+std::vector<std::string> StringIndex::PrefixMatch(const std::string& prefix) const
 {
-    std::string ret = FillZero(static_cast<int>(pos.fileID), static_cast<int>(MAX_DIGITS_FILE));
-    ret += FillZero(pos.line, static_cast<int>(MAX_DIGITS_LINE));
-    ret += FillZero(pos.column, static_cast<int>(MAX_DIGITS_COLUMN));
-    return ret;
+    std::vector<std::string> matches;
+    auto sortedEnd = values.cbegin() + static_cast<std::ptrdiff_t>(sortedNum);
+    for (auto it = std::lower_bound(values.cbegin(), sortedEnd, prefix); it != sortedEnd && StartsWith(*it, prefix);
+        ++it) {
+        matches.push_back(*it);
+    }
+    if (sortedEnd == values.cend()) {
+        return matches;
+    }
+    std::copy_if(sortedEnd, values.cend(), std::back_inserter(matches),
+        [&prefix](const std::string& value) { return StartsWith(value, prefix); });
+    SortAndUnique(matches);
+    return matches;
 }
 
-TrieNode* PosSearchApi::FindCommonRootInPosTrie(const Trie& posTrie, const Position& pos)
+std::vector<std::string> StringIndex::SuffixMatch(const std::string& suffix) const
 {
-    std::string posStr = PosToStr(pos);
-    TrieNode* n = posTrie.root.get();
-    for (auto c : posStr) {
-        TrieNode::Next::const_iterator found = n->next.find(c);
-        if (found == n->next.cend()) {
-            return n;
+    std::vector<std::string> matches;
+    auto isMatched = [&suffix](const std::string& value) {
+        return value.size() > suffix.size() && EndsWith(value, suffix);
+    };
+    auto it = std::lower_bound(suffixOrder.cbegin(), suffixOrder.cend(), suffix,
+        [this](uint32_t idx, const std::string& target) { return ReversedLess(values[idx], target); });
+    for (; it != suffixOrder.cend() && EndsWith(values[*it], suffix); ++it) {
+        if (isMatched(values[*it])) {
+            matches.push_back(values[*it]);
         }
-        n = found->second.get();
     }
-    return n;
+    std::copy_if(values.cbegin() + static_cast<std::ptrdiff_t>(sortedNum), values.cend(),
+        std::back_inserter(matches), isMatched);
+    SortAndUnique(matches);
+    return matches;
 }
 
-TrieNode* PosSearchApi::FindCommonRootInPosTrie(const Trie& posTrie, const std::string& pos)
+void PosIndex::Build()
 {
-    TrieNode* n = posTrie.root.get();
-    for (auto c : pos) {
-        TrieNode::Next::const_iterator found = n->next.find(c);
-        if (found == n->next.cend()) {
-            return n;
-        }
-        n = found->second.get();
+    for (auto& it : files) {
+        auto& file = it.second;
+        auto tail = file.entries.begin() + static_cast<std::ptrdiff_t>(file.sortedNum);
+        std::sort(tail, file.entries.end());
+        std::inplace_merge(file.entries.begin(), tail, file.entries.end());
+        file.sortedNum = file.entries.size();
     }
-    return n;
 }
 
-std::set<Symbol*> PosSearchApi::GetIDsGreaterThanPos(const Trie& posTrie, const Position& pos, bool isClose)
+std::vector<uint32_t> PosIndex::GetIDs(
+    const Position* lower, bool isLowerClose, const Position* upper, bool isUpperClose) const
 {
-    std::string posStr = PosToStr(pos);
-    TrieNode* n = FindCommonRootInPosTrie(posTrie, posStr);
-    TrieNode::Next::const_iterator startIter;
-    std::set<Symbol*> ids;
-    while (n->depth > MAX_DIGITS_FILE) {
-        if (n->depth == GetMaxDigitsPostion()) {
-            n = n->parent;
-            continue;
-        }
-        if (isClose) {
-            startIter = n->next.lower_bound(posStr[n->depth]);
-            isClose = false;
-        } else {
-            startIter = n->next.upper_bound(posStr[n->depth]);
-        }
-        for (auto it = startIter; it != n->next.end(); ++it) {
-            ids = Searcher::Union(ids, it->second->ids);
+    std::vector<uint32_t> ids;
+    auto found = files.find(lower ? lower->fileID : upper->fileID);
+    if (found == files.cend()) {
+        return ids;
+    }
+    auto& entries = found->second.entries;
+    auto sortedEnd = entries.cbegin() + static_cast<std::ptrdiff_t>(found->second.sortedNum);
+    // An entry equal to a close bound is in the range.
+    auto isAbove = [](const Entry& entry, const Position& pos, bool isClose) {
+        return isClose ? !IsBefore(entry, pos) : IsAfter(entry, pos);
+    };
+    auto isBelow = [](const Entry& entry, const Position& pos, bool isClose) {
+        return isClose ? !IsAfter(entry, pos) : IsBefore(entry, pos);
+    };
+    auto begin = entries.cbegin();
+    if (lower) {
+        begin = std::partition_point(
+            begin, sortedEnd, [&](const Entry& entry) { return !isAbove(entry, *lower, isLowerClose); });
+    }
+    auto end = sortedEnd;
+    if (upper) {
+        end = std::partition_point(
+            begin, sortedEnd, [&](const Entry& entry) { return isBelow(entry, *upper, isUpperClose); });
+    }
+    for (auto it = begin; it < end; ++it) {
+        ids.push_back(it->symbolID);
+    }
+    for (auto it = sortedEnd; it != entries.cend(); ++it) {
+        if ((!lower || isAbove(*it, *lower, isLowerClose)) && (!upper || isBelow(*it, *upper, isUpperClose))) {
+            ids.push_back(it->symbolID);
         }
-        n = n->parent;
     }
     return ids;
 }
 
-void PosSearchApi::GetIDsLessThanPosOfDepth(
-    TrieNode& n, const std::string& posStr, std::set<Symbol*>& ids, bool& isClose)
+std::vector<uint32_t> PosIndex::GetIDsLessThanPos(const Position& pos, bool isClose) const
 {
-    auto endIter = n.next.lower_bound(posStr[n.depth]);
-    if (endIter != n.next.cend()) {
-        if (isClose) {
-            if (endIter->first == posStr[n.depth]) {
-                ++endIter;
-            }
-            isClose = false;
-        }
-    }
-    for (auto it = n.next.cbegin(); it != endIter; ++it) {
-        ids = Searcher::Union(ids, it->second->ids);
-    }
+    return GetIDs(nullptr, false, &pos, isClose);
 }
 
-std::set<Symbol*> PosSearchApi::GetIDsLessThanPos(const Trie& posTrie, const Position& pos, bool isClose)
+std::vector<uint32_t> PosIndex::GetIDsGreaterThanPos(const Position& pos, bool isClose) const
 {
-    std::string posStr = PosToStr(pos);
-    TrieNode* n = FindCommonRootInPosTrie(posTrie, posStr);
-    std::set<Symbol*> ids;
-    while (n->depth > MAX_DIGITS_FILE) {
-        if (n->depth == GetMaxDigitsPostion()) {
-            CJC_ASSERT(n->next.empty());
-            n = n->parent;
-            continue;
-        }
-        GetIDsLessThanPosOfDepth(*n, posStr, ids, isClose);
-        n = n->parent;
+    return GetIDs(&pos, isClose, nullptr, false);
+}
+
+std::vector<uint32_t> PosIndex::GetIDsWithinRange(
+    const Position& startPos, const Position& endPos, bool isLeftClose, bool isRightClose) const
+{
+    if (endPos <= startPos || startPos.fileID != endPos.fileID) {
+        return {};
     }
-    return ids;
+    return GetIDs(&startPos, isLeftClose, &endPos, isRightClose);
 }
 
-std::set<Symbol*> PosSearchApi::GetIDsWithinPosXByRange(
-    const Trie& posTrie, const Position& startPos, const Position& endPos, bool isLeftClose, bool isRightClose)
+uint32_t PosSearchApi::MAX_DIGITS_FILE = 4;   /**< Max num of files to compile once is 9999. */
+uint32_t PosSearchApi::MAX_DIGITS_LINE = 5;   /**< Max num of lines of a file is 99999. */
+uint32_t PosSearchApi::MAX_DIGITS_COLUMN = 5; /**< Max column width is 99999. */
+
+void PosSearchApi::UpdatePosLimit(unsigned int fileId, int line, int column)
 {
-    std::set<Symbol*> ids;
-    if (endPos <= startPos) {
-        return ids;
+    uint32_t digitsFile = static_cast<uint32_t>(FillZero(static_cast<int>(fileId), 0).size());
+    uint32_t digitsLine = static_cast<uint32_t>(FillZero(line, 0).size());
+    uint32_t digitsColumn = static_cast<uint32_t>(FillZero(column, 0).size());
+    if (digitsFile > MAX_DIGITS_FILE) {
+        MAX_DIGITS_FILE = digitsFile;
+    }
+    if (digitsLine > MAX_DIGITS_LINE) {
+        MAX_DIGITS_LINE = digitsLine;
+    }
+    if (digitsColumn > MAX_DIGITS_COLUMN) {
+        MAX_DIGITS_COLUMN = digitsColumn;
     }
-    ids = GetIDsGreaterThanPos(posTrie, startPos, isLeftClose);
-    ids = Searcher::Intersection(ids, GetIDsLessThanPos(posTrie, endPos, isRightClose));
-    return ids;
+}
+
+std::string PosSearchApi::PosToStr(const Position& pos)
+{
+    std::string ret = FillZero(static_cast<int>(pos.fileID), static_cast<int>(MAX_DIGITS_FILE));
+    ret += FillZero(pos.line, static_cast<int>(MAX_DIGITS_LINE));
+    ret += FillZero(pos.column, static_cast<int>(MAX_DIGITS_COLUMN));
+    return ret;
 }
 
 // Used for sort function, caller guarantees symbol inputs are not nullptr.
@@ -293,10 +279,10 @@ Order Sort::posDesc = [](const Symbol* a, const Symbol* b) noexcept {
 };
 
 std::pair<std::vector<Symbol*>, bool> Searcher::FindInSearchCache(
-    const Query& query, const std::string& normalizedQuery)
+    const std::unordered_set<uint64_t>& fileHashes, const std::string& normalizedQuery)
 {
     std::vector<Symbol*> results;
-    bool needFilter = !query.fileHashes.empty();
+    bool needFilter = !fileHashes.empty();
     auto it = cache.find(normalizedQuery);
     if (it == cache.end()) {
         // Cached filtered results.
@@ -306,97 +292,79 @@ std::pair<std::vector<Symbol*>, bool> Searcher::FindInSearchCache(
         return {it->second, true};
     }
     for (auto sym : it->second) {
-        if (InFiles(query.fileHashes, *sym->id)) {
+        if (InFiles(fileHashes, *sym->id)) {
             results.push_back(sym);
         }
     }
     return {results, true};
 }
 
-std::vector<Symbol*> Searcher::FilterAndSortSearchResult(
-    const std::set<Symbol*>& ids, const Query& query, const Order& order) const
+std::vector<Symbol*> Searcher::FilterAndSortSearchResult(const ASTContext& ctx, const SymbolBitmap& ids,
+    const std::unordered_set<uint64_t>& fileHashes, const Order& order) const
 {
     std::vector<Symbol*> results;
-    bool needFilter = !query.fileHashes.empty();
-    for (Symbol* id : ids) {
-        if (needFilter && !InFiles(query.fileHashes, *id)) {
-            continue;
+    bool needFilter = !fileHashes.empty();
+    ids.ForEach([this, &ctx, &fileHashes, &results, needFilter](uint32_t id) {
+        Symbol* symbol = ctx.invertedIndex.indexedSymbols[id];
+        // The node of a symbol may have been released without the symbol being deleted from the indexes.
+        if (symbol->invertedIndexBeenDeleted || (needFilter && !InFiles(fileHashes, *symbol))) {
+            return;
         }
-        results.push_back(id);
-    }
+        results.push_back(symbol);
+    });
     sort(results.begin(), results.end(), order);
     return results;
 }
 
-std::vector<Symbol*> Searcher::Search(const ASTContext& ctx, const Query* query, const Order& order)
+std::vector<Symbol*> Searcher::Search(const ASTContext& ctx, const CompiledQuery& query,
+    const std::unordered_set<uint64_t>& fileHashes, const Order& order)
 {
-    if (!query) {
-        return {};
-    }
-    auto normalizedQuery = NormalizeQuery(*query, order);
-    auto ret = FindInSearchCache(*query, normalizedQuery);
+    auto key = GetCacheKey(query.normalizedQuery, fileHashes, order);
+    auto ret = FindInSearchCache(fileHashes, key);
     if (ret.second) {
         return ret.first;
     }
-    std::set<Symbol*> ids = PerformSearch(ctx, *query);
-    auto results = FilterAndSortSearchResult(ids, *query, order);
-    cache.insert_or_assign(normalizedQuery, results);
+    auto results = FilterAndSortSearchResult(ctx, Evaluate(ctx, *query.plan), fileHashes, order);
+    cache.insert_or_assign(key, results);
     return results;
 }
 
-std::vector<Symbol*> Searcher::Search(
-    const ASTContext& ctx, const std::string& query, const Order& order, const std::unordered_set<uint64_t>& fileHashes)
+std::vector<Symbol*> Searcher::Search(const ASTContext& ctx, const Query* query, const Order& order)
 {
-    QueryParser qp(query, ctx.diag, ctx.diag.GetSourceManager());
-    std::unique_ptr<Query> q = qp.Parse();
-    if (!q) {
+    if (!query) {
         return {};
     }
-    if (!fileHashes.empty()) {
-        q->fileHashes = fileHashes;
-    }
-    auto symbols = Search(ctx, q.get(), order);
-    return symbols;
-}
-
-std::set<Symbol*> Searcher::GetIDsByName(const ASTContext& ctx, const std::string& name) const
-{
-    std::set<Symbol*> ids;
-    auto it = ctx.invertedIndex.nameIndexes.find(name);
-    if (it != ctx.invertedIndex.nameIndexes.end()) {
-        ids.insert(it->second.begin(), it->second.end());
-    }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByNamePrefix(const ASTContext& ctx, const std::string& prefix) const
-{
-    std::set<Symbol*> ids;
-    std::vector<std::string> names = ctx.invertedIndex.nameTrie->PrefixMatch(prefix);
-    for (std::string& name : names) {
-        ids = Union(ids, GetIDsByName(ctx, name));
-    }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByNameSuffix(const ASTContext& ctx, const std::string& suffix) const
-{
-    std::set<Symbol*> ids;
-    std::vector<std::string> names = ctx.invertedIndex.nameTrie->SuffixMatch(suffix);
-    for (std::string& name : names) {
-        ids = Union(ids, GetIDsByName(ctx, name));
+    auto key = GetCacheKey(NormalizeQuery(*query), query->fileHashes, order);
+    auto ret = FindInSearchCache(query->fileHashes, key);
+    if (ret.second) {
+        return ret.first;
     }
-    return ids;
+    bool isValid = true;
+    auto plan = Compile(ctx, *query, isValid);
+    auto results = FilterAndSortSearchResult(ctx, Evaluate(ctx, *plan), query->fileHashes, order);
+    cache.insert_or_assign(key, results);
+    return results;
 }
 
-std::set<Symbol*> Searcher::GetIDsByScopeName(const ASTContext& ctx, const std::string& scopeName) const
+std::vector<Symbol*> Searcher::Search(
+    const ASTContext& ctx, const std::string& query, const Order& order, const std::unordered_set<uint64_t>& fileHashes)
 {
-    std::set<Symbol*> ids;
-    auto it = ctx.invertedIndex.scopeNameIndexes.find(scopeName);
-    if (it != ctx.invertedIndex.scopeNameIndexes.end()) {
-        ids.insert(it->second.begin(), it->second.end());
+    // Queries are written in the code of tools, the same strings are searched again and again.
+    auto found = plans.find(query);
+    if (found == plans.end()) {
+        QueryParser qp(query, ctx.diag, ctx.diag.GetSourceManager());
+        std::unique_ptr<Query> q = qp.Parse();
+        if (!q) {
+            return {};
+        }
+        bool isValid = true;
+        CompiledQuery compiled{Compile(ctx, *q, isValid), NormalizeQuery(*q)};
+        if (!isValid) {
+            return Search(ctx, compiled, fileHashes, order);
+        }
+        found = plans.emplace(query, std::move(compiled)).first;
     }
-    return ids;
+    return Search(ctx, found->second, fileHashes, order);
 }
 
 void Searcher::InvalidateCacheBut(const std::string& query)
@@ -412,233 +380,204 @@ void Searcher::InvalidateCacheBut(const std::string& query)
 
 std::vector<std::string> Searcher::GetScopeNamesByPrefix(const ASTContext& ctx, const std::string& prefix) const
 {
-    return ctx.invertedIndex.scopeNameTrie->PrefixMatch(prefix);
-}
-
-std::set<Symbol*> Searcher::GetIDsByScopeLevel(const ASTContext& ctx, uint32_t scopeLevel) const
-{
-    std::set<Symbol*> ids;
-    auto it = ctx.invertedIndex.scopeLevelIndexes.find(scopeLevel);
-    if (it != ctx.invertedIndex.scopeLevelIndexes.end()) {
-        ids.insert(it->second.begin(), it->second.end());
-    }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByASTKind(const ASTContext& ctx, const std::string& astKind) const
-{
-    std::set<Symbol*> ids;
-    auto it = ctx.invertedIndex.astKindIndexes.find(astKind);
-    if (it != ctx.invertedIndex.astKindIndexes.end()) {
-        ids.insert(it->second.begin(), it->second.end());
-    }
-    return ids;
-}
-
-std::vector<std::string> Searcher::GetAstKindsBySuffix(const ASTContext& ctx, const std::string& suffix) const
-{
-    return ctx.invertedIndex.astKindTrie->SuffixMatch(suffix);
+    return ctx.invertedIndex.scopeNameIndex.PrefixMatch(prefix);
 }
 
-std::set<Symbol*> Searcher::GetIDsByPosEQ(
+SymbolBitmap Searcher::GetIDsByPosEQ(
     const ASTContext& ctx, const Position& pos, bool isLeftClose, bool isRightClose) const
 {
     // Equivalent to finding symbol n whose position meets n->node->begin <= pos && pos < n->node->end.
-    std::set<Symbol*> ids;
-    if (ctx.invertedIndex.posBeginTrie != nullptr) {
-        ids = PosSearchApi::GetIDsLessThanPos(*ctx.invertedIndex.posBeginTrie, pos, isLeftClose);
-    }
-    std::set<Symbol*> ids1;
-    if (ctx.invertedIndex.posEndTrie != nullptr) {
-        ids1 = PosSearchApi::GetIDsGreaterThanPos(*ctx.invertedIndex.posEndTrie, pos, isRightClose);
-    }
-    if (!ids1.empty()) {
-        return Intersection(ids, ids1);
+    auto& index = ctx.invertedIndex;
+    SymbolBitmap ids = ToBitmap(index, index.posBeginIndex.GetIDsLessThanPos(pos, isLeftClose));
+    SymbolBitmap ids1 = ToBitmap(index, index.posEndIndex.GetIDsGreaterThanPos(pos, isRightClose));
+    if (!ids1.Empty()) {
+        ids &= ids1;
+        return ids;
     }
     // We use scope_level to filter the node contain the pos.
-    if (ids.empty()) {
-        return {};
-    }
-    std::set<Symbol*> result;
-    int scopeLevel = static_cast<int>((*ids.cbegin())->scopeLevel);
-    for (auto id : ids) {
+    SymbolBitmap result;
+    bool isFirst = true;
+    int scopeLevel = 0;
+    ids.ForEach([&index, &result, &isFirst, &scopeLevel](uint32_t id) {
+        if (isFirst) {
+            scopeLevel = static_cast<int>(index.indexedSymbols[id]->scopeLevel);
+            isFirst = false;
+        }
         if (scopeLevel >= 0) {
-            result.insert(id);
+            result.Insert(id);
             scopeLevel--;
-        } else {
-            break;
         }
-    }
+    });
     return result;
 }
 
-std::set<Symbol*> Searcher::GetIDsByPosLT(const ASTContext& ctx, const Position& pos, bool contain) const
+SymbolBitmap Searcher::GetIDsByPosLT(const ASTContext& ctx, const Position& pos, bool contain) const
 {
     // Equivalent to finding symbol n whose position meets n->node->begin <= pos && pos < n->node->end.
-    std::set<Symbol*> ids;
-    if (ctx.invertedIndex.posEndTrie != nullptr) {
-        ids = PosSearchApi::GetIDsLessThanPos(*ctx.invertedIndex.posEndTrie, pos, false);
-    }
+    auto& index = ctx.invertedIndex;
+    SymbolBitmap ids = ToBitmap(index, index.posEndIndex.GetIDsLessThanPos(pos, false));
     if (contain) {
-        ids = Union(ids, GetIDsByPosEQ(ctx, pos));
+        ids |= GetIDsByPosEQ(ctx, pos);
     }
     return ids;
 }
 
-std::set<Symbol*> Searcher::GetIDsByPosGT(const ASTContext& ctx, const Position& pos, bool contain) const
+SymbolBitmap Searcher::GetIDsByPosGT(const ASTContext& ctx, const Position& pos, bool contain) const
 {
     // Equivalent to finding symbol n whose position meets n->node->begin > pos && pos <= n->node->end.
-    std::set<Symbol*> ids;
-    if (ctx.invertedIndex.posBeginTrie != nullptr) {
-        ids = PosSearchApi::GetIDsGreaterThanPos(*ctx.invertedIndex.posBeginTrie, pos, false);
-    }
+    auto& index = ctx.invertedIndex;
+    SymbolBitmap ids = ToBitmap(index, index.posBeginIndex.GetIDsGreaterThanPos(pos, false));
     if (contain) {
-        ids = Union(ids, GetIDsByPosEQ(ctx, pos));
+        ids |= GetIDsByPosEQ(ctx, pos);
     }
     return ids;
 }
 
-std::set<Symbol*> Searcher::PerformSearch(const ASTContext& ctx, const Query& query)
+std::unique_ptr<QueryPlan> Searcher::Compile(const ASTContext& ctx, const Query& query, bool& isValid) const
 {
-    std::set<Symbol*> ids;
+    using Kind = QueryPlan::Kind;
+    using Sign = QueryPlan::Sign;
+    static const std::unordered_map<std::string, Sign> signs = {
+        {"=", Sign::EQ}, {"<", Sign::LT}, {"<=", Sign::LE}, {">", Sign::GT}, {">=", Sign::GE}};
+    auto plan = std::make_unique<QueryPlan>();
     if (query.type == QueryType::OP) {
         if (!query.left || !query.right) {
-            return {};
+            return plan;
         }
-        if (query.op == Operator::AND) {
-            ids = PerformSearch(ctx, *query.left);
-            ids = Intersection(ids, PerformSearch(ctx, *query.right));
-        } else if (query.op == Operator::OR) {
-            ids = PerformSearch(ctx, *query.left);
-            ids = Union(ids, PerformSearch(ctx, *query.right));
-        } else if (query.op == Operator::NOT) {
-            ids = PerformSearch(ctx, *query.left);
-            ids = Difference(ids, PerformSearch(ctx, *query.right));
-        }
-    } else {
-        ids = GetIDs(ctx, query);
-    }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByPos(const ASTContext& ctx, const Query& query) const
-{
-    std::set<Symbol*> ids;
-    if (query.type != QueryType::POS) {
-        return ids;
-    }
-    if (query.sign == "=") {
-        ids = GetIDsByPosEQ(ctx, query.pos);
-    } else if (query.sign == "<") {
-        ids = GetIDsByPosLT(ctx, query.pos);
-    } else if (query.sign == "<=") {
-        ids = GetIDsByPosLT(ctx, query.pos, true);
-    } else if (query.sign == ">") {
-        ids = GetIDsByPosGT(ctx, query.pos);
-    } else if (query.sign == ">=") {
-        ids = GetIDsByPosGT(ctx, query.pos, true);
-    }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByName(const ASTContext& ctx, const Query& query) const
-{
-    std::set<Symbol*> ids;
-    if (query.key != "name") {
-        return ids;
-    }
-    if (query.matchKind == MatchKind::PRECISE) {
-        ids = GetIDsByName(ctx, query.value);
-    } else if (query.matchKind == MatchKind::PREFIX) {
-        ids = GetIDsByNamePrefix(ctx, query.value);
-    } else {
-        ids = GetIDsByNameSuffix(ctx, query.value);
+        plan->kind = query.op == Operator::AND ? Kind::AND : (query.op == Operator::OR ? Kind::OR : Kind::NOT);
+        plan->left = Compile(ctx, *query.left, isValid);
+        plan->right = Compile(ctx, *query.right, isValid);
+        return plan;
     }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByScopeLevel(const ASTContext& ctx, const Query& query) const
-{
-    std::set<Symbol*> ids;
-    constexpr int decimalBase = 10;
-    if (query.key != "scope_level") {
-        return ids;
-    }
-    if (query.sign == "=") {
-        unsigned long level = StrToUint(ctx, query.value);
-        if (level < UINT32_MAX) {
-            ids = GetIDsByScopeLevel(ctx, static_cast<uint32_t>(level));
+    auto sign = signs.find(query.sign);
+    if (query.type == QueryType::POS) {
+        if (sign != signs.cend()) {
+            plan->kind = Kind::POS;
+            plan->sign = sign->second;
+            plan->pos = query.pos;
         }
-    } else if (query.sign == "<") {
-        for (uint32_t scopelevel = 0; scopelevel < std::strtoul(query.value.c_str(), nullptr, decimalBase);
-            ++scopelevel) {
-            ids = Union(ids, GetIDsByScopeLevel(ctx, scopelevel));
+        return plan;
+    }
+    plan->value = query.value;
+    plan->matchKind = query.matchKind;
+    const std::string& key = query.key;
+    if (key == "name") {
+        plan->kind = Kind::NAME;
+    } else if (key == "scope_level") {
+        constexpr int decimalBase = 10;
+        if (query.sign == "=") {
+            plan->scopeLevel = StrToUint(ctx, query.value);
+            plan->kind = plan->scopeLevel < UINT32_MAX ? Kind::SCOPE_LEVEL : Kind::EMPTY;
+            isValid = isValid && plan->kind == Kind::SCOPE_LEVEL;
+        } else if (query.sign == "<" || query.sign == "<=") {
+            plan->scopeLevel = std::strtoul(query.value.c_str(), nullptr, decimalBase);
+            plan->kind = Kind::SCOPE_LEVEL;
         }
-    } else if (query.sign == "<=") {
-        for (uint32_t scopelevel = 0; scopelevel <= std::strtoul(query.value.c_str(), nullptr, decimalBase);
-            ++scopelevel) {
-            ids = Union(ids, GetIDsByScopeLevel(ctx, scopelevel));
+        plan->sign = sign != signs.cend() ? sign->second : Sign::EQ;
+    } else if (key == "scope_name") {
+        if (query.matchKind == MatchKind::SUFFIX) {
+            ctx.diag.DiagnoseRefactor(DiagKindRefactor::searcher_invalid_scope_name, DEFAULT_POSITION, query.value);
+            isValid = false;
+        } else {
+            plan->kind = Kind::SCOPE_NAME;
         }
-    }
-    return ids;
-}
-
-std::set<Symbol*> Searcher::GetIDsByScopeName(const ASTContext& ctx, const Query& query) const
-{
-    std::set<Symbol*> ids;
-    if (query.key != "scope_name") {
-        return ids;
-    }
-    if (query.matchKind == MatchKind::PRECISE) {
-        ids = GetIDsByScopeName(ctx, query.value);
-    } else if (query.matchKind == MatchKind::PREFIX) {
-        auto scopeNames = GetScopeNamesByPrefix(ctx, query.value);
-        for (auto& n : scopeNames) {
-            ids = Union(ids, GetIDsByScopeName(ctx, n));
+    } else if (key == "ast_kind") {
+        if (query.matchKind != MatchKind::PREFIX) {
+            plan->kind = Kind::AST_KIND;
         }
     } else {
-        ctx.diag.DiagnoseRefactor(DiagKindRefactor::searcher_invalid_scope_name, DEFAULT_POSITION, query.value);
+        Errorf("Unknow query term: %s!\n", key.c_str());
+        isValid = false;
     }
-    return ids;
+    return plan;
 }
 
-std::set<Symbol*> Searcher::GetIDsByASTKind(const ASTContext& ctx, const Query& query) const
+SymbolBitmap Searcher::Evaluate(const ASTContext& ctx, const QueryPlan& plan) const
 {
-    std::set<Symbol*> ids;
-    if (query.key != "ast_kind") {
-        return ids;
-    }
-    if (query.matchKind == MatchKind::PRECISE) {
-        ids = GetIDsByASTKind(ctx, query.value);
-    } else if (query.matchKind == MatchKind::SUFFIX) {
-        auto astKinds = GetAstKindsBySuffix(ctx, query.value);
-        for (auto& n : astKinds) {
-            ids = Union(ids, GetIDsByASTKind(ctx, n));
-        }
+    using Kind = QueryPlan::Kind;
+    auto& index = ctx.invertedIndex;
+    SymbolBitmap ids;
+    switch (plan.kind) {
+        case Kind::AND:
+            ids = Evaluate(ctx, *plan.left);
+            if (!ids.Empty()) {
+                ids &= Evaluate(ctx, *plan.right);
+            }
+            break;
+        case Kind::OR:
+            ids = Evaluate(ctx, *plan.left);
+            ids |= Evaluate(ctx, *plan.right);
+            break;
+        case Kind::NOT:
+            ids = Evaluate(ctx, *plan.left);
+            if (!ids.Empty()) {
+                ids -= Evaluate(ctx, *plan.right);
+            }
+            break;
+        case Kind::NAME:
+            if (plan.matchKind == MatchKind::PRECISE) {
+                InsertSymbols(ids, index.nameIndexes, plan.value);
+                break;
+            }
+            for (auto& name : plan.matchKind == MatchKind::PREFIX ? index.nameIndex.PrefixMatch(plan.value)
+                                                                  : index.nameIndex.SuffixMatch(plan.value)) {
+                InsertSymbols(ids, index.nameIndexes, name);
+            }
+            break;
+        case Kind::SCOPE_NAME:
+            if (plan.matchKind == MatchKind::PRECISE) {
+                InsertSymbols(ids, index.scopeNameIndexes, plan.value);
+                break;
+            }
+            for (auto& scopeName : GetScopeNamesByPrefix(ctx, plan.value)) {
+                InsertSymbols(ids, index.scopeNameIndexes, scopeName);
+            }
+            break;
+        case Kind::SCOPE_LEVEL:
+            if (plan.sign == QueryPlan::Sign::EQ) {
+                InsertSymbols(ids, index.scopeLevelIndexes, static_cast<uint32_t>(plan.scopeLevel));
+                break;
+            }
+            for (auto& [scopeLevel, symbols] : index.scopeLevelIndexes) {
+                bool isLess = scopeLevel < plan.scopeLevel;
+                if (isLess || (plan.sign == QueryPlan::Sign::LE && scopeLevel == plan.scopeLevel)) {
+                    InsertSymbols(ids, symbols);
+                }
+            }
+            break;
+        case Kind::AST_KIND:
+            if (plan.matchKind == MatchKind::PRECISE) {
+                InsertSymbols(ids, index.astKindIndexes, plan.value);
+                break;
+            }
+            for (auto& astKind : index.astKindIndex.SuffixMatch(plan.value)) {
+                InsertSymbols(ids, index.astKindIndexes, astKind);
+            }
+            break;
+        case Kind::POS:
+            ids = EvaluatePos(ctx, plan);
+            break;
+        case Kind::EMPTY:
+            break;
     }
     return ids;
 }
 
-std::set<Symbol*> Searcher::GetIDs(const ASTContext& ctx, const Query& query) const
+SymbolBitmap Searcher::EvaluatePos(const ASTContext& ctx, const QueryPlan& plan) const
 {
-    std::set<Symbol*> ids;
-    if (query.type == QueryType::POS) {
-        ids = GetIDsByPos(ctx, query);
-    } else {
-        std::string key = query.key;
-        if (key == "name") {
-            ids = GetIDsByName(ctx, query);
-        } else if (key == "scope_level") {
-            ids = GetIDsByScopeLevel(ctx, query);
-        } else if (key == "scope_name") {
-            ids = GetIDsByScopeName(ctx, query);
-        } else if (key == "ast_kind") {
-            ids = GetIDsByASTKind(ctx, query);
-        } else {
-            Errorf("Unknow query term: %s!\n", key.c_str());
-        }
+    switch (plan.sign) {
+        case QueryPlan::Sign::EQ:
+            return GetIDsByPosEQ(ctx, plan.pos);
+        case QueryPlan::Sign::LT:
+            return GetIDsByPosLT(ctx, plan.pos);
+        case QueryPlan::Sign::LE:
+            return GetIDsByPosLT(ctx, plan.pos, true);
+        case QueryPlan::Sign::GT:
+            return GetIDsByPosGT(ctx, plan.pos);
+        case QueryPlan::Sign::GE:
+            return GetIDsByPosGT(ctx, plan.pos, true);
     }
-    return ids;
+    return {};
 }
 
 unsigned long Searcher::StrToUint(const ASTContext& ctx, const std::string& queryVal) const
@@ -667,27 +606,6 @@ unsigned long Searcher::StrToUint(const ASTContext& ctx, const std::string& quer
     return uintValue;
 }
 
-std::set<Symbol*> Searcher::Intersection(const std::set<Symbol*>& set1, const std::set<Symbol*>& set2)
-{
-    std::set<Symbol*> ret;
-    std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), std::inserter(ret, ret.begin()));
-    return ret;
-}
-
-std::set<Symbol*> Searcher::Union(const std::set<Symbol*>& set1, const std::set<Symbol*>& set2)
-{
-    std::set<Symbol*> ret;
-    std::set_union(set1.begin(), set1.end(), set2.begin(), set2.end(), std::inserter(ret, ret.begin()));
-    return ret;
-}
-
-std::set<Symbol*> Searcher::Difference(const std::set<Symbol*>& set1, const std::set<Symbol*>& set2) const
-{
-    std::set<Symbol*> ret;
-    std::set_difference(set1.begin(), set1.end(), set2.begin(), set2.end(), std::inserter(ret, ret.begin()));
-    return ret;
-}
-
 bool Searcher::InFiles(const std::unordered_set<uint64_t>& files, const Symbol& id) const
 {
     return files.find(id.hashID.hash64) != files.end();
@@ -449,6 +449,24 @@ void DiagnosticEngineImpl::ClearTransaction()
     transactionMutex.unlock();
 }
 
+std::vector<Diagnostic> DiagnosticEngineImpl::TakeTransaction()
+{
+    std::lock_guard<std::mutex> guard(transactionMutex);
+    CJC_ASSERT(isInTransaction[std::this_thread::get_id()]);
+    auto cachedDiagnostic = std::move(transactionMap[std::this_thread::get_id()]);
+    transactionMap.erase(std::this_thread::get_id());
+    isInTransaction.erase(std::this_thread::get_id());
+    return cachedDiagnostic;
+}
+
+void DiagnosticEngineImpl::Commit(std::vector<Diagnostic>& diags)
+{
+    std::lock_guard<std::mutex> guard(transactionMutex);
+    for (auto& diagnostic : diags) {
+        handler->HandleDiagnose(diagnostic);
+    }
+}
+
 std::string DiagnosticEngineImpl::GetArgStr(
     char formatChar, std::vector<DiagArgument>& formatArgs, unsigned long index, Diagnostic& diagnostic)
 {
@@ -102,6 +102,14 @@ void DiagnosticEngine::ClearTransaction()
 {
     impl->ClearTransaction();
 }
+std::vector<Diagnostic> DiagnosticEngine::TakeTransaction()
+{
+    return impl->TakeTransaction();
+}
+void DiagnosticEngine::Commit(std::vector<Diagnostic>& diags)
+{
+    impl->Commit(diags);
+}
 
 void DiagnosticEngine::EnableCheckRangeErrorCodeRatherICE()
 {
@@ -89,6 +89,8 @@ public:
     void Prepare();
     void Commit();
     void ClearTransaction();
+    std::vector<Diagnostic> TakeTransaction();
+    void Commit(std::vector<Diagnostic>& diags);
 
     // use DiagEngineErrorCode rather than internal error message (for libast)
     void EnableCheckRangeErrorCodeRatherICE()
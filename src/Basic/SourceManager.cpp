@@ -11,12 +11,29 @@
  */
 
 #include "cangjie/Basic/SourceManager.h"
+
+#include <cstring>
+
 #include "cangjie/Utils/CheckUtils.h"
 #include "cangjie/Utils/FileUtil.h"
 #include "cangjie/Utils/SafePointer.h"
 
 using namespace Cangjie;
 
+size_t Source::GetLineContentEnd(size_t index) const
+{
+    CJC_ASSERT(index < lineOffsets.size());
+    if (index + 1 == lineOffsets.size()) {
+        return buffer.length();
+    }
+    // Every line but the last one ends with '\n' or "\r\n".
+    size_t next = lineOffsets[index + 1];
+    if (next >= Utils::WINDOWS_LINE_TERMINATOR_LENGTH && buffer[next - Utils::WINDOWS_LINE_TERMINATOR_LENGTH] == '\r') {
+        return next - Utils::WINDOWS_LINE_TERMINATOR_LENGTH;
+    }
+    return next - Utils::LINUX_LINE_TERMINATOR_LENGTH;
+}
+
 size_t Source::PosToOffset(const Position& pos) const
 {
     if (pos.line > static_cast<int>(lineOffsets.size())) {
@@ -26,19 +43,24 @@ size_t Source::PosToOffset(const Position& pos) const
         return 0;
     }
     size_t index = static_cast<size_t>(pos.line) - 1;
-    auto pStart = buffer.data() + lineOffsets[index];
-    auto pEnd = buffer.data() + buffer.length();
-    size_t columnOffset = 0;
-    while (Utils::GetLineTerminatorLength(pStart + columnOffset, pEnd) == 0 &&
-        columnOffset < (static_cast<size_t>(pos.column) - 1) && pStart + columnOffset < pEnd) {
-        columnOffset++;
-    }
-    if (columnOffset < (static_cast<size_t>(pos.column) - 1) && pStart + columnOffset < pEnd) {
-        // there's line terminator before `pos.column`
-        columnOffset += Utils::GetLineTerminatorLength(pStart + columnOffset, pEnd);
+    size_t lineStart = lineOffsets[index];
+    size_t contentEnd = GetLineContentEnd(index);
+    // Columns count bytes. A column past the end of the line maps to the start of the next line.
+    size_t columnOffset = static_cast<size_t>(pos.column) - 1;
+    if (columnOffset <= contentEnd - lineStart) {
+        return std::min(lineStart + columnOffset, buffer.length());
     }
+    return index + 1 < lineOffsets.size() ? lineOffsets[index + 1] : buffer.length();
+}
 
-    return std::min(lineOffsets[index] + columnOffset, buffer.length());
+Position Source::GetEndPos() const
+{
+    if (buffer.empty()) {
+        return Position{fileID, 1, 1};
+    }
+    auto line = static_cast<int>(lineOffsets.size());
+    auto column = static_cast<int>(buffer.length() - lineOffsets.back()) + 1;
+    return Position{fileID, line, column};
 }
 
 Source::Source(unsigned int fileID, std::string path, std::string buffer, uint64_t fileHash,
@@ -49,22 +71,25 @@ Source::Source(unsigned int fileID, std::string path, std::string buffer, uint64
         return;
     }
 
-    // build lineOffsets
+    // build lineOffsets. Both line terminators end with '\n', so a line starts after each of them. memchr is
+    // vectorised by the C library, which makes this scan much faster than testing every character.
     auto pStart = this->buffer.data();
     size_t length = this->buffer.length();
-    auto pEnd = this->buffer.data() + length;
-    for (auto ptr = pStart; ptr < pEnd;) {
-        while (Utils::GetLineTerminatorLength(ptr, pEnd) == 0 && ptr < pEnd) {
-            ptr++;
-        }
-        if (ptr >= pEnd) {
-            break;
-        }
-        ptr += Utils::GetLineTerminatorLength(ptr, pEnd);
-        lineOffsets.emplace_back(ptr - pStart);
+    auto pEnd = pStart + length;
+    for (auto ptr = static_cast<const char*>(memchr(pStart, '\n', length)); ptr;
+         ptr = static_cast<const char*>(memchr(ptr, '\n', static_cast<size_t>(pEnd - ptr)))) {
+        ++ptr;
+        lineOffsets.emplace_back(static_cast<size_t>(ptr - pStart));
     }
 }
 
+void SourceManager::EmplaceSource(unsigned int fileID, std::string normalizedPath, std::string buffer,
+    uint64_t fileHash, std::optional<std::string> packageName)
+{
+    sources.emplace_back(fileID, normalizedPath, std::move(buffer), fileHash, packageName);
+    filePathToFileIDMap.emplace(std::move(normalizedPath), fileID);
+}
+
 void SourceManager::SaveSourceFile(
     unsigned int fileID,
     std::string normalizedPath,
@@ -72,16 +97,17 @@ void SourceManager::SaveSourceFile(
     uint64_t fileHash,
     std::optional<std::string> packageName)
 {
-    sources.emplace_back(fileID, normalizedPath, buffer, fileHash, packageName);
-    filePathToFileIDMap.emplace(normalizedPath, fileID);
+    std::lock_guard<std::mutex> lock(mtx);
+    EmplaceSource(fileID, std::move(normalizedPath), std::move(buffer), fileHash, std::move(packageName));
 }
 
 void SourceManager::ReserveCommonPartSources(std::vector<std::string> files)
 {
+    std::lock_guard<std::mutex> lock(mtx);
     for (size_t i = 0; i < files.size(); i++) {
         auto file = files.at(i);
         uint64_t fileHash = 0;
-        SaveSourceFile(static_cast<unsigned int>(i + 1), files.at(i), "", fileHash);
+        EmplaceSource(static_cast<unsigned int>(i + 1), files.at(i), "", fileHash);
         filePathToFileIDMap.emplace(file, i + 1);
     }
 }
@@ -93,6 +119,7 @@ unsigned int SourceManager::AddSource(
     std::string normalizePath = FileUtil::Normalize(path);
     // Change fileHash from content hash to path hash.
     uint64_t fileHash = Utils::GetHash(normalizePath);
+    std::lock_guard<std::mutex> lock(mtx);
     auto existed = filePathToFileIDMap.find(normalizePath);
     if (existed != filePathToFileIDMap.end()) {
         unsigned int fileID = static_cast<unsigned int>(existed->second);
@@ -101,16 +128,44 @@ unsigned int SourceManager::AddSource(
         return fileID;
     } else {
         auto fileID = static_cast<unsigned int>(sources.size());
-        SaveSourceFile(fileID, normalizePath, buffer, fileHash, packageName);
+        EmplaceSource(fileID, normalizePath, buffer, fileHash, packageName);
         return fileID;
     }
 }
 
+unsigned int SourceManager::ReserveSource(const std::string& path, std::optional<std::string> packageName)
+{
+    return AddSource(path, "", std::move(packageName));
+}
+
+void SourceManager::SetBuffer(unsigned int fileID, std::string buffer)
+{
+    Source* source = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        CJC_ASSERT(fileID < sources.size());
+        source = &sources[fileID];
+    }
+    // Building the line offsets is the expensive part, it is done out of the lock.
+    *source = Source{fileID, source->path, std::move(buffer), source->fileHash, source->packageName};
+}
+
+void SourceManager::UnreserveSource(unsigned int fileID)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    CJC_ASSERT(fileID < sources.size());
+    auto existed = filePathToFileIDMap.find(sources[fileID].path);
+    if (existed != filePathToFileIDMap.end() && static_cast<unsigned int>(existed->second) == fileID) {
+        filePathToFileIDMap.erase(existed);
+    }
+}
+
 unsigned int SourceManager::AppendSource(const std::string& path, const std::string& buffer)
 {
     // path canonicalize
     std::string normalizePath = FileUtil::Normalize(path);
     uint64_t fileHash = Utils::GetHash(normalizePath);
+    std::lock_guard<std::mutex> lock(mtx);
     auto existed = filePathToFileIDMap.find(normalizePath);
     if (existed != filePathToFileIDMap.end()) {
         unsigned int fileID = existed->second;
@@ -143,16 +198,16 @@ int SourceManager::GetLineEnd(const Position& pos)
     if (pos.fileID >= sources.size()) {
         return 0;
     }
-    auto buffer = sources[pos.fileID].buffer;
-    auto sourceSplited = Utils::SplitLines(buffer);
-    if (pos.line > static_cast<int>(sourceSplited.size())) {
+    auto& source = sources[pos.fileID];
+    if (source.buffer.empty() || pos.line > static_cast<int>(source.lineOffsets.size())) {
         return 0;
     }
     CJC_ASSERT(pos.line > 0);
     if (pos.line <= 0) {
         return 0;
     }
-    return static_cast<int>(sourceSplited[static_cast<size_t>(pos.line - 1)].size());
+    auto index = static_cast<size_t>(pos.line - 1);
+    return static_cast<int>(source.GetLineContentEnd(index) - source.lineOffsets[index]);
 }
 
 std::string SourceManager::GetContentBetween(
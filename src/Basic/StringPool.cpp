@@ -0,0 +1,109 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the SharedString class and the StringPool.
+ */
+
+#include "cangjie/Basic/StringPool.h"
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+using namespace Cangjie;
+
+namespace {
+constexpr size_t POOL_SHARDS_NUM = 32;
+
+struct PoolShard {
+    std::mutex mtx;
+    // The keys refer to the characters of the pooled strings, which do not move while they are in the map.
+    std::unordered_map<std::string_view, void*> values;
+};
+
+PoolShard* GetShards()
+{
+    // Never destroyed, handles in static objects may be released after the shards would be.
+    static PoolShard* const shards = new PoolShard[POOL_SHARDS_NUM];
+    return shards;
+}
+
+PoolShard& GetShard(std::string_view value)
+{
+    return GetShards()[std::hash<std::string_view>{}(value) % POOL_SHARDS_NUM];
+}
+} // namespace
+
+SharedString::SharedString(std::string value) : rep(EmptyRep())
+{
+    if (!value.empty()) {
+        rep = new Rep(std::move(value), false);
+    }
+}
+
+void SharedString::Release() noexcept
+{
+    if (rep == EmptyRep()) {
+        return;
+    }
+    if (rep->pooled) {
+        StringPool::Release(rep);
+    } else if (rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete rep;
+    }
+    rep = EmptyRep();
+}
+
+SharedString StringPool::Intern(std::string_view value)
+{
+    if (value.empty()) {
+        return SharedString();
+    }
+    auto& shard = GetShard(value);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    if (auto it = shard.values.find(value); it != shard.values.end()) {
+        auto rep = static_cast<SharedString::Rep*>(it->second);
+        rep->refs.fetch_add(1, std::memory_order_relaxed);
+        return SharedString(rep);
+    }
+    auto rep = new SharedString::Rep(std::string(value), true);
+    shard.values.emplace(rep->value, rep);
+    return SharedString(rep);
+}
+
+void StringPool::Release(SharedString::Rep* rep) noexcept
+{
+    // Dropping a reference which is not the last one needs no lock. The count only reaches zero under the lock of
+    // the shard, where Intern takes new references, so a string is never found in the pool once it is freed.
+    auto refs = rep->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (rep->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    auto& shard = GetShard(rep->value);
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        if (rep->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        shard.values.erase(rep->value);
+    }
+    delete rep;
+}
+
+size_t StringPool::Size()
+{
+    size_t size = 0;
+    for (size_t i = 0; i < POOL_SHARDS_NUM; ++i) {
+        std::lock_guard<std::mutex> lock(GetShards()[i].mtx);
+        size += GetShards()[i].values.size();
+    }
+    return size;
+}
@@ -4,6 +4,7 @@
 //
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
+#include "cangjie/AST/ConcurrentWalker.h"
 #include "cangjie/AST/Utils.h"
 #include "cangjie/CHIR/AST2CHIR/AST2CHIR.h"
 
@@ -128,7 +129,7 @@ void AST2CHIR::CollectImplicitFuncs()
         ImplicitImportedFuncMgr::FuncKind::GENERIC);
     for (auto& importedPkg : importedPkgs) {
         for (auto& instantiatedDecl : importedPkg->srcPackage->genericInstantiatedDecls) {
-            AST::Walker(instantiatedDecl.get(), collectImplicitDecls).Walk();
+            AST::ConcurrentWalk(instantiatedDecl.get(), collectImplicitDecls);
         }
     }
     // Collect implicitly imported/used non-generic funcDecl.
@@ -136,7 +137,7 @@ void AST2CHIR::CollectImplicitFuncs()
     registeredImplicitFuncs = ImplicitImportedFuncMgr::Instance().GetImplicitImportedFuncs(
         ImplicitImportedFuncMgr::FuncKind::NONE_GENERIC);
     AST::IterateToplevelDecls(*stdCorePkg->srcPackage, [&collectImplicitDecls](const OwnedPtr<AST::Decl>& decl) {
-        AST::Walker(decl.get(), collectImplicitDecls).Walk();
+        AST::ConcurrentWalk(decl.get(), collectImplicitDecls);
     });
     for (auto& implicitDecl : implicitDecls) {
         CJC_ASSERT(implicitDecl->IsFunc());
@@ -254,7 +255,8 @@ void AST2CHIR::CollectFuncDecl(AST::FuncDecl& funcDecl)
     } else {
         // `instantiated` decl denote that: generic definition in up-stream pkg, but instantiated in current pkg, these
         // decls's IMPORTED Attribute is false,So we can't distinguish it from the current package decl.
-        CollectDeclToList(funcDecl, globalAndMemberFuncs);
+        CollectDeclToList(funcDecl,
+            IsInstantiationOfImportedPackage(funcDecl) ? importedGlobalAndMemberFuncs : globalAndMemberFuncs);
         for (auto& param : funcDecl.funcBody->paramLists[0]->params) {
             if (param->desugarDecl) {
                 CollectDeclToList(*param->desugarDecl, globalAndMemberFuncs);
@@ -263,6 +265,19 @@ void AST2CHIR::CollectFuncDecl(AST::FuncDecl& funcDecl)
     }
 }
 
+bool AST2CHIR::IsInstantiationOfImportedPackage(const AST::FuncDecl& funcDecl) const
+{
+    // Only the instantiations of global generic functions are shared through the cjo, see 'SaveSharedInstantiations'.
+    // Const functions keep their bodies for const evaluation, and the platform part reuses the deserialized ones.
+    if (!funcDecl.TestAttr(AST::Attribute::GENERIC_INSTANTIATED) || funcDecl.outerDecl != nullptr ||
+        funcDecl.linkage != Linkage::WEAK_ODR || funcDecl.isConst || !funcDecl.genericDecl || mergingPlatform ||
+        opts.outputMode == GlobalOptions::OutputMode::CHIR) {
+        return false;
+    }
+    return importManager.GetCjoManager()->IsSharedByImportedPackage(
+        funcDecl.genericDecl->exportId, funcDecl.mangledName);
+}
+
 void AST2CHIR::CollectMemberDecl(AST::Decl& decl)
 {
     if (auto funcDecl = DynamicCast<AST::FuncDecl*>(&decl); funcDecl) {
@@ -6,6 +6,8 @@
 
 #include "cangjie/CHIR/CHIR.h"
 
+#include <fstream>
+
 #include "cangjie/CHIR/Analysis/CallGraphAnalysis.h"
 #include "cangjie/CHIR/Analysis/DevirtualizationInfo.h"
 #include "cangjie/CHIR/CHIRPrinter.h"
@@ -25,6 +27,7 @@
 #include "cangjie/CHIR/Transformation/DeadCodeElimination.h"
 #include "cangjie/CHIR/Transformation/Devirtualization.h"
 #include "cangjie/CHIR/Transformation/FlatForInExpr.h"
+#include "cangjie/CHIR/Transformation/FuncPassManager.h"
 #include "cangjie/CHIR/Transformation/FunctionInline.h"
 #include "cangjie/CHIR/Transformation/GetRefToArrayElem.h"
 #include "cangjie/CHIR/Transformation/MarkClassHasInited.h"
@@ -318,35 +321,58 @@ void ToCHIR::ReportUnusedCode()
     dce.ReportUnusedCode(*chirPkg, opts);
 }
 
-void ToCHIR::RedundantLoadElimination()
+void ToCHIR::RunFuncPasses(const std::string& stageName, const FuncPassList& passes)
+{
+    if (passes.empty()) {
+        return;
+    }
+    Utils::ProfileRecorder recorder("CHIR Opt", stageName);
+    // Debug logs of the passes are printed in function order.
+    size_t threadNum = opts.chirDebugOptimizer ? 1 : opts.GetJobs();
+    if (opts.NeedDumpCHIRToFile()) {
+        // Run the passes one by one, so that each dump is the package after a pass.
+        for (auto& [name, pass] : passes) {
+            FuncPassManager fpm(builder, threadNum);
+            fpm.AddPass(pass);
+            fpm.Run(*chirPkg);
+            DumpCHIRToFile(name);
+        }
+        return;
+    }
+    FuncPassManager fpm(builder, threadNum);
+    for (auto& [_, pass] : passes) {
+        fpm.AddPass(pass);
+    }
+    fpm.Run(*chirPkg);
+}
+
+void ToCHIR::RedundantLoadElimination(FuncPassList& passes) const
 {
     if (!opts.IsOptimizationExisted(GlobalOptions::OptimizationFlag::REDUNDANT_LOAD)) {
         return;
     }
-    Utils::ProfileRecorder recorder("CHIR Opt", "RedundantLoadElimination");
-    auto rle = CHIR::RedundantLoadElimination();
-    rle.RunOnPackage(chirPkg, opts.chirDebugOptimizer);
-    DumpCHIRToFile("RedundantLoadElimination");
+    passes.emplace_back("RedundantLoadElimination", [isDebug = opts.chirDebugOptimizer](Func& func, CHIRBuilder&) {
+        CHIR::RedundantLoadElimination().RunOnFunc(&func, isDebug);
+    });
 }
 
-void ToCHIR::UselessAllocateElimination()
+void ToCHIR::UselessAllocateElimination(FuncPassList& passes) const
 {
     if (!opts.IsCHIROptimizationLevelOverO2()) {
         return;
     }
-    Utils::ProfileRecorder recorder("CHIR Opt", "UselessAllocateElimination");
-    UselessAllocateElimination::RunOnPackage(*chirPkg, opts.chirDebugOptimizer);
-    DumpCHIRToFile("UselessAllocateElimination");
+    passes.emplace_back("UselessAllocateElimination", [isDebug = opts.chirDebugOptimizer](Func& func, CHIRBuilder&) {
+        CHIR::UselessAllocateElimination::RunOnFunc(func, isDebug);
+    });
 }
 
-void ToCHIR::RunGetRefToArrayElemOpt()
+void ToCHIR::RunGetRefToArrayElemOpt(FuncPassList& passes) const
 {
     if (!opts.IsCHIROptimizationLevelOverO2() || opts.interpFullBchir) {
         return;
     }
-    Utils::ProfileRecorder recorder("CHIR Opt", "ArrayGetRefOpt");
-    GetRefToArrayElem::RunOnPackage(*chirPkg, builder);
-    DumpCHIRToFile("ArrayGetRefOpt");
+    passes.emplace_back("ArrayGetRefOpt",
+        [](Func& func, CHIRBuilder& funcBuilder) { GetRefToArrayElem::RunOnFunc(func, funcBuilder); });
 }
 
 void ToCHIR::Devirtualization(DevirtualizationInfo& devirtInfo)
@@ -389,15 +415,15 @@ void ToCHIR::Devirtualization(DevirtualizationInfo& devirtInfo)
     DumpCHIRToFile("Devirtualization");
 }
 
-void ToCHIR::RedundantGetOrThrowElimination()
+void ToCHIR::RedundantGetOrThrowElimination(FuncPassList& passes) const
 {
     if (!opts.enableChirRGetOrThrowE) {
         return;
     }
-    Utils::ProfileRecorder recorder("CHIR Opt", "RedundantGetOrThrowElimination");
-    auto rGetOrThrowE = CHIR::RedundantGetOrThrowElimination();
-    rGetOrThrowE.RunOnPackage(chirPkg, opts.chirDebugOptimizer);
-    DumpCHIRToFile("RedundantGetOrThrowElimination");
+    passes.emplace_back(
+        "RedundantGetOrThrowElimination", [isDebug = opts.chirDebugOptimizer](Func& func, CHIRBuilder&) {
+            CHIR::RedundantGetOrThrowElimination().RunOnFunc(&func, isDebug);
+        });
 }
 
 void ToCHIR::FlatForInExpr()
@@ -449,6 +475,17 @@ void ToCHIR::RunFunctionInline(DevirtualizationInfo& devirtInfo)
     // Collect all call graph information.
     callGraphAnalysis.DoCallGraphAnalysis(opts.chirDebugOptimizer);
     auto pass = FunctionInline(builder, opts.optimizationLevel, opts.chirDebugOptimizer);
+    InlineProfile profile;
+    if (!opts.chirInlineProfile.empty() && profile.Load(opts.chirInlineProfile)) {
+        pass.SetProfile(&profile);
+    }
+    std::ofstream remarks;
+    if (!opts.chirInlineRemarks.empty()) {
+        remarks.open(opts.chirInlineRemarks);
+        if (remarks.is_open()) {
+            pass.SetRemarkStream(&remarks);
+        }
+    }
     for (auto func : callGraphAnalysis.postOrderSCCFunctionlist) {
         if (!func) {
             continue;
@@ -703,16 +740,27 @@ bool ToCHIR::RunOptimizationPassAndRulesChecking()
     RunUnitUnify();
     auto devirtInfo = CollectDevirtualizationInfo();
     RunFunctionInline(devirtInfo);
-    RedundantLoadElimination();
-    RedundantGetOrThrowElimination();
+    // Intra-procedural passes run per function in parallel, whole-package passes between them are barriers.
+    FuncPassList passes;
+    RedundantLoadElimination(passes);
+    RedundantGetOrThrowElimination(passes);
+    RunFuncPasses("Load And GetOrThrow Elimination", passes);
     RunRangePropagation();
-    RunMergingBlocks("CHIR Opt", "MergingBlockAfterRangeAnalysis");
-    UselessAllocateElimination();
+    passes.clear();
+    passes.emplace_back("MergingBlockAfterRangeAnalysis", [this](Func& func, CHIRBuilder& funcBuilder) {
+        if (!func.TestAttr(Attribute::SKIP_ANALYSIS)) {
+            MergeBlocks::RunOnFunc(*func.GetBody(), funcBuilder, opts);
+        }
+    });
+    UselessAllocateElimination(passes);
+    RunFuncPasses("Merging Block And Allocate Elimination", passes);
     Devirtualization(devirtInfo);
     RunArrayLambdaOpt();
     RunRedundantFutureOpt();
     RunNoSideEffectMarkerOpt();
-    RunGetRefToArrayElemOpt();
+    passes.clear();
+    RunGetRefToArrayElemOpt(passes);
+    RunFuncPasses("ArrayGetRefOpt", passes);
     return true;
 }
 
@@ -815,6 +863,21 @@ void ToCHIR::RecordCodeInfoAtTheBegin()
         return astNodeCnt;
     };
     Utils::ProfileRecorder::RecordCodeInfo("cur pkg generic ins ast node", getCurPkgInstantiatedAstNode);
+    if (kind == IncreKind::INCR) {
+        // Unchanged decls are not translated, they are pseudo imported and their cached code is reused by CodeGen.
+        auto importedValues = chirPkg->GetImportedVarAndFuncs();
+        int64_t reusedNum = std::count_if(importedValues.begin(), importedValues.end(),
+            [](auto value) { return value->TestAttr(Attribute::NON_RECOMPILE); });
+        Utils::ProfileRecorder::RecordCodeInfo("incr reused func and var", reusedNum);
+        // Only count the functions of decls, like the reused ones. Compiler added functions, e.g. the initializers of
+        // global variables and the annotation factories, are generated on every build.
+        auto funcs = chirPkg->GetGlobalFuncs();
+        int64_t recompiledNum = std::count_if(funcs.begin(), funcs.end(), [](auto func) {
+            return !func->TestAttr(Attribute::COMPILER_ADD) && func->GetFuncKind() != FuncKind::GLOBALVAR_INIT &&
+                func->GetFuncKind() != FuncKind::ANNOFACTORY_FUNC;
+        });
+        Utils::ProfileRecorder::RecordCodeInfo("incr recompiled func", recompiledNum);
+    }
 }
 
 void ToCHIR::RecordCodeInfoAtTheEnd()
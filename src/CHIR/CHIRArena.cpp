@@ -0,0 +1,81 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the bump pointer arena which CHIR nodes are allocated from.
+ */
+
+#include "cangjie/CHIR/CHIRArena.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "cangjie/Utils/TaskQueue.h"
+
+using namespace Cangjie::CHIR;
+
+namespace {
+// Sub builders often create only a few nodes, so chunks start small and grow as the arena is used.
+constexpr size_t MIN_CHUNK_SIZE = 4 * 1024;
+constexpr size_t MAX_CHUNK_SIZE = 256 * 1024;
+// Below this number, running the destructors costs less than starting the threads.
+constexpr size_t MIN_FINALIZERS_PER_THREAD = 4096;
+} // namespace
+
+void CHIRArena::NewChunk(size_t minSize)
+{
+    nextChunkSize = std::clamp(nextChunkSize * 2, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE);
+    size_t size = std::max(nextChunkSize, minSize);
+    // Not value initialized, pages are only touched when nodes are placed in them.
+    chunks.emplace_back(new std::byte[size]);
+    cur = chunks.back().get();
+    end = cur + size;
+}
+
+void CHIRArena::Merge(CHIRArena& other)
+{
+    chunks.insert(
+        chunks.end(), std::make_move_iterator(other.chunks.begin()), std::make_move_iterator(other.chunks.end()));
+    finalizers.insert(finalizers.end(), other.finalizers.begin(), other.finalizers.end());
+    nodesNum += other.nodesNum;
+    other.chunks.clear();
+    other.finalizers.clear();
+    other.cur = nullptr;
+    other.end = nullptr;
+    other.nextChunkSize = 0;
+    other.nodesNum = 0;
+}
+
+void CHIRArena::Release(size_t threadsNum)
+{
+    size_t finalizersNum = finalizers.size();
+    threadsNum = std::clamp<size_t>(finalizersNum / MIN_FINALIZERS_PER_THREAD, 1, std::max<size_t>(threadsNum, 1));
+    if (threadsNum == 1) {
+        for (auto& finalizer : finalizers) {
+            finalizer.destroy(finalizer.node);
+        }
+    } else {
+        Utils::TaskQueue taskQueue(threadsNum);
+        for (size_t i = 0; i < threadsNum; ++i) {
+            size_t begin = finalizersNum * i / threadsNum;
+            size_t sliceEnd = finalizersNum * (i + 1) / threadsNum;
+            taskQueue.AddTask<void>([this, begin, sliceEnd]() {
+                for (size_t idx = begin; idx < sliceEnd; ++idx) {
+                    finalizers[idx].destroy(finalizers[idx].node);
+                }
+            });
+        }
+        taskQueue.RunAndWaitForAllTasksCompleted();
+    }
+    finalizers.clear();
+    chunks.clear();
+    cur = nullptr;
+    end = nullptr;
+    nextChunkSize = 0;
+    nodesNum = 0;
+}
@@ -39,9 +39,7 @@ CHIRBuilder::~CHIRBuilder()
 // ===--------------------------------------------------------------------=== //
 BlockGroup* CHIRBuilder::CreateBlockGroup(Func& func)
 {
-    auto blockGroup = new BlockGroup(std::to_string(func.GenerateBlockGroupId()));
-    this->allocatedBlockGroups.push_back(blockGroup);
-    return blockGroup;
+    return NewNode<BlockGroup>(std::to_string(func.GenerateBlockGroupId()));
 }
 
 // ===--------------------------------------------------------------------===//
@@ -54,8 +52,7 @@ Block* CHIRBuilder::CreateBlock(BlockGroup* parentGroup)
     CJC_NULLPTR_CHECK(func);
     std::string idstr = "#" + std::to_string(func->GenerateBlockId());
 
-    auto basicBlock = new Block(idstr, parentGroup);
-    this->allocatedBlocks.push_back(basicBlock);
+    auto basicBlock = NewNode<Block>(idstr, parentGroup);
     if (markAsCompileTimeValue) {
         basicBlock->EnableAttr(Attribute::CONST);
     }
@@ -90,10 +87,9 @@ std::pair<Block*, Block*> CHIRBuilder::SplitBlock(const Expression& separator)
 Parameter* CHIRBuilder::CreateParameter(Type* ty, const DebugLocation& loc, Func& parentFunc)
 {
     auto id = parentFunc.GenerateLocalId();
-    auto param = new Parameter(ty, "%" + std::to_string(id), &parentFunc);
+    auto param = NewNode<Parameter>(ty, "%" + std::to_string(id), &parentFunc);
     param->EnableAttr(Attribute::READONLY);
     param->SetDebugLocation(loc);
-    this->allocatedValues.push_back(param);
     return param;
 }
 
@@ -101,19 +97,18 @@ Parameter* CHIRBuilder::CreateParameter(Type* ty, const DebugLocation& loc, Lamb
 {
     CJC_NULLPTR_CHECK(parentLambda.GetTopLevelFunc());
     auto id = parentLambda.GetTopLevelFunc()->GenerateLocalId();
-    auto param = new Parameter(ty, "%" + std::to_string(id), parentLambda);
+    auto param = NewNode<Parameter>(ty, "%" + std::to_string(id), parentLambda);
     param->EnableAttr(Attribute::READONLY);
     param->SetDebugLocation(loc);
-    this->allocatedValues.push_back(param);
     return param;
 }
 
 GlobalVar* CHIRBuilder::CreateGlobalVar(const DebugLocation& loc, RefType* ty, const std::string& mangledName,
     const std::string& srcCodeIdentifier, const std::string& rawMangledName, const std::string& packageName)
 {
-    GlobalVar* globalVar = new GlobalVar(ty, "@" + mangledName, srcCodeIdentifier, rawMangledName, packageName);
+    GlobalVar* globalVar =
+        NewNode<GlobalVar>(ty, "@" + mangledName, srcCodeIdentifier, rawMangledName, packageName);
     globalVar->SetDebugLocation(loc);
-    this->allocatedValues.push_back(globalVar);
     if (context.GetCurPackage() != nullptr) {
         context.GetCurPackage()->AddGlobalVar(globalVar);
     }
@@ -128,8 +123,8 @@ Func* CHIRBuilder::CreateFunc(const DebugLocation& loc, FuncType* funcTy, const
     const std::string& srcCodeIdentifier, const std::string& rawMangledName, const std::string& packageName,
     const std::vector<GenericType*>& genericTypeParams)
 {
-    Func* func = new Func(funcTy, "@" + mangledName, srcCodeIdentifier, rawMangledName, packageName, genericTypeParams);
-    this->allocatedValues.push_back(func);
+    Func* func =
+        NewNode<Func>(funcTy, "@" + mangledName, srcCodeIdentifier, rawMangledName, packageName, genericTypeParams);
     if (context.GetCurPackage() != nullptr) {
         context.GetCurPackage()->AddGlobalFunc(func);
     }
@@ -143,8 +138,7 @@ Func* CHIRBuilder::CreateFunc(const DebugLocation& loc, FuncType* funcTy, const
 StructDef* CHIRBuilder::CreateStruct(const DebugLocation& loc, const std::string& srcCodeIdentifier,
     const std::string& mangledName, const std::string& pkgName, bool isImported)
 {
-    StructDef* ret = new StructDef(srcCodeIdentifier, "@" + mangledName, pkgName);
-    this->allocatedStructs.push_back(ret);
+    StructDef* ret = NewNode<StructDef>(srcCodeIdentifier, "@" + mangledName, pkgName);
     if (context.GetCurPackage() != nullptr) {
         if (isImported) {
             context.GetCurPackage()->AddImportedStruct(ret);
@@ -163,8 +157,7 @@ ClassDef* CHIRBuilder::CreateClass(const DebugLocation& loc,
     const std::string& srcCodeIdentifier, const std::string& mangledName, const std::string& pkgName, bool isClass,
     bool isImported)
 {
-    ClassDef* ret = new ClassDef(srcCodeIdentifier, "@" + mangledName, pkgName, isClass);
-    this->allocatedClasses.push_back(ret);
+    ClassDef* ret = NewNode<ClassDef>(srcCodeIdentifier, "@" + mangledName, pkgName, isClass);
     if (context.GetCurPackage() != nullptr) {
         if (isImported) {
             context.GetCurPackage()->AddImportedClass(ret);
@@ -182,8 +175,7 @@ ClassDef* CHIRBuilder::CreateClass(const DebugLocation& loc,
 EnumDef* CHIRBuilder::CreateEnum(const DebugLocation& loc, const std::string& srcCodeIdentifier,
     const std::string& mangledName, const std::string& pkgName, bool isImported, bool isNonExhaustive)
 {
-    EnumDef* ret = new EnumDef(srcCodeIdentifier, "@" + mangledName, pkgName, isNonExhaustive);
-    this->allocatedEnums.push_back(ret);
+    EnumDef* ret = NewNode<EnumDef>(srcCodeIdentifier, "@" + mangledName, pkgName, isNonExhaustive);
     if (context.GetCurPackage() != nullptr) {
         if (isImported) {
             context.GetCurPackage()->AddImportedEnum(ret);
@@ -201,8 +193,7 @@ EnumDef* CHIRBuilder::CreateEnum(const DebugLocation& loc, const std::string& sr
 ExtendDef* CHIRBuilder::CreateExtend(const DebugLocation& loc, const std::string& mangledName,
     const std::string& pkgName, bool isImported, const std::vector<GenericType*> genericParams)
 {
-    ExtendDef* ret = new ExtendDef("@" + mangledName, pkgName, genericParams);
-    this->allocatedExtends.emplace_back(ret);
+    ExtendDef* ret = NewNode<ExtendDef>("@" + mangledName, pkgName, genericParams);
     if (context.GetCurPackage() != nullptr) {
         if (isImported) {
             context.GetCurPackage()->AddImportedExtend(ret);
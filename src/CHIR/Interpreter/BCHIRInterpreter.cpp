@@ -32,47 +32,85 @@ const Bchir& BCHIRInterpreter::GetBchir() const
     return bchir;
 }
 
+#if defined(__GNUC__) && !defined(CANGJIE_BCHIR_SWITCH_DISPATCH)
+// Direct-threaded dispatch: each handler fetches the next operation and jumps to its handler through the
+// dispatch table, instead of going back to the single indirect jump of the switch.
+#define BCHIR_THREADED_DISPATCH
+#endif
+
+#ifndef NDEBUG
+#define BCHIR_DEBUG_INFO() PrintDebugInfo(pc)
+#else
+#define BCHIR_DEBUG_INFO() (void)0
+#endif
+
+#ifdef BCHIR_THREADED_DISPATCH
+#define BCHIR_CASE(ID)                                                                                                 \
+    case OpCode::ID:                                                                                                   \
+    OP_LABEL_##ID
+#define BCHIR_NEXT()                                                                                                   \
+    do {                                                                                                               \
+        if (interpreterError) {                                                                                        \
+            return;                                                                                                    \
+        }                                                                                                              \
+        current = static_cast<OpCode>(bchir.Get(pc));                                                                 \
+        BCHIR_DEBUG_INFO();                                                                                            \
+        pcExcOffset = 0;                                                                                               \
+        goto* dispatchTable[static_cast<size_t>(current)];                                                             \
+    } while (false)
+#else
+#define BCHIR_CASE(ID) case OpCode::ID
+#define BCHIR_NEXT() continue
+#endif
+
 void BCHIRInterpreter::Interpret()
 {
     CJC_ASSERT(pc == baseIndex);
+#ifdef BCHIR_THREADED_DISPATCH
+    static const void* const dispatchTable[] = {
+#define OPCODE(ID, VALUE, SIZE, HAS_EXC_HANDLER) &&OP_LABEL_##ID,
+#include "cangjie/CHIR/Interpreter/OpCodes.inc"
+#undef OPCODE
+    };
+#endif
+    // when interpreting an X_EXC operation
+    // 1. set pcExcOffset to 1
+    // 2. interpret operation X
+    //
+    // after interpreting X operation
+    // 1. increment pc taking into account pcExcOffset
+    //
+    // basically when updating pc after interpreting X,
+    // pcExcOffset is going to 0 if entry point was X or 1 is entry point was X_EXC
+    Bchir::ByteCodeIndex pcExcOffset{0};
+    OpCode current;
     // no bound variables in the top-level thunk
     while (!interpreterError) {
-        auto current = static_cast<OpCode>(bchir.Get(pc));
-#ifndef NDEBUG
-        PrintDebugInfo(pc);
-#endif
-
-        // when interpreting an X_EXC operation
-        // 1. set pcExcOffset to 1
-        // 2. interpret operation X
-        //
-        // after interpreting X operation
-        // 1. increment pc taking into account pcExcOffset
-        //
-        // basically when updating pc after interpreting X,
-        // pcExcOffset is going to 0 if entry point was X or 1 is entry point was X_EXC
-        Bchir::ByteCodeIndex pcExcOffset{0};
+        current = static_cast<OpCode>(bchir.Get(pc));
+        BCHIR_DEBUG_INFO();
+        pcExcOffset = 0;
+        // with threaded dispatch, the switch is only used to enter the first operation
         switch (current) {
-            case OpCode::ALLOCATE_RAW_ARRAY: {
+            BCHIR_CASE(ALLOCATE_RAW_ARRAY): {
                 InterpretAllocateRawArray<false, false>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::ALLOCATE_EXC:
+            BCHIR_CASE(ALLOCATE_EXC):
                 pcExcOffset = 1;
                 // intended missing break
                 // for the time being allocate never raises exception
-            case OpCode::ALLOCATE: {
+            BCHIR_CASE(ALLOCATE): {
                 auto ptr = IPointer();
                 ptr.content = AllocateValue(INullptr());
                 interpStack.ArgsPush(ptr);
                 pc += 1 + pcExcOffset;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::ALLOCATE_STRUCT_EXC:
+            BCHIR_CASE(ALLOCATE_STRUCT_EXC):
                 pcExcOffset = 1;
                 // intended missing break
                 // for the time being allocate never raises exception
-            case OpCode::ALLOCATE_STRUCT: {
+            BCHIR_CASE(ALLOCATE_STRUCT): {
                 auto numField = bchir.Get(pc + 1);
                 std::vector<IVal> content;
                 for (size_t i = 0; i < numField; i++) {
@@ -82,13 +120,13 @@ void BCHIRInterpreter::Interpret()
                 ptr.content = AllocateValue(ITuple{std::move(content)});
                 interpStack.ArgsPush(ptr);
                 pc += Bchir::FLAG_TWO + pcExcOffset;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::ALLOCATE_CLASS_EXC:
+            BCHIR_CASE(ALLOCATE_CLASS_EXC):
                 pcExcOffset = 1;
                 // intended missing break
                 // for the time being allocate never raises exception
-            case OpCode::ALLOCATE_CLASS: {
+            BCHIR_CASE(ALLOCATE_CLASS): {
                 auto classId = bchir.Get(pc + 1);
                 auto numField = bchir.Get(pc + Bchir::FLAG_TWO);
                 std::vector<IVal> content;
@@ -99,73 +137,73 @@ void BCHIRInterpreter::Interpret()
                 ptr.content = AllocateValue(IObject{classId, std::move(content)});
                 interpStack.ArgsPush(ptr);
                 pc += Bchir::FLAG_THREE + pcExcOffset;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FRAME: {
+            BCHIR_CASE(FRAME): {
                 auto num = bchir.Get(pc + 1);
                 env.AllocateLocalVarsForFrame(static_cast<size_t>(num));
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::LVAR: {
+            BCHIR_CASE(LVAR): {
                 auto varIdx = pc + 1;
                 auto var = bchir.Get(varIdx);
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
 
                 interpStack.ArgsPushIValRef(env.GetLocal(var));
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::GVAR: {
+            BCHIR_CASE(GVAR): {
                 auto varId = bchir.Get(pc + 1);
                 auto& val = env.GetGlobal(varId);
                 interpStack.ArgsPush(IPointer{&val});
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::GVAR_SET: {
+            BCHIR_CASE(GVAR_SET): {
                 auto varId = bchir.Get(pc + 1);
                 env.SetGlobal(varId, interpStack.ArgsPopIVal());
                 pc = pc + 1 + 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::LVAR_SET: {
+            BCHIR_CASE(LVAR_SET): {
                 auto varId = bchir.Get(pc + 1);
                 env.SetLocal(varId, interpStack.ArgsPopIVal());
                 pc = pc + 1 + 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UINT8: {
+            BCHIR_CASE(UINT8): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IUInt8>(static_cast<uint8_t>(bchir.Get(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UINT16: {
+            BCHIR_CASE(UINT16): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IUInt16>(static_cast<uint16_t>(bchir.Get(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UINT32: {
+            BCHIR_CASE(UINT32): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IUInt32>(static_cast<uint32_t>(bchir.Get(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UINT64: {
+            BCHIR_CASE(UINT64): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(
                     IValUtils::PrimitiveValue<IUInt64>(static_cast<uint64_t>(bchir.Get8bytes(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_THREE;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UINTNAT: {
+            BCHIR_CASE(UINTNAT): {
                 auto valIdx = pc + 1;
 #if (defined(__x86_64__) || defined(__aarch64__))
                 interpStack.ArgsPush(
@@ -176,37 +214,37 @@ void BCHIRInterpreter::Interpret()
 #endif
                 // update pc for next operation
                 pc += Bchir::FLAG_THREE;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INT8: {
+            BCHIR_CASE(INT8): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IInt8>(static_cast<int8_t>(bchir.Get(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INT16: {
+            BCHIR_CASE(INT16): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IInt16>(static_cast<int16_t>(bchir.Get(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INT32: {
+            BCHIR_CASE(INT32): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IInt32>(static_cast<int32_t>(bchir.Get(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INT64: {
+            BCHIR_CASE(INT64): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IInt64>(static_cast<int64_t>(bchir.Get8bytes(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_THREE;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INTNAT: {
+            BCHIR_CASE(INTNAT): {
                 auto valIdx = pc + 1;
 #if (defined(__x86_64__) || defined(__aarch64__))
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IIntNat>(static_cast<int64_t>(bchir.Get8bytes(valIdx))));
@@ -215,9 +253,9 @@ void BCHIRInterpreter::Interpret()
 #endif
                 // update pc for next operation
                 pc += Bchir::FLAG_THREE;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FLOAT16: {
+            BCHIR_CASE(FLOAT16): {
                 auto valIdx = pc + 1;
                 auto tmp = bchir.Get(valIdx);
                 // Value for a FLOAT16 instruction is a 32-bit float.
@@ -228,9 +266,9 @@ void BCHIRInterpreter::Interpret()
                 }
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IFloat16>(static_cast<float>(f)));
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FLOAT32: {
+            BCHIR_CASE(FLOAT32): {
                 auto valIdx = pc + 1;
                 auto tmp = bchir.Get(valIdx);
                 float f;
@@ -240,9 +278,9 @@ void BCHIRInterpreter::Interpret()
                 }
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IFloat32>(static_cast<float>(f)));
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FLOAT64: {
+            BCHIR_CASE(FLOAT64): {
                 auto valIdx = pc + 1;
                 auto tmp = bchir.Get8bytes(valIdx);
                 double d;
@@ -252,40 +290,40 @@ void BCHIRInterpreter::Interpret()
                 }
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IFloat64>(d));
                 pc += Bchir::FLAG_THREE;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::RUNE: {
+            BCHIR_CASE(RUNE): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IRune>(bchir.Get(static_cast<char32_t>(valIdx))));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BOOL: {
+            BCHIR_CASE(BOOL): {
                 auto valIdx = pc + 1;
                 interpStack.ArgsPush(IValUtils::PrimitiveValue<IBool>(bchir.Get(valIdx)));
                 // update pc for next operation
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UNIT: {
+            BCHIR_CASE(UNIT): {
                 interpStack.ArgsPush(IUnit());
                 // update pc for next operation
                 pc += 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::NULLPTR: {
+            BCHIR_CASE(NULLPTR): {
                 interpStack.ArgsPush(INullptr());
                 // update pc for next operation
                 pc += 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::STRING: {
+            BCHIR_CASE(STRING): {
                 InterpretString();
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::TUPLE: {
+            BCHIR_CASE(TUPLE): {
                 auto sizeIdx = pc + 1;
                 auto size = bchir.Get(sizeIdx);
                 pc = sizeIdx + 1;
@@ -293,188 +331,188 @@ void BCHIRInterpreter::Interpret()
                 auto tuple = ITuple();
                 interpStack.ArgsPop(size, tuple.content);
                 interpStack.ArgsPush(std::move(tuple));
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::VARRAY: {
+            BCHIR_CASE(VARRAY): {
                 auto sizeIdx = pc + 1;
                 auto size = bchir.Get(sizeIdx);
                 auto array = IArray();
                 interpStack.ArgsPop(size, array.content);
                 interpStack.ArgsPush(std::move(array));
                 pc = sizeIdx + 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::VARRAY_GET: {
+            BCHIR_CASE(VARRAY_GET): {
                 InterpretVArrayGet();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::RAW_ARRAY_LITERAL_INIT: {
+            BCHIR_CASE(RAW_ARRAY_LITERAL_INIT): {
                 InterpretRawArrayLiteralInit();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FUNC: {
+            BCHIR_CASE(FUNC): {
                 // FUNC :: THUNK_IDX :: NEXT_OP
                 auto thunkIdx = pc + 1;
                 auto func = IFunc{bchir.Get(thunkIdx)};
                 interpStack.ArgsPush(func);
                 pc = thunkIdx + 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::RETURN: {
+            BCHIR_CASE(RETURN): {
                 InterpretReturn();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::EXIT: {
+            BCHIR_CASE(EXIT): {
                 // we are done
                 return;
             }
-            case OpCode::DROP: {
+            BCHIR_CASE(DROP): {
                 interpStack.ArgsPopBack();
                 pc += 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::JUMP: {
+            BCHIR_CASE(JUMP): {
                 pc = bchir.Get(pc + 1);
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BRANCH: {
+            BCHIR_CASE(BRANCH): {
                 auto cond = interpStack.ArgsPop<IBool>();
                 if (cond.content) {
                     pc = bchir.Get(pc + 1);
                 } else {
                     pc = bchir.Get(pc + Bchir::FLAG_TWO);
                 }
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UN_NEG_EXC: {
+            BCHIR_CASE(UN_NEG_EXC): {
                 BinOp<OpCode::UN_NEG_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_ADD_EXC: {
+            BCHIR_CASE(BIN_ADD_EXC): {
                 BinOp<OpCode::BIN_ADD_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_SUB_EXC: {
+            BCHIR_CASE(BIN_SUB_EXC): {
                 BinOp<OpCode::BIN_SUB_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_MUL_EXC: {
+            BCHIR_CASE(BIN_MUL_EXC): {
                 BinOp<OpCode::BIN_MUL_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_DIV_EXC: {
+            BCHIR_CASE(BIN_DIV_EXC): {
                 BinOp<OpCode::BIN_DIV_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_MOD_EXC: {
+            BCHIR_CASE(BIN_MOD_EXC): {
                 BinOp<OpCode::BIN_MOD_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_EXP_EXC: {
+            BCHIR_CASE(BIN_EXP_EXC): {
                 BinOp<OpCode::BIN_EXP_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_LSHIFT_EXC: {
+            BCHIR_CASE(BIN_LSHIFT_EXC): {
                 BinOp<OpCode::BIN_LSHIFT_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_RSHIFT_EXC: {
+            BCHIR_CASE(BIN_RSHIFT_EXC): {
                 BinOp<OpCode::BIN_RSHIFT_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UN_NEG: {
+            BCHIR_CASE(UN_NEG): {
                 BinOp<OpCode::UN_NEG>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UN_DEC: {
+            BCHIR_CASE(UN_DEC): {
                 BinOp<OpCode::UN_DEC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UN_INC: {
+            BCHIR_CASE(UN_INC): {
                 BinOp<OpCode::UN_INC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UN_NOT: {
+            BCHIR_CASE(UN_NOT): {
                 BinOpFixedBool<OpCode::UN_NOT>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UN_BITNOT: {
+            BCHIR_CASE(UN_BITNOT): {
                 BinOp<OpCode::UN_BITNOT>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_ADD: {
+            BCHIR_CASE(BIN_ADD): {
                 BinOp<OpCode::BIN_ADD>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_SUB: {
+            BCHIR_CASE(BIN_SUB): {
                 BinOp<OpCode::BIN_SUB>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_MUL: {
+            BCHIR_CASE(BIN_MUL): {
                 BinOp<OpCode::BIN_MUL>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_DIV: {
+            BCHIR_CASE(BIN_DIV): {
                 BinOp<OpCode::BIN_DIV>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_MOD: {
+            BCHIR_CASE(BIN_MOD): {
                 BinOp<OpCode::BIN_MOD>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_EXP: {
+            BCHIR_CASE(BIN_EXP): {
                 BinOp<OpCode::BIN_EXP>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_LT: {
+            BCHIR_CASE(BIN_LT): {
                 BinOp<OpCode::BIN_LT>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_GT: {
+            BCHIR_CASE(BIN_GT): {
                 BinOp<OpCode::BIN_GT>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_LE: {
+            BCHIR_CASE(BIN_LE): {
                 BinOp<OpCode::BIN_LE>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_GE: {
+            BCHIR_CASE(BIN_GE): {
                 BinOp<OpCode::BIN_GE>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_NOTEQ: {
+            BCHIR_CASE(BIN_NOTEQ): {
                 BinOp<OpCode::BIN_NOTEQ>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_EQUAL: {
+            BCHIR_CASE(BIN_EQUAL): {
                 BinOp<OpCode::BIN_EQUAL>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_BITAND: {
+            BCHIR_CASE(BIN_BITAND): {
                 BinOp<OpCode::BIN_BITAND>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_BITOR: {
+            BCHIR_CASE(BIN_BITOR): {
                 BinOp<OpCode::BIN_BITOR>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_BITXOR: {
+            BCHIR_CASE(BIN_BITXOR): {
                 BinOp<OpCode::BIN_BITXOR>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_LSHIFT: {
+            BCHIR_CASE(BIN_LSHIFT): {
                 BinOp<OpCode::BIN_LSHIFT>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BIN_RSHIFT: {
+            BCHIR_CASE(BIN_RSHIFT): {
                 BinOp<OpCode::BIN_RSHIFT>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FIELD_TPL: {
+            BCHIR_CASE(FIELD_TPL): {
                 InterpretFieldTpl();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::FIELD: {
+            BCHIR_CASE(FIELD): {
                 auto fieldIdx = pc + 1;
                 auto field = bchir.Get(fieldIdx);
                 // OPTIMIZE
@@ -488,33 +526,33 @@ void BCHIRInterpreter::Interpret()
                     interpStack.ArgsPushIVal(std::move(object.content[field - 1]));
                 }
                 pc = fieldIdx + 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INVOKE_EXC: {
+            BCHIR_CASE(INVOKE_EXC): {
                 InterpretInvoke<OpCode::INVOKE_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INVOKE: {
+            BCHIR_CASE(INVOKE): {
                 InterpretInvoke<OpCode::INVOKE>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::TYPECAST: {
+            BCHIR_CASE(TYPECAST): {
                 InterpretTypeCast();
                 if (raiseExnToTopLevel) {
                     return;
                 }
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INSTANCEOF: {
+            BCHIR_CASE(INSTANCEOF): {
                 auto ptr = interpStack.ArgsPop<IPointer>();
                 auto& obj = IValUtils::Get<IObject>(*ptr.content);
                 auto lhs = obj.classId;
                 auto rhs = bchir.Get(pc + 1);
                 interpStack.ArgsPush(IBool{IsSubclass(lhs, rhs)});
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::BOX: {
+            BCHIR_CASE(BOX): {
                 auto classId = bchir.Get(pc + 1);
                 std::vector<IVal> content;
                 interpStack.ArgsPop(1, content);
@@ -522,89 +560,134 @@ void BCHIRInterpreter::Interpret()
                 ptr.content = AllocateValue(IObject{classId, std::move(content)});
                 interpStack.ArgsPush(std::move(ptr));
                 pc += Bchir::FLAG_TWO;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UNBOX: {
+            BCHIR_CASE(UNBOX): {
                 auto ptr = interpStack.ArgsPop<IPointer>();
                 auto& obj = IValUtils::Get<IObject>(*ptr.content);
                 auto value = obj.content[0];
                 interpStack.ArgsPushIVal(std::move(value));
                 pc++;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::UNBOX_REF: {
+            BCHIR_CASE(UNBOX_REF): {
                 auto ptr = interpStack.ArgsPop<IPointer>();
                 auto& obj = IValUtils::Get<IObject>(*ptr.content);
                 ptr.content = &obj.content[0]; // reusing ptr
                 interpStack.ArgsPush(std::move(ptr));
                 pc++;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::APPLY: {
+            BCHIR_CASE(APPLY): {
                 InterpretApply<OpCode::APPLY>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::APPLY_EXC: {
+            BCHIR_CASE(APPLY_EXC): {
                 InterpretApply<OpCode::APPLY_EXC>();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::ASG: {
+            BCHIR_CASE(ASG): {
                 auto ptr = interpStack.ArgsPop<IPointer>();
                 auto value = interpStack.ArgsPopIVal();
                 *ptr.content = std::move(value);
                 interpStack.ArgsPush(IUnit());
                 pc += 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::STOREINREF: {
+            BCHIR_CASE(STOREINREF): {
                 InterpretStoreInRef();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::STORE: {
+            BCHIR_CASE(STORE): {
                 auto ptr = interpStack.ArgsPop<IPointer>();
                 auto value = interpStack.ArgsPopIVal();
                 *ptr.content = std::move(value);
                 pc += 1;
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::DEREF: {
+            BCHIR_CASE(DEREF): {
                 InterpretDeref();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INTRINSIC0: {
+            BCHIR_CASE(INTRINSIC0): {
                 InterpretIntrinsic<OpCode::INTRINSIC0>();
                 if (raiseExnToTopLevel) {
                     return;
                 }
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::INTRINSIC1: {
+            BCHIR_CASE(INTRINSIC1): {
                 InterpretIntrinsic<OpCode::INTRINSIC1>();
                 if (raiseExnToTopLevel) {
                     return;
                 }
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::SWITCH: {
+            BCHIR_CASE(SWITCH): {
                 InterpretSwitch();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::GETREF: {
+            BCHIR_CASE(GETREF): {
                 InterpretGetRef();
-                continue;
+                BCHIR_NEXT();
             }
-            case OpCode::SYSCALL:
-            case OpCode::CAPPLY:
-            case OpCode::ABORT: {
+            BCHIR_CASE(SYSCALL):
+            BCHIR_CASE(CAPPLY):
+            BCHIR_CASE(ABORT): {
                 if (!isConstEval) {
                     FailWith(pc, "operation not currently supported in const eval", DiagKind::const_eval_unsupported);
                 }
                 interpreterError = true;
                 return;
             }
-            case OpCode::SPAWN:
-            case OpCode::NOT_SUPPORTED:
-            case OpCode::INVALID:
+            BCHIR_CASE(LVAR_FIELD): {
+                InterpretLVarField();
+                BCHIR_NEXT();
+            }
+            BCHIR_CASE(BIN_LT_BRANCH): {
+                InterpretCompareAndBranch<OpCode::BIN_LT>();
+                BCHIR_NEXT();
+            }
+            BCHIR_CASE(BIN_GT_BRANCH): {
+                InterpretCompareAndBranch<OpCode::BIN_GT>();
+                BCHIR_NEXT();
+            }
+            BCHIR_CASE(BIN_LE_BRANCH): {
+                InterpretCompareAndBranch<OpCode::BIN_LE>();
+                BCHIR_NEXT();
+            }
+            BCHIR_CASE(BIN_GE_BRANCH): {
+                InterpretCompareAndBranch<OpCode::BIN_GE>();
+                BCHIR_NEXT();
+            }
+            BCHIR_CASE(BIN_NOTEQ_BRANCH): {
+                InterpretCompareAndBranch<OpCode::BIN_NOTEQ>();
+                BCHIR_NEXT();
+            }
+            BCHIR_CASE(BIN_EQUAL_BRANCH): {
+                InterpretCompareAndBranch<OpCode::BIN_EQUAL>();
+                BCHIR_NEXT();
+            }
+            // operations which are never emitted or are handled inside other operations,
+            // listed so that every operation has an entry in the dispatch table
+            BCHIR_CASE(ALLOCATE_RAW_ARRAY_EXC):
+            BCHIR_CASE(ALLOCATE_RAW_ARRAY_LITERAL):
+            BCHIR_CASE(ALLOCATE_RAW_ARRAY_LITERAL_EXC):
+            BCHIR_CASE(ARRAY):
+            BCHIR_CASE(GET_EXCEPTION):
+            BCHIR_CASE(INTRINSIC0_EXC):
+            BCHIR_CASE(INTRINSIC1_EXC):
+            BCHIR_CASE(INTRINSIC2):
+            BCHIR_CASE(INTRINSIC2_EXC):
+            BCHIR_CASE(RAISE):
+            BCHIR_CASE(RAISE_EXC):
+            BCHIR_CASE(RAW_ARRAY_INIT_BY_VALUE):
+            BCHIR_CASE(SPAWN_EXC):
+            BCHIR_CASE(TYPECAST_EXC):
+            BCHIR_CASE(VARRAY_BY_VALUE):
+            BCHIR_CASE(SPAWN):
+            BCHIR_CASE(NOT_SUPPORTED):
+            BCHIR_CASE(INVALID):
             default: {
                 FailWith(pc, "operation not currently supported in interpreter", DiagKind::interp_unsupported,
                     "Interpret", GetOpCodeLabel(current));
@@ -614,6 +697,39 @@ void BCHIRInterpreter::Interpret()
     }
 }
 
+void BCHIRInterpreter::InterpretLVarField()
+{
+    // LVAR_FIELD :: VAR :: FIELD :: FIELD_IDX :: NEXT_OP
+    // only the field is copied, LVAR followed by FIELD would copy the whole local variable
+    auto var = bchir.Get(pc + 1);
+    auto field = bchir.Get(pc + Bchir::FLAG_THREE);
+    auto& local = env.GetLocal(var);
+    if (auto tuple = IValUtils::GetIf<ITuple>(&local)) {
+        interpStack.ArgsPushIValRef(tuple->content[field]);
+    } else {
+        CJC_ASSERT(std::holds_alternative<IObject>(local));
+        // -1 because we don't have the class node anymore
+        interpStack.ArgsPushIValRef(IValUtils::Get<IObject>(local).content[field - 1]);
+    }
+    pc += Bchir::FLAG_FOUR;
+}
+
+template <OpCode op> void BCHIRInterpreter::InterpretCompareAndBranch()
+{
+    // BIN_X_BRANCH :: TYPE_KIND :: OVERFLOW_STRAT :: BRANCH :: TRUE_IDX :: FALSE_IDX
+    BinOp<op>();
+    if (interpreterError || static_cast<OpCode>(bchir.Get(pc)) != OpCode::BRANCH) {
+        // the comparison did not complete normally, the main loop takes over
+        return;
+    }
+    auto cond = interpStack.ArgsPop<IBool>();
+    pc = cond.content ? bchir.Get(pc + 1) : bchir.Get(pc + Bchir::FLAG_TWO);
+}
+
+#undef BCHIR_CASE
+#undef BCHIR_NEXT
+#undef BCHIR_DEBUG_INFO
+
 void BCHIRInterpreter::InterpretString()
 {
     // String values in the interpreter must match the definition of strings in the core library
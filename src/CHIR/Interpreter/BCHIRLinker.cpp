@@ -354,6 +354,13 @@ void BCHIRLinker::TraverseAndLink(const Bchir& bchir, const Bchir::Definition& c
         AddMangledName(mangledNames, curr);
 #endif
         auto next = curr + GetOpCodeArgSize(op) + 1;
+        if (next < currentDef.NextIndex()) {
+            // the second operation of a superinstruction is linked as usual in the next iteration
+            auto fused = GetSuperInstruction(op, static_cast<OpCode>(currentDef.Get(next)));
+            if (fused != OpCode::INVALID) {
+                topDef.SetOp(topDef.NextIndex() - 1, fused);
+            }
+        }
         // pushing anything else
         switch (op) {
             case OpCode::GVAR: {
@@ -330,7 +330,8 @@ void BCHIRPrinter::DefinitionPrinter::PrintOP()
         case OpCode::GVAR_SET:
         case OpCode::LVAR_SET:
         case OpCode::GVAR:
-        case OpCode::LVAR: {
+        case OpCode::LVAR:
+        case OpCode::LVAR_FIELD: {
             PrintAtIndex();
             return;
         }
@@ -514,7 +515,13 @@ void BCHIRPrinter::DefinitionPrinter::PrintOP()
         case OpCode::BIN_BITOR:
         case OpCode::BIN_BITXOR:
         case OpCode::BIN_LSHIFT:
-        case OpCode::BIN_RSHIFT: {
+        case OpCode::BIN_RSHIFT:
+        case OpCode::BIN_LT_BRANCH:
+        case OpCode::BIN_GT_BRANCH:
+        case OpCode::BIN_LE_BRANCH:
+        case OpCode::BIN_GE_BRANCH:
+        case OpCode::BIN_NOTEQ_BRANCH:
+        case OpCode::BIN_EQUAL_BRANCH: {
             PrintOPBinRshift(opCode);
             return;
         }
@@ -46,9 +46,10 @@ bool CHIRDeserializer::Deserialize(const std::string& fileName, Cangjie::CHIR::C
         return false;
     }
     CHIRDeserializerImpl deserializer(chirBuilder, compilePlatform);
-    std::vector<uint8_t> serializationInfo;
     std::string failedReason;
-    if (!FileUtil::ReadBinaryFileToBuffer(fileName, serializationInfo, failedReason)) {
+    // Map the file rather than copy it, strings are copied out of the buffer while deserializing.
+    auto serializationInfo = FileUtil::MappedFile::Open(fileName, failedReason);
+    if (!serializationInfo) {
         Errorln(failedReason, ".");
         return false;
     }
@@ -56,13 +57,13 @@ bool CHIRDeserializer::Deserialize(const std::string& fileName, Cangjie::CHIR::C
     flatbuffers::Verifier::Options options;
     options.max_depth = std::numeric_limits<::flatbuffers::uoffset_t>::max();
     options.max_tables = std::numeric_limits<::flatbuffers::uoffset_t>::max();
-    flatbuffers::Verifier verifier(serializationInfo.data(), serializationInfo.size(), options);
+    flatbuffers::Verifier verifier(serializationInfo->Data(), serializationInfo->Size(), options);
     if (!verifier.VerifyBuffer<PackageFormat::CHIRPackage>()) {
         Errorln("validation of '", fileName, "' failed, please confirm it was created by compiler whose version is '",
             CANGJIE_VERSION, "'.");
         return false;
     }
-    const PackageFormat::CHIRPackage* package = PackageFormat::GetCHIRPackage(serializationInfo.data());
+    const PackageFormat::CHIRPackage* package = PackageFormat::GetCHIRPackage(serializationInfo->Data());
     deserializer.Run(package);
     phase = Cangjie::CHIR::ToCHIR::Phase(package->phase());
     return true;
@@ -1805,7 +1806,7 @@ template <> void CHIRDeserializer::CHIRDeserializerImpl::Config(const PackageFor
 
 Value* CHIRDeserializer::CHIRDeserializerImpl::GetValue(uint32_t id)
 {
-    if (id2Value.count(id) == 0) {
+    if (id != 0 && id2Value[id] == nullptr) {
         switch (PackageFormat::ValueElem(pool->values_type()->Get(id - 1))) {
             case PackageFormat::ValueElem_BoolLiteral:
                 id2Value[id] = Deserialize<BoolLiteral>(
@@ -1912,7 +1913,7 @@ template <typename T> T* CHIRDeserializer::CHIRDeserializerImpl::GetValue(uint32
 
 Type* CHIRDeserializer::CHIRDeserializerImpl::GetType(uint32_t id)
 {
-    if (id2Type.count(id) == 0) {
+    if (id != 0 && id2Type[id] == nullptr) {
         switch (PackageFormat::TypeElem(pool->types_type()->Get(id - 1))) {
             case PackageFormat::TypeElem_RuneType:
                 id2Type[id] =
@@ -2016,7 +2017,7 @@ template <typename T> T* CHIRDeserializer::CHIRDeserializerImpl::GetType(uint32_
 
 Expression* CHIRDeserializer::CHIRDeserializerImpl::GetExpression(uint32_t id)
 {
-    if (id2Expression.count(id) == 0) {
+    if (id != 0 && id2Expression[id] == nullptr) {
         switch (PackageFormat::ExpressionElem(pool->exprs_type()->Get(id - 1))) {
             case PackageFormat::ExpressionElem_UnaryExpression:
                 id2Expression[id] = Deserialize<UnaryExpression>(
@@ -2400,7 +2401,7 @@ template <typename T> T* CHIRDeserializer::CHIRDeserializerImpl::GetExpression(u
 
 CustomTypeDef* CHIRDeserializer::CHIRDeserializerImpl::GetCustomTypeDef(uint32_t id)
 {
-    if (id2CustomTypeDef.count(id) == 0) {
+    if (id != 0 && id2CustomTypeDef[id] == nullptr) {
         switch (PackageFormat::CustomTypeDefElem(pool->defs_type()->Get(id - 1))) {
             case PackageFormat::CustomTypeDefElem_EnumDef:
                 id2CustomTypeDef[id] =
@@ -2487,6 +2488,10 @@ void CHIRDeserializer::CHIRDeserializerImpl::ResetImportedDefsUnderPackage()
 void CHIRDeserializer::CHIRDeserializerImpl::Run(const PackageFormat::CHIRPackage* package)
 {
     pool = package;
+    id2Type.resize(pool->types()->size() + 1, nullptr);
+    id2Value.resize(pool->values()->size() + 1, nullptr);
+    id2Expression.resize(pool->exprs()->size() + 1, nullptr);
+    id2CustomTypeDef.resize(pool->defs()->size() + 1, nullptr);
     builder.CreatePackage(pool->name()->str());
     builder.GetCurPackage()->SetPackageAccessLevel(Package::AccessLevel(pool->pkgAccessLevel()));
     // To keep order, get CustomTypeDef first
@@ -18,6 +18,7 @@
 #include <fstream>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "cangjie/CHIR/CHIRBuilder.h"
 #include "cangjie/CHIR/CHIRContext.h"
@@ -62,11 +63,11 @@ private:
     bool compilePlatform = false;
     const PackageFormat::CHIRPackage* pool{};
 
-    // Package object maps
-    std::unordered_map<uint32_t, Type*> id2Type{{0, nullptr}};
-    std::unordered_map<uint32_t, Value*> id2Value{{0, nullptr}};
-    std::unordered_map<uint32_t, Expression*> id2Expression{{0, nullptr}};
-    std::unordered_map<uint32_t, CustomTypeDef*> id2CustomTypeDef{{0, nullptr}};
+    // Package object maps, indexed by id. Ids are dense from 1 and id 0 is null, so they are sized in `Run`.
+    std::vector<Type*> id2Type;
+    std::vector<Value*> id2Value;
+    std::vector<Expression*> id2Expression;
+    std::vector<CustomTypeDef*> id2CustomTypeDef;
 
     // lazy GenericType config
     std::vector<std::pair<GenericType*, const PackageFormat::GenericType*>> genericTypeConfig;
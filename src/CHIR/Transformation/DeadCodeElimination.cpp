@@ -902,6 +902,10 @@ bool DeadCodeElimination::CheckUselessFunc(const Func& func, const GlobalOptions
     if (IsExternalDecl(func)) {
         return false;
     }
+    // Weak_odr instantiations are recorded in the cjo, the packages importing this one may link to them.
+    if (func.Get<LinkTypeInfo>() == Linkage::WEAK_ODR && func.TestAttr(Attribute::GENERIC_INSTANTIATED)) {
+        return false;
+    }
     // The func is in vtable.
     if (func.IsVirtualFunc()) {
         return false;
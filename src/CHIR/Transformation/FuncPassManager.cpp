@@ -0,0 +1,49 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include "cangjie/CHIR/Transformation/FuncPassManager.h"
+
+#include <memory>
+
+#include "cangjie/Utils/TaskQueue.h"
+
+using namespace Cangjie::CHIR;
+
+void FuncPassManager::Run(const Package& package)
+{
+    if (passes.empty()) {
+        return;
+    }
+    std::vector<Func*> globalFuncs = package.GetGlobalFuncs();
+    if (threadNum <= 1) {
+        for (auto func : globalFuncs) {
+            for (auto& pass : passes) {
+                pass(*func, builder);
+            }
+        }
+        return;
+    }
+    size_t funcNum = globalFuncs.size();
+    std::vector<std::unique_ptr<CHIRBuilder>> builderList;
+    builderList.reserve(funcNum);
+    for (size_t idx = 0; idx < funcNum; ++idx) {
+        builderList.emplace_back(std::make_unique<CHIRBuilder>(builder.GetChirContext(), idx));
+    }
+    Utils::TaskQueue taskQueue(threadNum);
+    for (size_t idx = 0; idx < funcNum; ++idx) {
+        taskQueue.AddTask<void>([this, func = globalFuncs[idx], subBuilder = builderList[idx].get()]() {
+            for (auto& pass : passes) {
+                pass(*func, *subBuilder);
+            }
+        });
+    }
+    taskQueue.RunAndWaitForAllTasksCompleted();
+    // Merge in function order, the same order as a serial run allocates.
+    for (auto& subBuilder : builderList) {
+        subBuilder->MergeAllocatedInstance();
+    }
+    builder.GetChirContext().MergeTypes();
+}
@@ -12,7 +12,10 @@
 
 #include "cangjie/CHIR/Transformation/FunctionInline.h"
 
+#include <fstream>
 #include <list>
+#include <sstream>
+#include <unordered_set>
 
 #include "cangjie/CHIR/CHIRCasting.h"
 #include "cangjie/CHIR/Expression/Terminator.h"
@@ -21,6 +24,7 @@
 #include "cangjie/CHIR/Utils.h"
 #include "cangjie/CHIR/Visitor/Visitor.h"
 #include "cangjie/CHIR/Transformation/BlockGroupCopyHelper.h"
+#include "cangjie/Basic/StringConvertor.h"
 
 using namespace Cangjie::CHIR;
 
@@ -41,6 +45,21 @@ constexpr static size_t INCREASE_WHEN_CALLEE_WITH_LAMBDA_ARG = 2;
 // Set the threshold of CHIR in one block for inline
 constexpr static size_t INLINED_BLOCKSIZE_THRESHOLD = 10000;
 
+// Loop levels beyond this one do not raise the threshold any further
+constexpr static size_t MAX_LOOP_DEPTH_BONUS = 3;
+
+// A call site is hot when its count is at least 1/HOT_COUNT_RATIO of the hottest call site in the profile
+constexpr static uint64_t HOT_COUNT_RATIO = 100;
+
+// Step of the threshold for hot call sites
+constexpr static size_t INCREASE_WHEN_HOT_CALL_SITE = 2;
+
+// Threshold of call sites which never ran in the profile
+constexpr static size_t COLD_CALL_SITE_THRESHOLD = INIT_INLINE_THRESHOLD / 2;
+
+// Longer counts may not fit into 64 bits
+constexpr static size_t MAX_COUNT_DIGITS = 19;
+
 static const std::vector<FuncInfo> functionInlineWhiteList = {
     FuncInfo("get", "Array", {NOT_CARE}, ANY_TYPE, "std.core"),
     FuncInfo("set", "Array", {NOT_CARE}, ANY_TYPE, "std.core"),
@@ -71,8 +90,158 @@ static const std::vector<FuncInfo> functionInlineBlackList = {
     FuncInfo("wrappingShr", NOT_CARE, {NOT_CARE}, ANY_TYPE, "std.overflow"),
 };
 
+bool InlineProfile::Load(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream entry(line);
+        std::string caller;
+        std::string callee;
+        std::string countStr;
+        std::string rest;
+        // Exactly three fields, and a count of decimal digits: stream extraction would wrap a negative count.
+        if (!(entry >> caller >> callee >> countStr) || entry >> rest || countStr.size() > MAX_COUNT_DIGITS ||
+            !std::all_of(countStr.begin(), countStr.end(), [](char c) { return std::isdigit(c) != 0; })) {
+            continue;
+        }
+        uint64_t count = std::stoull(countStr);
+        auto& total = counts[caller + " " + callee];
+        // Saturate, a wrapped sum would turn the hottest call site cold.
+        total = count > std::numeric_limits<uint64_t>::max() - total ? std::numeric_limits<uint64_t>::max()
+                                                                     : total + count;
+        maxCount = std::max(maxCount, total);
+    }
+    return true;
+}
+
+std::optional<uint64_t> InlineProfile::GetCount(const std::string& caller, const std::string& callee) const
+{
+    if (auto it = counts.find(caller + " " + callee); it != counts.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+/**
+ * Loop nesting depth of the blocks of @p group from the back edges of its control flow graph. A back edge goes from
+ * a block to one of its ancestors in the depth-first tree, and its loop is the header plus every descendant of the
+ * header in that tree which reaches the tail without passing through the header. In a reducible graph this is the
+ * natural loop. In an irreducible one the header does not dominate the loop, and the descendant check keeps the
+ * blocks before the loop out of it.
+ */
+static std::unordered_map<const Block*, size_t> GetCFGLoopDepth(const BlockGroup& group)
+{
+    std::unordered_map<const Block*, size_t> depth;
+    auto entry = group.GetEntryBlock();
+    if (entry == nullptr) {
+        return depth;
+    }
+    struct Frame {
+        Block* block;
+        std::vector<Block*> succs;
+        size_t next;
+    };
+    // The order in which each block is entered and left by the depth-first search, a block is a descendant of
+    // another iff it is entered after and left before it. A block still on the stack has not been left yet.
+    constexpr size_t onStack = std::numeric_limits<size_t>::max();
+    std::unordered_map<const Block*, std::pair<size_t, size_t>> order;
+    size_t clock = 0;
+    std::vector<std::pair<Block*, Block*>> backEdges;
+    std::vector<Frame> stack{{entry, entry->GetSuccessors(), 0}};
+    order[entry] = {clock++, onStack};
+    while (!stack.empty()) {
+        auto& frame = stack.back();
+        if (frame.next == frame.succs.size()) {
+            order[frame.block].second = clock++;
+            stack.pop_back();
+            continue;
+        }
+        auto succ = frame.succs[frame.next++];
+        if (auto it = order.find(succ); it == order.end()) {
+            order[succ] = {clock++, onStack};
+            stack.push_back({succ, succ->GetSuccessors(), 0});
+        } else if (it->second.second == onStack) {
+            backEdges.emplace_back(frame.block, succ);
+        }
+    }
+    auto isDescendant = [&order](const Block* block, const Block* ancestor) {
+        auto it = order.find(block);
+        auto& range = order[ancestor];
+        return it != order.end() && it->second.first >= range.first && it->second.second <= range.second;
+    };
+    // Back edges sharing a header form one loop.
+    std::unordered_map<Block*, std::unordered_set<Block*>> loops;
+    for (auto [tail, header] : backEdges) {
+        auto& body = loops[header];
+        body.emplace(header);
+        std::vector<Block*> worklist{tail};
+        while (!worklist.empty()) {
+            auto block = worklist.back();
+            worklist.pop_back();
+            if (!isDescendant(block, header) || !body.emplace(block).second) {
+                continue;
+            }
+            for (auto pred : block->GetPredecessors()) {
+                if (pred->GetParentBlockGroup() == &group) {
+                    worklist.emplace_back(pred);
+                }
+            }
+        }
+    }
+    for (auto& [header, body] : loops) {
+        for (auto block : body) {
+            ++depth[block];
+        }
+    }
+    return depth;
+}
+
+void FunctionInline::CollectLoopDepth(const BlockGroup& group, size_t baseDepth)
+{
+    auto cfgDepth = GetCFGLoopDepth(group);
+    for (auto block : group.GetBlocks()) {
+        size_t depth = baseDepth;
+        if (auto it = cfgDepth.find(block); it != cfgDepth.end()) {
+            depth += it->second;
+        }
+        for (auto e : block->GetExpressions()) {
+            if (e->GetExprKind() == ExprKind::APPLY) {
+                loopDepthMap[StaticCast<Apply*>(e)] = depth;
+                continue;
+            }
+            // Structured loops which are not lowered yet, lambdas are handled when they are visited.
+            if (e->GetExprKind() == ExprKind::LOOP || Is<ForIn>(*e)) {
+                for (auto bg : e->GetBlockGroups()) {
+                    CollectLoopDepth(*bg, depth + 1);
+                }
+            } else if (e->GetExprKind() == ExprKind::IF) {
+                for (auto bg : e->GetBlockGroups()) {
+                    CollectLoopDepth(*bg, depth);
+                }
+            }
+        }
+    }
+}
+
+size_t FunctionInline::GetLoopDepth(const Apply& apply) const
+{
+    // Applies cloned from inlined callees are not recorded, they are not visited in this round either.
+    if (auto it = loopDepthMap.find(&apply); it != loopDepthMap.end()) {
+        return it->second;
+    }
+    return 0;
+}
+
 void FunctionInline::InlineImpl(BlockGroup& bg)
 {
+    CollectLoopDepth(bg, 0);
     auto postVisit = [this](Expression& e) {
         if (e.GetExprKind() == ExprKind::LAMBDA) {
             auto lambda = StaticCast<Lambda*>(&e);
@@ -95,6 +264,7 @@ void FunctionInline::InlineImpl(BlockGroup& bg)
 void FunctionInline::Run(Func& func)
 {
     globalFunc = &func;
+    loopDepthMap.clear();
     InlineImpl(*func.GetBody());
 }
 
@@ -155,8 +325,7 @@ static bool IsHotSpotCall(const Func& callee)
     if (callee.TestAttr(Attribute::OPERATOR)) {
         return true;
     }
-    // Case B: the call site is located in a loop
-    // note: currently unsupported
+    // Case B: call sites located in loops are handled per call site by `FunctionInline::CalculateThreshold`
     return false;
 }
 
@@ -170,7 +339,7 @@ static bool FunctionWithLambdaArg(const Func& func)
     return false;
 }
 
-static size_t CalculateThreshold(const Value& callee, const Cangjie::GlobalOptions::OptimizationLevel& optLevel)
+static size_t CalculateBaseThreshold(const Value& callee, const Cangjie::GlobalOptions::OptimizationLevel& optLevel)
 {
     size_t realThreshold = INIT_INLINE_THRESHOLD;
     auto func = Cangjie::DynamicCast<const Func*>(&callee);
@@ -219,11 +388,62 @@ static size_t CountFuncSize(const Func& func)
     return funcSize;
 }
 
+size_t FunctionInline::CalculateThreshold(const Apply& apply, const Func& callee, InlineRemark& remark) const
+{
+    size_t realThreshold = CalculateBaseThreshold(callee, optLevel);
+    remark.loopDepth = GetLoopDepth(apply);
+    if (optLevel < Cangjie::GlobalOptions::OptimizationLevel::Os) {
+        // Increase the threshold value by 20% for each loop level the call site is in
+        realThreshold += INIT_INLINE_THRESHOLD / INCREASE_THRESHOLD * std::min(remark.loopDepth, MAX_LOOP_DEPTH_BONUS);
+    }
+    if (profile != nullptr) {
+        remark.count = profile->GetCount(globalFunc->GetIdentifierWithoutPrefix(), callee.GetIdentifierWithoutPrefix());
+    }
+    if (remark.count.has_value()) {
+        // The least count with count * HOT_COUNT_RATIO >= maxCount, computed without overflowing
+        auto maxCount = profile->GetMaxCount();
+        auto hotCount = maxCount / HOT_COUNT_RATIO + (maxCount % HOT_COUNT_RATIO != 0 ? 1 : 0);
+        if (remark.count.value() == 0) {
+            realThreshold = std::min(realThreshold, COLD_CALL_SITE_THRESHOLD);
+        } else if (remark.count.value() >= hotCount) {
+            realThreshold *= INCREASE_WHEN_HOT_CALL_SITE;
+        }
+    }
+    // The size of callee is not counted beyond `SEARCH_THRESHOLD`
+    return std::min(realThreshold, SEARCH_THRESHOLD - 1);
+}
+
+void FunctionInline::EmitRemark(const Apply& apply, bool inlined, const InlineRemark& remark) const
+{
+    if (remarks == nullptr) {
+        return;
+    }
+    auto quote = [](const std::string& str) { return "\"" + Cangjie::StringConvertor::EscapeToJsonString(str) + "\""; };
+    auto optionalNum = [](const auto& num) { return num.has_value() ? std::to_string(num.value()) : "null"; };
+    auto& loc = apply.GetDebugLocation();
+    auto pos = loc.GetBeginPos();
+    *remarks << "{\"pass\":" << quote(optName) << ",\"caller\":" << quote(globalFunc->GetIdentifierWithoutPrefix())
+             << ",\"callee\":" << quote(apply.GetCallee()->GetIdentifierWithoutPrefix())
+             << ",\"file\":" << quote(loc.GetAbsPath()) << ",\"line\":" << pos.line << ",\"column\":" << pos.column
+             << ",\"inlined\":" << (inlined ? "true" : "false") << ",\"reason\":" << quote(remark.reason)
+             << ",\"size\":" << optionalNum(remark.size) << ",\"threshold\":" << optionalNum(remark.threshold)
+             << ",\"loopDepth\":" << remark.loopDepth << ",\"count\":" << optionalNum(remark.count) << "}\n";
+}
+
 bool FunctionInline::CheckCanRewrite(const Apply& apply)
+{
+    InlineRemark remark;
+    bool res = ShouldInline(apply, remark);
+    EmitRemark(apply, res, remark);
+    return res;
+}
+
+bool FunctionInline::ShouldInline(const Apply& apply, InlineRemark& remark)
 {
     auto callee = apply.GetCallee();
     // imported func decl, intrinsic func decl, foreign func decl are excluded
     if (!callee->IsFuncWithBody()) {
+        remark.reason = "callee has no body";
         return false;
     }
     auto func = VirtualCast<Func*>(callee);
@@ -231,6 +451,7 @@ bool FunctionInline::CheckCanRewrite(const Apply& apply)
 
     // when the terminator of this block is RaiseException, do not inline this apply because it rarely happens
     if (auto block = apply.GetParentBlock(); Is<RaiseException>(block->GetTerminator())) {
+        remark.reason = "block raises exception";
         return false;
     }
 
@@ -238,28 +459,35 @@ bool FunctionInline::CheckCanRewrite(const Apply& apply)
     // threshold to avoid the huge time consume.
     auto block = apply.GetParentBlock();
     if (block->GetExpressions().size() >= INLINED_BLOCKSIZE_THRESHOLD) {
+        remark.reason = "block too large";
         return false;
     }
 
     // recursive function doesn't need to inline
     // if you really want to inline it, yes, you can, it won't cause a problem
     if (callee == globalFunc) {
+        remark.reason = "recursive call";
         return false;
     }
     if (InBlackList(*func)) {
+        remark.reason = "callee in black list";
         return false;
     }
     if (InWhiteList(*func)) {
+        remark.reason = "callee in white list";
         return true;
     }
     if (func->GetFuncKind() == FuncKind::INSTANCEVAR_INIT) {
+        remark.reason = "instance variable initializer";
         return true;
     }
     // Determine if we can inline by checking the size of callee exceed the threshold
     if (inlinedCountMap[globalFunc] >= INLINED_COUNT_THRESHOLD) {
+        remark.reason = "too many calls inlined into caller";
         return false;
     }
-    size_t realThreshold = CalculateThreshold(*callee, optLevel);
+    size_t realThreshold = CalculateThreshold(apply, *func, remark);
+    remark.threshold = realThreshold;
     // `res` is std::pair<iterator, bool>, so
     // `res.second == true` means `callee` is emplaced successfully, then we must set correct function size
     // `res.second == false` means `callee` has already been emplaced before, we can use its size directly
@@ -267,10 +495,13 @@ bool FunctionInline::CheckCanRewrite(const Apply& apply)
     if (res.second) {
         res.first->second = CountFuncSize(*func);
     }
+    remark.size = res.first->second;
     if (res.first->second <= realThreshold) {
+        remark.reason = "callee size within threshold";
         inlinedCountMap[globalFunc]++;
         return true;
     }
+    remark.reason = "callee size over threshold";
     return false;
 }
 
@@ -49,6 +49,7 @@ void CGContext::Clear()
     globalsOfCompileUnit.clear();
 #ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
     llvmUsedGVs.clear();
+    sharedInstantiations.clear();
     subCHIRPackage.Clear();
     callBasesToInline.clear();
     callBasesToReplace.clear();
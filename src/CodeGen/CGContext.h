@@ -318,6 +318,15 @@ public:
         return llvmUsedGVs;
     }
 
+    void AddSharedInstantiation(const std::string& funcName)
+    {
+        (void)sharedInstantiations.emplace(funcName);
+    }
+    const std::set<std::string>& GetSharedInstantiations() const
+    {
+        return sharedInstantiations;
+    }
+
     void AddNullableReference(llvm::Value* value);
 
     void SetBasePtr(const llvm::Value* val, llvm::Value* basePtr);
@@ -385,6 +394,8 @@ private:
     // linkage into llvm.used to prevent them from being eliminated by llvm-opt.
     std::set<std::string> llvmUsedGVs;
     std::set<std::string> staticGINames;
+    // Instantiated functions which are linkonce_odr or weak_odr because every package using them emits the same body.
+    std::set<std::string> sharedInstantiations;
     std::vector<std::string> reflectGeneratedStaticGINames;
     std::vector<std::pair<llvm::CallBase*, llvm::ReturnInst*>> callBasesToInline;
     std::vector<CallBaseToReplaceInfo> callBasesToReplace;
@@ -309,6 +309,12 @@ CGFunction* CGModule::GetOrInsertCGFunction(const CHIR::Value* func, bool forWra
     if (func->IsFuncWithBody()) {
         bool markByMD = cgCtx->IsCGParallelEnabled() && !IsCHIRWrapper(func->GetIdentifierWithoutPrefix());
         AddLinkageTypeMetadata(*function, CHIRLinkage2LLVMLinkage(chirLinkage), markByMD);
+#ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
+        if (chirLinkage == Linkage::LINKONCE_ODR ||
+            (chirLinkage == Linkage::WEAK_ODR && chirFunc->TestAttr(CHIR::Attribute::GENERIC_INSTANTIATED))) {
+            cgCtx->AddSharedInstantiation(function->getName().str());
+        }
+#endif
     } else if (chirLinkage == Linkage::EXTERNAL_WEAK) {
         // Import function in if branch of @IfAvailable need to mark as EXTERNAL_WEAK.
         function->setLinkage(llvm::GlobalValue::ExternalWeakLinkage);
@@ -12,7 +12,9 @@
 
 #include "CJNative/CHIRSplitter.h"
 
+#include <limits>
 #include <queue>
+#include <unordered_set>
 
 #include "llvm/IR/Module.h"
 #include "llvm/IRReader/IRReader.h"
@@ -23,6 +25,7 @@
 #include "Utils/CGUtils.h"
 #include "cangjie/Basic/StringConvertor.h"
 #include "cangjie/CHIR/CHIRCasting.h"
+#include "cangjie/CHIR/Expression/Terminator.h"
 #include "cangjie/CHIR/Package.h"
 #include "cangjie/CHIR/Type/EnumDef.h"
 #include "cangjie/CHIR/Type/StructDef.h"
@@ -38,8 +41,115 @@ std::size_t GetSubCHIRPackageIdx(std::size_t splitNum)
     static std::size_t counter = 0;
     return counter++ % splitNum;
 }
+
+// Weights of the codegen cost model. An expression costs one unit, calls are inline candidates which grow the
+// caller, and each level of loop nesting multiplies the cost since the backend unrolls and vectorizes loops.
+constexpr std::size_t CALL_COST = 2;
+constexpr std::size_t LOOP_COST_FACTOR = 2;
+constexpr std::size_t MAX_COUNTED_LOOP_DEPTH = 3;
+// Every SubCHIRPackage pays for its own type infos, metadata and backend run, so packages are not split into
+// pieces cheaper than this.
+constexpr std::size_t MIN_COST_PER_SPLIT = 2000;
+
+bool IsCall(CHIR::ExprKind kind)
+{
+    return kind == CHIR::ExprKind::APPLY || kind == CHIR::ExprKind::APPLY_WITH_EXCEPTION ||
+        kind == CHIR::ExprKind::INVOKE || kind == CHIR::ExprKind::INVOKE_WITH_EXCEPTION ||
+        kind == CHIR::ExprKind::INVOKESTATIC || kind == CHIR::ExprKind::INVOKESTATIC_WITH_EXCEPTION;
+}
+
+// Loops have been flattened before CodeGen, so they are found as back edges of a depth-first walk from the
+// entry block. The body of a loop is its header and every block reaching one of its latches without passing
+// the header, the loop depth of a block is the number of bodies it belongs to.
+std::unordered_map<const CHIR::Block*, std::size_t> CalcLoopDepths(const CHIR::BlockGroup& blockGroup)
+{
+    std::unordered_map<const CHIR::Block*, std::size_t> loopDepths;
+    auto entry = blockGroup.GetEntryBlock();
+    if (entry == nullptr) {
+        return loopDepths;
+    }
+    struct Frame {
+        CHIR::Block* block;
+        std::vector<CHIR::Block*> successors;
+        std::size_t next;
+    };
+    // The order in which each block is entered and left by the walk, a block is a descendant of another iff it is
+    // entered after and left before it. The blocks of an irreducible loop which are not descendants of the header
+    // are entered from outside of the loop, they are not counted as its body.
+    constexpr std::size_t onStack = std::numeric_limits<std::size_t>::max();
+    std::unordered_map<const CHIR::Block*, std::pair<std::size_t, std::size_t>> order;
+    std::size_t clock = 0;
+    std::vector<std::pair<CHIR::Block*, CHIR::Block*>> backEdges; // latch -> header
+    std::vector<Frame> stack{{entry, entry->GetSuccessors(), 0}};
+    order.emplace(entry, std::make_pair(clock++, onStack));
+    while (!stack.empty()) {
+        auto& frame = stack.back();
+        if (frame.next == frame.successors.size()) {
+            order[frame.block].second = clock++;
+            stack.pop_back();
+            continue;
+        }
+        auto succ = frame.successors[frame.next++];
+        if (auto it = order.find(succ); it == order.end()) {
+            order.emplace(succ, std::make_pair(clock++, onStack));
+            stack.push_back({succ, succ->GetSuccessors(), 0});
+        } else if (it->second.second == onStack) {
+            backEdges.emplace_back(frame.block, succ);
+        }
+    }
+    auto isDescendant = [&order](const CHIR::Block* block, const CHIR::Block* ancestor) {
+        auto it = order.find(block);
+        auto& range = order[ancestor];
+        return it != order.end() && it->second.first >= range.first && it->second.second <= range.second;
+    };
+    std::unordered_map<CHIR::Block*, std::unordered_set<CHIR::Block*>> loopBodies;
+    for (auto [latch, header] : backEdges) {
+        auto& body = loopBodies[header];
+        body.emplace(header);
+        std::vector<CHIR::Block*> worklist{latch};
+        while (!worklist.empty()) {
+            auto block = worklist.back();
+            worklist.pop_back();
+            if (!isDescendant(block, header) || !body.emplace(block).second) {
+                continue;
+            }
+            for (auto pred : block->GetPredecessors()) {
+                worklist.emplace_back(pred);
+            }
+        }
+    }
+    for (auto& [header, body] : loopBodies) {
+        for (auto block : body) {
+            ++loopDepths[block];
+        }
+    }
+    return loopDepths;
+}
 } // namespace
 
+std::size_t CHIRSplitter::EstimateCodeGenCost(const CHIR::BlockGroup& blockGroup)
+{
+    auto loopDepths = CalcLoopDepths(blockGroup);
+    std::size_t cost = 0;
+    for (auto block : blockGroup.GetBlocks()) {
+        auto it = loopDepths.find(block);
+        auto loopDepth = std::min(it == loopDepths.end() ? 0 : it->second, MAX_COUNTED_LOOP_DEPTH);
+        std::size_t factor = 1;
+        for (std::size_t i = 0; i < loopDepth; ++i) {
+            factor *= LOOP_COST_FACTOR;
+        }
+        for (auto expr : block->GetExpressions()) {
+            auto kind = expr->GetExprKind();
+            cost += (IsCall(kind) ? 1 + CALL_COST : 1) * factor;
+            // A lambda is emitted as a function of its own, its cost does not depend on where it is defined.
+            if (kind == CHIR::ExprKind::LAMBDA) {
+                cost += EstimateCodeGenCost(*StaticCast<CHIR::Lambda*>(expr)->GetBody());
+            }
+        }
+    }
+    return cost;
+}
+
 bool ChirTypeDefCmp::operator()(const CHIR::CustomTypeDef* lhs, const CHIR::CustomTypeDef* rhs) const
 {
     return lhs->GetIdentifierWithoutPrefix() < rhs->GetIdentifierWithoutPrefix();
@@ -51,7 +161,7 @@ bool ChirValueCmp::operator()(const CHIR::Value* lhs, const CHIR::Value* rhs) co
 }
 
 SubCHIRPackage::SubCHIRPackage(std::size_t splitNum)
-    : mainModule(false), subCHIRPackageIdx(GetSubCHIRPackageIdx(splitNum)), exprNumInChirFuncs(0), splitNum(splitNum)
+    : mainModule(false), subCHIRPackageIdx(GetSubCHIRPackageIdx(splitNum)), estimatedCost(0), splitNum(splitNum)
 {
 }
 
@@ -65,10 +175,23 @@ void SubCHIRPackage::Clear()
 }
 
 CHIRSplitter::CHIRSplitter(const CGPkgContext& cgPkgCtx)
-    : cgPkgCtx(cgPkgCtx), splitNum(0), index(0), subCHIRPackagesCache()
+    : cgPkgCtx(cgPkgCtx), splitNum(0), index(0), totalCost(0), subCHIRPackagesCache()
 {
 }
 
+// Estimate the cost of generating and compiling every global function, which is used to balance the
+// SubCHIRPackages instead of the bare number of expressions.
+void CHIRSplitter::EstimateFuncCosts()
+{
+    for (auto chirFunc : cgPkgCtx.GetCHIRPackage().GetGlobalFuncs()) {
+        auto cost = chirFunc->GetBody() ? EstimateCodeGenCost(*chirFunc->GetBody()) : 0;
+        funcCosts.emplace(chirFunc, cost);
+        totalCost += cost;
+    }
+}
+
+// The degree of parallelism given by `--apc` follows the number of jobs, it is the upper bound here. Small
+// packages are split into fewer SubCHIRPackages so that none of them is dominated by the per-module overhead.
 void CHIRSplitter::CalcSplitsNum()
 {
     if (subCHIRPackagesCache.splitNum.has_value()) {
@@ -79,6 +202,7 @@ void CHIRSplitter::CalcSplitsNum()
     auto& options = cgPkgCtx.GetGlobalOptions();
     auto& chirPkg = cgPkgCtx.GetCHIRPackage();
     splitNum = options.aggressiveParallelCompile.value_or(1);
+    splitNum = std::min(splitNum, std::max(totalCost / MIN_COST_PER_SPLIT, static_cast<std::size_t>(1)));
     if (splitNum > chirPkg.GetGlobalFuncs().size()) {
         splitNum = chirPkg.GetGlobalFuncs().size();
     }
@@ -92,6 +216,7 @@ std::vector<SubCHIRPackage> CHIRSplitter::SplitCHIRPackage()
     Utils::ProfileRecorder recorder("EmitIR", "SplitCHIRPackage");
 
     LoadSubCHIRPackagesInfo();
+    EstimateFuncCosts();
     CalcSplitsNum(); // Compute the degree of parallelism
     std::vector<SubCHIRPackage> subCHIRPackages;
     subCHIRPackages.reserve(splitNum);
@@ -113,8 +238,8 @@ namespace {
 struct SubCHIRPackageCmp {
     bool operator()(const SubCHIRPackage& lhs, const SubCHIRPackage& rhs) const
     {
-        return lhs.exprNumInChirFuncs == rhs.exprNumInChirFuncs ? lhs.subCHIRPackageIdx < rhs.subCHIRPackageIdx
-                                                                : lhs.exprNumInChirFuncs < rhs.exprNumInChirFuncs;
+        return lhs.estimatedCost == rhs.estimatedCost ? lhs.subCHIRPackageIdx < rhs.subCHIRPackageIdx
+                                                      : lhs.estimatedCost < rhs.estimatedCost;
     }
 };
 
@@ -132,8 +257,8 @@ auto FindTargetSubCHIRPackage(const CHIR::Value& chirValue,
 };
 
 void SplitSpecialFuncs(CHIR::Func& globalInitFunc, CHIR::Func& globalInitLiteralFunc,
-    const std::vector<CHIR::Func*>& toAnyFuncs, std::set<SubCHIRPackage, SubCHIRPackageCmp>& subCHIRPackagesSet,
-    std::map<std::string, std::size_t>& cache)
+    const std::vector<CHIR::Func*>& toAnyFuncs, const std::unordered_map<const CHIR::Func*, std::size_t>& funcCosts,
+    std::set<SubCHIRPackage, SubCHIRPackageCmp>& subCHIRPackagesSet, std::map<std::string, std::size_t>& cache)
 {
     auto target = FindTargetSubCHIRPackage(globalInitFunc, subCHIRPackagesSet, cache);
     auto targetSubCHIRPackage = subCHIRPackagesSet.extract(target);
@@ -141,12 +266,12 @@ void SplitSpecialFuncs(CHIR::Func& globalInitFunc, CHIR::Func& globalInitLiteral
     subCHIRPackage.mainModule = true;
     subCHIRPackage.chirFuncs.emplace(&globalInitFunc);
     subCHIRPackage.chirFuncs.emplace(&globalInitLiteralFunc);
-    subCHIRPackage.exprNumInChirFuncs += globalInitFunc.GetExpressionsNum() + globalInitLiteralFunc.GetExpressionsNum();
+    subCHIRPackage.estimatedCost += funcCosts.at(&globalInitFunc) + funcCosts.at(&globalInitLiteralFunc);
     cache.emplace(globalInitFunc.GetIdentifierWithoutPrefix(), subCHIRPackage.subCHIRPackageIdx);
     cache.emplace(globalInitLiteralFunc.GetIdentifierWithoutPrefix(), subCHIRPackage.subCHIRPackageIdx);
     for (auto toAny : toAnyFuncs) {
         subCHIRPackage.chirFuncs.emplace(toAny);
-        subCHIRPackage.exprNumInChirFuncs += toAny->GetExpressionsNum();
+        subCHIRPackage.estimatedCost += funcCosts.at(toAny);
         cache.emplace(toAny->GetIdentifierWithoutPrefix(), subCHIRPackage.subCHIRPackageIdx);
     }
     subCHIRPackagesSet.insert(std::move(targetSubCHIRPackage));
@@ -161,7 +286,7 @@ void SplitNormalFunc(const std::multimap<std::size_t, CHIR::Func*>& sortedChirFu
         auto targetSubCHIRPackage = subCHIRPackagesSet.extract(target);
         auto& subCHIRPackage = targetSubCHIRPackage.value();
         subCHIRPackage.chirFuncs.emplace(func);
-        subCHIRPackage.exprNumInChirFuncs += iter->first;
+        subCHIRPackage.estimatedCost += iter->first;
         cache.emplace(func->GetIdentifierWithoutPrefix(), subCHIRPackage.subCHIRPackageIdx);
         subCHIRPackagesSet.insert(std::move(targetSubCHIRPackage));
     }
@@ -181,7 +306,7 @@ void SplitForeign(const CHIR::Package& chirPkg, std::set<SubCHIRPackage, SubCHIR
         auto targetSubCHIRPackage = subCHIRPackagesSet.extract(target);
         auto& subCHIRPackage = targetSubCHIRPackage.value();
         subCHIRPackage.chirForeigns.emplace(foreign);
-        subCHIRPackage.exprNumInChirFuncs += 1;
+        subCHIRPackage.estimatedCost += 1;
         cache.emplace(foreign->GetIdentifierWithoutPrefix(), subCHIRPackage.subCHIRPackageIdx);
         subCHIRPackagesSet.insert(std::move(targetSubCHIRPackage));
     }
@@ -189,7 +314,7 @@ void SplitForeign(const CHIR::Package& chirPkg, std::set<SubCHIRPackage, SubCHIR
 }; // namespace
 
 // Split chirPkg.GetGlobalFuncs evenly into splitNum subCHIRPackages,
-// so that the total number of expressions of all functions in each subCHIRPackage is close to.
+// so that the total estimated cost of all functions in each subCHIRPackage is close to.
 void CHIRSplitter::SplitCHIRFuncs(std::vector<SubCHIRPackage>& subCHIRPackages)
 {
     std::set<SubCHIRPackage, SubCHIRPackageCmp> subCHIRPackagesSet;
@@ -198,7 +323,7 @@ void CHIRSplitter::SplitCHIRFuncs(std::vector<SubCHIRPackage>& subCHIRPackages)
     }
 
     auto& chirPkg = cgPkgCtx.GetCHIRPackage();
-    // 1. Sorts chirFuncs based on the number of expressions in a chirFunc.
+    // 1. Sorts chirFuncs based on the estimated cost of a chirFunc.
     auto globalInitFunc = chirPkg.GetPackageInitFunc();
     std::string globalInitFuncName = globalInitFunc->GetIdentifierWithoutPrefix();
     // init func must have suffix iiHv, index 4 is the start of ii. 2 is the length of il.
@@ -210,12 +335,12 @@ void CHIRSplitter::SplitCHIRFuncs(std::vector<SubCHIRPackage>& subCHIRPackages)
         if (chirPkg.GetName() == REFLECT_PACKAGE_NAME && chirFunc->GetSrcCodeIdentifier() == "toAny") {
             toAnyFuncs.emplace_back(chirFunc);
         } else if (chirFunc != globalInitFunc && chirFunc != globalInitLiteralFunc) {
-            sortedChirFuncs.emplace(chirFunc->GetExpressionsNum(), chirFunc);
+            sortedChirFuncs.emplace(funcCosts.at(chirFunc), chirFunc);
         }
     }
-    // 2. Add the chirFunc with the most expressions to the subCHIRPackage with the least exprNumInChirFuncs.
-    SplitSpecialFuncs(
-        *globalInitFunc, *globalInitLiteralFunc, toAnyFuncs, subCHIRPackagesSet, subCHIRPackagesCache.funcsCache);
+    // 2. Add the most costly chirFunc to the subCHIRPackage with the least estimatedCost.
+    SplitSpecialFuncs(*globalInitFunc, *globalInitLiteralFunc, toAnyFuncs, funcCosts, subCHIRPackagesSet,
+        subCHIRPackagesCache.funcsCache);
     SplitNormalFunc(sortedChirFuncs, subCHIRPackagesSet, subCHIRPackagesCache.funcsCache);
     SplitForeign(chirPkg, subCHIRPackagesSet, subCHIRPackagesCache.foreignsCache);
 
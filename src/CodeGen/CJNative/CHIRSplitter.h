@@ -11,6 +11,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Cangjie {
@@ -25,6 +26,7 @@ class Value;
 class FuncBase;
 class Func;
 class ImportedFunc;
+class BlockGroup;
 }
 namespace CodeGen {
 class CGPkgContext;
@@ -40,7 +42,7 @@ struct ChirValueCmp {
 struct SubCHIRPackage {
     bool mainModule = false;
     std::size_t subCHIRPackageIdx;
-    std::size_t exprNumInChirFuncs;
+    std::size_t estimatedCost; // Predicted codegen cost of the functions, see `CHIRSplitter::EstimateFuncCosts`.
     std::size_t splitNum;
     std::set<CHIR::CustomTypeDef*, ChirTypeDefCmp> chirCustomDefs;
     std::set<CHIR::GlobalVar*, ChirValueCmp> chirGVs;
@@ -58,6 +60,12 @@ public:
 
     std::vector<SubCHIRPackage> SplitCHIRPackage();
 
+    /**
+     * Estimate the cost of generating and compiling @p blockGroup: an expression costs one unit and a call three, as
+     * an inline candidate, and each level of loop nesting up to 3 doubles the cost.
+     */
+    static std::size_t EstimateCodeGenCost(const CHIR::BlockGroup& blockGroup);
+
 private:
     struct SubCHIRPackagesCache {
         std::optional<std::size_t> splitNum = std::nullopt;
@@ -71,6 +79,7 @@ private:
         std::map<std::string, std::size_t> importedCFuncsCache;
     };
 
+    void EstimateFuncCosts();
     void CalcSplitsNum();
 
     void SplitCHIRFuncs(std::vector<SubCHIRPackage>& subCHIRPackages);
@@ -89,6 +98,8 @@ private:
     const CGPkgContext& cgPkgCtx;
     std::size_t splitNum;
     std::size_t index;
+    std::unordered_map<const CHIR::Func*, std::size_t> funcCosts;
+    std::size_t totalCost;
 
     SubCHIRPackagesCache subCHIRPackagesCache;
 };
@@ -20,6 +20,7 @@
 #include "Utils/CGUtils.h"
 #include "cangjie/CHIR/Package.h"
 #include "cangjie/CHIR/Value.h"
+#include "cangjie/Utils/ProfileRecorder.h"
 
 namespace {
 using namespace Cangjie;
@@ -232,6 +233,11 @@ void FunctionGeneratorImpl::EmitIR()
 
 void EmitFunctionIR(CGModule& cgMod, const CHIR::Func& chirFunc)
 {
+    // The identifier is built only when tracing, this is called for every function.
+    std::optional<Utils::TraceScope> trace;
+    if (Utils::ProfileRecorder::IsTraceEnabled()) {
+        trace.emplace("CodeGen", chirFunc.GetIdentifierWithoutPrefix());
+    }
     IRGenerator<FunctionGeneratorImpl>(cgMod, chirFunc).EmitIR();
 }
 
@@ -6,6 +6,8 @@
 
 #include "cangjie/CodeGen/EmitPackageIR.h"
 
+#include <chrono>
+
 #include "llvm/IR/Verifier.h"
 
 #include "Base/CGTypes/CGEnumType.h"
@@ -287,6 +289,20 @@ void SetSymbolLinkageType(const CGModule& cgMod)
             cgMod.GetCGContext().AddLocalizedSymbol(globalObject.getName().str());
         }
     }
+    // Generic instantiations emitted by several packages are linkonce_odr, or weak_odr when dependent packages may
+    // link to them. Putting each of them in a COMDAT of its own name lets the linker drop the duplicated code, not
+    // only the duplicated symbols. Mach-O has no COMDAT, its linker coalesces weak definitions by itself. Other
+    // linkonce_odr globals, e.g. TypeInfos, keep their linkage as it was before.
+    if (cgMod.GetCGContext().GetCompileOptions().target.IsMacOS()) {
+        return;
+    }
+    for (auto& funcName : cgMod.GetCGContext().GetSharedInstantiations()) {
+        auto function = llvmModule->getFunction(funcName);
+        if (function && !function->isDeclaration() &&
+            (function->hasLinkOnceODRLinkage() || function->hasWeakODRLinkage()) && !function->hasComdat()) {
+            function->setComdat(llvmModule->getOrInsertComdat(funcName));
+        }
+    }
 }
 
 /*
@@ -346,6 +362,7 @@ void EmitCJSDKVersion(const CGModule& cgMod)
 
 void GenSubCHIRPackage(CGModule& cgMod)
 {
+    Utils::TraceScope trace("CodeGen", cgMod.GetLLVMModule()->getSourceFileName());
     auto& subCHIRPkg = cgMod.GetCGContext().GetSubCHIRPackage();
     EmitTIOrTTForCustomDefs(cgMod);
     EmitGlobalVariableIR(cgMod, std::vector<CHIR::GlobalVar*>(subCHIRPkg.chirGVs.begin(), subCHIRPkg.chirGVs.end()));
@@ -468,18 +485,26 @@ private:
         if (globalOptions.NeedDumpIRToFile()) {
             ClearOldIRDumpFiles(globalOptions.output, cgPkgCtx.GetCurrentPkgName());
         }
+        std::vector<int64_t> elapsedTimes(cgMods.size(), 0);
+        auto genSubCHIRPackage = [&cgMods, &elapsedTimes](size_t idx) {
+            auto start = std::chrono::steady_clock::now();
+            GenSubCHIRPackage(*cgMods[idx]);
+            elapsedTimes[idx] = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        };
         size_t threadNum = cgPkgCtx.GetGlobalOptions().codegenDebugMode ? 1 : cgMods.size();
         if (threadNum == 1) {
-            for (auto& cgMod : cgMods) {
-                GenSubCHIRPackage(*cgMod);
+            for (size_t idx = 0; idx < cgMods.size(); ++idx) {
+                genSubCHIRPackage(idx);
             }
         } else {
             Utils::TaskQueue taskQueueCHIRIR2LLVMIR(threadNum);
-            for (auto& cgMod : cgMods) {
-                taskQueueCHIRIR2LLVMIR.AddTask<void>([&cgMod]() { GenSubCHIRPackage(*cgMod); });
+            for (size_t idx = 0; idx < cgMods.size(); ++idx) {
+                taskQueueCHIRIR2LLVMIR.AddTask<void>([&genSubCHIRPackage, idx]() { genSubCHIRPackage(idx); });
             }
             taskQueueCHIRIR2LLVMIR.RunAndWaitForAllTasksCompleted();
         }
+        RecordLoadBalance(elapsedTimes);
         if (cgPkgCtx.GetGlobalOptions().NeedDumpIRToScreen()) {
             for (auto& cgMod : cgPkgCtx.GetCGModules()) {
                 DumpIR(*cgMod->GetLLVMModule());
@@ -487,6 +512,25 @@ private:
         }
         Utils::ProfileRecorder::Stop("EmitIR", "GenSubCHIRPackages");
     }
+
+    // Record the cost predicted by CHIRSplitter and the measured time of each module, and their imbalance.
+    void RecordLoadBalance(const std::vector<int64_t>& elapsedTimes)
+    {
+        if (!Utils::ProfileRecorder::IsEnabled()) {
+            return;
+        }
+        auto& cgMods = cgPkgCtx.GetCGModules();
+        std::vector<int64_t> costs;
+        for (size_t idx = 0; idx < cgMods.size(); ++idx) {
+            auto cost = static_cast<int64_t>(cgMods[idx]->GetCGContext().GetSubCHIRPackage().estimatedCost);
+            auto moduleName = cgMods[idx]->GetLLVMModule()->getSourceFileName();
+            Utils::ProfileRecorder::RecordCodeInfo("codegen predicted cost(" + moduleName + ")", cost);
+            Utils::ProfileRecorder::RecordCodeInfo("codegen measured time(us)(" + moduleName + ")", elapsedTimes[idx]);
+            costs.emplace_back(cost);
+        }
+        Utils::ProfileRecorder::RecordImbalance("codegen predicted imbalance(%)", costs);
+        Utils::ProfileRecorder::RecordImbalance("codegen measured imbalance(%)", elapsedTimes);
+    }
 #endif
 
 private:
@@ -83,6 +83,7 @@ void DeleteFuncBody(llvm::Function* func)
         (void)func->begin()->eraseFromParent();
     }
     func->clearMetadata();
+    func->setComdat(nullptr); // A declaration must not be in a COMDAT.
 }
 
 bool IsGVForExtensionDefs(const llvm::GlobalVariable& gv)
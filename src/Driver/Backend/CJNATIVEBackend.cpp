@@ -165,11 +165,25 @@ bool CJNATIVEBackend::ProcessGenerationOfNormalCompile(const std::vector<TempFil
         return TC->ProcessGeneration(preprocessedFiles);
     }
 
-    auto preprocessedFiles = GeneratePreprocessTools(bitCodeFiles);
-    if (driverOptions.saveTemps) {
-        (void)GenerateCompileTool(preprocessedFiles, true);
+    // Frontend outputs are already object files if they were compiled by the in-process backend,
+    // only the remaining bitcode files go through 'opt' and 'llc'.
+    std::vector<TempFileInfo> objFiles;
+    std::vector<TempFileInfo> remainingBitCodeFiles;
+    for (auto& fileInfo : bitCodeFiles) {
+        if (driverOptions.frontendOutputsCompiled && fileInfo.isFrontendOutput) {
+            objFiles.emplace_back(fileInfo);
+        } else {
+            remainingBitCodeFiles.emplace_back(fileInfo);
+        }
+    }
+    if (!remainingBitCodeFiles.empty()) {
+        auto preprocessedFiles = GeneratePreprocessTools(remainingBitCodeFiles);
+        if (driverOptions.saveTemps) {
+            (void)GenerateCompileTool(preprocessedFiles, true);
+        }
+        auto compiledFiles = GenerateCompileTool(preprocessedFiles);
+        objFiles.insert(objFiles.end(), compiledFiles.begin(), compiledFiles.end());
     }
-    auto objFiles = GenerateCompileTool(preprocessedFiles);
     // copy each obj file from temporary directory to cache directory in normal compile case
     ToolBatch batch{};
     for (auto& objFile : objFiles) {
@@ -243,26 +257,7 @@ bool CJNATIVEBackend::ProcessGenerationOfIncrementalNoChangeCompile(const std::v
 
 void CJNATIVEBackend::PreprocessOfNewPassManager(Tool& tool)
 {
-    std::string passesCollector = "-passes=";
-    std::vector<std::string> passItems;
-    {
-        using namespace ToolOptions;
-        SetFuncType setOptimizationLevelHandler = [&passItems](
-                                                      const std::string& option) { passItems.emplace_back(option); };
-        SetOptions(setOptimizationLevelHandler, driverOptions, OPT::SetOptimizationLevelOptions);
-        // remove the initial hyphen in the options.
-        SetFuncType setOptionHandler = [&passItems](
-                                           const std::string& option) { passItems.emplace_back(option.substr(1)); };
-        SetOptions(setOptionHandler, driverOptions, OPT::SetNewPassManagerOptions);
-    }
-
-    for (auto& it : passItems) {
-        passesCollector += it;
-        if (&it != &passItems.back()) {
-            passesCollector += ",";
-        }
-    }
-    tool.AppendArg(passesCollector);
+    tool.AppendArg("-passes=" + ToolOptions::OPT::GetNewPassManagerPipeline(driverOptions));
 }
 
 std::vector<TempFileInfo> CJNATIVEBackend::GeneratePreprocessTools(const std::vector<TempFileInfo>& bitCodeFiles)
@@ -0,0 +1,256 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the in-process code generation of the cjnative backend.
+ */
+
+#include "cangjie/Driver/Backend/CJNATIVEInProcessCodeGen.h"
+
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+
+#include "llvm/CodeGen/CommandFlags.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include "cangjie/Basic/Print.h"
+#include "cangjie/Driver/TempFileManager.h"
+#include "cangjie/Driver/ToolOptions.h"
+#include "cangjie/Utils/ProfileRecorder.h"
+#include "cangjie/Utils/TaskQueue.h"
+
+using namespace Cangjie;
+
+// Only the targets listed for the in-process backend in third_party/CMakeLists.txt are linked into cjc, so their
+// initializers are declared here rather than through the InitializeAll* functions of all configured llvm targets.
+#define DECLARE_LLVM_TARGET_INITIALIZERS(TARGET)                                                                       \
+    extern "C" void LLVMInitialize##TARGET##TargetInfo();                                                              \
+    extern "C" void LLVMInitialize##TARGET##Target();                                                                  \
+    extern "C" void LLVMInitialize##TARGET##TargetMC();                                                                \
+    extern "C" void LLVMInitialize##TARGET##AsmPrinter();                                                              \
+    extern "C" void LLVMInitialize##TARGET##AsmParser();
+DECLARE_LLVM_TARGET_INITIALIZERS(X86)
+DECLARE_LLVM_TARGET_INITIALIZERS(AArch64)
+DECLARE_LLVM_TARGET_INITIALIZERS(ARM)
+#undef DECLARE_LLVM_TARGET_INITIALIZERS
+
+namespace {
+#define INITIALIZE_LLVM_TARGET(TARGET)                                                                                 \
+    do {                                                                                                               \
+        LLVMInitialize##TARGET##TargetInfo();                                                                          \
+        LLVMInitialize##TARGET##Target();                                                                              \
+        LLVMInitialize##TARGET##TargetMC();                                                                            \
+        LLVMInitialize##TARGET##AsmPrinter();                                                                          \
+        LLVMInitialize##TARGET##AsmParser();                                                                           \
+    } while (false)
+
+/** Initialize the llvm target of @p arch, return false if it is not linked into cjc. */
+bool InitializeTarget(Triple::ArchType arch)
+{
+    switch (arch) {
+        case Triple::ArchType::X86_64:
+            INITIALIZE_LLVM_TARGET(X86);
+            return true;
+        case Triple::ArchType::AARCH64:
+        case Triple::ArchType::ARM64:
+            INITIALIZE_LLVM_TARGET(AArch64);
+            return true;
+        case Triple::ArchType::ARM32:
+            INITIALIZE_LLVM_TARGET(ARM);
+            return true;
+        default:
+            return false;
+    }
+}
+#undef INITIALIZE_LLVM_TARGET
+
+/**
+ * Options of 'opt' and 'llc' which are parsed by llvm::cl. The triple and the optimization levels are not
+ * included, they are given through the API. Options shared by both tools are only added once.
+ */
+std::vector<std::string> CollectCommandLineOptions(const DriverOptions& driverOptions)
+{
+    std::vector<std::string> options{"cjc"};
+    std::unordered_set<std::string> added;
+    ToolOptions::SetFuncType setOptionHandler = [&options, &added](const std::string& option) {
+        if (added.emplace(option).second) {
+            options.emplace_back(option);
+        }
+    };
+    using namespace ToolOptions;
+    std::vector<ToolOptionType> setOptionsPass = {
+        OPT::SetOptions,                // Comment ensure vector members are arranged vertically.
+        OPT::SetCodeObfuscationOptions, //
+        OPT::SetPgoOptions,             //
+        OPT::SetTransparentOptions,     //
+        LLC::SetOptions,                //
+        LLC::SetTransparentOptions,     // The transparent options must after other options.
+    };
+    SetOptions(setOptionHandler, driverOptions, setOptionsPass);
+    return options;
+}
+
+llvm::CodeGenOpt::Level GetCodeGenOptLevel(const DriverOptions& driverOptions)
+{
+    // Reuse the level given to 'llc', which is in the form of "-O<digit>".
+    std::string levelOption;
+    ToolOptions::SetFuncType setOptionHandler = [&levelOption](const std::string& option) { levelOption = option; };
+    ToolOptions::LLC::SetOptimizationLevelOptions(setOptionHandler, driverOptions);
+    switch (levelOption.empty() ? '2' : levelOption.back()) {
+        case '0':
+            return llvm::CodeGenOpt::None;
+        case '1':
+            return llvm::CodeGenOpt::Less;
+        case '3':
+            return llvm::CodeGenOpt::Aggressive;
+        default:
+            return llvm::CodeGenOpt::Default;
+    }
+}
+} // namespace
+
+bool CJNATIVEInProcessCodeGen::Initialize() const
+{
+    static std::once_flag initFlag;
+    static bool initialized = false;
+    std::call_once(initFlag, [this]() {
+        if (!InitializeTarget(driverOptions.target.arch)) {
+            if (driverOptions.enableVerbose) {
+                Warningln("the in-process backend is not used: the target " + driverOptions.target.ArchToString() +
+                    " is not linked into cjc");
+            }
+            return;
+        }
+        // The code generation options of 'llc' (e.g. '--relocation-model', '-mcpu') are registered by the tool itself.
+        static llvm::codegen::RegisterCodeGenFlags codeGenFlags;
+
+        auto options = CollectCommandLineOptions(driverOptions);
+        std::vector<const char*> argv;
+        argv.reserve(options.size());
+        for (auto& option : options) {
+            argv.emplace_back(option.c_str());
+        }
+        std::string errMsg;
+        llvm::raw_string_ostream errStream(errMsg);
+        initialized = llvm::cl::ParseCommandLineOptions(
+            static_cast<int>(argv.size()), argv.data(), "cjc in-process backend", &errStream);
+        if (!initialized && driverOptions.enableVerbose) {
+            // Some options are only known by the external tools, fall back to them.
+            Warningln("the in-process backend is not used: " + errStream.str());
+        }
+    });
+    return initialized;
+}
+
+bool CJNATIVEInProcessCodeGen::Compile(const std::vector<std::unique_ptr<llvm::Module>>& modules,
+    const std::vector<TempFileInfo>& bitCodeFiles, std::vector<TempFileInfo>& objFiles) const
+{
+    CJC_ASSERT(modules.size() == bitCodeFiles.size());
+    for (const auto& bitCodeFile : bitCodeFiles) {
+        TempFileInfo objFileInfo = TempFileManager::Instance().CreateNewFileInfo(bitCodeFile, TempFileKind::T_OBJ);
+        objFileInfo.isFrontendOutput = bitCodeFile.isFrontendOutput;
+        objFiles.emplace_back(objFileInfo);
+    }
+    Utils::TaskQueue taskQueue(driverOptions.GetJobs());
+    std::vector<Utils::TaskResult<bool>> results;
+    // The backend takes most of the time of a module, so its balance is what the split of the package aims at.
+    std::vector<int64_t> elapsedTimes(modules.size(), 0);
+    for (size_t i = 0; i < modules.size(); ++i) {
+        auto& module = *modules[i];
+        auto& objFilePath = objFiles[i].filePath;
+        auto& elapsedTime = elapsedTimes[i];
+        results.emplace_back(taskQueue.AddTask<bool>([this, &module, &objFilePath, &elapsedTime]() {
+            auto start = std::chrono::steady_clock::now();
+            bool res = CompileModule(module, objFilePath);
+            elapsedTime =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            return res;
+        }));
+    }
+    taskQueue.RunAndWaitForAllTasksCompleted();
+    Utils::ProfileRecorder::RecordImbalance("backend measured imbalance(%)", elapsedTimes);
+    bool res = true;
+    for (auto& result : results) {
+        res = result.get() && res;
+    }
+    return res;
+}
+
+bool CJNATIVEInProcessCodeGen::CompileModule(llvm::Module& module, const std::string& objFilePath) const
+{
+    Utils::ProfileRecorder recorder("In-process Backend", module.getName().str());
+    // Same as the '--mtriple' option given to 'opt' and 'llc', otherwise the triple of the module is used.
+    if (driverOptions.IsCrossCompiling() || driverOptions.target.IsMinGW()) {
+        module.setTargetTriple(driverOptions.target.GetEffectiveTripleString());
+    }
+    llvm::Triple triple(module.getTargetTriple());
+    std::string errMsg;
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple.getTriple(), errMsg);
+    if (target == nullptr) {
+        Errorln("failed to find the target of " + triple.getTriple() + ": " + errMsg);
+        return false;
+    }
+    auto cpu = llvm::codegen::getCPUStr();
+    auto features = llvm::codegen::getFeaturesStr();
+    std::unique_ptr<llvm::TargetMachine> targetMachine(target->createTargetMachine(triple.getTriple(), cpu, features,
+        llvm::codegen::InitTargetOptionsFromCodeGenFlags(triple), llvm::codegen::getExplicitRelocModel(),
+        llvm::codegen::getExplicitCodeModel(), GetCodeGenOptLevel(driverOptions)));
+    if (!targetMachine) {
+        Errorln("failed to create the target machine of " + triple.getTriple());
+        return false;
+    }
+    module.setDataLayout(targetMachine->createDataLayout());
+    llvm::codegen::setFunctionAttributes(cpu, features, module);
+
+    // 1. The 'opt' stage.
+    llvm::LoopAnalysisManager loopAM;
+    llvm::FunctionAnalysisManager functionAM;
+    llvm::CGSCCAnalysisManager cgsccAM;
+    llvm::ModuleAnalysisManager moduleAM;
+    llvm::PassBuilder passBuilder(targetMachine.get());
+    passBuilder.registerModuleAnalyses(moduleAM);
+    passBuilder.registerCGSCCAnalyses(cgsccAM);
+    passBuilder.registerFunctionAnalyses(functionAM);
+    passBuilder.registerLoopAnalyses(loopAM);
+    passBuilder.crossRegisterProxies(loopAM, functionAM, cgsccAM, moduleAM);
+    llvm::ModulePassManager modulePM;
+    if (auto err = passBuilder.parsePassPipeline(modulePM, ToolOptions::OPT::GetNewPassManagerPipeline(driverOptions))) {
+        Errorln("invalid pass pipeline: " + llvm::toString(std::move(err)));
+        return false;
+    }
+    modulePM.run(module, moduleAM);
+
+    // 2. The 'llc' stage.
+    std::error_code errorCode;
+    llvm::raw_fd_ostream os(objFilePath, errorCode, llvm::sys::fs::OF_None);
+    if (errorCode) {
+        Errorln("failed to open " + objFilePath + ": " + errorCode.message());
+        return false;
+    }
+    llvm::legacy::PassManager codeGenPM;
+    if (targetMachine->addPassesToEmitFile(codeGenPM, os, nullptr, llvm::CGFT_ObjectFile)) {
+        Errorln("the target " + triple.getTriple() + " cannot emit object files");
+        return false;
+    }
+    codeGenPM.run(module);
+    os.close();
+    if (os.has_error()) {
+        Errorln("failed to write " + objFilePath + ": " + os.error().message());
+        os.clear_error();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,419 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the CompilerDaemon class.
+ */
+
+#include "cangjie/Driver/CompilerDaemon.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "cangjie/Basic/Print.h"
+#include "cangjie/Modules/CjoFileCache.h"
+#include "cangjie/Utils/FileUtil.h"
+#include "cangjie/Utils/ConstantsUtils.h"
+
+using namespace Cangjie;
+
+#ifndef _WIN32
+namespace {
+// The standard streams of the client, passed to the daemon with the request.
+constexpr int STD_FD_NUM = 3;
+constexpr int SIGNAL_EXIT_CODE_BASE = 128;
+constexpr int FAILED_EXIT_CODE = 1;
+constexpr size_t REPORT_BUFFER_SIZE = 4096;
+
+volatile sig_atomic_t g_stopRequested = 0;
+
+void StopHandler(int)
+{
+    g_stopRequested = 1;
+}
+
+bool WriteAll(int fd, const void* data, size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        auto written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool ReadAll(int fd, void* data, size_t size)
+{
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        auto got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+bool WriteUint32(int fd, uint32_t value)
+{
+    return WriteAll(fd, &value, sizeof(value));
+}
+
+bool ReadUint32(int fd, uint32_t& value)
+{
+    return ReadAll(fd, &value, sizeof(value));
+}
+
+bool WriteString(int fd, const std::string& str)
+{
+    return WriteUint32(fd, static_cast<uint32_t>(str.size())) && WriteAll(fd, str.data(), str.size());
+}
+
+bool ReadString(int fd, std::string& str)
+{
+    uint32_t size = 0;
+    if (!ReadUint32(fd, size)) {
+        return false;
+    }
+    str.resize(size);
+    return size == 0 || ReadAll(fd, str.data(), size);
+}
+
+/**
+ * A request is the working directory and the executable path, then the count and the items of the arguments and the
+ * environment.
+ */
+bool WriteRequest(int fd, const CompileRequest& request)
+{
+    if (!WriteString(fd, request.workingDirectory) || !WriteString(fd, request.exePath) ||
+        !WriteUint32(fd, static_cast<uint32_t>(request.args.size()))) {
+        return false;
+    }
+    for (auto& arg : request.args) {
+        if (!WriteString(fd, arg)) {
+            return false;
+        }
+    }
+    if (!WriteUint32(fd, static_cast<uint32_t>(request.environmentVars.size()))) {
+        return false;
+    }
+    for (auto& [name, value] : request.environmentVars) {
+        if (!WriteString(fd, name) || !WriteString(fd, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReadRequest(int fd, CompileRequest& request)
+{
+    uint32_t count = 0;
+    if (!ReadString(fd, request.workingDirectory) || !ReadString(fd, request.exePath) || !ReadUint32(fd, count)) {
+        return false;
+    }
+    request.args.resize(count);
+    for (auto& arg : request.args) {
+        if (!ReadString(fd, arg)) {
+            return false;
+        }
+    }
+    if (!ReadUint32(fd, count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        std::string value;
+        if (!ReadString(fd, name) || !ReadString(fd, value)) {
+            return false;
+        }
+        request.environmentVars.emplace(std::move(name), std::move(value));
+    }
+    return true;
+}
+
+bool SendStdFds(int socketFd)
+{
+    int fds[STD_FD_NUM] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    char byte = 0;
+    iovec iov{&byte, sizeof(byte)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    (void)memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    return sendmsg(socketFd, &msg, 0) == static_cast<ssize_t>(sizeof(byte));
+}
+
+bool ReceiveStdFds(int socketFd, int (&fds)[STD_FD_NUM])
+{
+    char byte = 0;
+    iovec iov{&byte, sizeof(byte)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(socketFd, &msg, 0) != static_cast<ssize_t>(sizeof(byte))) {
+        return false;
+    }
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == nullptr || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(fds))) {
+        return false;
+    }
+    (void)memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    return true;
+}
+
+bool MakeSocketAddress(const std::string& socketPath, sockaddr_un& addr)
+{
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    (void)memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    return true;
+}
+
+void SetupEnvironment(const std::unordered_map<std::string, std::string>& environmentVars)
+{
+#ifdef __linux__
+    (void)clearenv();
+#endif
+    for (auto& [name, value] : environmentVars) {
+        (void)setenv(name.c_str(), value.c_str(), 1);
+    }
+}
+} // namespace
+
+void CompilerDaemon::PreloadDirectory(const std::string& dir) const
+{
+    auto dirs = FileUtil::GetAllDirsUnderCurrentPath(dir);
+    dirs.emplace_back(dir);
+    for (auto& subDir : dirs) {
+        for (auto& file : FileUtil::GetAllFilesUnderCurrentPath(subDir, SERIALIZED_FILE_EXTENSION.substr(1), false)) {
+            (void)CjoFileCache::Instance().Preload(FileUtil::JoinPath(subDir, file));
+        }
+    }
+}
+
+bool CompilerDaemon::Serve()
+{
+    sockaddr_un addr;
+    if (!MakeSocketAddress(socketPath, addr)) {
+        Errorln("cjc daemon: invalid socket path '" + socketPath + "'");
+        return false;
+    }
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    (void)unlink(socketPath.c_str());
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listenFd, SOMAXCONN) != 0) {
+        Errorln("cjc daemon: cannot listen on '" + socketPath + "': " + strerror(errno));
+        if (listenFd >= 0) {
+            (void)close(listenFd);
+        }
+        return false;
+    }
+    // Interrupt 'poll' instead of restarting it, so the daemon can remove its socket before exiting.
+    struct sigaction sa {};
+    sa.sa_handler = StopHandler;
+    (void)sigemptyset(&sa.sa_mask);
+    (void)sigaction(SIGTERM, &sa, nullptr);
+    (void)sigaction(SIGINT, &sa, nullptr);
+    // A client may go away before its compilation finishes.
+    (void)signal(SIGPIPE, SIG_IGN);
+
+    std::vector<pollfd> fds;
+    std::vector<int> pids;
+    while (g_stopRequested == 0) {
+        fds.assign(1, pollfd{listenFd, POLLIN, 0});
+        pids.clear();
+        for (auto& [pid, client] : clients) {
+            fds.emplace_back(pollfd{client.reportFd, POLLIN, 0});
+            pids.emplace_back(pid);
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            continue;
+        }
+        // Children are finished before accepting new requests, so the files they imported are cached for them.
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            auto& client = clients[pids[i - 1]];
+            char buffer[REPORT_BUFFER_SIZE];
+            auto got = read(client.reportFd, buffer, sizeof(buffer));
+            if (got > 0) {
+                client.report.append(buffer, static_cast<size_t>(got));
+            } else if (got == 0 || errno != EINTR) {
+                Finish(pids[i - 1], client);
+                clients.erase(pids[i - 1]);
+            }
+        }
+        if ((fds[0].revents & POLLIN) != 0) {
+            Accept(listenFd);
+        }
+    }
+    (void)close(listenFd);
+    (void)unlink(socketPath.c_str());
+    for (auto& [pid, client] : clients) {
+        Finish(pid, client);
+    }
+    clients.clear();
+    return true;
+}
+
+void CompilerDaemon::Accept(int listenFd)
+{
+    int clientFd = accept(listenFd, nullptr, nullptr);
+    if (clientFd < 0) {
+        return;
+    }
+    int reportPipe[2] = {-1, -1};
+    if (pipe(reportPipe) != 0) {
+        (void)close(clientFd);
+        return;
+    }
+    // The request is read by the child, so a client which is slow to send it never stalls the daemon.
+    auto pid = fork();
+    if (pid == 0) {
+        // The child compiles the request and reports the .cjo files it opened back to the daemon.
+        (void)signal(SIGTERM, SIG_DFL);
+        (void)signal(SIGINT, SIG_DFL);
+        (void)signal(SIGPIPE, SIG_DFL);
+        (void)close(listenFd);
+        (void)close(reportPipe[0]);
+        for (auto& [_, client] : clients) {
+            (void)close(client.clientFd);
+            (void)close(client.reportFd);
+        }
+        int stdFds[STD_FD_NUM] = {-1, -1, -1};
+        CompileRequest request;
+        if (!ReceiveStdFds(clientFd, stdFds) || !ReadRequest(clientFd, request)) {
+            _exit(FAILED_EXIT_CODE);
+        }
+        (void)close(clientFd);
+        for (int i = 0; i < STD_FD_NUM; ++i) {
+            (void)dup2(stdFds[i], i);
+            (void)close(stdFds[i]);
+        }
+        int ret = FAILED_EXIT_CODE;
+        if (chdir(request.workingDirectory.c_str()) == 0) {
+            SetupEnvironment(request.environmentVars);
+            ret = compile(request);
+        } else {
+            Errorln("cjc daemon: cannot enter '" + request.workingDirectory + "': " + strerror(errno));
+        }
+        std::string report;
+        for (auto& path : CjoFileCache::Instance().GetOpenedPaths()) {
+            report += path + '\n';
+        }
+        (void)WriteAll(reportPipe[1], report.data(), report.size());
+        (void)fflush(stdout);
+        (void)fflush(stderr);
+        _exit(ret);
+    }
+    (void)close(reportPipe[1]);
+    if (pid < 0) {
+        (void)WriteUint32(clientFd, FAILED_EXIT_CODE);
+        (void)close(reportPipe[0]);
+        (void)close(clientFd);
+        return;
+    }
+    clients.emplace(pid, Client{clientFd, reportPipe[0], ""});
+}
+
+void CompilerDaemon::Finish(int pid, Client& client) const
+{
+    int status = 0;
+    int ret = FAILED_EXIT_CODE;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (WIFEXITED(status)) {
+        ret = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        ret = SIGNAL_EXIT_CODE_BASE + WTERMSIG(status);
+    }
+    (void)WriteUint32(client.clientFd, static_cast<uint32_t>(ret));
+    (void)close(client.clientFd);
+    (void)close(client.reportFd);
+    // Keep what the compilation imported resident for the following requests.
+    for (auto& path : FileUtil::SplitStr(client.report, '\n')) {
+        if (!path.empty()) {
+            (void)CjoFileCache::Instance().Preload(path);
+        }
+    }
+}
+
+std::optional<int> CompilerDaemon::Forward(const std::string& socketPath, const CompileRequest& request)
+{
+    sockaddr_un addr;
+    if (!MakeSocketAddress(socketPath, addr)) {
+        return std::nullopt;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || !SendStdFds(fd)) {
+        (void)close(fd);
+        return std::nullopt;
+    }
+    // Once the streams are passed, the daemon owns the compilation. Don't compile again if it fails afterwards.
+    uint32_t ret = FAILED_EXIT_CODE;
+    if (!WriteRequest(fd, request) || !ReadUint32(fd, ret)) {
+        Errorln("cjc daemon: lost connection to '" + socketPath + "'");
+        ret = FAILED_EXIT_CODE;
+    }
+    (void)close(fd);
+    return static_cast<int>(ret);
+}
+#else
+void CompilerDaemon::PreloadDirectory(const std::string&) const
+{
+}
+
+bool CompilerDaemon::Serve()
+{
+    Errorln("cjc daemon: not supported on this platform");
+    return false;
+}
+
+std::optional<int> CompilerDaemon::Forward(const std::string&, const CompileRequest&)
+{
+    return std::nullopt;
+}
+#endif
@@ -34,6 +34,11 @@
 
 #include "Job.h"
 
+#ifdef CANGJIE_IN_PROCESS_BACKEND
+#include "cangjie/CodeGen/EmitPackageIR.h"
+#include "cangjie/Driver/Backend/CJNATIVEInProcessCodeGen.h"
+#endif
+
 using namespace Cangjie;
 
 Driver::Driver(const std::vector<std::string>& args, DiagnosticEngine& diag, const std::string& exeName)
@@ -91,6 +96,34 @@ bool DeleteInstance(DefaultCompilerInstance* instance)
 #endif
     return true;
 }
+
+#ifdef CANGJIE_IN_PROCESS_BACKEND
+/**
+ * Compile the modules kept by the frontend into object files. If the backend options cannot be applied in process,
+ * the bitcode files are written instead and the external tools compile them as usual.
+ */
+bool CompileFrontendModulesInProcess(DefaultCompilerInstance& instance, DriverOptions& driverOptions)
+{
+    Utils::ProfileRecorder recorder("Main Stage", "In-process Backend");
+    auto modules = instance.ReleaseLLVMModules();
+    auto& bitCodeFiles = driverOptions.frontendOutputFiles;
+    CJC_ASSERT(modules.size() == bitCodeFiles.size());
+    bool res = true;
+    CJNATIVEInProcessCodeGen codeGen(driverOptions);
+    if (codeGen.Initialize()) {
+        std::vector<TempFileInfo> objFiles;
+        res = codeGen.Compile(modules, bitCodeFiles, objFiles);
+        bitCodeFiles = objFiles;
+        driverOptions.frontendOutputsCompiled = true;
+    } else {
+        for (size_t i = 0; i < modules.size(); ++i) {
+            res = CodeGen::SavePackageModule(*modules[i], bitCodeFiles[i].filePath) && res;
+        }
+    }
+    CodeGen::ClearPackageModules(modules);
+    return res;
+}
+#endif
 } // namespace
 
 bool Driver::ParseArgs()
@@ -167,6 +200,9 @@ bool Driver::ExecuteCompilation() const
     if (driverOptions->enableMemoryCollect) {
         Utils::ProfileRecorder::Enable(true, Utils::ProfileRecorder::Type::MEMORY);
     }
+    if (driverOptions->enableTrace) {
+        Utils::ProfileRecorder::EnableTrace(true);
+    }
     if (!TempFileManager::Instance().Init(*driverOptions, false)) {
         return false;
     }
@@ -201,6 +237,13 @@ bool Driver::ExecuteCompilation() const
         return true;
     }
 
+#ifdef CANGJIE_IN_PROCESS_BACKEND
+    // The modules must be taken before the instance is released.
+    if (driverOptions->IsInProcessBackendEnabled() && !CompileFrontendModulesInProcess(*instance, *driverOptions)) {
+        DeleteInstance(instance);
+        return false;
+    }
+#endif
     std::future<bool> future = std::async(DeleteInstance, instance);
     bool res = InvokeCompileToolchain();
     Utils::ProfileRecorder::Start("Main Stage", "DeleteInstanceLeftTime");
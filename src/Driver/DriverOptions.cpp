@@ -91,6 +91,14 @@ std::unordered_map<Options::ID, std::function<bool(DriverOptions&, OptionArgInst
     { Options::ID::STRIP_ALL, OPTION_TRUE_ACTION(opts.stripSymbolTable = true) },
     { Options::ID::USE_RUNTIME_RPATH, OPTION_TRUE_ACTION(opts.useRuntimeRpath = true) },
     { Options::ID::SANITIZE_SET_RPATH, OPTION_TRUE_ACTION(opts.sanitizerEnableRpath = true) },
+    { Options::ID::IN_PROCESS_BACKEND, []([[maybe_unused]] DriverOptions& opts, OptionArgInstance&) {
+#ifdef CANGJIE_IN_PROCESS_BACKEND
+        opts.inProcessBackend = true;
+#else
+        Warningln("cjc is built without the in-process backend, '--in-process-backend' has no effect.");
+#endif
+        return true;
+    }},
 
     // ---------- CODE OBFUSCATION OPTIONS ----------
     { Options::ID::OBF_STRING, OPTION_TRUE_ACTION(opts.enableStringObfuscation = true) },
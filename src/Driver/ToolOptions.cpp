@@ -61,6 +61,29 @@ void SetNewPassManagerOptions(SetFuncType setOptionHandler, const DriverOptions&
     SetOptionIf(setOptionHandler, (!driverOptions.optPassOptions.empty()), "-" + driverOptions.optPassOptions);
 }
 
+std::string GetNewPassManagerPipeline(const DriverOptions& driverOptions)
+{
+    std::vector<std::string> passItems;
+    SetFuncType setOptimizationLevelHandler = [&passItems](const std::string& option) {
+        passItems.emplace_back(option);
+    };
+    SetOptimizationLevelOptions(setOptimizationLevelHandler, driverOptions);
+    // remove the initial hyphen in the options.
+    SetFuncType setOptionHandler = [&passItems](const std::string& option) {
+        passItems.emplace_back(option.substr(1));
+    };
+    SetNewPassManagerOptions(setOptionHandler, driverOptions);
+
+    std::string pipeline;
+    for (auto& it : passItems) {
+        pipeline += it;
+        if (&it != &passItems.back()) {
+            pipeline += ",";
+        }
+    }
+    return pipeline;
+}
+
 void SetCodeLayoutObfuscationOptions(SetFuncType setOptionHandler, const DriverOptions& driverOptions)
 {
     setOptionHandler("--obf-layout=true");
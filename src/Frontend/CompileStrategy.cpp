@@ -28,6 +28,7 @@
 #include "cangjie/Utils/Signal.h"
 #endif
 #include "cangjie/Utils/ProfileRecorder.h"
+#include "cangjie/Utils/TaskQueue.h"
 
 using namespace Cangjie;
 using namespace Utils;
@@ -198,23 +199,36 @@ public:
         return true;
     }
 
+    /// A file to be parsed. The content of a file which is not loaded yet is read by its parsing task.
+    struct ParseInput {
+        std::string path;
+        std::optional<std::string> content;
+        unsigned fileID;
+        bool reserved{false}; // Whether the source of 'fileID' was reserved for this input, see ParseOnePackage.
+    };
+    using ParseResult = std::tuple<OwnedPtr<File>, TokenVecMap, size_t>;
+
     OwnedPtr<AST::Package> GetMultiThreadParseOnePackage(
-        std::queue<std::future<std::tuple<OwnedPtr<File>, TokenVecMap, size_t>>>& futureQueue,
-        const std::string& defaultPackageName) const
+        std::vector<Utils::TaskResult<std::optional<ParseResult>>>& results, const std::string& defaultPackageName,
+        bool& success) const
     {
         auto package = MakeOwned<Package>(defaultPackageName);
         size_t lineNumInOnePackage = 0;
         const size_t filePtrIdx = 0;
         const size_t commentIdx = 1;
         const size_t lineNumIdx = 2;
-        while (!futureQueue.empty()) {
-            auto curFuture = futureQueue.front().get();
-            std::get<filePtrIdx>(curFuture)->curPackage = package.get();
-            std::get<filePtrIdx>(curFuture)->indexOfPackage = package->files.size();
-            package->files.push_back(std::move(std::get<filePtrIdx>(curFuture)));
-            s.ci->GetSourceManager().AddComments(std::get<commentIdx>(curFuture));
-            lineNumInOnePackage += std::get<lineNumIdx>(curFuture);
-            futureQueue.pop();
+        for (auto& result : results) {
+            auto curResult = result.get();
+            if (!curResult.has_value()) {
+                success = false;
+                continue;
+            }
+            auto& parsed = *curResult;
+            std::get<filePtrIdx>(parsed)->curPackage = package.get();
+            std::get<filePtrIdx>(parsed)->indexOfPackage = package->files.size();
+            package->files.push_back(std::move(std::get<filePtrIdx>(parsed)));
+            s.ci->GetSourceManager().AddComments(std::get<commentIdx>(parsed));
+            lineNumInOnePackage += std::get<lineNumIdx>(parsed);
         }
         Utils::ProfileRecorder::RecordCodeInfo("package line num", static_cast<int64_t>(lineNumInOnePackage));
         if (!package->files.empty()) {
@@ -247,41 +261,57 @@ public:
         package.isMacroPackage = package.files[0]->package->hasMacro;
     }
 
-    OwnedPtr<Package> MultiThreadParseOnePackage(
-        std::queue<std::tuple<std::string, unsigned>>& fileInfoQueue, const std::string& defaultPackageName) const
+    std::optional<ParseResult> ParseFile(ParseInput& input) const
     {
-        std::queue<std::future<std::tuple<OwnedPtr<File>, TokenVecMap, size_t>>> futureQueue;
-        while (!fileInfoQueue.empty()) {
-            auto curFile = fileInfoQueue.front();
-            futureQueue.push(
-                std::async(std::launch::async, [this, curFile]() -> std::tuple<OwnedPtr<File>, TokenVecMap, size_t> {
 #if (defined RELEASE)
 #if (defined __unix__)
-                    // Since alternate signal stack is per thread, we have to create an alternate signal stack for each
-                    // thread.
-                    Cangjie::CreateAltSignalStack();
+        // Since alternate signal stack is per thread, we have to create an alternate signal stack for each
+        // thread.
+        Cangjie::CreateAltSignalStack();
 #elif _WIN32
-                    // When the SIGABRT, SIGFPE, SIGSEGV and SIGILL signals are triggered in a subthread,
-                    // the signals cannot be captured and the process exits directly. Therefore,
-                    // the signal processing function must be set for each thread.
-                    Cangjie::RegisterCrashSignalHandler();
+        // When the SIGABRT, SIGFPE, SIGSEGV and SIGILL signals are triggered in a subthread,
+        // the signals cannot be captured and the process exits directly. Therefore,
+        // the signal processing function must be set for each thread.
+        Cangjie::RegisterCrashSignalHandler();
 #endif
 #endif
-                    auto parser = CreateParser(curFile);
-                    parser->SetCompileOptions(s.ci->invocation.globalOptions);
-                    auto file = parser->ParseTopLevel();
+        if (!input.content.has_value()) {
+            std::string failedReason;
+            input.content = ReadFileContent(input.path, failedReason);
+            if (!input.content.has_value()) {
+                s.ci->diag.DiagnoseRefactor(DiagKindRefactor::module_read_file_to_buffer_failed, DEFAULT_POSITION,
+                    input.path, failedReason);
+                if (input.reserved) {
+                    s.ci->GetSourceManager().UnreserveSource(input.fileID);
+                }
+                return std::nullopt;
+            }
+            s.ci->GetSourceManager().SetBuffer(input.fileID, *input.content);
+        }
+        auto parser = CreateParser({*input.content, input.fileID});
+        parser->SetCompileOptions(s.ci->invocation.globalOptions);
+        auto file = parser->ParseTopLevel();
 #ifdef SIGNAL_TEST
-                    // The interrupt signal triggers the function. In normal cases, this function does not take effect.
-                    Cangjie::SignalTest::ExecuteSignalTestCallbackFunc(
-                        Cangjie::SignalTest::TriggerPointer::PARSER_POINTER);
+        // The interrupt signal triggers the function. In normal cases, this function does not take effect.
+        Cangjie::SignalTest::ExecuteSignalTestCallbackFunc(Cangjie::SignalTest::TriggerPointer::PARSER_POINTER);
 #endif
-                    return {std::move(file), parser->GetCommentsMap(), parser->GetLineNum()};
-                }));
-            fileInfoQueue.pop();
-        }
+        return ParseResult{std::move(file), parser->GetCommentsMap(), parser->GetLineNum()};
+    }
 
-        auto package = GetMultiThreadParseOnePackage(futureQueue, defaultPackageName);
-        return package;
+    OwnedPtr<Package> MultiThreadParseOnePackage(
+        std::vector<ParseInput>& inputs, const std::string& defaultPackageName, bool& success) const
+    {
+        // Reading, lexing and parsing a file is one task, at most `jobs` files are in flight at the same time. The
+        // results are merged in the order of the inputs, so the file order does not depend on the scheduling.
+        Utils::TaskQueue taskQueue(s.ci->invocation.globalOptions.GetJobs());
+        std::vector<Utils::TaskResult<std::optional<ParseResult>>> results;
+        results.reserve(inputs.size());
+        for (auto& input : inputs) {
+            results.emplace_back(
+                taskQueue.AddTask<std::optional<ParseResult>>([this, &input]() { return ParseFile(input); }));
+        }
+        taskQueue.RunAndWaitForAllTasksCompleted();
+        return GetMultiThreadParseOnePackage(results, defaultPackageName, success);
     }
 
     OwnedPtr<Parser> CreateParser(const std::tuple<std::string, unsigned>& curFile) const
@@ -293,7 +323,7 @@ public:
     OwnedPtr<Package> ParseOnePackage(
         const std::vector<std::string>& files, bool& success, const std::string& defaultPackageName)
     {
-        std::queue<std::tuple<std::string, unsigned>> fileInfoQueue;
+        std::vector<ParseInput> inputs;
 
         // Parse source code files to File node list.
         if (s.ci->loadSrcFilesFromCache) {
@@ -304,35 +334,33 @@ public:
                         DiagKindRefactor::module_read_file_conflicted, DEFAULT_POSITION, it.first);
                 }
                 (void)s.fileIds.insert(fileID);
-                fileInfoQueue.emplace(it.second, fileID);
+                inputs.emplace_back(ParseInput{it.first, it.second, fileID});
             }
         } else {
             // The readdir cannot guarantee stable order of inputted files, need sort before adding to sourceManager.
+            // The file ids of new files are reserved in this order, the files are read by the parsing tasks. A file
+            // registered before keeps its id and its content until it is read again, since the AST of an earlier
+            // parse may still refer to it.
             std::vector<std::string> parseFiles{files};
             std::sort(parseFiles.begin(), parseFiles.end(),
                 [&](auto& f, auto& second) { return GetFileName(f) < GetFileName(second); });
-            std::for_each(parseFiles.begin(), parseFiles.end(), [this, &success, &fileInfoQueue](auto file) {
-                std::string failedReason;
-                auto content = ReadFileContent(file, failedReason);
-                if (!content.has_value()) {
-                    s.ci->diag.DiagnoseRefactor(
-                        DiagKindRefactor::module_read_file_to_buffer_failed, DEFAULT_POSITION, file, failedReason);
-                    success = false;
-                    return;
-                }
-                const unsigned int fileID = s.ci->GetSourceManager().AddSource(file | IdenticalFunc, content.value());
-                if (s.fileIds.count(fileID) > 0) {
+            auto& sm = s.ci->GetSourceManager();
+            for (auto& file : parseFiles) {
+                int existedID = sm.GetFileID(FileUtil::Normalize(file | IdenticalFunc));
+                if (existedID >= 0 && s.fileIds.count(static_cast<unsigned int>(existedID)) > 0) {
                     (void)s.ci->diag.DiagnoseRefactor(
                         DiagKindRefactor::module_read_file_conflicted, DEFAULT_POSITION, file);
-                    return;
+                    continue;
                 }
-
+                bool reserved = existedID < 0;
+                const unsigned int fileID =
+                    reserved ? sm.ReserveSource(file | IdenticalFunc) : static_cast<unsigned int>(existedID);
                 (void)s.fileIds.insert(fileID);
-                fileInfoQueue.emplace(std::move(content.value()), fileID);
-            });
+                inputs.emplace_back(ParseInput{file, std::nullopt, fileID, reserved});
+            }
         }
 
-        auto package = MultiThreadParseOnePackage(fileInfoQueue, defaultPackageName);
+        auto package = MultiThreadParseOnePackage(inputs, defaultPackageName, success);
         s.ci->diag.EmitCategoryGroup();
         std::sort(package->files.begin(), package->files.end(),
             [](const OwnedPtr<File>& fileOne, const OwnedPtr<File>& fileTwo) {
@@ -342,6 +342,8 @@ bool CompilerInstance::PerformMacroExpand()
 {
     auto ret = compileStrategy->MacroExpand();
 
+    // Expanded code may name deferred decls of imported packages, materialize them while loaders are alive.
+    importManager.GetCjoManager()->LoadDeclsUsedBy(GetSourcePackages());
     // Constant evaluation and the interpreter needs to load bchir, which requires an AST loader.
     if (!invocation.globalOptions.IsConstEvalEnabled() && !invocation.globalOptions.interpreter) {
         importManager.DeleteASTLoaders();
@@ -470,6 +472,7 @@ bool CompilerInstance::WriteCachedInfo()
 #ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
     auto& pkg{*srcPkgs[0]};
     std::string path{invocation.globalOptions.GenerateCachedPathName(pkg.fullPackageName, CACHED_AST_EXTENSION)};
+    cachedInfo.fileContentHashes = std::move(fileContentHashes);
     WriteCache(pkg, std::move(cachedInfo), std::move(order), path);
 #endif
     return true;
@@ -485,7 +488,7 @@ bool CompilerInstance::UpdateAndWriteCachedInfoToDisk()
     return WriteCachedInfo();
 }
 
-bool CompilerInstance::CalculateASTCache()
+bool CompilerInstance::CalculateASTCache(const CachedFileHashes* prevHashes)
 {
     auto& package = srcPkgs[0];
 
@@ -512,13 +515,14 @@ bool CompilerInstance::CalculateASTCache()
     // the incremental compilation is enabled
     auto needCodePosInfo =
         std::make_pair(invocation.globalOptions.enableCompileDebug, invocation.globalOptions.displayLineInfo);
-    IncrementalCompilation::ASTCacheCalculator pc{*package, needCodePosInfo};
+    IncrementalCompilation::ASTCacheCalculator pc{*package, needCodePosInfo, &GetSourceManager(), prevHashes};
     pc.Walk();
     rawMangleName2DeclMap = std::move(pc.mangled2Decl);
     astCacheInfo = std::move(pc.ret);
     declsWithDuplicatedRawMangleName = std::move(pc.duplicatedMangleNames);
     directExtends = std::move(pc.directExtends);
     fileMap = std::move(pc.fileMap);
+    fileContentHashes = std::move(pc.fileContentHashes);
     order = std::move(pc.order);
     return true;
 }
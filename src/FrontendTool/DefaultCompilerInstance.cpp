@@ -12,6 +12,8 @@
 
 #include "cangjie/FrontendTool/DefaultCompilerInstance.h"
 
+#include <iterator>
+
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Verifier.h"
 
@@ -61,6 +63,10 @@ private:
         const TempFileKind& kind, const std::string& pkgName, const std::string& idx = "");
 
     std::vector<std::unique_ptr<llvm::Module>> llvmModules;
+    // Modules of all packages whose bitcode is compiled by the in-process backend of the driver.
+    std::vector<std::unique_ptr<llvm::Module>> deferredModules;
+
+    friend class DefaultCompilerInstance;
 };
 
 DefaultCompilerInstance::DefaultCompilerInstance(CompilerInvocation& invocation, DiagnosticEngine& diag)
@@ -72,6 +78,7 @@ DefaultCompilerInstance::DefaultCompilerInstance(CompilerInvocation& invocation,
 DefaultCIImpl::~DefaultCIImpl()
 {
     CodeGen::ClearPackageModules(llvmModules);
+    CodeGen::ClearPackageModules(deferredModules);
 }
 DefaultCompilerInstance::~DefaultCompilerInstance()
 {
@@ -252,6 +259,18 @@ bool DefaultCIImpl::EmitLLVMSimilarBytecode(Package& pkg, bool enableIncrement)
     // 2. save LLVM IR to bc file
     Utils::ProfileRecorder recorder("CodeGen", "Save bc file");
     ci.invocation.globalOptions.UpdateCachedDirName(pkg.fullPackageName);
+    if (ci.invocation.globalOptions.IsInProcessBackendEnabled()) {
+        // The driver optimizes and compiles the modules directly, only the file names are recorded here.
+        for (size_t i = 0; i < llvmModules.size(); ++i) {
+            auto idx = llvmModules.size() == 1 ? "" : std::to_string(i);
+            if (GenerateBCFilePathAndUpdateToInvocation(TempFileKind::T_BC, pkg.fullPackageName, idx).empty()) {
+                return false;
+            }
+        }
+        std::move(llvmModules.begin(), llvmModules.end(), std::back_inserter(deferredModules));
+        llvmModules.clear();
+        return true;
+    }
     if (llvmModules.size() == 1) {
         auto filePath = GenerateBCFilePathAndUpdateToInvocation(TempFileKind::T_BC, pkg.fullPackageName);
         if (filePath.empty()) {
@@ -286,6 +305,15 @@ bool DefaultCIImpl::EmitLLVMSimilarBytecode(Package& pkg, bool enableIncrement)
 }
 #endif
 
+#ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
+std::vector<std::unique_ptr<llvm::Module>> DefaultCompilerInstance::ReleaseLLVMModules()
+{
+    auto modules = std::move(impl->deferredModules);
+    impl->deferredModules.clear();
+    return modules;
+}
+#endif
+
 bool DefaultCompilerInstance::PerformMangling()
 {
     Utils::ProfileRecorder recorder("Main Stage", "Perform Mangling");
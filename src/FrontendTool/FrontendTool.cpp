@@ -167,6 +167,9 @@ int Cangjie::ExecuteFrontend(const std::string& exePath, const std::vector<std::
     if (globalOptions.enableMemoryCollect) {
         Utils::ProfileRecorder::Enable(true, Utils::ProfileRecorder::Type::MEMORY);
     }
+    if (globalOptions.enableTrace) {
+        Utils::ProfileRecorder::EnableTrace(true);
+    }
     if (!TempFileManager::Instance().Init(globalOptions, true)) {
         return 1;
     }
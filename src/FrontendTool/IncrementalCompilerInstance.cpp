@@ -196,8 +196,9 @@ bool IncrementalCompilerInstance::PerformIncrementalScopeAnalysis()
     CJC_ASSERT(srcPkgs.size() == 1);
     auto& package = srcPkgs[0];
 
-    // calculate the AST cache info
-    bool res = CalculateASTCache();
+    // calculate the AST cache info, reusing the hashes of the files unchanged since last compilation
+    auto prevHashes = LoadCachedFileHashes(invocation.globalOptions, package->fullPackageName);
+    bool res = CalculateASTCache(prevHashes ? &*prevHashes : nullptr);
     if (!res) {
         return true;
     }
@@ -6,34 +6,58 @@
 
 #include "cangjie/IncrementalCompilation/ASTCacheCalculator.h"
 
+#include <optional>
+#include <string_view>
+#include <thread>
+
+#include "cangjie/AST/ConcurrentWalker.h"
 #include "cangjie/AST/Utils.h"
+#include "cangjie/Basic/SourceManager.h"
 #include "cangjie/IncrementalCompilation/IncrementalScopeAnalysis.h"
 #include "cangjie/IncrementalCompilation/Utils.h"
 #include "cangjie/Mangle/ASTMangler.h"
+#include "cangjie/Utils/FastHash.h"
 #include "cangjie/Utils/SafePointer.h"
+#include "cangjie/Utils/TaskQueue.h"
 
 using namespace Cangjie::AST;
 
 namespace Cangjie::IncrementalCompilation {
 class ASTCacheCalculatorImpl {
 public:
-    explicit ASTCacheCalculatorImpl(
-        ASTCacheCalculator& calculator, const AST::Package& p1, std::pair<bool, bool> srcInfo1)
+    explicit ASTCacheCalculatorImpl(ASTCacheCalculator& calculator, const AST::Package& p1,
+        std::pair<bool, bool> srcInfo1, const SourceManager* sm, const CachedFileHashes* prev)
         : p{p1},
           mangler{p1.fullPackageName},
           srcInfo{srcInfo1},
+          sourceManager{sm},
+          prevHashes{prev},
           calc{calculator},
           mangled2Decl{calc.mangled2Decl},
           ret{calc.ret},
           duplicatedMangleNames{calc.duplicatedMangleNames},
           directExtends{calc.directExtends},
           order{calc.order},
-          fileMap{calc.fileMap}
+          fileMap{calc.fileMap},
+          fileContentHashes{calc.fileContentHashes}
     {
     }
 
     void Walk()
     {
+        // The hashes of a decl use the mangled names of the decls it refers to, which may be in other files, so all
+        // decls are mangled before any of them is hashed.
+        std::vector<FileHashTask> hashTasks;
+        hashTasks.reserve(p.files.size());
+        for (auto& file : p.files) {
+            auto& task = hashTasks.emplace_back();
+            task.file = file.get();
+            for (auto& decl : file->decls) {
+                MangleTopLevel(*decl, task.decls);
+            }
+        }
+        HashFiles(hashTasks);
+
         for (auto& file : p.files) {
             gid = 0;
             invp = false;
@@ -54,6 +78,16 @@ public:
     }
 
 private:
+    /// The decls of a file to hash, with whether each one is a top level decl.
+    struct FileHashTask {
+        Ptr<File> file;
+        std::vector<std::pair<Ptr<Decl>, bool>> decls;
+        std::optional<uint64_t> contentHash;
+    };
+    /// Cached hashes of the last compilation by raw mangled name, the top level one is null for member decls.
+    using CachedDeclMap =
+        std::unordered_map<std::string_view, std::pair<const DeclCacheBase*, const TopLevelDeclCache*>>;
+
     const AST::Package& p;
     ASTMangler mangler;
     // Note: polish the implementation here
@@ -61,6 +95,8 @@ private:
     // 1) debug mode, we need all code position info
     // 2) stacktrace, we need code position info of expressions and functions
     std::pair<bool, bool> srcInfo;
+    const SourceManager* sourceManager;
+    const CachedFileHashes* prevHashes;
     int gid{0}; // current gvid to increment when visiting a global or static variable or to use otherwise
     bool invp{false}; // in the visit of varwithpattern
     ASTCacheCalculator& calc;
@@ -72,10 +108,190 @@ private:
     std::unordered_map<RawMangledName, std::list<std::pair<Ptr<AST::ExtendDecl>, int>>>& directExtends;
     std::vector<const Decl*>& order;
     FileMap& fileMap;
+    FileContentHashMap& fileContentHashes;
     // output fields end
 
     FileMap::mapped_type* curFile{nullptr};
 
+    // Visit the members of a top level decl. Static vars are visited first so their gvid is smaller than other
+    // decls, and member parameters are visited right after their primary constructor.
+    template <typename Fn> static void ForEachTopLevelMember(const Decl& decl, Fn&& fn)
+    {
+        for (auto member : decl.GetMemberDeclPtrs()) {
+            if (IsStaticVar(*member)) {
+                fn(*member);
+            }
+        }
+        for (auto member : decl.GetMemberDeclPtrs()) {
+            if (IsStaticVar(*member)) {
+                continue;
+            }
+            fn(*member);
+            if (auto pd = DynamicCast<PrimaryCtorDecl*>(member);
+                pd && pd->funcBody && !pd->funcBody->paramLists.empty()) {
+                for (auto& param : pd->funcBody->paramLists[0]->params) {
+                    if (param->isMemberParam) {
+                        fn(*param);
+                    }
+                }
+            }
+        }
+    }
+
+    // Mangle a top level decl and its members in the order of the walk, and collect the decls to hash.
+    void MangleTopLevel(Decl& decl, std::vector<std::pair<Ptr<Decl>, bool>>& toHash)
+    {
+        if (IsDirectExtend(decl)) {
+            // the direct extend itself is hashed together with the other direct extends of the same name
+            decl.rawMangleName = mangler.Mangle(decl);
+            for (auto member : decl.GetMemberDeclPtrs()) {
+                MangleMember(*member, toHash);
+            }
+            return;
+        }
+        ForEachTopLevelMember(decl, [this, &toHash](Decl& member) { MangleMember(member, toHash); });
+        decl.rawMangleName = mangler.Mangle(decl);
+        toHash.emplace_back(&decl, true);
+        if (auto vp = DynamicCast<VarWithPatternDecl*>(&decl)) {
+            CJC_NULLPTR_CHECK(vp->irrefutablePattern);
+            ConcurrentWalk(vp->irrefutablePattern.get(), [this, &toHash](Ptr<Node> node) {
+                if (auto varDecl = DynamicCast<VarDecl*>(node)) {
+                    MangleTopLevel(*varDecl, toHash);
+                }
+                return VisitAction::WALK_CHILDREN;
+            });
+        }
+    }
+
+    void MangleMember(Decl& decl, std::vector<std::pair<Ptr<Decl>, bool>>& toHash)
+    {
+        for (auto member : GetMembers(decl)) {
+            MangleMember(*member, toHash);
+        }
+        decl.rawMangleName = mangler.Mangle(decl);
+        toHash.emplace_back(&decl, false);
+    }
+
+    // Hash the decls of each file on its own thread. The hasher only reads the AST and each decl is written by the
+    // task of its file, so no lock is needed.
+    void HashFiles(std::vector<FileHashTask>& tasks)
+    {
+        CachedDeclMap cachedDecls = CollectCachedDecls();
+        Utils::TaskQueue taskQueue(std::min<size_t>(tasks.size(), std::thread::hardware_concurrency()));
+        for (auto& task : tasks) {
+            taskQueue.AddTask<void>([this, &task, &cachedDecls]() { HashFile(task, cachedDecls); });
+        }
+        taskQueue.RunAndWaitForAllTasksCompleted();
+        for (auto& task : std::as_const(tasks)) {
+            if (task.contentHash) {
+                fileContentHashes[GetTrimmedPath(task.file.get())] = *task.contentHash;
+            }
+        }
+    }
+
+    CachedDeclMap CollectCachedDecls() const
+    {
+        CachedDeclMap res;
+        if (!prevHashes) {
+            return res;
+        }
+        for (auto& [mangle, decl] : prevHashes->curPkgASTCache) {
+            (void)res.emplace(mangle, std::make_pair(&decl, &decl));
+            CollectCachedMembers(decl, res);
+        }
+        return res;
+    }
+
+    static void CollectCachedMembers(const DeclCacheBase& decl, CachedDeclMap& res)
+    {
+        for (auto& member : decl.members) {
+            (void)res.emplace(member.rawMangle, std::make_pair(&member, nullptr));
+            CollectCachedMembers(member, res);
+        }
+    }
+
+    void HashFile(FileHashTask& task, const CachedDeclMap& cachedDecls) const
+    {
+        if (sourceManager) {
+            auto& sources = sourceManager->GetSources();
+            if (auto fileID = task.file->begin.fileID; fileID < sources.size()) {
+                task.contentHash = Utils::FastHash::GetHashValue(sources[fileID].buffer);
+            }
+        }
+        if (ReuseCachedHashes(task, cachedDecls)) {
+            return;
+        }
+        for (auto [decl, isTopLevel] : task.decls) {
+            HashDecl(*decl, isTopLevel);
+        }
+    }
+
+    // A file whose content is unchanged has the same decls as in the last compilation, unless macros are expanded
+    // in it, so their hashes are copied from the cache.
+    bool ReuseCachedHashes(const FileHashTask& task, const CachedDeclMap& cachedDecls) const
+    {
+        if (!prevHashes || !task.contentHash || task.file->hasMacro) {
+            return false;
+        }
+        auto it = prevHashes->fileContentHashes.find(GetTrimmedPath(task.file.get()));
+        if (it == prevHashes->fileContentHashes.cend() || it->second != *task.contentHash) {
+            return false;
+        }
+        std::vector<CachedDeclMap::mapped_type> cached;
+        cached.reserve(task.decls.size());
+        for (auto [decl, isTopLevel] : task.decls) {
+            auto cachedIt = cachedDecls.find(decl->rawMangleName);
+            if (cachedIt == cachedDecls.cend() || (isTopLevel && !cachedIt->second.second)) {
+                return false;
+            }
+            cached.push_back(cachedIt->second);
+        }
+        for (size_t i{0}; i < task.decls.size(); ++i) {
+            auto& decl = *task.decls[i].first;
+            auto [cache, topLevelCache] = cached[i];
+            decl.hash.srcUse = cache->srcUse;
+            decl.hash.bodyHash = cache->bodyHash;
+            decl.hash.sig = cache->sigHash;
+            if (task.decls[i].second) {
+                decl.hash.instVar = topLevelCache->instVarHash;
+                decl.hash.virt = topLevelCache->virtHash;
+            }
+        }
+        return true;
+    }
+
+    void HashDecl(Decl& decl, bool isTopLevel) const
+    {
+        decl.hash.srcUse = ASTHasher::SrcUseHash(decl);
+        decl.hash.bodyHash = ASTHasher::BodyHash(decl, srcInfo);
+        decl.hash.sig = ASTHasher::SigHash(decl);
+        if (!isTopLevel) {
+            return;
+        }
+        size_t instVarHash{0};
+        size_t virtHash{0};
+        switch (decl.astKind) {
+            case ASTKind::ENUM_DECL:
+                instVarHash = VisitEnumConstructors(static_cast<const EnumDecl&>(decl));
+                break;
+            case ASTKind::INTERFACE_DECL:
+                // Instantce interface members are also treated as open.
+                virtHash = VirtualHashOfInterface(decl);
+                break;
+            case ASTKind::CLASS_DECL:
+                virtHash = ASTHasher::VirtualHash(static_cast<const ClassDecl&>(decl));
+                instVarHash = VisitMemberVariables(decl);
+                break;
+            case ASTKind::STRUCT_DECL:
+                instVarHash = VisitMemberVariables(decl);
+                break;
+            default:
+                break;
+        }
+        decl.hash.instVar = instVarHash;
+        decl.hash.virt = virtHash;
+    }
+
     TopLevelDeclCache ComputeDirectExtend(std::list<std::pair<Ptr<AST::ExtendDecl>, int>>&& extends)
     {
         TopLevelDeclCache r{};
@@ -105,7 +321,6 @@ private:
         if (auto extend = DynamicCast<ExtendDecl*>(&decl); extend && extend->inheritedTypes.empty()) {
             // collect direct extends but do not compute the cache; delay the computation until all direct extends
             // with the same name are seen
-            extend->rawMangleName = mangler.Mangle(*extend);
             auto& it = directExtends[extend->rawMangleName];
             if (it.empty()) {
                 order.push_back(&decl); // ensure direct extends are written to the cache only once
@@ -125,7 +340,7 @@ private:
 
     static void CombineDeclHash(size_t& acc, const Decl& decl)
     {
-        acc = ASTHasher::CombineHash(acc, Utils::SipHash::GetHashValue(decl.rawMangleName));
+        acc = ASTHasher::CombineHash(acc, Utils::FastHash::GetHashValue(decl.rawMangleName));
         acc = ASTHasher::CombineHash(acc, ASTHasher::SigHash(decl));
         acc = ASTHasher::CombineHash(acc, ASTHasher::SrcUseHash(decl));
     }
@@ -169,7 +384,7 @@ private:
 
     size_t VisitEnumConstructors(const EnumDecl& decl) const
     {
-        size_t hashed = Utils::SipHash::GetHashValue(decl.hasEllipsis);
+        size_t hashed = Utils::FastHash::GetHashValue(decl.hasEllipsis);
         for (auto& cons : decl.constructors) {
             CombineDeclHash(hashed, *cons);
         }
@@ -215,37 +430,18 @@ private:
     void VisitVarWithPattern(const VarWithPatternDecl& decl)
     {
         CJC_NULLPTR_CHECK(decl.irrefutablePattern);
-        Walker(decl.irrefutablePattern.get(), [this](Ptr<Node> node) {
+        ConcurrentWalk(decl.irrefutablePattern.get(), [this](Ptr<Node> node) {
             if (auto varDecl = DynamicCast<VarDecl*>(node)) {
                 WalkDecl(*varDecl);
             }
             return VisitAction::WALK_CHILDREN;
-        }).Walk();
+        });
     }
 
     void VisitTopLevelDeclMembers(const Decl& decl, TopLevelDeclCache& result)
     {
-        for (auto member : decl.GetMemberDeclPtrs()) {
-            // visit static var first so their gvid is smaller than other decls
-            if (IsStaticVar(*member)) {
-                result.members.push_back(VisitMember(*member));
-            }
-        }
-        for (auto member : decl.GetMemberDeclPtrs()) {
-            // then visit other member decls
-            if (!IsStaticVar(*member)) {
-                result.members.push_back(VisitMember(*member));
-                // visit member parameters
-                if (auto pd = DynamicCast<PrimaryCtorDecl*>(member);
-                    pd && pd->funcBody && !pd->funcBody->paramLists.empty()) {
-                    for (auto& param : pd->funcBody->paramLists[0]->params) {
-                        if (param->isMemberParam) {
-                            result.members.push_back(VisitMember(*param));
-                        }
-                    }
-                }
-            }
-        }
+        ForEachTopLevelMember(
+            decl, [this, &result](Decl& member) { result.members.push_back(VisitMember(member)); });
     }
 
     static bool IsDirectExtend(const Decl& decl)
@@ -264,11 +460,7 @@ private:
         for (auto member : GetMembers(decl)) {
             PrevisitDirectExtendMember(*member);
         }
-        decl.rawMangleName = mangler.Mangle(decl);
         CollectDecl(decl);
-        decl.hash.srcUse = ASTHasher::SrcUseHash(decl);
-        decl.hash.bodyHash = ASTHasher::BodyHash(decl, srcInfo);
-        decl.hash.sig = ASTHasher::SigHash(decl);
         decl.hash.gvid = gid;
         if (IsOOEAffectedDecl(decl)) {
             CJC_NULLPTR_CHECK(curFile);
@@ -281,20 +473,6 @@ private:
     void VisitTopLevelImpl1(const Decl& decl, TopLevelDeclCache& result)
     {
         switch (decl.astKind) {
-            case ASTKind::ENUM_DECL:
-                result.instVarHash = VisitEnumConstructors(static_cast<const EnumDecl&>(decl));
-                break;
-            case ASTKind::INTERFACE_DECL:
-                // Instantce interface members are also treated as open.
-                result.virtHash = VirtualHashOfInterface(decl);
-                break;
-            case ASTKind::CLASS_DECL:
-                result.virtHash = ASTHasher::VirtualHash(static_cast<const ClassDecl&>(decl));
-                result.instVarHash = VisitMemberVariables(decl);
-                break;
-            case ASTKind::STRUCT_DECL:
-                result.instVarHash = VisitMemberVariables(decl);
-                break;
             case ASTKind::VAR_WITH_PATTERN_DECL:
                 ++gid;
                 invp = true;
@@ -336,13 +514,12 @@ private:
         TopLevelDeclCache result{};
         VisitTopLevelDeclMembers(decl, result);
 
-        decl.rawMangleName = mangler.Mangle(decl);
-        decl.hash.srcUse = result.srcUse = ASTHasher::SrcUseHash(decl);
-        decl.hash.bodyHash = result.bodyHash = ASTHasher::BodyHash(decl, srcInfo);
-        decl.hash.sig = result.sigHash = ASTHasher::SigHash(decl);
+        result.srcUse = decl.hash.srcUse;
+        result.bodyHash = decl.hash.bodyHash;
+        result.sigHash = decl.hash.sig;
         VisitTopLevelImpl1(decl, result);
-        decl.hash.instVar = result.instVarHash;
-        decl.hash.virt = result.virtHash;
+        result.instVarHash = decl.hash.instVar;
+        result.virtHash = decl.hash.virt;
         result.gvid = {GetTrimmedPath(decl.curFile.get()), decl.hash.gvid = gid};
         result.astKind = static_cast<uint8_t>(decl.astKind);
         return result;
@@ -354,11 +531,11 @@ private:
         for (auto member : GetMembers(decl)) {
             result.members.push_back(VisitMember(*member));
         }
-        result.rawMangle = decl.rawMangleName = mangler.Mangle(decl);
+        result.rawMangle = decl.rawMangleName;
         CollectDecl(decl);
-        decl.hash.srcUse = result.srcUse = ASTHasher::SrcUseHash(decl);
-        decl.hash.bodyHash = result.bodyHash = ASTHasher::BodyHash(decl, srcInfo);
-        decl.hash.sig = result.sigHash = ASTHasher::SigHash(decl);
+        result.srcUse = decl.hash.srcUse;
+        result.bodyHash = decl.hash.bodyHash;
+        result.sigHash = decl.hash.sig;
         if (IsStaticVar(decl)) {
             ++gid; // only increment gid, not basegid
         }
@@ -415,8 +592,9 @@ private:
     }
 };
 
-ASTCacheCalculator::ASTCacheCalculator(const AST::Package& p, const std::pair<bool, bool>& srcInfo)
-    : impl{MakeOwned<ASTCacheCalculatorImpl>(*this, p, srcInfo)}
+ASTCacheCalculator::ASTCacheCalculator(const AST::Package& p, const std::pair<bool, bool>& srcInfo,
+    const SourceManager* sourceManager, const CachedFileHashes* prevHashes)
+    : impl{MakeOwned<ASTCacheCalculatorImpl>(*this, p, srcInfo, sourceManager, prevHashes)}
 {
 }
 ASTCacheCalculator::~ASTCacheCalculator() = default;
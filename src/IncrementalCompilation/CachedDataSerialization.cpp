@@ -192,6 +192,18 @@ void LoadCCOutFunc(const CachedASTFormat::HashedPackage& package, CompilationCac
         }
     }
 }
+
+FileContentHashMap LoadFileContentHashes(const CachedASTFormat::HashedPackage& package)
+{
+    FileContentHashMap ret{};
+    if (package.fileContentHashes()) {
+        for (uoffset_t i = 0; i < package.fileContentHashes()->size(); i++) {
+            auto fileHash = package.fileContentHashes()->Get(i);
+            ret[fileHash->file()->str()] = fileHash->hash();
+        }
+    }
+    return ret;
+}
 } // namespace
 
 #ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
@@ -212,6 +224,7 @@ bool WriteCache(const Package& pkg, CompilationCache&& cachedInfo, std::vector<c
     writer.SetCCOutFuncs(cachedInfo.ccOutFuncs);
     writer.SetSemanticInfo(cachedInfo.semaInfo);
     writer.SetBitcodeFilesName(cachedInfo.bitcodeFilesName);
+    writer.SetFileContentHashes(cachedInfo.fileContentHashes);
     writer.WriteAllDecls(
         std::move(cachedInfo.curPkgASTCache), std::move(cachedInfo.importedASTCache), std::move(order));
 
@@ -313,6 +326,14 @@ void HashedASTWriter::SetBitcodeFilesName(const std::vector<std::string>& bitcod
     }
 }
 
+void HashedASTWriter::SetFileContentHashes(const FileContentHashMap& hashes)
+{
+    for (const auto& [file, hash] : hashes) {
+        auto fileOffset = builder.CreateSharedString(file);
+        fileContentHashes.emplace_back(CachedASTFormat::CreateFileContentHash(builder, fileOffset, hash));
+    }
+}
+
 std::vector<uint8_t> HashedASTWriter::AST2FB(const std::string& pkgName)
 {
     auto cjcVersion = builder.CreateString(CANGJIE_VERSION);
@@ -324,9 +345,10 @@ std::vector<uint8_t> HashedASTWriter::AST2FB(const std::string& pkgName)
     auto varDep = builder.CreateVector<TVirtualDepOffset>(varInitDep);
     auto bcFilesName = builder.CreateVector<TStringOffset>(bitcodeFilesName);
     auto ccOutFuncVec = builder.CreateVector<TStringOffset>(ccOutFuncs);
+    auto fileHashes = builder.CreateVector<TFileContentHashOffset>(fileContentHashes);
     auto root = CachedASTFormat::CreateHashedPackage(builder, cjcVersion, packageName, specs, optArgs, allAST,
         importedDecls, declDep, optInfo, virDep, varDep, ccOutFuncVec, lambdaCounter, envClassCounter,
-        stringLiteralCounter, semaUsages, bcFilesName);
+        stringLiteralCounter, semaUsages, bcFilesName, fileHashes);
     FinishHashedPackageBuffer(builder, root);
     auto size = static_cast<size_t>(builder.GetSize());
     std::vector<uint8_t> data;
@@ -344,16 +366,43 @@ bool HashedASTLoader::VerifyData()
     return CachedASTFormat::VerifyHashedPackageBuffer(verifier);
 }
 
-std::pair<bool, CompilationCache> HashedASTLoader::DeserializeData(const RawMangled2DeclMap& mangledName2DeclMap)
+const CachedASTFormat::HashedPackage* HashedASTLoader::GetPackage()
 {
     if (!VerifyData()) {
-        return {false, {}};
+        return nullptr;
     }
     const auto package = CachedASTFormat::GetHashedPackage(serializedData.data());
     CJC_NULLPTR_CHECK(package);
     CJC_NULLPTR_CHECK(package->version());
     if (package->version()->str() != CANGJIE_VERSION) {
         // Incremental compilation do not use cached data created with different version.
+        return nullptr;
+    }
+    return package;
+}
+
+std::optional<CachedFileHashes> HashedASTLoader::DeserializeFileHashes(const std::vector<std::string>& compileArgs)
+{
+    const auto package = GetPackage();
+    if (!package || !package->compileOptionArgs() || !package->fileContentHashes()) {
+        return std::nullopt;
+    }
+    // The hashes depend on the options, e.g. whether the code positions are hashed.
+    if (package->compileOptionArgs()->size() != compileArgs.size()) {
+        return std::nullopt;
+    }
+    for (uoffset_t i = 0; i < package->compileOptionArgs()->size(); i++) {
+        if (package->compileOptionArgs()->Get(i)->str() != compileArgs[i]) {
+            return std::nullopt;
+        }
+    }
+    return CachedFileHashes{LoadFileContentHashes(*package), LoadCachedAST(*package)};
+}
+
+std::pair<bool, CompilationCache> HashedASTLoader::DeserializeData(const RawMangled2DeclMap& mangledName2DeclMap)
+{
+    const auto package = GetPackage();
+    if (!package) {
         return {false, {}};
     }
     CompilationCache cached;
@@ -380,6 +429,7 @@ std::pair<bool, CompilationCache> HashedASTLoader::DeserializeData(const RawMang
         }
         cached.fileMap.emplace(std::move(const_cast<std::string&>(m.first)), std::move(tmp));
     }
+    cached.fileContentHashes = LoadFileContentHashes(*package);
     cached.importedASTCache = LoadImported(*package);
     cached.specs = package->specs();
     cached.lambdaCounter = package->lambdaCounter();
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <flatbuffers/flatbuffers.h>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -24,6 +25,7 @@
 
 namespace Cangjie {
 using TVirtualDepOffset = flatbuffers::Offset<CachedASTFormat::VirtualDep>;
+using TFileContentHashOffset = flatbuffers::Offset<CachedASTFormat::FileContentHash>;
 class HashedASTWriter {
 public:
     HashedASTWriter() = default;
@@ -43,6 +45,7 @@ public:
     void SetVarInitDep(const VarInitDepMap& depMap);
     void SetCCOutFuncs(const std::set<std::string>& funcs);
     void SetBitcodeFilesName(const std::vector<std::string>& bitcodeFiles);
+    void SetFileContentHashes(const FileContentHashMap& hashes);
     void SetSemanticInfo(const SemanticInfo& info);
     void WriteAllDecls(ASTCache&& ast, ASTCache&& imports, std::vector<const AST::Decl*>&& order);
     std::vector<uint8_t> AST2FB(const std::string& pkgName);
@@ -56,6 +59,7 @@ private:
     std::vector<TVirtualDepOffset> virtualFuncDep;
     std::vector<TVirtualDepOffset> varInitDep;
     std::vector<TStringOffset> ccOutFuncs;
+    std::vector<TFileContentHashOffset> fileContentHashes;
     // NOTE: For incremental compilation 2.0. Above members will be removed later.
     flatbuffers::Offset<CachedASTFormat::SemanticInfo> semaUsages;
     flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<CachedASTFormat::TopDecl>>> allAST;
@@ -73,9 +77,12 @@ public:
     }
     ~HashedASTLoader() = default;
     std::pair<bool, CompilationCache> DeserializeData(const RawMangled2DeclMap& mangledName2DeclMap);
+    /// Load only the decl hashes and the file content hashes, nullopt if they were computed with other options.
+    std::optional<CachedFileHashes> DeserializeFileHashes(const std::vector<std::string>& compileArgs);
 
 private:
     bool VerifyData();
+    const CachedASTFormat::HashedPackage* GetPackage();
     ASTCache LoadCachedAST(const CachedASTFormat::HashedPackage& p);
     std::unordered_map<RawMangledName, TopLevelDeclCache> LoadImported(const CachedASTFormat::HashedPackage& p);
     static SemanticInfo LoadSemanticInfos(
@@ -271,6 +271,19 @@ static std::optional<CompilationCache> LoadCacheInfo(
     return cachedInfo;
 }
 
+std::optional<CachedFileHashes> Cangjie::LoadCachedFileHashes(
+    const GlobalOptions& op, const std::string& fullPackageName)
+{
+    std::string cachePath = op.GenerateCachedPathName(fullPackageName, CACHED_AST_EXTENSION);
+    std::vector<uint8_t> data;
+    std::string failedReason;
+    if (!FileUtil::ReadBinaryFileToBuffer(cachePath, data, failedReason)) {
+        return {};
+    }
+    HashedASTLoader loader(std::move(data));
+    return loader.DeserializeFileHashes(op.ToSerialized());
+}
+
 namespace {
 struct ImportPackageWalker {
     static std::tuple<ASTCache, RawMangled2DeclMap, SrcImportedDepMap, TypeMap> Get(
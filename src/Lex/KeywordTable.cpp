@@ -0,0 +1,96 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements class KeywordTable.
+ */
+
+#include "KeywordTable.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "cangjie/Utils/CheckUtils.h"
+
+using namespace Cangjie;
+
+namespace {
+constexpr uint32_t MAX_SEED = 1u << 20;
+
+std::vector<TokenKind> CollectKeywordKinds()
+{
+    std::vector<TokenKind> kinds;
+    for (unsigned char i = 0; i < static_cast<unsigned char>(TokenKind::IDENTIFIER); i++) {
+        kinds.emplace_back(static_cast<TokenKind>(i));
+    }
+    // These are added after TokenKind::IDENTIFIER.
+    kinds.insert(kinds.end(),
+        {TokenKind::AT_EXCL, TokenKind::COMMON, TokenKind::PLATFORM, TokenKind::FEATURES, TokenKind::PERFORM,
+            TokenKind::RESUME, TokenKind::THROWING, TokenKind::HANDLE});
+    return kinds;
+}
+} // namespace
+
+const KeywordTable& KeywordTable::Get()
+{
+    static const KeywordTable TABLE;
+    return TABLE;
+}
+
+KeywordTable::KeywordTable()
+{
+    std::vector<Entry> keys;
+    for (auto kind : CollectKeywordKinds()) {
+        keys.emplace_back(Entry{TOKENS[static_cast<unsigned char>(kind)], kind});
+    }
+    keys.emplace_back(Entry{"true", TokenKind::BOOL_LITERAL});
+    keys.emplace_back(Entry{"false", TokenKind::BOOL_LITERAL});
+    CJC_ASSERT(keys.size() < SLOTS_NUM);
+
+    std::array<std::vector<Entry>, BUCKETS_NUM> buckets;
+    for (auto& key : keys) {
+        maxKeyLength = std::max(maxKeyLength, key.key.size());
+        buckets[Hash(key.key, 0) & (BUCKETS_NUM - 1)].emplace_back(key);
+    }
+    std::array<size_t, BUCKETS_NUM> order;
+    for (size_t i = 0; i < BUCKETS_NUM; ++i) {
+        order[i] = i;
+    }
+    // Place the largest buckets first, while most slots are still free.
+    std::stable_sort(order.begin(), order.end(),
+        [&buckets](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    std::array<bool, SLOTS_NUM> used{};
+    std::vector<size_t> placed;
+    for (auto bucketIdx : order) {
+        auto& bucket = buckets[bucketIdx];
+        if (bucket.empty()) {
+            break;
+        }
+        uint32_t seed = 1;
+        for (; seed < MAX_SEED; ++seed) {
+            placed.clear();
+            for (auto& key : bucket) {
+                size_t slot = Hash(key.key, seed) & (SLOTS_NUM - 1);
+                if (used[slot] || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                    break;
+                }
+                placed.emplace_back(slot);
+            }
+            if (placed.size() == bucket.size()) {
+                break;
+            }
+        }
+        CJC_ASSERT(seed < MAX_SEED);
+        seeds[bucketIdx] = seed;
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            used[placed[i]] = true;
+            slots[placed[i]] = bucket[i];
+        }
+    }
+}
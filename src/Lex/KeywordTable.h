@@ -0,0 +1,78 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file declares class KeywordTable, the perfect hash table of keywords and symbols used by the lexer.
+ */
+
+#ifndef CANGJIE_LEX_KEYWORDTABLE_H
+#define CANGJIE_LEX_KEYWORDTABLE_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "cangjie/Lex/Token.h"
+
+namespace Cangjie {
+/**
+ * A read-only table mapping the text of keywords and symbols to their TokenKind. It is built once per process
+ * with hash and displace: keys are grouped into buckets by a first hash, every bucket gets a seed such that a
+ * second hash puts its keys into free slots. A lookup then costs two hashes and a single string comparison.
+ * The experimental effect handler keywords are always in the table, the lexer filters them when disabled.
+ */
+class KeywordTable {
+public:
+    static const KeywordTable& Get();
+
+    /// Returns the kind of keyword or symbol @p text, or TokenKind::IDENTIFIER if it is neither.
+    TokenKind Lookup(std::string_view text) const
+    {
+        if (text.empty() || text.size() > maxKeyLength) {
+            return TokenKind::IDENTIFIER;
+        }
+        uint32_t seed = seeds[Hash(text, 0) & (BUCKETS_NUM - 1)];
+        const Entry& entry = slots[Hash(text, seed) & (SLOTS_NUM - 1)];
+        return entry.key == text ? entry.kind : TokenKind::IDENTIFIER;
+    }
+
+    static bool IsEHKeyword(TokenKind kind)
+    {
+        return kind == TokenKind::PERFORM || kind == TokenKind::RESUME || kind == TokenKind::THROWING ||
+            kind == TokenKind::HANDLE;
+    }
+
+private:
+    struct Entry {
+        std::string_view key;
+        TokenKind kind{TokenKind::IDENTIFIER};
+    };
+    static constexpr size_t BUCKETS_NUM = 64;  // Must be a power of 2.
+    static constexpr size_t SLOTS_NUM = 256;   // Must be a power of 2 and larger than the number of keys.
+
+    KeywordTable();
+
+    static uint32_t Hash(std::string_view text, uint32_t seed)
+    {
+        // FNV-1a, keys are short so this is cheaper than std::hash.
+        constexpr uint32_t fnvOffset = 2166136261u;
+        constexpr uint32_t fnvPrime = 16777619u;
+        uint32_t h = fnvOffset ^ (seed * fnvPrime);
+        for (char c : text) {
+            h = (h ^ static_cast<uint8_t>(c)) * fnvPrime;
+        }
+        return h ^ (h >> 15); // Mix the high bits into the masked low bits.
+    }
+
+    std::array<uint32_t, BUCKETS_NUM> seeds{};
+    std::array<Entry, SLOTS_NUM> slots{};
+    size_t maxKeyLength{0};
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_LEX_KEYWORDTABLE_H
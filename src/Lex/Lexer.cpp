@@ -19,6 +19,7 @@
 #include "cangjie/Basic/Display.h"
 #include "cangjie/Basic/Utils.h"
 #include "cangjie/Utils/Unicode.h"
+#include "KeywordTable.h"
 
 using namespace Cangjie;
 namespace {
@@ -287,15 +288,13 @@ void LexerImpl::ReadUTF8CharFromMultiBytes(int32_t& ch)
     }
 }
 
-TokenKind LexerImpl::LookupKeyword(const std::string& literal)
+TokenKind LexerImpl::LookupKeyword(std::string_view literal) const
 {
-    if (LexerImpl::tokenMap.count(literal) != 0) {
-        // keyword
-        return LexerImpl::tokenMap[literal];
+    auto kind = KeywordTable::Get().Lookup(literal);
+    if (!ehEnabled && KeywordTable::IsEHKeyword(kind)) {
+        return TokenKind::IDENTIFIER;
     }
-
-    // identifier
-    return TokenKind::IDENTIFIER;
+    return kind;
 }
 
 void LexerImpl::Back()
@@ -739,6 +738,7 @@ void LexerImpl::ScanIdentifierContinue(Token& res, const char* pStart)
 {
     CJC_ASSERT(pCurrent == pStart);
     res.kind = TokenKind::IDENTIFIER;
+    bool isASCII = IsASCII(static_cast<UTF32>(static_cast<uint8_t>(*pStart)));
     while (pNext != pInputEnd) { // input may end at the last identifier
         currentChar = *pNext;
         auto cp = static_cast<UTF32>(currentChar);
@@ -750,13 +750,15 @@ void LexerImpl::ScanIdentifierContinue(Token& res, const char* pStart)
         if (IsASCII(cp)) {
             break;
         }
+        isASCII = false;
         if (!TryConsumeIdentifierUTF8Char()) {
             res.kind = TokenKind::ILLEGAL;
             break;
         }
     }
     std::string s{pStart, pNext};
-    if (res.kind == TokenKind::IDENTIFIER) {
+    // ASCII identifiers are already in NFC.
+    if (res.kind == TokenKind::IDENTIFIER && !isASCII) {
         NFC(s);
     }
     res.SetValuePos(std::move(s), GetPos(pStart), GetPos(pNext));
@@ -1675,7 +1677,7 @@ void LexerImpl::ScanSymbolColon()
 
 Token LexerImpl::GetSymbolToken(const char* pStart)
 {
-    TokenKind kind = LookupKeyword(std::string(pStart, pNext));
+    TokenKind kind = LookupKeyword(std::string_view(pStart, static_cast<size_t>(pNext - pStart)));
     if (kind == TokenKind::IDENTIFIER) {
         if (success) {
             DiagUnknownStartOfToken(GetPos(pStart));
@@ -44,7 +44,6 @@ public:
           splitAmbiguousToken{args.splitAmbiguousToken},
           enableCollectTokenStream{args.collectTokenStream}
     {
-        Init();
         EnterNormalMod();
     }
     LexerImpl(const std::vector<Token>& inputTokens, DiagnosticEngine& diag, SourceManager& sm, LexerConfig args)
@@ -56,7 +55,6 @@ public:
           enableScan{false},
           enableCollectTokenStream{args.collectTokenStream}
     {
-        Init();
         EnterNormalMod();
         lineResetOffsetsFromBase = 0;
         for (auto& tk : inputTokens) {
@@ -153,7 +151,7 @@ private:
     const char* pCurrent{nullptr};  // point to the current character
     const char* pResetCurrent{nullptr};
     int32_t currentChar{-1}; // currently processing character
-    std::unordered_map<std::string_view, TokenKind> tokenMap{};
+    bool ehEnabled{false}; // Whether the experimental effect handler keywords are recognized.
     unsigned lineResetOffsetsFromBase{0};
     TokenKind tokenKind{TokenKind::ILLEGAL};
     Position pos;
@@ -211,7 +209,7 @@ private:
     bool ProcessDigits(const int& base, bool& hasDigit, const char* reasonPoint, bool* isFloat = nullptr);
     std::string GetSuffix(const char* pSuffixStart);
     void ProcessIntegerSuffix();
-    TokenKind LookupKeyword(const std::string& literal);
+    TokenKind LookupKeyword(std::string_view literal) const;
     void ProcessEscape(const char* pStart, bool isInString, bool isByteLiteral);
     void ProcessUnicodeEscape();
     Token ProcessIllegalToken(bool needStringParts, bool multiLine, const char* pStart, bool isJString = false);
@@ -319,23 +317,6 @@ private:
     {
         diag.Diagnose(diagPos, kind, args...);
     }
-    void Init()
-    {
-        for (unsigned char i = 0; i < static_cast<unsigned char>(TokenKind::IDENTIFIER); i++) {
-            tokenMap[TOKENS[i]] = static_cast<TokenKind>(i);
-        }
-        // @! is added after TokenKind::IDENTIFIER
-        auto atExclIndex = static_cast<unsigned char>(TokenKind::AT_EXCL);
-        tokenMap[TOKENS[atExclIndex]] = static_cast<TokenKind>(atExclIndex);
-        auto commonIndex = static_cast<unsigned char>(TokenKind::COMMON);
-        tokenMap[TOKENS[commonIndex]] = static_cast<TokenKind>(commonIndex);
-        auto platformIndex = static_cast<unsigned char>(TokenKind::PLATFORM);
-        tokenMap[TOKENS[platformIndex]] = static_cast<TokenKind>(platformIndex);
-        tokenMap["true"] = TokenKind::BOOL_LITERAL;
-        tokenMap["false"] = TokenKind::BOOL_LITERAL;
-        auto ftrIndex = static_cast<unsigned char>(TokenKind::FEATURES);
-        tokenMap[TOKENS[ftrIndex]] = TokenKind::FEATURES;
-    }
     void Back();
     bool IsCharOrString() const;
     Token ScanCharOrString(const char* pStart);
@@ -0,0 +1,40 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the storage of token values.
+ */
+
+#include "cangjie/Lex/Token.h"
+
+using namespace Cangjie;
+
+namespace {
+bool IsPooledKind(TokenKind kind)
+{
+    switch (kind) {
+        case TokenKind::COMMENT:
+        case TokenKind::STRING_LITERAL:
+        case TokenKind::JSTRING_LITERAL:
+        case TokenKind::MULTILINE_STRING:
+        case TokenKind::MULTILINE_RAW_STRING:
+            return false;
+        default:
+            return true;
+    }
+}
+} // namespace
+
+void Token::SetValue(std::string s)
+{
+    if (IsPooledKind(kind)) {
+        v = StringPool::Intern(s);
+    } else {
+        v = SharedString(std::move(s));
+    }
+}
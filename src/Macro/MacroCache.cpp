@@ -0,0 +1,246 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the on-disk cache of macro expansion results.
+ */
+
+#include "cangjie/Macro/MacroCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "cangjie/Basic/Version.h"
+#include "cangjie/Macro/TokenSerialization.h"
+#include "cangjie/Utils/FastHash.h"
+#include "cangjie/Utils/FileUtil.h"
+
+using namespace Cangjie;
+
+namespace {
+/**
+ * An entry is: the magic, the key size as uint32_t, the key, the serialized tokens. The whole key is stored so that
+ * a hash collision of the file name is a miss rather than a wrong expansion.
+ */
+constexpr char ENTRY_MAGIC[] = {'C', 'J', 'M', 'C'};
+constexpr size_t MAGIC_SIZE = sizeof(ENTRY_MAGIC);
+const std::string ENTRY_EXTENSION = ".macro";
+
+void AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    (void)buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void AppendString(std::vector<uint8_t>& buffer, const std::string& str)
+{
+    uint64_t size = str.size();
+    AppendBytes(buffer, &size, sizeof(size));
+    AppendBytes(buffer, str.data(), str.size());
+}
+
+void AppendBlock(std::vector<uint8_t>& buffer, const std::vector<uint8_t>& block)
+{
+    uint64_t size = block.size();
+    AppendBytes(buffer, &size, sizeof(size));
+    AppendBytes(buffer, block.data(), block.size());
+}
+
+/**
+ * Whether @p size bytes at @p data are exactly the tokens serialized by 'TokenSerialization::GetTokensBytes'. The
+ * deserializer trusts the sizes in the buffer, so a truncated or corrupted entry must be rejected before it is read.
+ */
+bool IsValidTokensPayload(const uint8_t* data, size_t size)
+{
+    size_t offset = 0;
+    auto read = [data, size, &offset](void* value, size_t valueSize) {
+        if (size - offset < valueSize) {
+            return false;
+        }
+        (void)memcpy(value, data + offset, valueSize);
+        offset += valueSize;
+        return true;
+    };
+    auto skip = [size, &offset](size_t skipSize) {
+        if (size - offset < skipSize) {
+            return false;
+        }
+        offset += skipSize;
+        return true;
+    };
+    uint32_t tokenNum = 0;
+    if (!read(&tokenNum, sizeof(tokenNum))) {
+        return false;
+    }
+    // Kind, string size, file id, line, column and single quote flag, without the string.
+    constexpr size_t minTokenSize = sizeof(uint16_t) + sizeof(uint32_t) * 4 + sizeof(uint16_t);
+    if ((size - offset) / minTokenSize < tokenNum) {
+        return false;
+    }
+    for (uint32_t i = 0; i < tokenNum; ++i) {
+        uint16_t kind = 0;
+        uint32_t strLen = 0;
+        if (!read(&kind, sizeof(kind)) || !read(&strLen, sizeof(strLen)) || !skip(strLen) ||
+            !skip(sizeof(uint32_t) * 3 + sizeof(uint16_t))) {
+            return false;
+        }
+        // The delimiter number of a multi-line raw string.
+        if (static_cast<TokenKind>(kind) == TokenKind::MULTILINE_RAW_STRING && !skip(sizeof(uint16_t))) {
+            return false;
+        }
+    }
+    return offset == size;
+}
+} // namespace
+
+bool MacroCache::IsCacheable(const MacroCall& macCall)
+{
+    return !macCall.libPath.empty() && !macCall.parentMacroCall && macCall.children.empty() &&
+        !macCall.usedCompilerCallback && macCall.GetInvocation();
+}
+
+std::optional<uint64_t> MacroCache::GetLibHash(const std::string& libPath)
+{
+    if (auto it = libHashes.find(libPath); it != libHashes.end()) {
+        return it->second;
+    }
+    std::string failedReason;
+    std::optional<uint64_t> hash;
+    if (auto file = FileUtil::MappedFile::Open(libPath, failedReason)) {
+        hash = Utils::FastHash::Hash(file->Data(), file->Size());
+    }
+    libHashes.emplace(libPath, hash);
+    return hash;
+}
+
+std::optional<uint64_t> MacroCache::GetLoadedLibsHash()
+{
+    if (loadedLibsHash) {
+        return *loadedLibsHash;
+    }
+    // Sorted, so that the hash does not depend on the order the libraries were collected in.
+    std::sort(loadedLibs.begin(), loadedLibs.end());
+    std::vector<uint8_t> buffer;
+    for (auto& lib : loadedLibs) {
+        auto hash = GetLibHash(lib);
+        if (!hash) {
+            // A library which cannot be read cannot be checked for changes, nothing is cached.
+            loadedLibsHash.emplace(std::nullopt);
+            return std::nullopt;
+        }
+        AppendString(buffer, lib);
+        AppendBytes(buffer, &hash.value(), sizeof(uint64_t));
+    }
+    loadedLibsHash.emplace(Utils::FastHash::Hash(buffer.data(), buffer.size()));
+    return *loadedLibsHash;
+}
+
+std::optional<std::vector<uint8_t>> MacroCache::GetKey(const MacroCall& macCall)
+{
+    auto libHash = GetLibHash(macCall.libPath);
+    auto loadedHash = GetLoadedLibsHash();
+    if (!libHash || !loadedHash) {
+        return std::nullopt;
+    }
+    auto invocation = macCall.GetInvocation();
+    std::vector<uint8_t> key;
+    AppendString(key, CANGJIE_VERSION);
+    AppendBytes(key, &libHash.value(), sizeof(uint64_t));
+    AppendBytes(key, &loadedHash.value(), sizeof(uint64_t));
+    AppendString(key, macCall.methodName);
+    uint8_t hasAttr = invocation->hasAttr ? 1 : 0;
+    AppendBytes(key, &hasAttr, sizeof(hasAttr));
+    AppendBlock(key, TokenSerialization::GetTokensBytes(invocation->attrs));
+    AppendBlock(key, TokenSerialization::GetTokensBytes(invocation->args));
+    return key;
+}
+
+std::string MacroCache::GetEntryPath(const std::vector<uint8_t>& key) const
+{
+    std::stringstream ss;
+    ss << std::hex << Utils::FastHash::Hash(key.data(), key.size());
+    return FileUtil::JoinPath(cacheDir, ss.str() + ENTRY_EXTENSION);
+}
+
+std::optional<std::vector<Token>> MacroCache::Lookup(const MacroCall& macCall)
+{
+    if (!IsCacheable(macCall)) {
+        return std::nullopt;
+    }
+    auto key = GetKey(macCall);
+    if (!key) {
+        return std::nullopt;
+    }
+    auto path = GetEntryPath(*key);
+    if (!FileUtil::FileExist(path)) {
+        return std::nullopt;
+    }
+    std::string failedReason;
+    auto file = FileUtil::MappedFile::Open(path, failedReason);
+    if (!file) {
+        return std::nullopt;
+    }
+    auto data = file->Data();
+    auto size = file->Size();
+    uint32_t keySize = 0;
+    if (size < MAGIC_SIZE + sizeof(keySize) || memcmp(data, ENTRY_MAGIC, MAGIC_SIZE) != 0) {
+        return std::nullopt;
+    }
+    (void)memcpy(&keySize, data + MAGIC_SIZE, sizeof(keySize));
+    auto keyBegin = MAGIC_SIZE + sizeof(keySize);
+    if (keySize != key->size() || size < keyBegin + keySize || memcmp(data + keyBegin, key->data(), keySize) != 0) {
+        return std::nullopt;
+    }
+    // An entry truncated by an interrupted write or corrupted on disk is a miss, and is overwritten by the next store.
+    auto tokensBegin = data + keyBegin + keySize;
+    if (!IsValidTokensPayload(tokensBegin, size - keyBegin - keySize)) {
+        return std::nullopt;
+    }
+    ++hitCount;
+    (void)usedEntries.emplace(FileUtil::GetFileName(path));
+    return TokenSerialization::GetTokensFromBytes(tokensBegin);
+}
+
+void MacroCache::Store(const MacroCall& macCall)
+{
+    if (!IsCacheable(macCall) || macCall.status != MacroEvalStatus::SUCCESS) {
+        return;
+    }
+    auto key = GetKey(macCall);
+    if (!key) {
+        return;
+    }
+    auto tokens = TokenSerialization::GetTokensBytes(macCall.GetInvocation()->newTokens);
+    if (tokens.empty()) {
+        return;
+    }
+    std::vector<uint8_t> entry;
+    entry.reserve(MAGIC_SIZE + sizeof(uint32_t) + key->size() + tokens.size());
+    AppendBytes(entry, ENTRY_MAGIC, MAGIC_SIZE);
+    auto keySize = static_cast<uint32_t>(key->size());
+    AppendBytes(entry, &keySize, sizeof(keySize));
+    AppendBytes(entry, key->data(), key->size());
+    AppendBytes(entry, tokens.data(), tokens.size());
+    // A failed write only costs a miss in the next build.
+    auto path = GetEntryPath(*key);
+    if (FileUtil::WriteBufferToASTFile(path, entry)) {
+        (void)usedEntries.emplace(FileUtil::GetFileName(path));
+    }
+}
+
+void MacroCache::Prune() const
+{
+    // Every cacheable call of the package is looked up or stored in each build, an entry not used by this build is
+    // for a call which no longer exists, e.g. one whose position changed.
+    for (auto& file : FileUtil::GetAllFilesUnderCurrentPath(cacheDir, ENTRY_EXTENSION.substr(1))) {
+        if (usedEntries.count(file) == 0) {
+            (void)FileUtil::Remove(FileUtil::JoinPath(cacheDir, file));
+        }
+    }
+}
@@ -81,6 +81,7 @@ bool MacroCall::TraverseParentMacroNode(MacroCall* mcNode, const std::string& pa
  */
 bool MacroCall::CheckParentContext(const char* parentStr, bool report)
 {
+    usedCompilerCallback = true;
     std::string parentName(parentStr);
     bool success{false};
     if (this->parentNames.empty()) {
@@ -109,6 +110,7 @@ bool MacroCall::CheckParentContext(const char* parentStr, bool report)
 
 void MacroCall::DiagReport(const int level, const Range range, const char *message, const char* hint) const
 {
+    usedCompilerCallback = true;
     DiagKindRefactor diagKind;
     if (level == static_cast<int>(DiagSeverity::DS_ERROR)) {
         diagKind = DiagKindRefactor::parse_diag_error;
@@ -127,6 +129,7 @@ void MacroCall::DiagReport(const int level, const Range range, const char *messa
  */
 void MacroCall::SetItemMacroContext(char* key, void* value, uint8_t type)
 {
+    usedCompilerCallback = true;
     (void)this->recordMacroInfo.emplace_back(key);
 
     void* valueP = value;
@@ -203,6 +206,7 @@ void MacroCall::TraverseMacroNode(
  */
 void*** MacroCall::GetChildMessagesFromMacroContext(const char* childrenStr)
 {
+    usedCompilerCallback = true;
     this->macroInfoVec.clear();
     if (this->children.empty() && this->childMessages.empty()) {
         return nullptr;
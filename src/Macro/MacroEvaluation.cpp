@@ -871,6 +871,7 @@ bool MacroEvaluation::WaitForOneMacroCallEvalFinish(std::list<MacroCall*>& evalM
             if (evalMacCall->isDataReady) {
                 // Evaluate macroCall failed or success.
                 SetMacroCallEvalResult(*evalMacCall, ci->diag);
+                SaveToMacroCache(*evalMacCall);
             } else {
                 // Evaluating macroCall.
                 (void)++iter;
@@ -946,15 +947,58 @@ void MacroEvaluation::EvalMacroCallsOnSingleThread()
         Utils::ProfileRecorder::Start("Serial Evaluate Macros", name);
         EvalOneMacroCall(*macCall);
         SetMacroCallEvalResult(*macCall, ci->diag);
+        SaveToMacroCache(*macCall);
         Utils::ProfileRecorder::Stop("Serial Evaluate Macros", name);
     }
 }
 
 void MacroEvaluation::EvalOneMacroCall(MacroCall& macCall)
 {
+    if (LoadFromMacroCache(macCall)) {
+        return;
+    }
     EvaluateWithRuntime(macCall);
 }
 
+void MacroEvaluation::InitMacroCache()
+{
+    auto& opts = ci->invocation.globalOptions;
+    // The macro server of lsp evaluates in another process, results are only cached for cjc.
+    if (useChildProcess || !opts.enIncrementalCompilation || opts.compilationCachedPath.empty()) {
+        return;
+    }
+    auto srcPkgs = ci->GetSourcePackages();
+    if (srcPkgs.empty()) {
+        return;
+    }
+    // Each package has its own directory, so that pruning the entries unused by one package keeps the others'.
+    auto [cachedDir, pkgDir] = opts.GenerateNamesOfCachedDirAndFile(srcPkgs[0]->fullPackageName);
+    macroCache = std::make_unique<MacroCache>(
+        FileUtil::JoinPath(FileUtil::JoinPath(cachedDir, "macro"), pkgDir), GetMacroDefDynamicFiles());
+}
+
+bool MacroEvaluation::LoadFromMacroCache(MacroCall& macCall)
+{
+    if (!macroCache) {
+        return false;
+    }
+    auto tokens = macroCache->Lookup(macCall);
+    if (!tokens) {
+        return false;
+    }
+    macCall.GetInvocation()->newTokens = std::move(*tokens);
+    macCall.isDataReady = true;
+    (void)cachedCalls.emplace(&macCall);
+    return true;
+}
+
+void MacroEvaluation::SaveToMacroCache(const MacroCall& macCall)
+{
+    if (macroCache && cachedCalls.count(&macCall) == 0) {
+        macroCache->Store(macCall);
+    }
+}
+
 void MacroEvaluation::FreeMacroInfoVecForMacroCall(MacroCall& mc) const
 {
     for (size_t i = 0; i < mc.recordMacroInfo.size(); i++) {
@@ -1021,6 +1065,13 @@ void MacroEvaluation::EvalMacros()
     CreateMacroCallsTree();
     EvalMacroCalls();
     ReEvalAfterEvalMacroCalls();
+    if (macroCache) {
+        Utils::ProfileRecorder::RecordCodeInfo("macro cache hits", static_cast<int64_t>(macroCache->GetHitCount()));
+        // A failed expansion may have skipped calls whose entries are still valid.
+        if (ci->diag.GetErrorCount() == 0) {
+            macroCache->Prune();
+        }
+    }
     Utils::ProfileRecorder::Stop("MacroExpand", "Evaluate Macros");
 }
 
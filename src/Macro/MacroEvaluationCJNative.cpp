@@ -179,7 +179,12 @@ void MacroEvaluation::InitGlobalVariable()
 
 void MacroEvaluation::ReleaseThreadHandle(MacroCall& macCall)
 {
+    // Macrocalls expanded from the macro cache have no coroutine.
+    if (macCall.coroutineHandle == nullptr) {
+        return;
+    }
     auto invokeReleaseHandle =
         reinterpret_cast<ReleaseHandleFromC>(RuntimeInit::GetInstance().runtimeReleaseFunc);
     invokeReleaseHandle(macCall.coroutineHandle);
-}
\ No newline at end of file
+    macCall.coroutineHandle = nullptr;
+}
\ No newline at end of file
@@ -121,6 +121,7 @@ void MacroProcMsger::CloseClientResource()
         pipefdC2P[0] = -1;
     }
 #endif
+    shm.reset();
 }
 
 void MacroProcMsger::CloseMacroSrv()
@@ -151,6 +152,9 @@ void MacroProcMsger::CloseMacroSrv()
 
 bool MacroProcMsger::WriteToSrvPipe(const uint8_t* buf, size_t size) const
 {
+    if (shm) {
+        return shm->Write(MacroShmTransport::Direction::CLIENT_TO_SRV, buf, size);
+    }
 #ifdef _WIN32
     return WriteFile(hParentWrite, buf, size, nullptr, 0) == TRUE;
 #else
@@ -166,6 +170,9 @@ bool MacroProcMsger::WriteToSrvPipe(const uint8_t* buf, size_t size) const
 
 bool MacroProcMsger::ReadFromSrvPipe(uint8_t* buf, size_t size) const
 {
+    if (shm) {
+        return shm->Read(MacroShmTransport::Direction::SRV_TO_CLIENT, buf, size);
+    }
 #ifdef _WIN32
     return ReadFile(hParentRead, buf, size, nullptr, nullptr) == TRUE;
 #else
@@ -190,17 +197,19 @@ bool MacroProcMsger::SendMsgToSrv(const std::vector<uint8_t>& msg)
     }
     // Pipe capacity is limited, send msg slice by slice
     size_t sumSize = msg.size();
-    size_t rest = sumSize % msgSliceLen;
-    size_t msgNum = rest == 0 ? msg.size() / msgSliceLen : msg.size() / msgSliceLen + 1;
-    size_t lastSize = rest == 0 ? msgSliceLen : rest;
+    // The ring takes a whole msg at once, only the pipe needs slices.
+    size_t sliceLen = shm ? sumSize : msgSliceLen;
+    size_t rest = sumSize % sliceLen;
+    size_t msgNum = rest == 0 ? msg.size() / sliceLen : msg.size() / sliceLen + 1;
+    size_t lastSize = rest == 0 ? sliceLen : rest;
     if (!WriteToSrvPipe(reinterpret_cast<uint8_t*>(&sumSize), sizeof(sumSize))) {
         perror("WriteToSrvPipe");
         pipeError.store(true);
         return false;
     }
     for (size_t i = 0; i < msgNum; ++i) {
-        size_t curNum = (i == msgNum - 1) ? lastSize : msgSliceLen;
-        if (!WriteToSrvPipe(msg.data() + i * msgSliceLen, curNum)) {
+        size_t curNum = (i == msgNum - 1) ? lastSize : sliceLen;
+        if (!WriteToSrvPipe(msg.data() + i * sliceLen, curNum)) {
             perror("WriteToSrvPipe");
             pipeError.store(true);
             return false;
@@ -226,13 +235,15 @@ bool MacroProcMsger::ReadMsgFromSrv(std::vector<uint8_t>& msg)
         pipeError.store(true);
         return false;
     }
-    size_t rest = msgSize % msgSliceLen;
-    size_t msgNum = rest == 0 ? msgSize / msgSliceLen : msgSize / msgSliceLen + 1;
-    size_t lastSize = rest == 0 ? msgSliceLen : rest;
+    // The ring takes a whole msg at once, only the pipe needs slices.
+    size_t sliceLen = shm ? msgSize : msgSliceLen;
+    size_t rest = msgSize % sliceLen;
+    size_t msgNum = rest == 0 ? msgSize / sliceLen : msgSize / sliceLen + 1;
+    size_t lastSize = rest == 0 ? sliceLen : rest;
     msg.resize(msgSize);
     for (size_t i = 0; i < msgNum; ++i) {
-        size_t curNum = (i == msgNum - 1) ? lastSize : msgSliceLen;
-        if (!ReadFromSrvPipe(msg.data() + i * msgSliceLen, curNum)) {
+        size_t curNum = (i == msgNum - 1) ? lastSize : sliceLen;
+        if (!ReadFromSrvPipe(msg.data() + i * sliceLen, curNum)) {
             perror("ReadFromSrvPipe");
             pipeError.store(true);
             return false;
@@ -260,6 +271,12 @@ bool MacroProcMsger::ReadAllMsgFromSrv(std::list<std::vector<uint8_t>>& msgVec)
             return true;
         }
 #else
+        if (shm) {
+            if (!shm->HasData(MacroShmTransport::Direction::SRV_TO_CLIENT)) {
+                return true;
+            }
+            continue;
+        }
         fd_set readset;
         FD_ZERO(&readset);
         FD_SET(pipefdC2P[0], &readset);
@@ -505,6 +522,12 @@ void MacroEvaluation::ExecMacroSrv(pid_t pid) const
     cstrings.push_back(enPara.data());
     cstrings.push_back(ci->invocation.globalOptions.executablePath.data());
     cstrings.push_back(pidStr.data());
+    // The optional last arg is the fd of the shared memory transport, without it the server uses the pipes.
+    std::string shmFd;
+    if (MacroProcMsger::GetInstance().shm && MacroProcMsger::GetInstance().shm->InheritFdOnExec()) {
+        shmFd = std::to_string(MacroProcMsger::GetInstance().shm->GetFd());
+        cstrings.push_back(shmFd.data());
+    }
     cstrings.push_back(nullptr);  // for execvp argv
     execvp(macSrvName.c_str(), cstrings.data());
 }
@@ -527,12 +550,15 @@ void MacroEvaluation::CreateMacroSrvProcess()
         perror("Create C2P pipe fail: ");
         return;
     }
+    // Prefer shared memory, the pipes are still created as the fallback of an older macro srv.
+    MacroProcMsger::GetInstance().shm = MacroShmTransport::Create();
     MacroProcMsger::GetInstance().pipeError.store(false);
     pid_t ppid = getpid();
     pid_t pid = fork();
     if (pid < 0) {
         CloseBothEndsOfPipe(MacroProcMsger::GetInstance().pipefdP2C);
         CloseBothEndsOfPipe(MacroProcMsger::GetInstance().pipefdC2P);
+        MacroProcMsger::GetInstance().shm.reset();
         return;
     }
     MacroProcMsger::GetInstance().macroSrvRun.store(true);
@@ -556,6 +582,10 @@ void MacroEvaluation::CreateMacroSrvProcess()
         // close unused pipe
         close(MacroProcMsger::GetInstance().pipefdP2C[0]);
         close(MacroProcMsger::GetInstance().pipefdC2P[1]);
+        if (auto& shm = MacroProcMsger::GetInstance().shm) {
+            shm->CloseFd();
+            shm->SetPeerAlive(&MacroProcMsger::GetInstance().macroSrvRun);
+        }
     }
     return;
 }
@@ -55,8 +55,17 @@ inline TaskType GetMacroTaskType(const std::vector<uint8_t>& msg)
 } // namespace
 
 // MacroProcMsger for srv
+bool MacroProcMsger::SetSrvShm(int fd)
+{
+    shm = MacroShmTransport::Open(fd);
+    return shm != nullptr;
+}
+
 bool MacroProcMsger::WriteToClientPipe(const uint8_t* buf, size_t size) const
 {
+    if (shm) {
+        return shm->Write(MacroShmTransport::Direction::SRV_TO_CLIENT, buf, size);
+    }
 #ifdef _WIN32
     return WriteFile(hChildWrite, buf, size, nullptr, nullptr) == TRUE;
 
@@ -72,6 +81,9 @@ bool MacroProcMsger::WriteToClientPipe(const uint8_t* buf, size_t size) const
 }
 bool MacroProcMsger::ReadFromClientPipe(uint8_t* buf, size_t size) const
 {
+    if (shm) {
+        return shm->Read(MacroShmTransport::Direction::CLIENT_TO_SRV, buf, size);
+    }
 #ifdef _WIN32
     return ReadFile(hChildRead, buf, size, nullptr, nullptr) == TRUE;
 #else
@@ -92,16 +104,18 @@ bool MacroProcMsger::SendMsgToClient(const std::vector<uint8_t>& msg)
         return false;
     }
     size_t sumSize = msg.size();
-    size_t rest = sumSize % msgSliceLen;
-    size_t msgNum = rest == 0 ? msg.size() / msgSliceLen : msg.size() / msgSliceLen + 1;
-    size_t lastSize = rest == 0 ? msgSliceLen : rest;
+    // The ring takes a whole msg at once, only the pipe needs slices.
+    size_t sliceLen = shm ? sumSize : msgSliceLen;
+    size_t rest = sumSize % sliceLen;
+    size_t msgNum = rest == 0 ? msg.size() / sliceLen : msg.size() / sliceLen + 1;
+    size_t lastSize = rest == 0 ? sliceLen : rest;
     if (!WriteToClientPipe(reinterpret_cast<uint8_t*>(&sumSize), sizeof(sumSize))) {
         perror("WriteToClientPipe");
         return false;
     }
     for (size_t i = 0; i < msgNum; ++i) {
-        size_t curNum = (i == msgNum - 1) ? lastSize : msgSliceLen;
-        if (!WriteToClientPipe(msg.data() + i * msgSliceLen, curNum)) {
+        size_t curNum = (i == msgNum - 1) ? lastSize : sliceLen;
+        if (!WriteToClientPipe(msg.data() + i * sliceLen, curNum)) {
             perror("WriteToClientPipe");
             return false;
         }
@@ -121,13 +135,15 @@ bool MacroProcMsger::ReadMsgFromClient(std::vector<uint8_t>& msg)
         Errorln(getpid(), " Msg size error, size: ", msgSize);
         return false;
     }
-    size_t rest = msgSize % msgSliceLen;
-    size_t msgNum = rest == 0 ? msgSize / msgSliceLen : msgSize / msgSliceLen + 1;
-    size_t lastSize = rest == 0 ? msgSliceLen : rest;
+    // The ring takes a whole msg at once, only the pipe needs slices.
+    size_t sliceLen = shm ? msgSize : msgSliceLen;
+    size_t rest = msgSize % sliceLen;
+    size_t msgNum = rest == 0 ? msgSize / sliceLen : msgSize / sliceLen + 1;
+    size_t lastSize = rest == 0 ? sliceLen : rest;
     msg.resize(msgSize);
     for (size_t i = 0; i < msgNum; ++i) {
-        size_t curNum = (i == msgNum - 1) ? lastSize : msgSliceLen;
-        if (!ReadFromClientPipe(msg.data() + i * msgSliceLen, curNum)) {
+        size_t curNum = (i == msgNum - 1) ? lastSize : sliceLen;
+        if (!ReadFromClientPipe(msg.data() + i * sliceLen, curNum)) {
             perror("ReadFromClientPipe");
             return false;
         }
@@ -167,6 +183,10 @@ void MacroEvaluation::RunMacroSrv()
     // close unused pipe
     close(MacroProcMsger::GetInstance().pipefdP2C[1]);
     close(MacroProcMsger::GetInstance().pipefdC2P[0]);
+    if (auto& shm = MacroProcMsger::GetInstance().shm) {
+        // Forked without exec, the mapping of the client is inherited.
+        shm->CloseFd();
+    }
     ExecuteEvalSrvTask();
     RuntimeInit::GetInstance().CloseRuntime();
     close(MacroProcMsger::GetInstance().pipefdP2C[0]);
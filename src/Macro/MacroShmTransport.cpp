@@ -0,0 +1,248 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the shared-memory transport between the compiler and the macro server.
+ */
+
+#include "cangjie/Macro/MacroShmTransport.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <linux/memfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Cangjie;
+
+namespace {
+// Large enough for the messages of most macro calls, pages are only committed once they are touched.
+constexpr size_t RING_CAPACITY = 4 * 1024 * 1024;
+constexpr size_t RING_NUM = 2;
+constexpr size_t CACHE_LINE_SIZE = 64;
+// Waits time out so that the client notices a server that exited without replying.
+constexpr long WAIT_TIMEOUT_NS = 100 * 1000 * 1000;
+} // namespace
+
+/// Positions are the total numbers of bytes written and read, each one is only modified by one side.
+struct MacroShmTransport::Ring {
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> writePos{0};
+    std::atomic<uint32_t> dataSeq{0};     // Futex word, bumped when bytes are written.
+    std::atomic<uint32_t> dataWaiters{0}; // Number of readers sleeping on 'dataSeq'.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> readPos{0};
+    std::atomic<uint32_t> spaceSeq{0};     // Futex word, bumped when bytes are read.
+    std::atomic<uint32_t> spaceWaiters{0}; // Number of writers sleeping on 'spaceSeq'.
+};
+
+/// The ring headers, followed by the data of each ring.
+struct MacroShmTransport::Region {
+    Ring rings[RING_NUM];
+
+    uint8_t* GetData(Direction dir)
+    {
+        return reinterpret_cast<uint8_t*>(this) + sizeof(Region) + static_cast<size_t>(dir) * RING_CAPACITY;
+    }
+};
+
+#ifdef __linux__
+size_t MacroShmTransport::GetMappingSize()
+{
+    return sizeof(Region) + RING_NUM * RING_CAPACITY;
+}
+
+std::unique_ptr<MacroShmTransport> MacroShmTransport::Create()
+{
+    // Close-on-exec, the linker and other children must not inherit it. Only the macro server clears the flag.
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "cjc-macro", MFD_CLOEXEC));
+    if (fd < 0) {
+        return nullptr;
+    }
+    size_t size = GetMappingSize();
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<MacroShmTransport>(new MacroShmTransport(fd, new (addr) Region()));
+}
+
+std::unique_ptr<MacroShmTransport> MacroShmTransport::Open(int fd)
+{
+    size_t size = GetMappingSize();
+    struct stat st {};
+    // The region must come from a compiler of the same version.
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != size) {
+        close(fd);
+        return nullptr;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::unique_ptr<MacroShmTransport>(new MacroShmTransport(-1, static_cast<Region*>(addr)));
+}
+
+MacroShmTransport::~MacroShmTransport()
+{
+    CloseFd();
+    if (region != nullptr) {
+        munmap(region, GetMappingSize());
+    }
+}
+
+void MacroShmTransport::CloseFd()
+{
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool MacroShmTransport::InheritFdOnExec() const
+{
+    int flags = fcntl(fd, F_GETFD);
+    return flags != -1 && fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC) != -1;
+}
+
+bool MacroShmTransport::Wait(
+    std::atomic<uint32_t>& seq, uint32_t expected, std::atomic<uint32_t>& waiters) const
+{
+    // Paired with 'Wake': either the waker sees this waiter, or the futex sees the bumped sequence.
+    waiters.fetch_add(1);
+    timespec timeout{0, WAIT_TIMEOUT_NS};
+    (void)syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+    waiters.fetch_sub(1);
+    if (peerAlive != nullptr && !peerAlive->load()) {
+        // The peer may have made progress right before exiting.
+        return seq.load() != expected;
+    }
+    return true;
+}
+
+void MacroShmTransport::Wake(std::atomic<uint32_t>& seq, const std::atomic<uint32_t>& waiters)
+{
+    seq.fetch_add(1);
+    if (waiters.load() > 0) {
+        (void)syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+}
+
+bool MacroShmTransport::Write(Direction dir, const uint8_t* buf, size_t size)
+{
+    auto& ring = GetRing(dir);
+    auto data = region->GetData(dir);
+    while (size > 0) {
+        uint32_t seq = ring.spaceSeq.load();
+        uint64_t writePos = ring.writePos.load(std::memory_order_relaxed);
+        size_t space = RING_CAPACITY - static_cast<size_t>(writePos - ring.readPos.load(std::memory_order_acquire));
+        if (space == 0) {
+            if (!Wait(ring.spaceSeq, seq, ring.spaceWaiters)) {
+                return false;
+            }
+            continue;
+        }
+        size_t len = std::min(space, size);
+        size_t offset = static_cast<size_t>(writePos % RING_CAPACITY);
+        size_t firstPart = std::min(len, RING_CAPACITY - offset);
+        (void)memcpy(data + offset, buf, firstPart);
+        (void)memcpy(data, buf + firstPart, len - firstPart);
+        ring.writePos.store(writePos + len, std::memory_order_release);
+        Wake(ring.dataSeq, ring.dataWaiters);
+        buf += len;
+        size -= len;
+    }
+    return true;
+}
+
+bool MacroShmTransport::Read(Direction dir, uint8_t* buf, size_t size)
+{
+    auto& ring = GetRing(dir);
+    auto data = region->GetData(dir);
+    while (size > 0) {
+        uint32_t seq = ring.dataSeq.load();
+        uint64_t readPos = ring.readPos.load(std::memory_order_relaxed);
+        size_t avail = static_cast<size_t>(ring.writePos.load(std::memory_order_acquire) - readPos);
+        if (avail == 0) {
+            if (!Wait(ring.dataSeq, seq, ring.dataWaiters)) {
+                return false;
+            }
+            continue;
+        }
+        size_t len = std::min(avail, size);
+        size_t offset = static_cast<size_t>(readPos % RING_CAPACITY);
+        size_t firstPart = std::min(len, RING_CAPACITY - offset);
+        (void)memcpy(buf, data + offset, firstPart);
+        (void)memcpy(buf + firstPart, data, len - firstPart);
+        ring.readPos.store(readPos + len, std::memory_order_release);
+        Wake(ring.spaceSeq, ring.spaceWaiters);
+        buf += len;
+        size -= len;
+    }
+    return true;
+}
+
+bool MacroShmTransport::HasData(Direction dir) const
+{
+    auto& ring = GetRing(dir);
+    return ring.writePos.load(std::memory_order_acquire) != ring.readPos.load(std::memory_order_relaxed);
+}
+#else
+std::unique_ptr<MacroShmTransport> MacroShmTransport::Create()
+{
+    return nullptr;
+}
+
+std::unique_ptr<MacroShmTransport> MacroShmTransport::Open(int)
+{
+    return nullptr;
+}
+
+MacroShmTransport::~MacroShmTransport() = default;
+
+void MacroShmTransport::CloseFd()
+{
+}
+
+bool MacroShmTransport::InheritFdOnExec() const
+{
+    return false;
+}
+
+bool MacroShmTransport::Write(Direction, const uint8_t*, size_t)
+{
+    return false;
+}
+
+bool MacroShmTransport::Read(Direction, uint8_t*, size_t)
+{
+    return false;
+}
+
+bool MacroShmTransport::HasData(Direction) const
+{
+    return false;
+}
+#endif
+
+MacroShmTransport::Ring& MacroShmTransport::GetRing(Direction dir) const
+{
+    return region->rings[static_cast<size_t>(dir)];
+}
@@ -154,6 +154,12 @@ ASTLoader::ASTLoader(std::vector<uint8_t>&& data, const std::string& fullPackage
     pImpl = MakeOwned<ASTLoaderImpl>(std::move(data), fullPackageName, typeManager, cjoManager, opts);
 }
 
+ASTLoader::ASTLoader(std::shared_ptr<const CjoFile> file, const std::string& fullPackageName,
+    TypeManager& typeManager, const CjoManager& cjoManager, const GlobalOptions& opts)
+{
+    pImpl = MakeOwned<ASTLoaderImpl>(std::move(file), fullPackageName, typeManager, cjoManager, opts);
+}
+
 ASTLoader::~ASTLoader()
 {
 }
@@ -177,7 +183,7 @@ std::string ASTLoader::PreReadAndSetPackageName()
 std::string ASTLoader::ASTLoaderImpl::PreReadAndSetPackageName()
 {
     if (!package) {
-        package = PackageFormat::GetPackage(data.data());
+        package = PackageFormat::GetPackage(GetData());
     }
     CJC_NULLPTR_CHECK(package);
     CJC_NULLPTR_CHECK(package->fullPkgName());
@@ -212,10 +218,16 @@ const std::vector<std::string> ASTLoader::GetDependentPackageNames() const
 
 bool ASTLoader::ASTLoaderImpl::VerifyForData(const std::string& id)
 {
-    size_t size = data.size();
-    // We need to verify the size first.
-    flatbuffers::Verifier verifier(data.data(), size, FB_MAX_DEPTH, FB_MAX_TABLES);
-    if (!PackageFormat::VerifyPackageBuffer(verifier)) {
+    // Verifying walks the whole buffer, the result is kept for the following loading stages.
+    if (!isDataVerified.has_value() && cjoFile) {
+        // Files are verified once per process, see CjoFileCache.
+        isDataVerified = cjoFile->IsVerified();
+    } else if (!isDataVerified.has_value()) {
+        // We need to verify the size first.
+        flatbuffers::Verifier verifier(GetData(), GetDataSize(), FB_MAX_DEPTH, FB_MAX_TABLES);
+        isDataVerified = PackageFormat::VerifyPackageBuffer(verifier);
+    }
+    if (!isDataVerified.value()) {
         diag.DiagnoseRefactor(
             DiagKindRefactor::module_loaded_ast_failed, DEFAULT_POSITION, id, importedPackageName, CANGJIE_VERSION);
         return false;
@@ -234,7 +246,7 @@ std::string ASTLoader::ASTLoaderImpl::LoadPackageDepInfo()
     if (!VerifyForData("ast")) {
         return "";
     }
-    package = PackageFormat::GetPackage(data.data());
+    package = PackageFormat::GetPackage(GetData());
     return package->pkgDepInfo()->str();
 }
 
@@ -301,7 +313,7 @@ void ASTLoader::ASTLoaderImpl::PreloadCommonPartOfPackage(AST::Package& pkg)
         CJC_ABORT();
     }
 
-    package = PackageFormat::GetPackage(data.data());
+    package = PackageFormat::GetPackage(GetData());
     CJC_NULLPTR_CHECK(package);
 
     curPackage = &pkg; // Deserialize common part AST into current platform package AST
@@ -339,53 +351,270 @@ void ASTLoader::LoadPackageDecls() const
     pImpl->LoadPackageDecls();
 }
 
-/** 'LoadPackageDependencies' must be called before this method. */
+void ASTLoader::SetLazyLoading(bool enable) const
+{
+    pImpl->lazyLoading = enable;
+}
+
+bool ASTLoader::HasDeferredDecls() const
+{
+    return !pImpl->deferredDecls.empty();
+}
+
+bool ASTLoader::LoadDeferredDecls(const std::string& name) const
+{
+    return pImpl->LoadDeferredDecls(name);
+}
+
+void ASTLoader::LoadAllDeferredDecls() const
+{
+    pImpl->LoadAllDeferredDecls();
+}
+
+bool ASTLoader::LoadDeferredDeclByExportId(const std::string& exportId) const
+{
+    return pImpl->LoadDeferredDeclByExportId(exportId);
+}
+
+std::vector<Ptr<AST::Decl>> ASTLoader::TakeLazyLoadedDecls() const
+{
+    std::vector<Ptr<AST::Decl>> decls;
+    decls.swap(pImpl->lazyLoadedDecls);
+    return decls;
+}
+
+/**
+ * Decls which are not found by name must be loaded eagerly: extends are collected by the extended type,
+ * instantiated decls are used by CodeGen, implicitly used decls are collected into 'implicitDeclMap', and the
+ * variables of a 'VarWithPatternDecl' are not named by the decl itself.
+ */
+bool ASTLoader::ASTLoaderImpl::CanDeferDecl(const PackageFormat::Decl& decl) const
+{
+    if (!lazyLoading || deserializingCommon || decl.kind() == PackageFormat::DeclKind_ExtendDecl ||
+        decl.kind() == PackageFormat::DeclKind_VarWithPatternDecl) {
+        return false;
+    }
+    auto attr = GetAttributes(decl);
+    return !attr.TestAttr(AST::Attribute::GENERIC_INSTANTIATED) && !attr.TestAttr(AST::Attribute::IMPLICIT_USED) &&
+        !attr.TestAttr(AST::Attribute::FROM_COMMON_PART);
+}
+
+/**
+ * 'LoadPackageDependencies' must be called before this method.
+ * Without lazy loading, all toplevel decls are materialized here. With lazy loading, the toplevel decls which can be
+ * found by name are only indexed by identifier, and materialized on first lookup from 'CjoManager' or on first
+ * reference from a loaded node, see 'GetDeclFromIndex'.
+ */
 void ASTLoader::ASTLoaderImpl::LoadPackageDecls()
 {
     CJC_ASSERT(curPackage && package);
     // Get toplevel decls.
     uoffset_t nDecls = package->allDecls()->size();
+    std::vector<FormattedIndex> eagerDecls;
     for (uoffset_t i = 0; i < nDecls; i++) {
         // Only toplevel decls are loaded.
-        if (package->allDecls()->Get(i)->isTopLevel()) {
-            if (IgnoreDecl(i)) {
-                continue;
-            }
-            // NOTE: FormattedIndex is vector offset plus 1.
-            auto tmpDecl = LoadDecl(i + 1);
-            if (!tmpDecl) {
-                continue;
-            }
-            auto fileID = tmpDecl->begin.fileID;
-            if (auto found = idToFileMap.find(fileID); found != idToFileMap.end()) {
-                tmpDecl->curFile = found->second;
-            }
-            CJC_NULLPTR_CHECK(tmpDecl->curFile);
-            AddCurFile(*tmpDecl, tmpDecl->curFile); // Guarantees all sub-nodes have 'curFile'.
-            if (tmpDecl->TestAttr(Attribute::GENERIC_INSTANTIATED)) {
-                curPackage->genericInstantiatedDecls.emplace_back(std::move(tmpDecl));
-                continue;
-            }
-            // In this branch, decl's 'curFile' nodes must exist in current package.
-            CJC_ASSERT(tmpDecl->curFile->curPackage == curPackage);
-            if (tmpDecl->IsExportedDecl() || tmpDecl->TestAttr(Attribute::FROM_COMMON_PART)) {
-                tmpDecl->curFile->decls.emplace_back(std::move(tmpDecl));
-            } else {
-                tmpDecl->curFile->exportedInternalDecls.emplace_back(std::move(tmpDecl));
-            }
+        auto decl = package->allDecls()->Get(i);
+        if (!decl->isTopLevel() || IgnoreDecl(i)) {
+            continue;
+        }
+        // NOTE: FormattedIndex is vector offset plus 1.
+        if (!CanDeferDecl(*decl)) {
+            eagerDecls.emplace_back(i + 1);
+            continue;
         }
+        deferredDecls.emplace(i + 1);
+        auto identifier = decl->identifier();
+        CJC_NULLPTR_CHECK(identifier);
+        deferredDeclsByName[std::string_view(identifier->c_str(), identifier->size())].emplace_back(i + 1);
     }
-    // Remove decls inside any generic decl.
-    Utils::EraseIf(
-        importNonGenericSrcFuncDecls, [](auto it) { return IsInDeclWithAttribute(*it, Attribute::GENERIC); });
-    curPackage->srcImportedNonGenericDecls = importNonGenericSrcFuncDecls;
+    // Deferred decls are indexed first, so that the eager decls can reference them in any order.
+    for (auto index : eagerDecls) {
+        LoadToplevelDecl(index);
+    }
+    PublishSourceImportedDecls();
     // hasSourceImportedDecl true will trait as import package, but common part is not when compile platform
     if (!deserializingCommon) {
-        curPackage->hasSourceImportedDecl = !allLoadedExprs.empty() || curPackage->TestAttr(Attribute::TOOL_ADD);
+        // Deferred decls may have source code, which is known after they are materialized.
+        bool mayHaveSourceDecl = !deferredDecls.empty() && package->allExprs() && package->allExprs()->size() != 0;
+        curPackage->hasSourceImportedDecl =
+            !allLoadedExprs.empty() || mayHaveSourceDecl || curPackage->TestAttr(Attribute::TOOL_ADD);
     }
     AddCurFile(*curPackage); // Guarantees all nodes have 'curFile'.
 }
 
+/** Load the toplevel decl of @p index into its file, return it if it is added to the exported decls. */
+Ptr<Decl> ASTLoader::ASTLoaderImpl::LoadToplevelDecl(FormattedIndex index)
+{
+    auto tmpDecl = LoadDecl(index);
+    if (!tmpDecl) {
+        return nullptr;
+    }
+    auto fileID = tmpDecl->begin.fileID;
+    if (auto found = idToFileMap.find(fileID); found != idToFileMap.end()) {
+        tmpDecl->curFile = found->second;
+    }
+    CJC_NULLPTR_CHECK(tmpDecl->curFile);
+    AddCurFile(*tmpDecl, tmpDecl->curFile); // Guarantees all sub-nodes have 'curFile'.
+    if (tmpDecl->TestAttr(Attribute::GENERIC_INSTANTIATED)) {
+        curPackage->genericInstantiatedDecls.emplace_back(std::move(tmpDecl));
+        return nullptr;
+    }
+    // In this branch, decl's 'curFile' nodes must exist in current package.
+    CJC_ASSERT(tmpDecl->curFile->curPackage == curPackage);
+    if (tmpDecl->IsExportedDecl() || tmpDecl->TestAttr(Attribute::FROM_COMMON_PART)) {
+        return tmpDecl->curFile->decls.emplace_back(std::move(tmpDecl)).get();
+    }
+    tmpDecl->curFile->exportedInternalDecls.emplace_back(std::move(tmpDecl));
+    return nullptr;
+}
+
+void ASTLoader::ASTLoaderImpl::PublishSourceImportedDecls()
+{
+    // Remove decls inside any generic decl. The published decls may have been changed by Sema, only append new ones.
+    auto begin = importNonGenericSrcFuncDecls.begin() + static_cast<std::ptrdiff_t>(publishedSrcDeclNum);
+    (void)std::copy_if(begin, importNonGenericSrcFuncDecls.end(),
+        std::back_inserter(curPackage->srcImportedNonGenericDecls),
+        [](auto it) { return !IsInDeclWithAttribute(*it, Attribute::GENERIC); });
+    publishedSrcDeclNum = importNonGenericSrcFuncDecls.size();
+}
+
+void ASTLoader::ASTLoaderImpl::LoadDeferredDecl(FormattedIndex index)
+{
+    if (deferredDecls.erase(index) == 0) {
+        return; // Not deferred or already loaded.
+    }
+    if (auto decl = LoadToplevelDecl(index)) {
+        lazyLoadedDecls.emplace_back(decl);
+    }
+    PublishSourceImportedDecls();
+}
+
+bool ASTLoader::ASTLoaderImpl::LoadDeferredDecls(const std::string& name)
+{
+    auto found = deferredDeclsByName.find(name);
+    if (found == deferredDeclsByName.end()) {
+        return false;
+    }
+    auto indexes = std::move(found->second);
+    deferredDeclsByName.erase(found);
+    auto deferredNum = deferredDecls.size();
+    for (auto index : indexes) {
+        LoadDeferredDecl(index);
+    }
+    return deferredDecls.size() != deferredNum;
+}
+
+void ASTLoader::ASTLoaderImpl::LoadAllDeferredDecls()
+{
+    // Keep the order of decls in the serialized package.
+    std::vector<FormattedIndex> indexes(deferredDecls.begin(), deferredDecls.end());
+    std::sort(indexes.begin(), indexes.end());
+    deferredDeclsByName.clear();
+    for (auto index : indexes) {
+        LoadDeferredDecl(index);
+    }
+}
+
+void ASTLoader::ASTLoaderImpl::IndexNestedDecls(FormattedIndex owner, FormattedIndex index)
+{
+    if (index == INVALID_FORMAT_INDEX || !declOwners.emplace(index, owner).second) {
+        return;
+    }
+    auto decl = GetFormatDeclByIndex(index);
+    auto indexAll = [this, owner](const flatbuffers::Vector<uint32_t>* indexes) {
+        for (uoffset_t i = 0; indexes && i < indexes->size(); ++i) {
+            IndexNestedDecls(owner, static_cast<FormattedIndex>(indexes->Get(i)));
+        }
+    };
+    if (auto generic = decl->generic()) {
+        indexAll(generic->typeParameters());
+    }
+    switch (decl->kind()) {
+        case PackageFormat::DeclKind_ClassDecl:
+            indexAll(decl->info_as_ClassInfo()->body());
+            break;
+        case PackageFormat::DeclKind_InterfaceDecl:
+            indexAll(decl->info_as_InterfaceInfo()->body());
+            break;
+        case PackageFormat::DeclKind_StructDecl:
+            indexAll(decl->info_as_StructInfo()->body());
+            break;
+        case PackageFormat::DeclKind_EnumDecl:
+            indexAll(decl->info_as_EnumInfo()->body());
+            break;
+        case PackageFormat::DeclKind_ExtendDecl:
+            indexAll(decl->info_as_ExtendInfo()->body());
+            break;
+        case PackageFormat::DeclKind_PropDecl:
+            indexAll(decl->info_as_PropInfo()->setters());
+            indexAll(decl->info_as_PropInfo()->getters());
+            break;
+        case PackageFormat::DeclKind_FuncDecl: {
+            auto funcBody = decl->info_as_FuncInfo()->funcBody();
+            auto paramLists = funcBody ? funcBody->paramLists() : nullptr;
+            for (uoffset_t i = 0; paramLists && i < paramLists->size(); ++i) {
+                indexAll(paramLists->Get(i)->params());
+                indexAll(paramLists->Get(i)->desugars());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ASTLoader::ASTLoaderImpl::LoadDeferredDeclOf(FormattedIndex index)
+{
+    if (deferredDecls.empty() || index == INVALID_FORMAT_INDEX) {
+        return;
+    }
+    if (deferredDecls.count(index) != 0) {
+        LoadDeferredDecl(index);
+        return;
+    }
+    if (declOwners.empty()) {
+        // Index the members, generic parameters and parameters of all toplevel decls, not only the deferred ones, so
+        // that a miss of a decl nested in an eager or ignored decl is not mistaken for a local decl.
+        for (uoffset_t i = 0; i < package->allDecls()->size(); ++i) {
+            if (package->allDecls()->Get(i)->isTopLevel()) {
+                IndexNestedDecls(i + 1, i + 1);
+            }
+        }
+    }
+    if (auto found = declOwners.find(index); found != declOwners.end()) {
+        LoadDeferredDecl(found->second);
+    } else {
+        // Local decls are only indexed by the expressions of their owner, which are not walked before loading.
+        LoadAllDeferredDecls();
+    }
+}
+
+bool ASTLoader::ASTLoaderImpl::LoadDeferredDeclByExportId(const std::string& exportId)
+{
+    if (deferredDecls.empty()) {
+        return false;
+    }
+    if (exportIdDecls.empty()) {
+        // Same key as 'AddDeclToImportedPackage'.
+        for (uoffset_t i = 0; i < package->allDecls()->size(); ++i) {
+            auto decl = package->allDecls()->Get(i);
+            auto key = decl->exportId()->size() != 0 ? decl->exportId()
+                : decl->kind() != PackageFormat::DeclKind_GenericParamDecl ? decl->identifier()
+                                                                            : nullptr;
+            if (key != nullptr) {
+                exportIdDecls.emplace(std::string_view(key->c_str(), key->size()), i + 1);
+            }
+        }
+    }
+    auto found = exportIdDecls.find(exportId);
+    if (found == exportIdDecls.end()) {
+        return false;
+    }
+    auto deferredNum = deferredDecls.size();
+    LoadDeferredDeclOf(found->second);
+    return deferredDecls.size() != deferredNum;
+}
+
 OwnedPtr<AST::File> ASTLoader::ASTLoaderImpl::CreateFileNode(
     Package& pkg, unsigned int fileId, std::vector<OwnedPtr<AST::ImportSpec>>&& imports)
 {
@@ -405,7 +634,7 @@ OwnedPtr<AST::File> ASTLoader::ASTLoaderImpl::CreateFileNode(
 OwnedPtr<AST::Package> ASTLoader::ASTLoaderImpl::PreLoadImportedPackageNode()
 {
     // Begin to parse the flatbuffer.
-    package = PackageFormat::GetPackage(data.data());
+    package = PackageFormat::GetPackage(GetData());
     CJC_NULLPTR_CHECK(package);
     // Imported package is PackageDecl Node.
     OwnedPtr<Package> packageNode = MakeOwned<Package>();
@@ -444,6 +673,11 @@ OwnedPtr<AST::Package> ASTLoader::ASTLoaderImpl::PreLoadImportedPackageNode()
             packageNode->AddDependentStdPkg(depStdPkg);
         }
     }
+    if (package->sharedInstantiations()) {
+        for (auto shared : *package->sharedInstantiations()) {
+            packageNode->AddSharedInstantiation(shared->genericDecl()->str(), shared->mangledName()->str());
+        }
+    }
     return packageNode;
 }
 
@@ -531,7 +765,8 @@ void ASTLoader::ASTLoaderImpl::AddDeclToImportedPackage(Decl& decl)
 
 /**
  * Get decl pointer according to packageIndex and declIndex.
- * NOTE: This function should only be used during 'LoadRef' stage that all decls are loaded.
+ * NOTE: This function should only be used during 'LoadRef' stage that all eager decls are loaded, a deferred decl is
+ *       materialized on its first reference.
  */
 Ptr<Decl> ASTLoader::ASTLoaderImpl::GetDeclFromIndex(const PackageFormat::FullId* fullId)
 {
@@ -550,6 +785,10 @@ Ptr<Decl> ASTLoader::ASTLoaderImpl::GetDeclFromIndex(const PackageFormat::FullId
     } else if (pkgIndex == CURRENT_PKG_INDEX) {
         // NOTE: for incremental loading case, the decl may not exist in cache.
         auto found = allLoadedDecls.find(fullId->index());
+        if (found == allLoadedDecls.end()) {
+            LoadDeferredDeclOf(fullId->index());
+            found = allLoadedDecls.find(fullId->index());
+        }
         return found != allLoadedDecls.end() ? found->second : nullptr;
     }
     std::string fullPackageName = importedFullPackageNames.at(static_cast<unsigned>(pkgIndex));
@@ -558,6 +797,9 @@ Ptr<Decl> ASTLoader::ASTLoaderImpl::GetDeclFromIndex(const PackageFormat::FullId
     auto exportId = fullId->decl()->str();
     if (exportIdDeclMap != nullptr) {
         auto it1 = exportIdDeclMap->find(exportId);
+        if (it1 == exportIdDeclMap->end() && cjoManager.LoadDeferredDeclByExportId(fullPackageName, exportId)) {
+            it1 = exportIdDeclMap->find(exportId);
+        }
         if (it1 != exportIdDeclMap->end()) {
             return it1->second;
         }
@@ -13,6 +13,9 @@
 #ifndef CANGJIE_MODULES_ASTSERIALIZATION_ASTLOADER_IMPL_H
 #define CANGJIE_MODULES_ASTSERIALIZATION_ASTLOADER_IMPL_H
 
+#include <optional>
+#include <string_view>
+
 #include "flatbuffers/ModuleFormat_generated.h"
 
 #include "cangjie/AST/ASTCasting.h"
@@ -36,6 +39,19 @@ public:
     {
         InitializeTypeLoader();
     }
+    ASTLoaderImpl(std::shared_ptr<const CjoFile> file, const std::string& fullPackageName, TypeManager& typeManager,
+        const CjoManager& cjoManager, const GlobalOptions& opts)
+        : importedPackageName(fullPackageName),
+          cjoFile(std::move(file)),
+          typeManager(typeManager),
+          diag(cjoManager.GetDiag()),
+          sourceManager(diag.GetSourceManager()),
+          cjoManager(cjoManager),
+          opts(opts)
+    {
+        CJC_NULLPTR_CHECK(cjoFile);
+        InitializeTypeLoader();
+    }
     ~ASTLoaderImpl()
     {
         package = nullptr;
@@ -52,6 +68,10 @@ public:
         const AST::Package& sourcePackage, const std::map<std::string, Ptr<AST::Decl>>& mangledName2DeclMap);
     std::string LoadPackageDepInfo();
     void LoadRefs();
+    bool LoadDeferredDecls(const std::string& name);
+    void LoadAllDeferredDecls();
+    bool LoadDeferredDeclByExportId(const std::string& exportId);
+    bool LoadUnresolvedRefs();
     void SetImportSourceCode(bool enable)
     {
         importSrcCode = enable;
@@ -64,7 +84,17 @@ public:
 
 private:
 friend ASTLoader;
+    // The serialized package is either owned by 'data' or shared with CjoFileCache by 'cjoFile'.
     std::vector<uint8_t> data;
+    std::shared_ptr<const CjoFile> cjoFile;
+    const uint8_t* GetData() const
+    {
+        return cjoFile ? cjoFile->Data() : data.data();
+    }
+    size_t GetDataSize() const
+    {
+        return cjoFile ? cjoFile->Size() : data.size();
+    }
     TypeManager& typeManager;
     DiagnosticEngine& diag;
     SourceManager& sourceManager;
@@ -86,6 +116,32 @@ friend ASTLoader;
     Ptr<AST::Package> curPackage{nullptr};
     bool importSrcCode{false};
     bool deserializingCommon{false};
+    // Number of 'importNonGenericSrcFuncDecls' which have been added to 'srcImportedNonGenericDecls'.
+    size_t publishedSrcDeclNum{0};
+
+    // Lazy loading of toplevel decls. Deferred decls are indexed by FormattedIndex, the names are views into the
+    // serialized data which is kept alive by the loader.
+    bool lazyLoading{false};
+    std::unordered_set<FormattedIndex> deferredDecls;
+    std::unordered_map<std::string_view, std::vector<FormattedIndex>> deferredDeclsByName;
+    // Owner toplevel decl of every decl nested in a toplevel decl's signature or body, built on first use.
+    std::unordered_map<FormattedIndex, FormattedIndex> declOwners;
+    // Decl referenced by other packages of every export id, built on first use.
+    std::unordered_map<std::string_view, FormattedIndex> exportIdDecls;
+    // Exported toplevel decls materialized after 'LoadPackageDecls', which are not in 'CjoManager' yet.
+    std::vector<Ptr<AST::Decl>> lazyLoadedDecls;
+    // Once 'LoadRefs' starts, the nodes created by materialized decls are recorded to load their references later.
+    bool refsLoading{false};
+    std::vector<std::pair<int64_t, Ptr<AST::Decl>>> unresolvedDecls;
+    std::vector<std::pair<int64_t, Ptr<AST::Expr>>> unresolvedExprs;
+    bool CanDeferDecl(const PackageFormat::Decl& decl) const;
+    Ptr<AST::Decl> LoadToplevelDecl(FormattedIndex index);
+    void LoadDeferredDecl(FormattedIndex index);
+    void LoadDeferredDeclOf(FormattedIndex index);
+    void IndexNestedDecls(FormattedIndex owner, FormattedIndex index);
+    void PublishSourceImportedDecls();
+    void LoadRefsOf(const std::vector<std::pair<int64_t, Ptr<AST::Decl>>>& decls,
+        const std::vector<std::pair<int64_t, Ptr<AST::Expr>>>& exprs);
 
     // Define the context status for loading type cache of incremental compilation.
     bool isLoadCache{false};
@@ -103,6 +159,8 @@ friend ASTLoader;
         bool& status;
     };
 
+    // Result of the verification of data, which is done only once.
+    std::optional<bool> isDataVerified;
     // Verify legality of data.
     bool VerifyForData(const std::string& id);
     // Methods for loading cache during incremental compilation.
@@ -151,8 +209,14 @@ friend ASTLoader;
             if constexpr (std::is_base_of<AST::Expr, NodeT>::value) {
                 node->overflowStrategy = static_cast<OverflowStrategy>(nodeObj.overflowPolicy());
                 (void)allLoadedExprs.emplace(index, node.get());
+                if (refsLoading) {
+                    unresolvedExprs.emplace_back(index, node.get());
+                }
             } else if constexpr (std::is_base_of<AST::Decl, NodeT>::value) {
                 (void)allLoadedDecls.emplace(index, node.get());
+                if (refsLoading) {
+                    unresolvedDecls.emplace_back(index, node.get());
+                }
             }
         }
         LoadNodePos(nodeObj, *node);
@@ -667,9 +667,34 @@ void ASTWriter::ASTWriterImpl::ExportAST(const PackageDecl& package)
     for (auto decl : topLevelDeclsOrdered) {
         (void)GetDeclIndex(decl);
     }
+    SaveSharedInstantiations(*package.srcPackage);
     MarkImplicitExportOfImportSpec(*package.srcPackage);
 }
 
+void ASTWriter::ASTWriterImpl::SaveSharedInstantiations(const Package& package)
+{
+    // Sema only marks the instantiations of global generic functions as weak_odr when other packages can use them,
+    // the definitions are kept in the object of this package. A dependent package looks them up by the exportId of
+    // the generic decl and the mangled name, which encodes the type arguments.
+    if (config.compileCjd || package.isMacroPackage) {
+        return;
+    }
+    for (auto& decl : package.genericInstantiatedDecls) {
+        if (decl->astKind != ASTKind::FUNC_DECL || decl->outerDecl != nullptr || decl->linkage != Linkage::WEAK_ODR) {
+            continue;
+        }
+        if (!decl->genericDecl || decl->genericDecl->exportId.empty() || decl->mangledName.empty()) {
+            continue;
+        }
+        // The instantiation is only declared in this package when an imported package already defines it.
+        if (cjoManager.IsSharedByImportedPackage(decl->genericDecl->exportId, decl->mangledName)) {
+            continue;
+        }
+        allSharedInstantiations.emplace_back(PackageFormat::CreateSharedInstantiation(builder,
+            builder.CreateString(decl->genericDecl->exportId), builder.CreateString(decl->mangledName)));
+    }
+}
+
 void ASTWriter::SetSerializingCommon()
 {
     pImpl->SetSerializingCommon();
@@ -707,6 +732,7 @@ void ASTWriter::ASTWriterImpl::AST2FB(std::vector<uint8_t>& data, const PackageD
         vpackageNames.emplace_back(builder.CreateString(depStdPkg));
     }
     auto vdependentStdPkgs = builder.CreateVector<TStringOffset>(vpackageNames);
+    auto vsharedInstantiations = builder.CreateVector<TSharedInstantiationOffset>(allSharedInstantiations);
     PackageFormat::PackageKind kind = PackageFormat::PackageKind_Normal;
     if (package.srcPackage->isMacroPackage) {
         kind = PackageFormat::PackageKind_Macro;
@@ -723,7 +749,7 @@ void ASTWriter::ASTWriterImpl::AST2FB(std::vector<uint8_t>& data, const PackageD
     PackageFormat::CjoVersion cjoVersion(CJO_MAJOR_VERSION, CJO_MINOR_VERSION, CJO_PATCH_VERSION);
     auto root = PackageFormat::CreatePackage(builder, cjcVersion, &cjoVersion, packageName, dependencyInfo, vimports,
         vfiles, vfileImports, vtypes, vdecls, vexprs, INVALID_FORMAT_INDEX, kind, access, moduleName, vfileInfo,
-        vdependentStdPkgs);
+        vdependentStdPkgs, vsharedInstantiations);
     FinishPackageBuffer(builder, root);
     auto size = static_cast<size_t>(builder.GetSize());
     data.resize(size);
@@ -89,6 +89,7 @@ private:
     std::vector<TStringOffset> allFiles;
     std::vector<TImportsOffset> allFileImports;
     std::vector<TFileInfoOffset> allFileInfo;
+    std::vector<TSharedInstantiationOffset> allSharedInstantiations;
     std::vector<TTypeOffset> allTypes;
     std::vector<TDeclOffset> allDecls;
     std::vector<TExprOffset> allExprs;
@@ -126,6 +127,8 @@ private:
     FormattedIndex SavePackageName(const std::string& fullPackageName);
     // Save file names and add to savedFileMap.
     void SaveFileInfo(const AST::File& file);
+    // Save the instantiations which dependent packages can link to instead of emitting them.
+    void SaveSharedInstantiations(const AST::Package& package);
     flatbuffers::Offset<PackageFormat::Imports> SaveFileImports(const AST::File& file);
     /**
      * Save decls, return FormattedIndex and construct savedDeclMap, isTopLevel
@@ -271,7 +271,7 @@ std::unordered_set<std::string> ASTLoader::ASTLoaderImpl::LoadCachedTypeForPacka
         return {};
     }
     CacheLoadingStatus ctx(isLoadCache);
-    package = PackageFormat::GetPackage(data.data());
+    package = PackageFormat::GetPackage(GetData());
     // 2. Prepare cache for file ids.
     // NOTE: 'ASTDiff' guarantees files in previous compilation are same as the current compilation.
     //       So the 'fileID' is same with the 'fileIndex'.
@@ -163,14 +163,46 @@ void ASTLoader::LoadRefs() const
 
 void ASTLoader::ASTLoaderImpl::LoadRefs()
 {
-    for (auto [index, decl] : allLoadedDecls) {
+    // Materializing a deferred decl adds nodes to the loaded maps, so the references are loaded for a snapshot, and
+    // the nodes created since are loaded by 'LoadUnresolvedRefs'.
+    std::vector<std::pair<int64_t, Ptr<Decl>>> decls(allLoadedDecls.begin(), allLoadedDecls.end());
+    std::vector<std::pair<int64_t, Ptr<Expr>>> exprs(allLoadedExprs.begin(), allLoadedExprs.end());
+    refsLoading = true;
+    LoadRefsOf(decls, exprs);
+    (void)LoadUnresolvedRefs();
+}
+
+bool ASTLoader::LoadUnresolvedRefs() const
+{
+    CJC_NULLPTR_CHECK(pImpl);
+    return pImpl->LoadUnresolvedRefs();
+}
+
+bool ASTLoader::ASTLoaderImpl::LoadUnresolvedRefs()
+{
+    bool loaded = false;
+    while (!unresolvedDecls.empty() || !unresolvedExprs.empty()) {
+        std::vector<std::pair<int64_t, Ptr<Decl>>> decls;
+        std::vector<std::pair<int64_t, Ptr<Expr>>> exprs;
+        decls.swap(unresolvedDecls);
+        exprs.swap(unresolvedExprs);
+        LoadRefsOf(decls, exprs);
+        loaded = true;
+    }
+    return loaded;
+}
+
+void ASTLoader::ASTLoaderImpl::LoadRefsOf(
+    const std::vector<std::pair<int64_t, Ptr<Decl>>>& decls, const std::vector<std::pair<int64_t, Ptr<Expr>>>& exprs)
+{
+    for (auto [index, decl] : decls) {
         auto declObj = GetFormatDeclByIndex(static_cast<FormattedIndex>(index));
         CJC_NULLPTR_CHECK(declObj);
         CJC_NULLPTR_CHECK(decl);
         LoadDeclRefs(*declObj, *decl);
         LoadDeclDependencies(*declObj, *decl);
     }
-    for (auto [index, expr] : allLoadedExprs) {
+    for (auto [index, expr] : exprs) {
         auto exprObj = GetFormatExprByIndex(static_cast<FormattedIndex>(index));
         CJC_NULLPTR_CHECK(exprObj);
         CJC_NULLPTR_CHECK(expr);
@@ -184,7 +216,7 @@ void ASTLoader::ASTLoaderImpl::LoadRefs()
     // NOTE: funcArg expr's type reference is loaded after funcArg itself,
     // so we need to load for arg's ty after finish loading all reference for expression.
     // Also callExpr is loading before call base expr, loading possibly 'resolvedFunction' here.
-    for (auto [_, expr] : allLoadedExprs) {
+    for (auto [_, expr] : exprs) {
         PostLoadReference(*expr);
     }
 }
@@ -0,0 +1,110 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the process-wide cache of imported .cjo files.
+ */
+
+#include "cangjie/Modules/CjoFileCache.h"
+
+#include <sys/stat.h>
+
+#include "flatbuffers/ModuleFormat_generated.h"
+
+#include "cangjie/Modules/ASTSerialization.h"
+
+using namespace Cangjie;
+
+namespace {
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+} // namespace
+
+bool CjoFile::IsVerified() const
+{
+    std::call_once(verifyFlag, [this]() {
+        flatbuffers::Verifier verifier(Data(), Size(), FB_MAX_DEPTH, FB_MAX_TABLES);
+        verified = PackageFormat::VerifyPackageBuffer(verifier);
+    });
+    return verified;
+}
+
+CjoFileCache& CjoFileCache::Instance()
+{
+    static CjoFileCache instance;
+    return instance;
+}
+
+std::optional<CjoFileCache::FileStamp> CjoFileCache::GetStamp(const std::string& path)
+{
+    struct stat st {};
+    if (stat(path.c_str(), &st) != 0) {
+        return std::nullopt;
+    }
+    FileStamp stamp;
+    stamp.device = static_cast<uint64_t>(st.st_dev);
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+    stamp.size = static_cast<uint64_t>(st.st_size);
+#if defined(__APPLE__)
+    stamp.modifiedTime = static_cast<int64_t>(st.st_mtimespec.tv_sec) * NANOSECONDS_PER_SECOND +
+        static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+#elif defined(__linux__)
+    stamp.modifiedTime =
+        static_cast<int64_t>(st.st_mtim.tv_sec) * NANOSECONDS_PER_SECOND + static_cast<int64_t>(st.st_mtim.tv_nsec);
+#else
+    stamp.modifiedTime = static_cast<int64_t>(st.st_mtime) * NANOSECONDS_PER_SECOND;
+#endif
+    return stamp;
+}
+
+std::shared_ptr<const CjoFile> CjoFileCache::Open(const std::string& path, std::string& failedReason)
+{
+    failedReason.clear();
+    // Compilations served by the daemon have different working directories, so entries are keyed by absolute path.
+    auto absPath = FileUtil::GetAbsPath(path);
+    if (!absPath.has_value()) {
+        failedReason = "open file failed";
+        return nullptr;
+    }
+    auto stamp = GetStamp(absPath.value());
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (auto found = entries.find(absPath.value());
+            found != entries.end() && found->second.stamp.has_value() && found->second.stamp == stamp) {
+            return found->second.file;
+        }
+    }
+    // Mapping is done without the lock, racing threads may both map the file but only one of them is cached.
+    auto mapped = FileUtil::MappedFile::Open(absPath.value(), failedReason);
+    if (!mapped) {
+        return nullptr;
+    }
+    auto file = std::make_shared<const CjoFile>(std::move(mapped));
+    std::lock_guard<std::mutex> lock(mtx);
+    auto [it, inserted] = entries.try_emplace(absPath.value());
+    if (inserted) {
+        openedPaths.emplace_back(absPath.value());
+    } else if (it->second.stamp.has_value() && it->second.stamp == stamp) {
+        return it->second.file;
+    }
+    it->second.stamp = stamp;
+    it->second.file = file;
+    return file;
+}
+
+bool CjoFileCache::Preload(const std::string& path)
+{
+    std::string failedReason;
+    auto file = Open(path, failedReason);
+    return file && file->IsVerified();
+}
+
+std::vector<std::string> CjoFileCache::GetOpenedPaths() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return openedPaths;
+}
@@ -12,12 +12,15 @@
 
 #include "cangjie/Modules/CjoManager.h"
 
+#include <functional>
 #include <queue>
+#include <set>
 
 #include "CjoManagerImpl.h"
 #include "cangjie/AST/ASTCasting.h"
 #include "cangjie/AST/Utils.h"
 #include "cangjie/AST/Walker.h"
+#include "cangjie/Driver/StdlibMap.h"
 #include "cangjie/Modules/ASTSerialization.h"
 #include "cangjie/Modules/ModulesUtils.h"
 
@@ -47,6 +50,54 @@ void AddDeclToMap(Decl& decl, std::map<std::string, OrderedDeclSet>& declMap)
     }
 }
 
+/** Collect the names which may be looked up in imported packages by the nodes of @p pkg. */
+void CollectUsedNames(Package& pkg, std::unordered_set<std::string>& names)
+{
+    Walker walker(&pkg, [&names](Ptr<Node> node) {
+        if (auto re = DynamicCast<RefExpr*>(node)) {
+            names.emplace(re->ref.identifier.Val());
+        } else if (auto ma = DynamicCast<MemberAccess*>(node)) {
+            names.emplace(ma->field.Val());
+        } else if (auto rt = DynamicCast<RefType*>(node)) {
+            names.emplace(rt->ref.identifier.Val());
+        } else if (auto qt = DynamicCast<QualifiedType*>(node)) {
+            names.emplace(qt->field.Val());
+        } else if (auto anno = DynamicCast<Annotation*>(node)) {
+            names.emplace(anno->identifier.Val());
+        } else if (auto vep = DynamicCast<VarOrEnumPattern*>(node)) {
+            names.emplace(vep->identifier.Val());
+        } else if (auto import = DynamicCast<ImportSpec*>(node)) {
+            names.emplace(import->content.identifier.Val());
+        } else if (auto decl = DynamicCast<Decl*>(node)) {
+            names.emplace(decl->identifier.Val());
+        }
+        return VisitAction::WALK_CHILDREN;
+    });
+    walker.Walk();
+}
+
+/** Add the materialized @p decl of @p info to the packages which re-export it by @p name. */
+void AddReExportedDeclToMap(const CjoManagerImpl::PackageInfo& info, Decl& decl, const std::string& name,
+    std::unordered_set<Ptr<const CjoManagerImpl::PackageInfo>>& visited)
+{
+    for (auto [import, importer] : info.reExportedBy) {
+        auto& content = import->content;
+        std::string targetName = content.kind == ImportKind::IMPORT_ALL ? name
+            : content.identifier.Val() != name                            ? ""
+            : content.kind == ImportKind::IMPORT_ALIAS                    ? content.aliasName.Val()
+                                                                          : name;
+        if (targetName.empty() || !visited.emplace(importer).second) {
+            continue;
+        }
+        auto& targetSet = importer->declMap[targetName];
+        auto declNum = targetSet.size();
+        Modules::AddImportedDeclToMap(OrderedDeclSet{&decl}, targetSet, GetAccessLevel(*import));
+        if (targetSet.size() != declNum) {
+            AddReExportedDeclToMap(*importer, decl, targetName, visited);
+        }
+    }
+}
+
 bool CanInline(const GlobalOptions& opts)
 {
     return opts.chirLLVM && opts.optimizationLevel > GlobalOptions::OptimizationLevel::O1 && !opts.enableCompileTest &&
@@ -60,13 +111,19 @@ CjoManager::CjoManager(const CjoManager::Config& config) : impl{new CjoManagerIm
 
 CjoManager::~CjoManager()
 {
-    DeleteASTLoaders();
+    for (auto& p : impl->GetPackageNameMap()) {
+        delete p.second->loader.get();
+        p.second->loader = nullptr;
+    }
     delete impl;
 }
 
 void CjoManager::DeleteASTLoaders() const noexcept
 {
     for (auto& p : impl->GetPackageNameMap()) {
+        if (p.second->loader && p.second->loader->HasDeferredDecls()) {
+            continue; // Deferred decls may still be looked up.
+        }
         delete p.second->loader.get();
         p.second->loader = nullptr;
     }
@@ -211,10 +268,23 @@ const std::map<std::string, OrderedDeclSet>& CjoManager::GetPackageMembers(const
     return EMPTY_MAP;
 }
 
+void CjoManager::LoadAllPackageMembers(const std::string& fullPackageName) const
+{
+    auto info = impl->GetPackageInfo(fullPackageName);
+    if (info == nullptr || info->loader == nullptr || !info->loader->HasDeferredDecls()) {
+        return;
+    }
+    info->loader->LoadAllDeferredDecls();
+    impl->FinishLazyLoading();
+}
+
 const OrderedDeclSet& CjoManager::GetPackageMembersByName(
     const std::string& fullPackageName, const std::string& name) const
 {
     const static OrderedDeclSet EMPTY_DECLS;
+    if (auto info = impl->GetPackageInfo(fullPackageName); info && impl->LoadDeferredDecls(*info, name)) {
+        impl->FinishLazyLoading();
+    }
     auto& declMap = GetPackageMembers(fullPackageName);
     auto iter = declMap.find(name);
     if (iter != declMap.cend()) {
@@ -307,6 +377,8 @@ void CjoManager::LoadPackageDeclsOnDemand(const std::vector<Ptr<Package>>& packa
 {
     // Add all directly imported package's loader.
     std::queue<Ptr<CjoManagerImpl::PackageInfo>> q;
+    // Members of the packages imported by wildcard are all added to the source package, they are loaded eagerly.
+    std::queue<std::string> wildcardImported;
     for (auto pkg : packages) {
         if (fromLsp) {
             q.push(impl->GetPackageInfo(pkg->fullPackageName));
@@ -317,9 +389,31 @@ void CjoManager::LoadPackageDeclsOnDemand(const std::vector<Ptr<Package>>& packa
                 if (!pkgName.empty()) {
                     q.push(impl->GetPackageInfo(pkgName));
                 }
+                if (!pkgName.empty() && import->IsImportAll()) {
+                    wildcardImported.push(pkgName);
+                }
             }
         }
     }
+    std::unordered_set<std::string> eagerPackages;
+    while (!wildcardImported.empty()) {
+        auto pkgName = wildcardImported.front();
+        wildcardImported.pop();
+        auto info = impl->GetPackageInfo(pkgName);
+        if (!eagerPackages.emplace(pkgName).second || info == nullptr) {
+            continue;
+        }
+        for (auto& file : info->pkg->files) {
+            for (auto& import : file->imports) {
+                if (import->IsReExport() && import->IsImportAll() && !GetPackageNameByImport(*import).empty()) {
+                    wildcardImported.push(GetPackageNameByImport(*import));
+                }
+            }
+        }
+    }
+    auto& opts = impl->GetGlobalOptions();
+    bool canDeferDecls =
+        !fromLsp && !opts.enableCompileTest && !opts.enIncrementalCompilation && !opts.IsCompilingCJMP();
 
     std::vector<Ptr<ASTLoader>> loaders;
     // Load common part cjo
@@ -346,8 +440,11 @@ void CjoManager::LoadPackageDeclsOnDemand(const std::vector<Ptr<Package>>& packa
             continue;
         }
         loaders.emplace_back(cur->loader);
-        cur->loader->LoadPackageDecls();
         bool isCurMacro = cur->pkg->isMacroPackage;
+        // Std packages are looked up by name all over the compiler, keep them eager.
+        cur->loader->SetLazyLoading(canDeferDecls && !isCurMacro && !cur->onlyUsedByMacro &&
+            STANDARD_LIBS.count(pkgName) == 0 && eagerPackages.count(pkgName) == 0);
+        cur->loader->LoadPackageDecls();
         auto deps = cur->loader->GetDependentPackageNames();
         for (auto pkg : deps) {
             if (NeedCollectDependency(pkgName, isCurMacro, pkg)) {
@@ -355,10 +452,96 @@ void CjoManager::LoadPackageDeclsOnDemand(const std::vector<Ptr<Package>>& packa
             }
         }
     }
+    if (canDeferDecls) {
+        LoadDeclsUsedBy(packages);
+    }
 
     for (auto loader : loaders) {
         loader->LoadRefs();
     }
+    impl->FinishLazyLoading();
+}
+
+void CjoManager::LoadDeclsUsedBy(const std::vector<Ptr<Package>>& packages) const
+{
+    auto& packageMap = impl->GetPackageNameMap();
+    if (std::none_of(packageMap.cbegin(), packageMap.cend(),
+        [](auto& it) { return it.second->loader && it.second->loader->HasDeferredDecls(); })) {
+        return;
+    }
+    std::unordered_set<std::string> names;
+    for (auto pkg : packages) {
+        CollectUsedNames(*pkg, names);
+    }
+    bool loaded = false;
+    for (auto& [_, info] : packageMap) {
+        if (info->loader == nullptr || !info->loader->HasDeferredDecls()) {
+            continue;
+        }
+        for (auto& name : names) {
+            loaded = info->loader->LoadDeferredDecls(name) || loaded;
+        }
+    }
+    if (loaded) {
+        impl->FinishLazyLoading();
+    }
+}
+
+bool CjoManager::LoadDeferredDeclByExportId(const std::string& fullPackageName, const std::string& exportId) const
+{
+    auto info = impl->GetPackageInfo(fullPackageName);
+    return info != nullptr && info->loader != nullptr && info->loader->LoadDeferredDeclByExportId(exportId);
+}
+
+bool CjoManagerImpl::LoadDeferredDecls(PackageInfo& info, const std::string& name) const
+{
+    if ((info.loader == nullptr || !info.loader->HasDeferredDecls()) && info.reExports.empty()) {
+        return false;
+    }
+    std::set<std::pair<Ptr<const PackageInfo>, std::string>> visited;
+    std::function<bool(PackageInfo&, const std::string&)> load = [&visited, &load](
+                                                                     PackageInfo& cur, const std::string& curName) {
+        if (!visited.emplace(&cur, curName).second) {
+            return false;
+        }
+        bool loaded = cur.loader != nullptr && cur.loader->LoadDeferredDecls(curName);
+        // The name may be a decl re-exported from another package.
+        for (auto [import, dep] : cur.reExports) {
+            auto& content = import->content;
+            if (content.kind == ImportKind::IMPORT_ALL ||
+                (content.kind == ImportKind::IMPORT_SINGLE && content.identifier.Val() == curName)) {
+                loaded = load(*dep, curName) || loaded;
+            } else if (content.kind == ImportKind::IMPORT_ALIAS && content.aliasName.Val() == curName) {
+                loaded = load(*dep, content.identifier.Val()) || loaded;
+            }
+        }
+        return loaded;
+    };
+    return load(info, name);
+}
+
+void CjoManagerImpl::FinishLazyLoading() const
+{
+    // Loading references may materialize decls of any package, until no new node is loaded.
+    bool loaded = true;
+    while (loaded) {
+        loaded = false;
+        for (auto& [_, info] : packageNameMap) {
+            if (info->loader) {
+                loaded = info->loader->LoadUnresolvedRefs() || loaded;
+            }
+        }
+    }
+    for (auto& [_, info] : packageNameMap) {
+        if (info->loader == nullptr) {
+            continue;
+        }
+        for (auto decl : info->loader->TakeLazyLoadedDecls()) {
+            AddDeclToMap(*decl, info->declMap);
+            std::unordered_set<Ptr<const PackageInfo>> visited{info.get()};
+            AddReExportedDeclToMap(*info, *decl, decl->identifier, visited);
+        }
+    }
 }
 
 void CjoManager::LoadAllDeclsAndRefs() const
@@ -383,7 +566,6 @@ void CjoManager::LoadAllDeclsAndRefs() const
 std::optional<std::vector<std::string>> CjoManagerImpl::PreReadCommonPartCjoFiles(CjoManager& cjoManager)
 {
     // use `cjoFileCacheMap`
-    std::vector<uint8_t> buffer;
     std::string failedReason;
 
     if (!globalOptions.commonPartCjo) {
@@ -393,8 +575,8 @@ std::optional<std::vector<std::string>> CjoManagerImpl::PreReadCommonPartCjoFile
 
     CJC_ASSERT(globalOptions.commonPartCjo);
     std::string commonPartCjoPath = *globalOptions.commonPartCjo;
-    FileUtil::ReadBinaryFileToBuffer(commonPartCjoPath, buffer, failedReason);
-    if (!failedReason.empty()) {
+    auto file = CjoFileCache::Instance().Open(commonPartCjoPath, failedReason);
+    if (!file) {
         diag.DiagnoseRefactor(
             DiagKindRefactor::module_read_file_to_buffer_failed, DEFAULT_POSITION, commonPartCjoPath, failedReason);
         return {};
@@ -402,7 +584,7 @@ std::optional<std::vector<std::string>> CjoManagerImpl::PreReadCommonPartCjoFile
 
     // name of package is unknown before parsing and reading .cjo, so fake is used.
     std::string fakeName = "";
-    commonPartLoader = MakeOwned<ASTLoader>(std::move(buffer), fakeName, typeManager, cjoManager, globalOptions);
+    commonPartLoader = MakeOwned<ASTLoader>(std::move(file), fakeName, typeManager, cjoManager, globalOptions);
     commonPartLoader->SetImportSourceCode(importSrcCode);
     commonPartLoader->PreReadAndSetPackageName();
 
@@ -427,19 +609,24 @@ Ptr<ASTLoader> CjoManagerImpl::GetCommonPartCjo(std::string expectedName)
 OwnedPtr<ASTLoader> CjoManagerImpl::ReadCjo(
     const std::string& fullPackageName, const std::string& cjoPath, const CjoManager& cjoManager, bool printErr) const
 {
-    std::vector<uint8_t> buffer;
+    OwnedPtr<ASTLoader> loader;
     if (auto found = cjoFileCacheMap.find(fullPackageName); found != cjoFileCacheMap.end()) {
-        buffer = found->second;
+        auto buffer = found->second;
+        loader = MakeOwned<ASTLoader>(std::move(buffer), fullPackageName, typeManager, cjoManager, globalOptions);
     } else {
+        // Imported packages are only read, map them instead of copying the whole file into memory. The mapping is
+        // shared by all loaders of the same file in this process.
         std::string failedReason;
-        FileUtil::ReadBinaryFileToBuffer(cjoPath, buffer, failedReason);
-        if (printErr && !failedReason.empty()) {
+        auto file = CjoFileCache::Instance().Open(cjoPath, failedReason);
+        if (printErr && !file) {
             diag.DiagnoseRefactor(
                 DiagKindRefactor::module_read_file_to_buffer_failed, DEFAULT_POSITION, cjoPath, failedReason);
             return nullptr;
         }
+        loader = file ? MakeOwned<ASTLoader>(std::move(file), fullPackageName, typeManager, cjoManager, globalOptions)
+                      : MakeOwned<ASTLoader>(std::vector<uint8_t>{}, fullPackageName, typeManager, cjoManager,
+                            globalOptions);
     }
-    auto loader = MakeOwned<ASTLoader>(std::move(buffer), fullPackageName, typeManager, cjoManager, globalOptions);
     loader->SetImportSourceCode(importSrcCode);
     return loader;
 }
@@ -485,6 +672,9 @@ void CjoManagerImpl::AddImportsToMap(
         }
         return;
     }
+    if (LoadDeferredDecls(*pkgInfo, import.content.identifier)) {
+        FinishLazyLoading();
+    }
     auto& decls = pkgInfo->declMap[import.content.identifier];
     if (import.content.kind == ImportKind::IMPORT_SINGLE) {
         auto& targetMap = declMap[import.content.identifier];
@@ -531,6 +721,10 @@ void CjoManager::AddPackageDeclMap(const std::string& fullPackageName, const std
             AddPackageDeclMap(pkgName, fullPackageName);
             if (import->IsReExport() && Modules::IsVisible(*import, relation)) {
                 impl->AddImportsToMap(*import, pkgName, pkgInfo->declMap);
+                if (auto depInfo = impl->GetPackageInfo(pkgName)) {
+                    pkgInfo->reExports.emplace_back(import.get(), depInfo);
+                    depInfo->reExportedBy.emplace_back(import.get(), pkgInfo);
+                }
             }
         }
     }
@@ -643,6 +837,21 @@ std::vector<Ptr<AST::PackageDecl>> CjoManager::GetAllPackageDecls(bool includeMa
     return ret;
 }
 
+bool CjoManager::IsSharedByImportedPackage(const std::string& genericId, const std::string& mangledName) const
+{
+    for (auto& p : impl->GetPackageNameMap()) {
+        auto& pkgInfo = p.second;
+        // The instantiations of macro packages are not linked into the programs using them.
+        if (!pkgInfo->pkg->TestAttr(Attribute::IMPORTED) || pkgInfo->onlyUsedByMacro || pkgInfo->pkg->isMacroPackage) {
+            continue;
+        }
+        if (pkgInfo->pkg->HasSharedInstantiation(genericId, mangledName)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void CjoManager::RemovePackage(const std::string& fullPkgName, const Ptr<Package> package) const
 {
     impl->RemoveImportedPackages(package);
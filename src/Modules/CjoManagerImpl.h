@@ -28,6 +28,10 @@ public:
         std::map<std::string, Ptr<AST::Decl>> implicitDeclMap;
         std::string cjoPath;
         bool onlyUsedByMacro{false};
+        // Re-exporting imports of this package and the packages importing this package with a re-exporting import,
+        // used to forward the lookup of deferred decls and to add the materialized decls to 'declMap'.
+        std::vector<std::pair<Ptr<const AST::ImportSpec>, Ptr<PackageInfo>>> reExports;
+        std::vector<std::pair<Ptr<const AST::ImportSpec>, Ptr<PackageInfo>>> reExportedBy;
     };
     std::unordered_map<std::string, OwnedPtr<CjoManagerImpl::PackageInfo>>& GetPackageNameMap()
     {
@@ -115,6 +119,10 @@ public:
     }
     void AddImportsToMap(const AST::ImportSpec& import, const std::string& importedPackage,
         std::map<std::string, AST::OrderedDeclSet>& declMap) const;
+    /** Materialize the deferred decls named @p name of the package and of the packages it re-exports. */
+    bool LoadDeferredDecls(PackageInfo& info, const std::string& name) const;
+    /** Load references of all materialized nodes and add the materialized decls to 'declMap's. */
+    void FinishLazyLoading() const;
     void ClearCjoCache()
     {
         cjoFileCacheMap.clear();
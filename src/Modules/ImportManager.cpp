@@ -994,6 +994,7 @@ void ImportManager::AddImportedDeclsForSourcePackage(const AST::Package& pkg)
             auto relation = GetPackageRelation(pkg.fullPackageName, fullPackageName);
             auto importLevel = GetAccessLevel(*import);
             if (import->content.kind == ImportKind::IMPORT_ALL) {
+                cjoManager->LoadAllPackageMembers(fullPackageName);
                 auto members = cjoManager->GetPackageMembers(fullPackageName);
                 for (auto& member : std::as_const(members)) {
                     auto& targetMap = declMap[member.first];
@@ -1088,6 +1089,7 @@ AST::OrderedDeclSet ImportManager::GetPackageMembers(
         return {};
     }
     auto relation = Modules::GetPackageRelation(srcFullPackageName, targetFullPackageName);
+    cjoManager->LoadAllPackageMembers(targetFullPackageName);
     auto members = cjoManager->GetPackageMembers(targetFullPackageName);
     AST::OrderedDeclSet res;
     for (auto& [_, decls] : members) {
@@ -578,6 +578,10 @@ bool GlobalOptions::CheckPgoOptions() const
             }
         }
     }
+    if (!chirInlineProfile.empty() && !FileExist(chirInlineProfile)) {
+        (void)diag.DiagnoseRefactor(DiagKindRefactor::no_such_file_or_directory, DEFAULT_POSITION, chirInlineProfile);
+        return false;
+    }
     return true;
 }
 
@@ -618,6 +618,7 @@ std::unordered_map<Options::ID, std::function<bool(GlobalOptions&, OptionArgInst
 
     { Options::ID::PROFILE_COMPILE_TIME, OPTION_TRUE_ACTION(opts.enableTimer = true) },
     { Options::ID::PROFILE_COMPILE_MEMORY, OPTION_TRUE_ACTION(opts.enableMemoryCollect = true) },
+    { Options::ID::PROFILE_COMPILE_TRACE, OPTION_TRUE_ACTION(opts.enableTrace = true) },
     { Options::ID::IMPORT_PATH, [](GlobalOptions& opts, const OptionArgInstance& arg) {
         auto maybePath = opts.CheckDirectoryPath(arg.value);
         if (maybePath.has_value()) {
@@ -892,6 +893,14 @@ std::unordered_map<Options::ID, std::function<bool(GlobalOptions&, OptionArgInst
     }},
     { Options::ID::DEBUG_CODEGEN, OPTION_TRUE_ACTION(opts.codegenDebugMode = true) },
     { Options::ID::CHIR_OPT_DEBUG, OPTION_TRUE_ACTION(opts.chirDebugOptimizer = true) },
+    { Options::ID::CHIR_INLINE_PROFILE, [](GlobalOptions& opts, const OptionArgInstance& arg) {
+        opts.chirInlineProfile = arg.value;
+        return true;
+    }},
+    { Options::ID::CHIR_INLINE_REMARKS, [](GlobalOptions& opts, const OptionArgInstance& arg) {
+        opts.chirInlineRemarks = arg.value;
+        return true;
+    }},
     { Options::ID::DUMP_AST, OPTION_TRUE_ACTION(opts.dumpAST = true)},
     { Options::ID::DUMP_CHIR, OPTION_TRUE_ACTION(opts.dumpCHIR = true)},
     { Options::ID::DUMP_IR, OPTION_TRUE_ACTION(opts.dumpIR = true)},
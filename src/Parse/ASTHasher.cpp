@@ -21,7 +21,7 @@
 #include "cangjie/IncrementalCompilation/Utils.h"
 #include "cangjie/AST/ASTCasting.h"
 #include "cangjie/AST/Utils.h"
-#include "cangjie/Utils/SipHash.h"
+#include "cangjie/Utils/FastHash.h"
 
 static constexpr int ALL = 0;
 static constexpr int ONLY_POSITION = 1;
@@ -141,7 +141,7 @@ struct ASTHasherImpl {
     /** CombineHash is a function used to create hash with fewer collisions. */
     template <int whatTypeToHash = 0, typename T> void CombineHash(const T& v)
     {
-        (void)CombineTwoHashes(Utils::SipHash::GetHashValue(v));
+        (void)CombineTwoHashes(Utils::FastHash::GetHashValue(v));
     }
 
     template <int whatTypeToHash = 0, typename T> void CombineHash(const OwnedPtr<T>& v)
@@ -268,7 +268,7 @@ struct ASTHasherImpl {
 
     template <int whatTypeToHash> void HashNode(const Node& node)
     {
-        SUPERHash<whatTypeToHash>(static_cast<int64_t>(node.astKind), node.scopeName, node.exportId, node.scopeLevel);
+        SUPERHash<whatTypeToHash>(static_cast<int64_t>(node.astKind), node.scopeName.Val(), node.exportId, node.scopeLevel);
 
         // attrs below are set before sema
         auto nonSemaAttr = {Attribute::ABSTRACT, Attribute::CONSTRUCTOR, Attribute::DEFAULT,
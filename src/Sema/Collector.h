@@ -46,7 +46,7 @@ public:
     }
 
     /** Add a symbol with info @p nodeInfo to the symbolTable in @p ctx. The @p buildTrie is a flag to control whether
-     * to build a group of trie trees to accelerate search. */
+     * to put the symbol into the name and position indexes to accelerate search. */
     static void AddSymbol(ASTContext& ctx, const NodeInfo& nodeInfo, bool buildTrie = true);
 
     /**
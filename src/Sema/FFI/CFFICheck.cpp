@@ -13,6 +13,7 @@
 #include "TypeCheckerImpl.h"
 
 #include "TypeCheckUtil.h"
+#include "cangjie/AST/ConcurrentWalker.h"
 
 using namespace Cangjie;
 using namespace Cangjie::AST;
@@ -258,9 +259,9 @@ void TypeChecker::TypeCheckerImpl::CheckUnsafeInvoke(const CallExpr& ce)
     }
 }
 
-void TypeChecker::TypeCheckerImpl::CheckLegalityOfUnsafeAndInout(Node& root)
+void TypeChecker::TypeCheckerImpl::CheckLegalityOfUnsafeAndInout(Node& root, VisitedNodeSet& visited)
 {
-    Walker(&root, [this](auto node) {
+    ConcurrentWalkWith(visited, &root, [this](auto node) {
         CJC_ASSERT(node);
         if (node->astKind == ASTKind::CALL_EXPR) {
             CheckUnsafeInvoke(static_cast<const CallExpr&>(*node));
@@ -275,7 +276,7 @@ void TypeChecker::TypeCheckerImpl::CheckLegalityOfUnsafeAndInout(Node& root)
             }
         }
         return VisitAction::WALK_CHILDREN;
-    }).Walk();
+    });
 }
 
 void TypeChecker::TypeCheckerImpl::UnsafeCheck(const FuncBody& fb)
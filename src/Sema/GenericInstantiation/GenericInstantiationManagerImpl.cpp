@@ -58,7 +58,9 @@ GIM::GenericInstantiationManagerImpl::GenericInstantiationManagerImpl(CompilerIn
       promotion(*ci.typeManager),
       instantiationWalkerID(AST::Walker::GetNextWalkerID()),
       rearrangeWalkerID(AST::Walker::GetNextWalkerID()),
-      backend(ci.invocation.globalOptions.backend)
+      backend(ci.invocation.globalOptions.backend),
+      // The TypeInfos of instantiated types are internal on Windows, a shared copy would use another package's ones.
+      shareInstantiations(ci.invocation.globalOptions.target.os != Triple::OSType::WINDOWS)
 {
     instantiator = [this](auto node) { return CheckNodeInstantiation(*node); };
     rearranger = [this](auto node) { return RearrangeReferencePtr(*node); };
@@ -77,18 +79,80 @@ GIM::GenericInstantiationManagerImpl::GenericInstantiationManagerImpl(CompilerIn
 namespace {
 std::unordered_map<Ptr<const Decl>, std::vector<size_t>> g_skippedMemberOffsets = {};
 
-void UpdateInstantiatedDeclsLinkage(const Package& pkg)
+/** Whether each package which uses @p decl owns a copy of it, so its value differs between packages. */
+inline bool IsPerPackageVar(const Decl& decl)
 {
-    // All instantiated decls should be marked as internal for cjnative backend.
-    // For other backend, only mark extend as internal since extend will be instantiated in used package.
+    if (decl.astKind != ASTKind::VAR_DECL || !decl.TestAnyAttr(Attribute::GLOBAL, Attribute::STATIC)) {
+        return false;
+    }
+    return decl.linkage == Linkage::INTERNAL || IsInDeclWithAttribute(decl, Attribute::GENERIC_INSTANTIATED);
+}
+
+void UpdateInstantiatedDeclsLinkage(const Package& pkg, bool shareInstantiations)
+{
+    // Every package using an instantiation emits it, with a mangled name which only depends on the generic decl and
+    // the type arguments. Global and member functions are marked as linkonce_odr, so the linker keeps one copy of
+    // them. A function stays internal if it is local, or if it reads a variable owned by each package, directly or
+    // through other instantiated functions: the copy kept would use the variable of another package.
+    std::vector<Ptr<FuncDecl>> candidates;
     for (auto& decl : pkg.genericInstantiatedDecls) {
-        Walker(decl.get(), [](auto node) {
+        Walker(decl.get(), [&candidates](auto node) {
             if (auto fd = DynamicCast<FuncDecl*>(node); fd) {
                 fd->linkage = Linkage::INTERNAL;
+                if (IsGlobalOrMember(*fd) && fd->funcBody) {
+                    candidates.emplace_back(fd);
+                }
             }
             return VisitAction::WALK_CHILDREN;
         }).Walk();
     }
+    if (!shareInstantiations) {
+        return;
+    }
+    std::unordered_set<Ptr<Decl>> candidateSet(candidates.begin(), candidates.end());
+    std::unordered_map<Ptr<Decl>, std::vector<Ptr<FuncDecl>>> callers;
+    std::unordered_set<Ptr<FuncDecl>> unshared;
+    std::vector<Ptr<FuncDecl>> worklist;
+    for (auto fd : candidates) {
+        Walker(fd->funcBody.get(), [fd, &candidateSet, &callers, &unshared, &worklist](auto node) {
+            auto target = node->GetTarget();
+            if (!target) {
+                return VisitAction::WALK_CHILDREN;
+            }
+            if (IsPerPackageVar(*target)) {
+                if (unshared.emplace(fd).second) {
+                    worklist.emplace_back(fd);
+                }
+                return VisitAction::STOP_NOW;
+            }
+            if (target != fd && candidateSet.count(target) != 0) {
+                callers[target].emplace_back(fd);
+            }
+            return VisitAction::WALK_CHILDREN;
+        }).Walk();
+    }
+    while (!worklist.empty()) {
+        auto fd = worklist.back();
+        worklist.pop_back();
+        for (auto caller : callers[fd]) {
+            if (unshared.emplace(caller).second) {
+                worklist.emplace_back(caller);
+            }
+        }
+    }
+    for (auto fd : candidates) {
+        if (unshared.count(fd) == 0) {
+            fd->linkage = Linkage::LINKONCE_ODR;
+        }
+    }
+    // The instantiations of exported global generic functions are also kept as weak_odr definitions and recorded in
+    // the cjo, so that a package importing this one links to them instead of emitting its own copies.
+    for (auto& decl : pkg.genericInstantiatedDecls) {
+        if (decl->astKind == ASTKind::FUNC_DECL && decl->outerDecl == nullptr &&
+            decl->linkage == Linkage::LINKONCE_ODR && decl->genericDecl && decl->genericDecl->IsExportedDecl()) {
+            decl->linkage = Linkage::WEAK_ODR;
+        }
+    }
 }
 
 inline void UnsetBoxStatus(Package& pkg)
@@ -318,7 +382,7 @@ void GIM::GenericInstantiationManagerImpl::GenericInstantiatePackage(Package& pk
     }
     Utils::ProfileRecorder recorder("GenericInstantiatePackage", "cleanup");
     UpdateInstantiatedExtendMap();
-    UpdateInstantiatedDeclsLinkage(pkg);
+    UpdateInstantiatedDeclsLinkage(pkg, shareInstantiations);
     ClearImportedUnusedInstantiatedDecls();
     ValidateUsedNodes(diag, pkg);
     UnsetBoxStatus(pkg);
@@ -531,6 +595,7 @@ Ptr<Decl> GIM::GenericInstantiationManagerImpl::GetInstantiatedDeclWithGenericIn
         instantiatedDecl->toBeCompiled = instantiatedDecl->toBeCompiled || needCompile;
         return instantiatedDecl;
     }
+    Utils::TraceScope trace("GenericInstantiation", genericDecl->identifier.Val());
     TypeSubst g2gTyMap = {};
     if (IsGenericFuncWithDefaultParam(*genericDecl)) {
         BuildGenericsTyMap(*StaticCast<FuncDecl>(genericDecl), g2gTyMap);
@@ -123,6 +123,8 @@ private:
     unsigned rearrangeWalkerID;
     /** Current compiling backend. */
     Triple::BackendType backend;
+    /** Whether instantiated functions may be shared across packages, see UpdateInstantiatedDeclsLinkage. */
+    bool shareInstantiations;
     /** The node which triggered current instantiation. */
     Ptr<AST::Node> curTriggerNode{nullptr};
     /** Lambda function for instantiation walker. */
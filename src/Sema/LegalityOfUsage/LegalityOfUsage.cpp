@@ -83,7 +83,8 @@ void TypeChecker::TypeCheckerImpl::CheckLegalityOfUsage(ASTContext& ctx, AST::Pa
     }
     CheckGlobalVarInitialization(ctx, pkg);
     // CFunc must be called in an unsafe block.
-    CheckLegalityOfUnsafeAndInout(pkg);
+    CheckInParallel(
+        pkg, [this](Node& node, VisitedNodeSet& visited) { CheckLegalityOfUnsafeAndInout(node, visited); });
     // Check structure declaration inheritance.
     CheckInheritance(pkg);
     CheckClosures(ctx, pkg);
@@ -19,6 +19,7 @@
 #include "cangjie/AST/ScopeManagerApi.h"
 #include "cangjie/AST/Searcher.h"
 #include "cangjie/AST/Symbol.h"
+#include "cangjie/Utils/TaskQueue.h"
 #include "cangjie/Utils/Utils.h"
 
 using namespace Cangjie;
@@ -40,15 +41,13 @@ void TypeChecker::TypeCheckerImpl::WarmupCache(const ASTContext& ctx) const
         return;
     }
     std::unordered_map<std::string, std::vector<Symbol*>> cache;
-    std::vector<std::thread> threads(numScopeNames);
     std::vector<std::unique_ptr<Searcher>> searchers(numScopeNames);
+    Utils::TaskQueue taskQueue(numScopeNames);
     for (size_t i = 0; i < numScopeNames; i++) {
         searchers[i] = std::make_unique<Searcher>();
-    }
-    for (size_t i = 0; i < numScopeNames; i++) {
         std::string scopeName = scopeNames[i];
         Searcher* s = searchers[i].get();
-        threads[i] = std::thread([scopeName, s, &ctx]() {
+        taskQueue.AddTask<void>([scopeName, s, &ctx]() {
             Query q(Operator::NOT);
             q.left = std::make_unique<Query>(Operator::AND);
             q.left->left = std::make_unique<Query>("scope_name", scopeName);
@@ -60,11 +59,7 @@ void TypeChecker::TypeCheckerImpl::WarmupCache(const ASTContext& ctx) const
             s->Search(ctx, &q);
         });
     }
-    for (auto& t : threads) {
-        if (t.joinable()) {
-            t.join();
-        }
-    }
+    taskQueue.RunAndWaitForAllTasksCompleted();
     for (auto& searcher : searchers) {
         cache.merge(searcher->GetCache());
     }
@@ -427,7 +427,7 @@ void TypeChecker::TypeCheckerImpl::InferRefExpr(ASTContext& ctx, RefExpr& re)
     if (auto ce = DynamicCast<CallExpr*>(re.callOrPattern); ce && ce->callKind == CallKind::CALL_ANNOTATION) {
         isCustomAnnotation = true;
     }
-    auto targets = Lookup(ctx, re.ref.identifier, isCustomAnnotation ? TOPLEVEL_SCOPE_NAME : re.scopeName, re,
+    auto targets = Lookup(ctx, re.ref.identifier, isCustomAnnotation ? TOPLEVEL_SCOPE_NAME : re.scopeName.Val(), re,
         re.TestAttr(AST::Attribute::LEFT_VALUE));
     if (!isCustomAnnotation && !re.TestAttr(Attribute::MACRO_INVOKE_BODY) &&
         std::all_of(targets.cbegin(), targets.cend(), [](auto target) {
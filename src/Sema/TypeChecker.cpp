@@ -28,6 +28,7 @@
 #include "TypeCheckUtil.h"
 
 #include "cangjie/AST/Clone.h"
+#include "cangjie/AST/ConcurrentWalker.h"
 #include "cangjie/AST/Create.h"
 #include "cangjie/AST/Match.h"
 #include "cangjie/AST/Node.h"
@@ -36,6 +37,7 @@
 #include "cangjie/Basic/Print.h"
 #include "cangjie/Frontend/CompilerInstance.h"
 #include "cangjie/Utils/CheckUtils.h"
+#include "cangjie/Utils/TaskQueue.h"
 #include "cangjie/Utils/Utils.h"
 
 namespace Cangjie {
@@ -2151,7 +2153,8 @@ void TypeChecker::TypeCheckerImpl::PostTypeCheck(std::vector<Ptr<ASTContext>>& c
     Utils::ProfileRecorder recorder("Semantic", "Post TypeCheck");
     // Post checking for legality of semantic.
     for (auto& ctx : contexts) {
-        CheckOverflow(*ctx->curPackage);
+        CheckInParallel(
+            *ctx->curPackage, [this](Node& node, VisitedNodeSet& visited) { CheckOverflow(node, visited); });
         CheckUnusedImportSpec(*ctx->curPackage);
         // Check duplicated super interfaces in class, interface when type arguments applied.
         CheckInstDupSuperInterfacesEntry(*ctx->curPackage);
@@ -2206,6 +2209,7 @@ void TypeChecker::TypeCheckerImpl::PrepareTypeCheck(ASTContext& ctx, Package& pk
     // Update position limit for symbol collector to ensure Searcher API works correctly.
     collector.UpdatePosLimit(pkg);
     collector.BuildSymbolTable(ctx, &pkg, ci->buildTrie);
+    ctx.invertedIndex.Build();
     // Phase: mark outermost binary expressions.
     MarkOutermostBinaryExpressions(pkg);
     AddCurFile(pkg);
@@ -2216,6 +2220,7 @@ void TypeChecker::TypeCheckerImpl::PrepareTypeCheck(ASTContext& ctx, Package& pk
 
 void TypeChecker::TypeCheckerImpl::TypeCheckTopLevelDecl(ASTContext& ctx, Decl& decl)
 {
+    Utils::TraceScope trace("Sema", decl.identifier.Val());
     TyVarScope ts(typeManager); // to release local placeholder ty var
     Synthesize(ctx, &decl);
     MarkOverflow(decl);
@@ -2815,10 +2820,52 @@ void TypeChecker::TypeCheckerImpl::CheckInstDupSuperInterfacesEntry(Node& n)
     walker.Walk();
 }
 
+void TypeChecker::TypeCheckerImpl::CheckInParallel(
+    Package& pkg, const std::function<void(Node&, VisitedNodeSet&)>& check)
+{
+    // Same parts and order as walking the package. The generic instantiated decls and the files are disjoint
+    // subtrees. The source imported decls are not: the desugared functions of default params are collected along
+    // with the function owning them. They are one part, checked with one visited set like a walk of the package.
+    std::vector<std::vector<Ptr<Node>>> parts;
+    for (auto& decl : pkg.genericInstantiatedDecls) {
+        parts.emplace_back(std::vector<Ptr<Node>>{decl.get()});
+    }
+    for (auto& file : pkg.files) {
+        parts.emplace_back(std::vector<Ptr<Node>>{file.get()});
+    }
+    if (!pkg.srcImportedNonGenericDecls.empty()) {
+        parts.emplace_back(pkg.srcImportedNonGenericDecls.begin(), pkg.srcImportedNonGenericDecls.end());
+    }
+    auto jobs = ci->invocation.globalOptions.GetJobs();
+    if (jobs <= 1 || parts.size() <= 1) {
+        VisitedNodeSet visited;
+        check(pkg, visited);
+        return;
+    }
+    Utils::TaskQueue taskQueue(jobs);
+    std::vector<Utils::TaskResult<std::vector<Diagnostic>>> results;
+    for (auto& part : parts) {
+        results.emplace_back(taskQueue.AddTask<std::vector<Diagnostic>>([this, &check, &part]() {
+            // Keep the diagnostics of the part, they are reported below in the order of a serial check.
+            diag.Prepare();
+            VisitedNodeSet visited;
+            for (auto node : part) {
+                check(*node, visited);
+            }
+            return diag.TakeTransaction();
+        }));
+    }
+    taskQueue.RunAndWaitForAllTasksCompleted();
+    for (auto& result : results) {
+        auto diags = result.get();
+        diag.Commit(diags);
+    }
+}
+
 // Remove after Chir's constant folding really works.
-void TypeChecker::TypeCheckerImpl::CheckOverflow(Node& node)
+void TypeChecker::TypeCheckerImpl::CheckOverflow(Node& node, VisitedNodeSet& visited)
 {
-    Walker walker(&node, nullptr, [this](Ptr<Node> node) -> VisitAction {
+    ConcurrentWalkWith(visited, &node, nullptr, [this](Ptr<Node> node) -> VisitAction {
         switch (node->astKind) {
             case ASTKind::LIT_CONST_EXPR: {
                 auto& lce = *StaticAs<ASTKind::LIT_CONST_EXPR>(node);
@@ -2832,7 +2879,6 @@ void TypeChecker::TypeCheckerImpl::CheckOverflow(Node& node)
             }
         }
     });
-    walker.Walk();
 }
 
 Ptr<Ty> TypeChecker::TypeCheckerImpl::CalcFuncRetTyFromBody(const FuncBody& fb)
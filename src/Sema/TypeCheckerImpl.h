@@ -19,6 +19,7 @@
 #include "ScopeManager.h"
 #include "TypeCheckUtil.h"
 #include "cangjie/AST/Clone.h"
+#include "cangjie/AST/ConcurrentWalker.h"
 #include "cangjie/AST/Symbol.h"
 #include "cangjie/AST/Types.h"
 #include "cangjie/AST/Walker.h"
@@ -519,7 +520,14 @@ private:
     void TypeCheck(ASTContext& ctx, AST::Package& pkg);
     void TypeCheckTopLevelDecl(ASTContext& ctx, AST::Decl& decl);
     void TypeCheckImportedGenericMember(ASTContext& ctx);
-    void CheckOverflow(AST::Node& node);
+    void CheckOverflow(AST::Node& node, AST::VisitedNodeSet& visited);
+    /**
+     * Run @p check on the generic instantiated decls, the files and the source imported decls of @p pkg in
+     * parallel. @p check must only modify the nodes it walks, and must walk them with the given visited set so that
+     * no node is checked twice. The diagnostics are reported in the same order as running @p check on the whole
+     * package.
+     */
+    void CheckInParallel(AST::Package& pkg, const std::function<void(AST::Node&, AST::VisitedNodeSet&)>& check);
     void CheckWhetherHasProgramEntry();
 
     /**
@@ -1568,7 +1576,7 @@ private:
     void CheckStaticMemberAccessLegality(const AST::MemberAccess& ma, const AST::Decl& target);
     void CheckInstanceMemberAccessLegality(const ASTContext& ctx, const AST::MemberAccess& ma, const AST::Decl& target);
     void CheckLegalityOfReference(ASTContext& ctx, AST::Node& node);
-    void CheckLegalityOfUnsafeAndInout(AST::Node& root);
+    void CheckLegalityOfUnsafeAndInout(AST::Node& root, AST::VisitedNodeSet& visited);
 
     bool ShouldSkipDeprecationDiagnostic(const Ptr<AST::Decl> target, bool strict);
     void CheckUsageOfDeprecatedWithTarget(
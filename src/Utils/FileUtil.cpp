@@ -40,6 +40,8 @@
 #endif
 #elif defined(__linux__) || defined(__APPLE__)
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 namespace Cangjie::FileUtil {
@@ -581,6 +583,61 @@ bool ReadBinaryFileToBuffer(const std::string& filePath, std::vector<uint8_t>& b
     return failedReason.empty();
 }
 
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string& filePath, std::string& failedReason)
+{
+    auto file = std::unique_ptr<MappedFile>(new MappedFile());
+#if defined(__linux__) || defined(__APPLE__)
+    auto realFilePath = GetAbsPath(filePath);
+    failedReason.clear();
+    if (!realFilePath.has_value()) {
+        failedReason = "open file failed";
+        return nullptr;
+    }
+    int fd = open(realFilePath.value().c_str(), O_RDONLY);
+    if (fd < 0) {
+        failedReason = "open file failed";
+        return nullptr;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        failedReason = "open file failed";
+    } else if (st.st_size == 0) {
+        failedReason = "empty binary file";
+    } else if (static_cast<size_t>(st.st_size) >= FILE_LEN_LIMIT) {
+        failedReason = "exceed the max file length: 4 GB";
+    }
+    if (!failedReason.empty()) {
+        close(fd);
+        return nullptr;
+    }
+    auto fileLength = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, fileLength, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    if (addr != MAP_FAILED) {
+        file->data = static_cast<const uint8_t*>(addr);
+        file->size = fileLength;
+        file->isMapped = true;
+        return file;
+    }
+#endif
+    if (!ReadBinaryFileToBuffer(filePath, file->buffer, failedReason)) {
+        return nullptr;
+    }
+    file->data = file->buffer.data();
+    file->size = file->buffer.size();
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(__linux__) || defined(__APPLE__)
+    if (isMapped) {
+        (void)munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+}
+
 bool WriteToFile(const std::string& filePath, const std::string& data)
 {
     if (!FileExist(filePath)) {
@@ -625,7 +682,22 @@ bool WriteBufferToASTFile(const std::string& filePath, const std::vector<uint8_t
         return false;
     }
     auto fileName = GetFileName(filePath);
-    std::ofstream outStream(JoinPath(realFilePath.value(), fileName), std::ofstream::out | std::ofstream::binary);
+    auto targetPath = JoinPath(realFilePath.value(), fileName);
+#if defined(__linux__) || defined(__APPLE__)
+    // .cjo files may be mapped by other compilations (see MappedFile), so the file is never truncated in place:
+    // the content is written to a temporary file which then replaces the target atomically. A symbolic link is
+    // written through, its real target is replaced and keeps its mode.
+    struct stat targetStat;
+    bool targetExists = false;
+    if (auto realTarget = GetAbsPath(targetPath); realTarget.has_value()) {
+        targetPath = realTarget.value();
+        targetExists = stat(targetPath.c_str(), &targetStat) == 0;
+    }
+    auto writePath = targetPath + ".tmp" + std::to_string(getpid());
+#else
+    auto writePath = targetPath;
+#endif
+    std::ofstream outStream(writePath, std::ofstream::out | std::ofstream::binary);
     if (!outStream.is_open()) {
         return false;
     }
@@ -633,6 +705,16 @@ bool WriteBufferToASTFile(const std::string& filePath, const std::vector<uint8_t
     outStream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(length));
     bool success = !outStream.fail();
     outStream.close();
+#if defined(__linux__) || defined(__APPLE__)
+    constexpr mode_t permissionBits = 07777;
+    if (success && targetExists) {
+        success = chmod(writePath.c_str(), targetStat.st_mode & permissionBits) == 0;
+    }
+    success = success && rename(writePath.c_str(), targetPath.c_str()) == 0;
+    if (!success) {
+        (void)remove(writePath.c_str());
+    }
+#endif
     return success;
 }
 
@@ -6,10 +6,13 @@
 
 #include "cangjie/Utils/ProfileRecorder.h"
 
+#include <algorithm>
+
 #include "UserBase.h"
 #include "UserCodeInfo.h"
 #include "UserMemoryUsage.h"
 #include "UserTimer.h"
+#include "UserTrace.h"
 
 using namespace Cangjie;
 using namespace Cangjie::Utils;
@@ -47,6 +50,7 @@ void ProfileRecorder::SetPackageName(const std::string& name)
     UserTimer::Instance().SetPackageName(name);
     UserMemoryUsage::Instance().SetPackageName(name);
     UserCodeInfo::Instance().SetPackageName(name);
+    UserTrace::Instance().SetPackageName(name);
 }
 
 void ProfileRecorder::SetOutputDir(const std::string& path)
@@ -54,6 +58,7 @@ void ProfileRecorder::SetOutputDir(const std::string& path)
     UserTimer::Instance().SetOutputDir(path);
     UserMemoryUsage::Instance().SetOutputDir(path);
     UserCodeInfo::Instance().SetOutputDir(path);
+    UserTrace::Instance().SetOutputDir(path);
 }
 
 void ProfileRecorder::Start(
@@ -65,6 +70,9 @@ void ProfileRecorder::Start(
     if (UserMemoryUsage::Instance().IsEnable()) {
         UserMemoryUsage::Instance().Start(title, subtitle, desc);
     }
+    if (IsTraceEnabled()) {
+        UserTrace::Instance().Begin("Phase", title + ": " + subtitle);
+    }
 }
 
 void ProfileRecorder::Stop(
@@ -76,11 +84,51 @@ void ProfileRecorder::Stop(
     if (UserMemoryUsage::Instance().IsEnable()) {
         UserMemoryUsage::Instance().Stop(title, subtitle, desc);
     }
+    if (IsTraceEnabled()) {
+        UserTrace::Instance().End(title + ": " + subtitle);
+    }
+}
+
+void ProfileRecorder::EnableTrace(bool en)
+{
+    if (en && !IsTraceEnabled()) {
+        UserTrace::Instance().Reset();
+    }
+    UserTrace::Instance().Enable(en);
+    traceEnabled.store(en, std::memory_order_relaxed);
+}
+
+std::string ProfileRecorder::GetTraceResult()
+{
+    return UserTrace::Instance().GetResult();
+}
+
+TraceScope::TraceScope(const char* category, const std::string& name) : active(ProfileRecorder::IsTraceEnabled())
+{
+    if (active) {
+        UserTrace::Instance().Begin(category, name);
+    }
+}
+
+TraceScope::~TraceScope()
+{
+    if (!active) {
+        return;
+    }
+#ifndef CANGJIE_ENABLE_GCOV
+    try {
+#endif
+        UserTrace::Instance().End();
+#ifndef CANGJIE_ENABLE_GCOV
+    } catch (...) {
+        // Same as ~ProfileRecorder, no exception may leave the destructor.
+    }
+#endif
 }
 
 void ProfileRecorder::RecordCodeInfo(const std::string& item, const std::function<int64_t(void)>& getData)
 {
-    if (UserTimer::Instance().IsEnable() || UserMemoryUsage::Instance().IsEnable()) {
+    if (IsEnabled()) {
         UserCodeInfo::Instance().RecordInfo(item, getData());
     }
 }
@@ -90,6 +138,27 @@ void ProfileRecorder::RecordCodeInfo(const std::string& item, int64_t value)
     UserCodeInfo::Instance().RecordInfo(item, value);
 }
 
+void ProfileRecorder::RecordImbalance(const std::string& item, const std::vector<int64_t>& values)
+{
+    if (!IsEnabled() || values.empty()) {
+        return;
+    }
+    int64_t total = 0;
+    int64_t max = 0;
+    for (auto value : values) {
+        total += value;
+        max = std::max(max, value);
+    }
+    constexpr int64_t percent = 100;
+    auto num = static_cast<int64_t>(values.size());
+    UserCodeInfo::Instance().RecordInfo(item, total == 0 ? percent : max * num * percent / total);
+}
+
+bool ProfileRecorder::IsEnabled()
+{
+    return UserTimer::Instance().IsEnable() || UserMemoryUsage::Instance().IsEnable();
+}
+
 void ProfileRecorder::Enable(bool en, const Type& type)
 {
     if (type & ProfileRecorder::Type::TIMER) {
@@ -98,7 +167,7 @@ void ProfileRecorder::Enable(bool en, const Type& type)
     if (type & ProfileRecorder::Type::MEMORY) {
         UserMemoryUsage::Instance().Enable(en);
     }
-    if (UserTimer::Instance().IsEnable() || UserMemoryUsage::Instance().IsEnable()) {
+    if (IsEnabled()) {
         UserCodeInfo::Instance().Enable(true);
     } else {
         UserCodeInfo::Instance().Enable(false);
@@ -0,0 +1,188 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file implements the process-wide work-stealing thread pool.
+ */
+
+#include "cangjie/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+using namespace Cangjie::Utils;
+
+namespace {
+constexpr size_t NOT_A_WORKER = std::numeric_limits<size_t>::max();
+// Index of the deque owned by the current thread, NOT_A_WORKER for threads outside the pool.
+thread_local size_t g_currentWorker = NOT_A_WORKER;
+std::atomic<ThreadPool*> g_pool{nullptr};
+std::mutex g_poolMtx;
+
+#ifndef _WIN32
+void LockPoolForFork()
+{
+    g_poolMtx.lock();
+}
+
+void UnlockPoolInParent()
+{
+    g_poolMtx.unlock();
+}
+
+void ResetPoolInChild()
+{
+    // The workers do not exist in the child and the deques may be locked by them, the old pool is leaked. A new one
+    // is created on next use, e.g. by the compiler daemon or the macro server.
+    g_pool.store(nullptr);
+    g_currentWorker = NOT_A_WORKER;
+    g_poolMtx.unlock();
+}
+#endif
+} // namespace
+
+ThreadPool::ThreadPool(size_t workersNum)
+{
+    for (size_t i = 0; i < workersNum; ++i) {
+        (void)deques.emplace_back(std::make_unique<WorkerDeque>());
+    }
+    for (size_t i = 0; i < workersNum; ++i) {
+        (void)workers.emplace_back([this, i]() { WorkerLoop(i); });
+        // Workers sleep on the condition variable when idle and are never joined, they end with the process.
+        workers.back().detach();
+    }
+}
+
+ThreadPool& ThreadPool::Get()
+{
+    if (auto pool = g_pool.load(std::memory_order_acquire)) {
+        return *pool;
+    }
+    std::lock_guard<std::mutex> lock(g_poolMtx);
+    if (!g_pool.load()) {
+#ifndef _WIN32
+        [[maybe_unused]] static bool registered =
+            pthread_atfork(LockPoolForFork, UnlockPoolInParent, ResetPoolInChild) == 0;
+#endif
+        // The thread that waits for its jobs always helps to execute them, so one core is left for it.
+        auto numCores = std::thread::hardware_concurrency();
+        g_pool.store(new ThreadPool(numCores > 1 ? numCores - 1 : 1), std::memory_order_release);
+    }
+    return *g_pool.load();
+}
+
+void ThreadPool::Submit(Job job, const void* group)
+{
+    size_t index = g_currentWorker != NOT_A_WORKER ? g_currentWorker : nextDeque.fetch_add(1) % deques.size();
+    {
+        std::lock_guard<std::mutex> lock(deques[index]->mtx);
+        deques[index]->jobs.emplace_back(GroupJob{std::move(job), group});
+        ++pendingJobs;
+    }
+    {
+        // Synchronize with sleepers which have checked `pendingJobs` but not started waiting yet.
+        std::lock_guard<std::mutex> lock(sleepMtx);
+    }
+    sleepCv.notify_one();
+}
+
+void ThreadPool::HelpUntil(const std::function<bool()>& done, const void* group)
+{
+    while (!done()) {
+        if (TryRunOneOf(group)) {
+            continue;
+        }
+        // The remaining jobs of the group run on other threads, which call `NotifyAll` when they are done.
+        std::unique_lock<std::mutex> lock(sleepMtx);
+        doneCv.wait(lock, done);
+    }
+}
+
+void ThreadPool::NotifyAll()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMtx);
+    }
+    doneCv.notify_all();
+}
+
+void ThreadPool::WorkerLoop(size_t index)
+{
+    g_currentWorker = index;
+    while (true) {
+        if (TryRunOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMtx);
+        sleepCv.wait(lock, [this]() { return pendingJobs.load() > 0; });
+    }
+}
+
+bool ThreadPool::TryRunOne(size_t self)
+{
+    Job job;
+    bool found = self != NOT_A_WORKER && PopBack(self, job);
+    size_t start = self != NOT_A_WORKER ? self + 1 : 0;
+    for (size_t i = 0; !found && i < deques.size(); ++i) {
+        found = StealFront((start + i) % deques.size(), job);
+    }
+    if (!found) {
+        return false;
+    }
+    job();
+    return true;
+}
+
+bool ThreadPool::TryRunOneOf(const void* group)
+{
+    Job job;
+    for (size_t i = 0; i < deques.size() && !job; ++i) {
+        std::lock_guard<std::mutex> lock(deques[i]->mtx);
+        auto& jobs = deques[i]->jobs;
+        auto it = std::find_if(jobs.begin(), jobs.end(), [group](auto& entry) { return entry.group == group; });
+        if (it != jobs.end()) {
+            job = std::move(it->job);
+            jobs.erase(it);
+            --pendingJobs;
+        }
+    }
+    if (!job) {
+        return false;
+    }
+    job();
+    return true;
+}
+
+bool ThreadPool::PopBack(size_t index, Job& job)
+{
+    std::lock_guard<std::mutex> lock(deques[index]->mtx);
+    auto& jobs = deques[index]->jobs;
+    if (jobs.empty()) {
+        return false;
+    }
+    job = std::move(jobs.back().job);
+    jobs.pop_back();
+    --pendingJobs;
+    return true;
+}
+
+bool ThreadPool::StealFront(size_t index, Job& job)
+{
+    std::lock_guard<std::mutex> lock(deques[index]->mtx);
+    auto& jobs = deques[index]->jobs;
+    if (jobs.empty()) {
+        return false;
+    }
+    job = std::move(jobs.front().job);
+    jobs.pop_front();
+    --pendingJobs;
+    return true;
+}
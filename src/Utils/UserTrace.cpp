@@ -0,0 +1,137 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include "UserTrace.h"
+
+#include <cstdio>
+#include <utility>
+
+namespace Cangjie {
+namespace {
+void AppendEscaped(std::string& output, const std::string& str)
+{
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                output += "\\\"";
+                break;
+            case '\\':
+                output += "\\\\";
+                break;
+            case '\n':
+                output += "\\n";
+                break;
+            case '\t':
+                output += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) { // Other control characters are written as \u00XX.
+                    char buf[8];
+                    (void)snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    output += buf;
+                } else {
+                    output += c;
+                }
+                break;
+        }
+    }
+}
+} // namespace
+
+UserTrace::ThreadBuffer& UserTrace::GetThreadBuffer()
+{
+    // Buffers are owned by the singleton and are never freed before it, so the cached pointer stays valid.
+    thread_local ThreadBuffer* current = nullptr;
+    if (current == nullptr) {
+        std::lock_guard<std::mutex> lock(mtx);
+        buffers.emplace_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(buffers.size())));
+        current = buffers.back().get();
+    }
+    return *current;
+}
+
+int64_t UserTrace::Now() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void UserTrace::Begin(const char* category, std::string name)
+{
+    auto& buffer = GetThreadBuffer();
+    buffer.open.emplace_back(Span{category, std::move(name), Now(), 0});
+}
+
+void UserTrace::Close(ThreadBuffer& buffer, int64_t now)
+{
+    auto& span = buffer.open.back();
+    span.dur = now - span.start;
+    buffer.done.emplace_back(std::move(span));
+    buffer.open.pop_back();
+}
+
+void UserTrace::End()
+{
+    auto& buffer = GetThreadBuffer();
+    if (!buffer.open.empty()) {
+        Close(buffer, Now());
+    }
+}
+
+void UserTrace::End(const std::string& name)
+{
+    auto& buffer = GetThreadBuffer();
+    auto it = buffer.open.rbegin();
+    while (it != buffer.open.rend() && it->name != name) {
+        ++it;
+    }
+    if (it == buffer.open.rend()) {
+        return;
+    }
+    // Spans which were left open inside the one being closed end at the same time.
+    auto now = Now();
+    for (auto count = it - buffer.open.rbegin() + 1; count > 0; --count) {
+        Close(buffer, now);
+    }
+}
+
+void UserTrace::Reset()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& buffer : buffers) {
+        buffer->open.clear();
+        buffer->done.clear();
+    }
+    origin = std::chrono::steady_clock::now();
+}
+
+std::string UserTrace::GetJson() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string output = "{\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&output, &first]() {
+        output += first ? "\n" : ",\n";
+        first = false;
+    };
+    for (auto& buffer : buffers) {
+        std::string tid = std::to_string(buffer->tid);
+        separate();
+        output += R"({"name":"thread_name","ph":"M","pid":1,"tid":)" + tid + R"(,"args":{"name":"cjc thread )" +
+            tid + "\"}}";
+        for (auto& span : buffer->done) {
+            separate();
+            output += R"({"name":")";
+            AppendEscaped(output, span.name);
+            output += R"(","cat":")";
+            output += span.category;
+            output += R"(","ph":"X","ts":)" + std::to_string(span.start) + ",\"dur\":" + std::to_string(span.dur) +
+                ",\"pid\":1,\"tid\":" + tid + "}";
+        }
+    }
+    output += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return output;
+}
+} // namespace Cangjie
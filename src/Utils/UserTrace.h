@@ -0,0 +1,78 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#ifndef CANGJIE_USERTRACE_H
+#define CANGJIE_USERTRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "UserBase.h"
+
+namespace Cangjie {
+/**
+ * Records nested spans per thread and outputs them in the Chrome trace event format, which can be loaded by
+ * chrome://tracing and Perfetto. Every thread writes its own buffer, the lock is only taken when a thread records its
+ * first span.
+ */
+class UserTrace : public UserBase {
+public:
+    UserTrace() = default;
+    ~UserTrace() override
+    {
+        OutputResult();
+    }
+    static UserTrace& Instance()
+    {
+        static UserTrace single{};
+        return single;
+    }
+
+    /** Open a span on the current thread, it is closed by the next End on the same thread. */
+    void Begin(const char* category, std::string name);
+    /** Close the innermost open span of the current thread. */
+    void End();
+    /** Close the innermost open span named @p name and the spans nested in it. */
+    void End(const std::string& name);
+    /** Drop all recorded spans and restart the clock. Must not race with Begin or End. */
+    void Reset();
+
+private:
+    struct Span {
+        const char* category;
+        std::string name;
+        int64_t start;
+        int64_t dur;
+    };
+    struct ThreadBuffer {
+        explicit ThreadBuffer(uint32_t tid) : tid(tid)
+        {
+        }
+        uint32_t tid;
+        std::vector<Span> open;
+        std::vector<Span> done;
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+    int64_t Now() const;
+    void Close(ThreadBuffer& buffer, int64_t now);
+    std::string GetJson() const override;
+    std::string GetSuffix() const final
+    {
+        return ".trace.json";
+    }
+
+    mutable std::mutex mtx;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::chrono::steady_clock::time_point origin{std::chrono::steady_clock::now()};
+};
+} // namespace Cangjie
+
+#endif // CANGJIE_USERTRACE_H
@@ -0,0 +1,86 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * This file is the main entry of the compiler daemon. Usage:
+ *
+ *     cjc-daemon <socket path> [<directory of .cjo files to preload>...]
+ *
+ * The std library of the SDK is always preloaded. Compilations are forwarded to the daemon by running `cjc`
+ * with the environment variable `CJC_DAEMON_SOCKET` set to the socket path.
+ */
+
+#include "cangjie/Basic/DiagnosticEngine.h"
+#include "cangjie/Basic/Print.h"
+#include "cangjie/Driver/CompilerDaemon.h"
+#include "cangjie/Driver/Driver.h"
+#include "cangjie/Driver/TempFileManager.h"
+#include "cangjie/Macro/InvokeUtil.h"
+#include "cangjie/Utils/FileUtil.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Cangjie;
+
+namespace {
+const int EXIT_CODE_SUCCESS = 0;
+const int EXIT_CODE_ERROR = 1;
+const size_t IDX_OF_SOCKET = 1;
+const size_t IDX_OF_FIRST_PRELOAD_DIR = 2;
+
+/// Same as the Driver mode of the `cjc` which forwarded @p request, see main.cpp.
+int Compile(const CompileRequest& request)
+{
+    try {
+        SourceManager sm;
+        DiagnosticEngine diag;
+        diag.SetSourceManager(&sm);
+        std::unique_ptr<Driver> driver = std::make_unique<Driver>(request.args, diag, request.exePath);
+        driver->EnvironmentSetup(request.environmentVars);
+        if (!driver->ParseArgs()) {
+            WriteError("Invalid options. Try: 'cjc --help' for more information.\n");
+            return EXIT_CODE_ERROR;
+        }
+        auto res = driver->ExecuteCompilation();
+        TempFileManager::Instance().DeleteTempFiles();
+        RuntimeInit::GetInstance().CloseRuntime();
+        return res ? EXIT_CODE_SUCCESS : EXIT_CODE_ERROR;
+    } catch (const NullPointerException&) {
+        InternalError("null pointer");
+    }
+    return EXIT_CODE_ERROR;
+}
+} // namespace
+
+int main(int argc, const char** argv, const char** envp)
+{
+    std::vector<std::string> args = Utils::StringifyArgumentVector(argc, argv);
+    if (args.size() <= IDX_OF_SOCKET) {
+        Errorln("usage: cjc-daemon <socket path> [<directory of .cjo files to preload>...]");
+        return EXIT_CODE_ERROR;
+    }
+#ifdef _WIN32
+    auto maybeExePath = Utils::GetApplicationPath();
+#else
+    auto maybeExePath = Utils::GetApplicationPath(args[0], Utils::StringifyEnvironmentPointer(envp));
+#endif
+    if (!maybeExePath.has_value()) {
+        return EXIT_CODE_ERROR;
+    }
+    // The daemon is installed next to `cjc`, preload the std library of that SDK. Each compilation still runs as
+    // the `cjc` of its client, see `CompileRequest::exePath`.
+    std::string binDir = FileUtil::GetDirPath(maybeExePath.value());
+    CompilerDaemon daemon(args[IDX_OF_SOCKET], Compile);
+    daemon.PreloadDirectory(FileUtil::JoinPath(FileUtil::GetDirPath(binDir), "modules"));
+    for (size_t i = IDX_OF_FIRST_PRELOAD_DIR; i < args.size(); ++i) {
+        daemon.PreloadDirectory(args[i]);
+    }
+    return daemon.Serve() ? EXIT_CODE_SUCCESS : EXIT_CODE_ERROR;
+}
@@ -37,6 +37,8 @@ const size_t IDX_OF_WRITE_HANDLE = 2;
 const size_t IDX_OF_ENABLE_PARA = 3;
 const size_t IDX_OF_CJC_FOLDER = 4;
 const size_t IDX_OF_PPID = 5;
+// Optional, the fd of the shared memory transport created by the compiler.
+const size_t IDX_OF_SHM_FD = 6;
 #if defined(__linux__) || defined(__APPLE__)
 const unsigned int CHECK_INTERVAL = 2;
 static void MonitoringParentProcess(pid_t pid)
@@ -66,7 +68,7 @@ bool IsNumber(const std::string& str)
 
 bool IsArgsValid(const std::vector<std::string>& args)
 {
-    if (args.size() != ARGS_NUM) {
+    if (args.size() != ARGS_NUM && args.size() != ARGS_NUM + 1) {
         Errorln(
             "Macro srv: Incorrect number of args, " + std::to_string(args.size()) + " : " + std::to_string(ARGS_NUM));
         return false;
@@ -79,6 +81,10 @@ bool IsArgsValid(const std::vector<std::string>& args)
         Errorln("Macro srv: Arg of write handle is not number");
         return false;
     }
+    if (args.size() > IDX_OF_SHM_FD && !IsNumber(args[IDX_OF_SHM_FD])) {
+        Errorln("Macro srv: Arg of shared memory fd is not number");
+        return false;
+    }
     if (args[IDX_OF_CJC_FOLDER].empty()) {
         Errorln("Macro srv: Arg of cjc folder is empty");
         return false;
@@ -159,6 +165,11 @@ int main(int argc, const char* argv[], [[maybe_unused]] const char** envp)
     {
         [[maybe_unused]] std::lock_guard lg(MacroProcMsger::GetInstance().mutex);
         MacroProcMsger::GetInstance().SetSrvPipeHandle(hRead, hWrite);
+        if (args.size() > IDX_OF_SHM_FD && !MacroProcMsger::GetInstance().SetSrvShm(stoi(args[IDX_OF_SHM_FD]))) {
+            // The compiler reads and writes the same ring, it cannot fall back to the pipes anymore.
+            Errorln("Macro srv: Shared memory is not available");
+            return -1;
+        }
     }
 #ifdef CANGJIE_CODEGEN_CJNATIVE_BACKEND
     RuntimeInit::GetInstance().InitRuntime(
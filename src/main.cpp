@@ -11,6 +11,7 @@
  */
 
 #include "cangjie/Basic/DiagnosticEngine.h"
+#include "cangjie/Driver/CompilerDaemon.h"
 #include "cangjie/Driver/Driver.h"
 #include "cangjie/Driver/TempFileManager.h"
 #include "cangjie/FrontendTool/FrontendTool.h"
@@ -78,6 +79,14 @@ int main(int argc, const char** argv, const char** envp)
             TempFileManager::Instance().DeleteTempFiles();
             return ret;
         }
+        // A running compiler daemon keeps imported packages resident, let it compile if there is one.
+        if (auto socket = environmentVars.find(CJC_DAEMON_SOCKET_ENV); socket != environmentVars.end()) {
+            CompileRequest request{FileUtil::GetAbsPath(".").value_or("."), exePath, args, environmentVars};
+            (void)request.environmentVars.erase(CJC_DAEMON_SOCKET_ENV);
+            if (auto ret = CompilerDaemon::Forward(socket->second, request)) {
+                return ret.value();
+            }
+        }
 #ifdef SIGNAL_TEST
         // The interrupt signal triggers the function. In normal cases, this function does not take effect.
         Cangjie::SignalTest::ExecuteSignalTestCallbackFunc(Cangjie::SignalTest::TriggerPointer::MAIN_POINTER);
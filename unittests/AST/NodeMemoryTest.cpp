@@ -0,0 +1,126 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <cstdio>
+#include <map>
+#include "gtest/gtest.h"
+
+#include "cangjie/AST/Node.h"
+#include "cangjie/AST/NodeX.h"
+#include "cangjie/AST/Walker.h"
+#include "cangjie/Parse/Parser.h"
+
+using namespace Cangjie;
+using namespace AST;
+
+namespace {
+/** The size of the dynamic type of @p node, which is what the allocation of the node costs without its children. */
+size_t GetNodeSize(const Node& node)
+{
+    switch (node.astKind) {
+#define ASTKIND(KIND, VALUE, NODE, SIZE)                                                                               \
+    case ASTKind::KIND:                                                                                                \
+        return sizeof(NODE);
+#include "cangjie/AST/ASTKind.inc"
+#undef ASTKIND
+        default:
+            return sizeof(Node);
+    }
+}
+
+std::string GenerateCode(size_t funcNum)
+{
+    std::string code;
+    for (size_t i = 0; i < funcNum; ++i) {
+        auto idx = std::to_string(i);
+        code += "func f" + idx + "(a: Int64, b: Int64): Int64 {\n"
+                "    var c = a + b * " + idx + "\n"
+                "    if (c > 10) { c = c - 1 } else { c = f" + idx + "(c, a) }\n"
+                "    return c\n"
+                "}\n";
+    }
+    return code;
+}
+} // namespace
+
+TEST(NodeMemoryTest, PooledScopeName)
+{
+    EXPECT_EQ(sizeof(Position), 16);
+    EXPECT_EQ(sizeof(PooledString), sizeof(void*));
+
+    auto poolSize = StringPool::Size();
+    {
+        RefExpr a;
+        RefExpr b;
+        a.scopeName = std::string("a_0");
+        b.scopeName = a.scopeName.Val();
+        EXPECT_EQ(a.scopeName, b.scopeName);
+        EXPECT_EQ(&a.scopeName.Val(), &b.scopeName.Val());
+        EXPECT_EQ(a.scopeName, "a_0");
+        EXPECT_EQ(a.scopeName + "_1", "a_0_1");
+        b.scopeName = "";
+        EXPECT_TRUE(b.scopeName.empty());
+        EXPECT_NE(a.scopeName, b.scopeName);
+    }
+    // The scope name is freed with the last node referring to it.
+    EXPECT_EQ(StringPool::Size(), poolSize);
+}
+
+/**
+ * The sizes of the most frequent nodes must not grow unnoticed. The budgets are the sizes with libstdc++ on 64-bit
+ * hosts, other standard libraries have smaller strings and containers. Raise a budget on purpose, together with the
+ * numbers of DISABLED_BytesPerNodeByKind.
+ */
+TEST(NodeMemoryTest, NodeSizeBudgets)
+{
+    if constexpr (sizeof(void*) == 8) {
+        EXPECT_LE(sizeof(Node), 232);
+        EXPECT_LE(sizeof(RefExpr), 624);
+        EXPECT_LE(sizeof(LitConstExpr), 512);
+        EXPECT_LE(sizeof(BinaryExpr), 432);
+        EXPECT_LE(sizeof(CallExpr), 544);
+        EXPECT_LE(sizeof(MemberAccess), 704);
+        EXPECT_LE(sizeof(FuncArg), 368);
+        EXPECT_LE(sizeof(Block), 464);
+        EXPECT_LE(sizeof(VarDecl), 760);
+        EXPECT_LE(sizeof(FuncDecl), 776);
+    }
+}
+
+/**
+ * Parses a generated file and prints how much memory the nodes take per ASTKind. It is a benchmark to be run by hand
+ * when changing the layout of the nodes:
+ *
+ *     NodeMemoryTest --gtest_also_run_disabled_tests --gtest_filter=NodeMemoryTest.DISABLED_BytesPerNodeByKind
+ */
+TEST(NodeMemoryTest, DISABLED_BytesPerNodeByKind)
+{
+    DiagnosticEngine diag;
+    SourceManager sm;
+    Parser parser(GenerateCode(1000), diag, sm);
+    auto file = parser.ParseTopLevel();
+    ASSERT_NE(file.get(), nullptr);
+
+    std::map<std::string, std::pair<size_t, size_t>> stats; // Kind name -> (count, bytes).
+    size_t nodeNum = 0;
+    size_t totalBytes = 0;
+    Walker(file.get(), [&](Ptr<Node> node) {
+        auto size = GetNodeSize(*node);
+        auto& [count, bytes] = stats[ASTKIND_TO_STR.at(node->astKind)];
+        ++count;
+        bytes += size;
+        ++nodeNum;
+        totalBytes += size;
+        return VisitAction::WALK_CHILDREN;
+    }).Walk();
+
+    ASSERT_GT(nodeNum, 0);
+    printf("%-24s %10s %12s %10s\n", "kind", "count", "bytes", "per node");
+    for (auto& [kind, stat] : stats) {
+        printf("%-24s %10zu %12zu %10zu\n", kind.c_str(), stat.first, stat.second, stat.second / stat.first);
+    }
+    printf("%-24s %10zu %12zu %10zu\n", "total", nodeNum, totalBytes, totalBytes / nodeNum);
+}
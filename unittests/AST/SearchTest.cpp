@@ -4,6 +4,8 @@
 //
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
+#include <chrono>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -335,42 +337,49 @@ TEST_F(SearchTest, ScopeName)
     EXPECT_EQ(ScopeManagerApi::GetChildScopeName("a_a"), "a0a");
 }
 
-TEST_F(SearchTest, PrefixTrie)
+TEST_F(SearchTest, PrefixIndex)
 {
-    Trie prefixTrie;
-    prefixTrie.Insert("a0b");
-    prefixTrie.Insert("a0b0c0e");
-    prefixTrie.Insert("a0b");
-    prefixTrie.Insert("a0c");
-    prefixTrie.Insert("a0b0d");
-    prefixTrie.Insert("a0d");
-    auto results = prefixTrie.PrefixMatch("a0b");
+    StringIndex prefixIndex;
+    prefixIndex.Insert("a0b");
+    prefixIndex.Insert("a0b0c0e");
+    prefixIndex.Insert("a0b");
+    prefixIndex.Insert("a0c");
+    prefixIndex.Insert("a0b0d");
+    prefixIndex.Insert("a0d");
+    auto results = prefixIndex.PrefixMatch("a0b");
     std::vector<std::string> expectStrings = {"a0b", "a0b0c0e", "a0b0d"};
-    EXPECT_TRUE(std::equal(results.begin(), results.end(), expectStrings.begin()));
-
-    prefixTrie.Reset();
-    prefixTrie.Insert("a0b0c");
-    prefixTrie.Insert("a0c");
-    prefixTrie.Insert("a0b0d");
-    prefixTrie.Insert("a0d");
-    results = prefixTrie.PrefixMatch("a0b");
+    EXPECT_EQ(results, expectStrings);
+    prefixIndex.Build();
+    EXPECT_EQ(prefixIndex.PrefixMatch("a0b"), expectStrings);
+
+    prefixIndex.Reset();
+    prefixIndex.Insert("a0b0c");
+    prefixIndex.Insert("a0c");
+    prefixIndex.Build();
+    // Strings inserted after the build are found as well.
+    prefixIndex.Insert("a0b0d");
+    prefixIndex.Insert("a0d");
+    results = prefixIndex.PrefixMatch("a0b");
     expectStrings = {"a0b0c", "a0b0d"};
-    EXPECT_TRUE(std::equal(results.begin(), results.end(), expectStrings.begin()));
+    EXPECT_EQ(results, expectStrings);
 }
 
-TEST_F(SearchTest, SuffixTrie)
+TEST_F(SearchTest, SuffixIndex)
 {
-    Trie suffixTrie;
-    suffixTrie.Insert("var_decl");
-    suffixTrie.Insert("ref_type");
-    suffixTrie.Insert("member_access");
-    suffixTrie.Insert("func_decl");
-    suffixTrie.Insert("ref_expr");
-    suffixTrie.Insert("record_decl");
-    suffixTrie.Insert("class_decl");
-    auto results = suffixTrie.SuffixMatch("decl");
+    StringIndex suffixIndex;
+    suffixIndex.Insert("var_decl");
+    suffixIndex.Insert("ref_type");
+    suffixIndex.Insert("member_access");
+    suffixIndex.Insert("func_decl");
+    suffixIndex.Insert("ref_expr");
+    suffixIndex.Insert("decl");
+    suffixIndex.Build();
+    suffixIndex.Insert("record_decl");
+    suffixIndex.Insert("class_decl");
+    auto results = suffixIndex.SuffixMatch("decl");
+    // The string equal to the suffix is not matched.
     std::vector<std::string> expectStrings = {"class_decl", "func_decl", "record_decl", "var_decl"};
-    EXPECT_TRUE(std::equal(results.begin(), results.end(), expectStrings.begin()));
+    EXPECT_EQ(results, expectStrings);
 }
 
 TEST_F(SearchTest, FuzzyQuery)
@@ -416,6 +425,46 @@ TEST_F(SearchTest, FuzzyQuery)
     pkg.reset();
 }
 
+TEST_F(SearchTest, CompiledQueryCache)
+{
+    diag.SetSourceManager(&sm);
+    Parser parser(code, diag, sm);
+    OwnedPtr<Package> pkg = MakeOwned<Package>();
+    pkg->files.emplace_back(parser.ParseTopLevel());
+    ASTContext ctx(diag, *pkg);
+    ScopeManager scopeManager;
+    Collector collector(scopeManager);
+    collector.BuildSymbolTable(ctx, pkg.get());
+    ctx.invertedIndex.Build();
+    Searcher& searcher = *ctx.searcher;
+
+    // The plan of a query string is kept, and gives the same results as the query tree.
+    std::string queryString = "ast_kind: *decl && scope_level < 2";
+    auto res = searcher.Search(ctx, queryString);
+    EXPECT_FALSE(res.empty());
+    EXPECT_EQ(searcher.Search(ctx, queryString), res);
+    Query q(Operator::AND);
+    q.left = std::make_unique<Query>("ast_kind", "decl", MatchKind::SUFFIX);
+    q.right = std::make_unique<Query>("scope_level", "2");
+    q.right->sign = "<";
+    searcher.InvalidateCache();
+    EXPECT_EQ(searcher.Search(ctx, &q), res);
+
+    // Deleted symbols are not returned by the cached plan.
+    auto deleted = res.front();
+    ctx.DeleteInvertedIndexes(deleted->node);
+    auto res2 = searcher.Search(ctx, queryString);
+    EXPECT_LT(res2.size(), res.size());
+    EXPECT_EQ(std::find(res2.begin(), res2.end(), deleted), res2.end());
+
+    // Invalid queries are diagnosed and find nothing.
+    auto errorCount = diag.GetErrorCount();
+    EXPECT_TRUE(searcher.Search(ctx, "scope_name: *a").empty());
+    EXPECT_GT(diag.GetErrorCount(), errorCount);
+    // Need to release AST before ASTContext.
+    pkg.reset();
+}
+
 TEST_F(SearchTest, RangeQuery)
 {
     diag.SetSourceManager(&sm);
@@ -434,34 +483,33 @@ TEST_F(SearchTest, RangeQuery)
     std::string posStr = PosSearchApi::PosToStr(pos);
     EXPECT_EQ(posStr, "00000000600016");
 
-    // Test FindCommonRootInPosTrie of PosSearchApi.
-    std::set<Symbol*> ids;
-    TrieNode* root = PosSearchApi::FindCommonRootInPosTrie(*ctx.invertedIndex.posBeginTrie, pos);
-    EXPECT_EQ(root->value, "00000000600016");
-    const int expectDepth = 14;
-    EXPECT_EQ(root->depth, expectDepth);
-
-    // Test GetIDsGreaterTheanPos of PosSearchApi.
-    ids = PosSearchApi::GetIDsGreaterThanPos(*ctx.invertedIndex.posBeginTrie, pos);
+    // Test GetIDsGreaterThanPos of PosIndex.
+    auto& index = ctx.invertedIndex;
+    std::set<Symbol*> ids = index.GetSymbols(index.posBeginIndex.GetIDsGreaterThanPos(pos));
+    EXPECT_FALSE(ids.empty());
     for (auto i : ids) {
         EXPECT_TRUE(pos <= i->node->begin);
     }
 
-    // Test GetIDsLessThanPos of PosSearchApi.
-    ids = PosSearchApi::GetIDsLessThanPos(*ctx.invertedIndex.posBeginTrie, pos);
+    // Test GetIDsLessThanPos of PosIndex.
+    ids = index.GetSymbols(index.posBeginIndex.GetIDsLessThanPos(pos));
+    EXPECT_FALSE(ids.empty());
     for (auto i : ids) {
         EXPECT_TRUE(i->node->begin <= pos);
     }
 
-    // Test GetIDsWithinPosXByRange of PosSearchApi.
+    // Test GetIDsWithinRange of PosIndex.
     Position startPos = Position{0, 6, 1};
     Position endPos = Position{0, 6, 16};
-    ids = PosSearchApi::GetIDsWithinPosXByRange(*ctx.invertedIndex.posBeginTrie, startPos, endPos);
+    ids = index.GetSymbols(index.posBeginIndex.GetIDsWithinRange(startPos, endPos));
     auto expectSize = 1;
     EXPECT_EQ(ids.size(), expectSize);
-    ids = PosSearchApi::GetIDsWithinPosXByRange(*ctx.invertedIndex.posBeginTrie, startPos, endPos, true, true);
+    ids = index.GetSymbols(index.posBeginIndex.GetIDsWithinRange(startPos, endPos, true, true));
     auto expectSize2 = 3;
     EXPECT_EQ(ids.size(), expectSize2);
+    // Positions are not indexed across files.
+    ids = index.GetSymbols(index.posBeginIndex.GetIDsWithinRange(startPos, Position{1, 1, 1}));
+    EXPECT_TRUE(ids.empty());
 
     std::string queryString3 = "_ < (0, 4, 5) && ast_kind: var_decl";
     auto res7 = searcher.Search(ctx, queryString3);
@@ -2266,3 +2314,41 @@ main() {
     EXPECT_EQ(res[0]->node->begin.column, 22465);
     EXPECT_EQ(res[0]->node->astKind, ASTKind::FUNC_BODY);
 }
+
+/**
+ * Microbenchmark of Searcher::Search over the name, scope name, AST kind and position indexes of a generated package.
+ * It is disabled by default, run it with `--gtest_also_run_disabled_tests --gtest_filter=SearchTest.DISABLED_Bench*`.
+ */
+TEST_F(SearchTest, DISABLED_BenchSearch)
+{
+    const int funcNum = 2000;
+    const int rounds = 100;
+    std::string benchCode;
+    for (int i = 0; i < funcNum; ++i) {
+        auto idx = std::to_string(i);
+        benchCode += "func func" + idx + "(a: Int64): Int64 {\n    let value" + idx + " = a + " + idx +
+            "\n    value" + idx + "\n}\n";
+    }
+    std::unique_ptr<TestCompilerInstance> instance = std::make_unique<TestCompilerInstance>(invocation, diag);
+    instance->code = benchCode;
+    instance->invocation.globalOptions.implicitPrelude = false;
+    instance->Compile(CompileStage::SEMA);
+    ASSERT_EQ(diag.GetErrorCount(), 0);
+    ASTContext& ctx = *instance->GetASTContextByPackage(instance->GetSourcePackages()[0]);
+    auto fileID = std::to_string(instance->GetSourcePackages()[0]->files[0]->begin.fileID);
+
+    const std::vector<std::string> queries = {"name:func1999", "name:func1*", "name:*99", "scope_level:1",
+        "ast_kind:*decl", "_ = (" + fileID + ", 4001, 6)", "_ < (" + fileID + ", 100, 1) && ast_kind:var_decl"};
+    Searcher searcher;
+    for (auto& query : queries) {
+        EXPECT_FALSE(searcher.Search(ctx, query).empty()) << query;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            // Measure the indexes, not the result cache.
+            searcher.InvalidateCache();
+            (void)searcher.Search(ctx, query);
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[Search bench] " << query << ": " << elapsed / rounds << " us/query" << std::endl;
+    }
+}
@@ -4,10 +4,12 @@
 //
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 
 #define private public
+#include "cangjie/AST/ConcurrentWalker.h"
 #include "cangjie/AST/Match.h"
 #include "cangjie/AST/PrintNode.h"
 #include "cangjie/AST/Walker.h"
@@ -163,3 +165,88 @@ TEST_F(WalkerTest, GetCallExprs)
         EXPECT_EQ(expectedCallExprNames[i], callExprNames[i]);
     }
 }
+
+TEST_F(WalkerTest, ConcurrentWalkSameOrder)
+{
+    std::vector<Ptr<Node>> expected;
+    std::vector<Ptr<Node>> visited;
+    auto collect = [](std::vector<Ptr<Node>>& nodes) {
+        return [&nodes](Ptr<Node> node) -> VisitAction {
+            nodes.push_back(node);
+            return node->astKind == ASTKind::CALL_EXPR ? VisitAction::SKIP_CHILDREN : VisitAction::WALK_CHILDREN;
+        };
+    };
+    Walker(file.get(), collect(expected)).Walk();
+    ConcurrentWalk(file.get(), collect(visited));
+
+    EXPECT_EQ(expected, visited);
+}
+
+TEST_F(WalkerTest, ConcurrentWalkSharedTree)
+{
+    size_t expected = 0;
+    ConstWalker(file.get(), [&expected](Ptr<const Node>) {
+        ++expected;
+        return VisitAction::WALK_CHILDREN;
+    }).Walk();
+
+    // Each walker must visit the whole tree, whatever the other one has visited.
+    std::vector<size_t> counts(2, 0);
+    std::vector<std::thread> threads;
+    for (auto& count : counts) {
+        threads.emplace_back([this, &count]() {
+            for (int i = 0; i < 100; ++i) {
+                ConcurrentWalk(static_cast<const File*>(file.get()), [&count](Ptr<const Node>) {
+                    ++count;
+                    return VisitAction::WALK_CHILDREN;
+                });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto count : counts) {
+        EXPECT_EQ(expected * 100, count);
+    }
+}
+
+TEST_F(WalkerTest, ConcurrentWalkSharedVisitedSet)
+{
+    // Walking a subtree first with the same visited set leaves only the rest of the tree to the second walk.
+    auto callExpr = Ptr<Node>();
+    ConcurrentWalk(file.get(), [&callExpr](Ptr<Node> node) {
+        if (!callExpr && node->astKind == ASTKind::CALL_EXPR) {
+            callExpr = node;
+        }
+        return VisitAction::WALK_CHILDREN;
+    });
+    ASSERT_TRUE(callExpr);
+    auto counter = [](size_t& count) {
+        return [&count](Ptr<Node>) {
+            ++count;
+            return VisitAction::WALK_CHILDREN;
+        };
+    };
+    size_t total = 0;
+    ConcurrentWalk(file.get(), counter(total));
+    size_t first = 0;
+    size_t second = 0;
+    VisitedNodeSet visited;
+    ConcurrentWalkWith(visited, callExpr.get(), counter(first));
+    ConcurrentWalkWith(visited, file.get(), counter(second));
+    EXPECT_GT(first, 0);
+    EXPECT_EQ(total, first + second);
+}
+
+TEST_F(WalkerTest, CopiedNodeHasNewID)
+{
+    Modifier modifier(TokenKind::PUBLIC, {0, 0, 0});
+    Modifier copied = modifier;
+    EXPECT_NE(modifier.nodeID.Get(), copied.nodeID.Get());
+
+    VisitedNodeSet visited;
+    EXPECT_TRUE(visited.Insert(modifier));
+    EXPECT_FALSE(visited.Insert(modifier));
+    EXPECT_TRUE(visited.Insert(copied));
+}
@@ -109,6 +109,51 @@ TEST(EngineTest, HandlerFilter)
     EXPECT_EQ(2, diag.GetErrorCount());
 }
 
+namespace {
+class RecordingDiagnosticHandler : public DiagnosticHandler {
+public:
+    RecordingDiagnosticHandler(DiagnosticEngine& diag, std::vector<int>& lines)
+        : DiagnosticHandler(diag, DiagHandlerKind::LSP_HANDLER), lines(lines)
+    {
+    }
+    void HandleDiagnose(Diagnostic& d) override
+    {
+        lines.emplace_back(d.mainHint.range.begin.line);
+    }
+
+private:
+    std::vector<int>& lines;
+};
+} // namespace
+
+TEST(EngineTest, TakeTransactionInThreads)
+{
+    Cangjie::ICE::TriggerPointSetter iceSetter(static_cast<int64_t>(Cangjie::ICE::UNITTEST_TP));
+    DiagnosticEngine diag;
+    std::vector<int> lines;
+    diag.RegisterHandler(std::make_unique<RecordingDiagnosticHandler>(diag, lines));
+    constexpr int threadsNum = 4;
+    std::vector<std::vector<Diagnostic>> diagsOfThreads(threadsNum);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadsNum; ++i) {
+        threads.emplace_back([&diag, &diagsOfThreads, i]() {
+            diag.Prepare();
+            diag.DiagnoseRefactor(DiagKindRefactor::parse_expected_name, Position{0, i + 1, 1},
+                std::string{"test name"}, std::string{"test02"}, std::string{"test03"});
+            diagsOfThreads[static_cast<size_t>(i)] = diag.TakeTransaction();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // Nothing is reported before the diagnostics are committed.
+    EXPECT_TRUE(lines.empty());
+    for (int i = threadsNum - 1; i >= 0; --i) {
+        diag.Commit(diagsOfThreads[static_cast<size_t>(i)]);
+    }
+    EXPECT_EQ(lines, (std::vector<int>{4, 3, 2, 1}));
+}
+
 TEST(EngineTest, apiTest)
 {
     DiagnosticEngine diag;
@@ -5,6 +5,7 @@
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "ScopeManager.h"
@@ -123,4 +124,75 @@ TEST_F(SourceManagerTest, GetContentBetweenTest)
     code = sm.GetContentBetween(fileID1, Position(16, 9), Position(17, std::numeric_limits<int>::max()));
     EXPECT_EQ(code, "let a = 1\n        print(\"PageRankList${a}\\n\");\n");
 #endif
-}
\ No newline at end of file
+}
+TEST_F(SourceManagerTest, ReserveSourceTest)
+{
+    constexpr unsigned fileNum = 16;
+    std::vector<unsigned> ids;
+    for (unsigned i = 0; i < fileNum; ++i) {
+        ids.emplace_back(sm.ReserveSource("file" + std::to_string(i) + ".cj"));
+    }
+    // Ids follow the order of reservation, whatever order the contents are set in.
+    std::vector<std::thread> threads;
+    for (unsigned i = fileNum; i > 0; --i) {
+        threads.emplace_back([this, &ids, i]() { sm.SetBuffer(ids[i - 1], "let a" + std::to_string(i - 1) + "\n"); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (unsigned i = 0; i < fileNum; ++i) {
+        EXPECT_EQ(ids[i], i + 1);
+        auto& source = sm.GetSource(ids[i]);
+        EXPECT_EQ(source.buffer, "let a" + std::to_string(i) + "\n");
+        EXPECT_EQ(source.lineOffsets.size(), 2);
+    }
+    EXPECT_EQ(sm.ReserveSource("file0.cj"), ids[0]);
+}
+
+TEST_F(SourceManagerTest, LineTableTest)
+{
+    Source source(1, "a.cj", "ab\r\ncd\n\ne\rf");
+    EXPECT_EQ(source.lineOffsets, (std::vector<size_t>{0, 4, 7, 8}));
+    EXPECT_EQ(source.GetLineContentEnd(0), 2);
+    EXPECT_EQ(source.GetLineContentEnd(1), 6);
+    EXPECT_EQ(source.GetLineContentEnd(2), 7);
+    EXPECT_EQ(source.GetLineContentEnd(3), 11);
+
+    EXPECT_EQ(source.PosToOffset(Position(1, 2)), 1);
+    EXPECT_EQ(source.PosToOffset(Position(1, 3)), 2);
+    // A column past the end of a line points at the start of the next line.
+    EXPECT_EQ(source.PosToOffset(Position(1, 10)), 4);
+    EXPECT_EQ(source.PosToOffset(Position(3, 2)), 8);
+    EXPECT_EQ(source.PosToOffset(Position(4, 3)), 10);
+    EXPECT_EQ(source.PosToOffset(Position(4, 10)), 11);
+    EXPECT_EQ(source.PosToOffset(Position(5, 1)), 11);
+    EXPECT_EQ(source.PosToOffset(Position(0, 1)), 0);
+
+    auto end = source.GetEndPos();
+    EXPECT_EQ(end.line, 4);
+    EXPECT_EQ(end.column, 4);
+    end = Source(1, "b.cj", "ab\n").GetEndPos();
+    EXPECT_EQ(end.line, 2);
+    EXPECT_EQ(end.column, 1);
+    end = Source(1, "c.cj", "").GetEndPos();
+    EXPECT_EQ(end.line, 1);
+    EXPECT_EQ(end.column, 1);
+
+    auto fileID = sm.AddSource("d.cj", "ab\r\ncd\n\ne\rf");
+    EXPECT_EQ(sm.GetLineEnd(Position(fileID, 1, 1)), 2);
+    EXPECT_EQ(sm.GetLineEnd(Position(fileID, 3, 1)), 0);
+    EXPECT_EQ(sm.GetLineEnd(Position(fileID, 4, 1)), 3);
+    EXPECT_EQ(sm.GetLineEnd(Position(fileID, 5, 1)), 0);
+}
+TEST_F(SourceManagerTest, UnreserveSourceTest)
+{
+    auto readID = sm.ReserveSource("read.cj");
+    sm.SetBuffer(readID, "let a = 1\n");
+    auto failedID = sm.ReserveSource("failed.cj");
+    sm.UnreserveSource(failedID);
+    // The path of a source which could not be read is forgotten, its id is not reused.
+    EXPECT_EQ(sm.GetFileID(FileUtil::Normalize("failed.cj")), -1);
+    EXPECT_EQ(sm.GetFileID(FileUtil::Normalize("read.cj")), static_cast<int>(readID));
+    EXPECT_EQ(sm.ReserveSource("next.cj"), failedID + 1);
+    EXPECT_EQ(sm.GetSource(readID).buffer, "let a = 1\n");
+}
@@ -0,0 +1,267 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+/**
+ * @file
+ *
+ * Tests of the superinstructions fused by BCHIRLinker, and a microbenchmark of the BCHIR interpreter main loop.
+ * The benchmarks are disabled by default, run them with `--gtest_also_run_disabled_tests`. The dispatch mode is
+ * the one the interpreter was built with (see CANGJIE_BCHIR_SWITCH_DISPATCH).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+#include "cangjie/CHIR/Interpreter/BCHIRInterpreter.h"
+#include "cangjie/CHIR/Interpreter/BCHIRLinker.h"
+
+using namespace Cangjie;
+using namespace Cangjie::CHIR::Interpreter;
+
+namespace {
+constexpr int64_t LOOP_COUNT = 200000;
+constexpr int64_t FIELD_VALUE = 5;
+const std::string LOOP_FUNC_NAME = "bench_loop";
+
+using BodyEmitter = std::function<void(Bchir::Definition&)>;
+
+void EmitInt64(Bchir::Definition& def, int64_t value)
+{
+    def.Push(OpCode::INT64);
+    def.Push8bytes(static_cast<uint64_t>(value));
+}
+
+void EmitBinOp(Bchir::Definition& def, OpCode op)
+{
+    def.Push(op);
+    def.Push(static_cast<Bchir::ByteCodeContent>(CHIR::Type::TypeKind::TYPE_INT64));
+    def.Push(static_cast<Bchir::ByteCodeContent>(OverflowStrategy::WRAPPING));
+}
+
+/**
+ * Unlinked body of
+ * var i = 0; var sum = 0; let t = (7, FIELD_VALUE)
+ * while (i < LOOP_COUNT) { sum = sum + body; i = i + 1 }
+ * return sum
+ */
+Bchir::Definition EmitLoop(const BodyEmitter& body)
+{
+    const Bchir::VarIdx iVar = 0;
+    const Bchir::VarIdx sumVar = 1;
+    const Bchir::VarIdx tupleVar = 2;
+    Bchir::Definition def;
+    def.SetNumLVars(Bchir::FLAG_THREE);
+    EmitInt64(def, 0);
+    def.Push(OpCode::LVAR_SET);
+    def.Push(iVar);
+    EmitInt64(def, 0);
+    def.Push(OpCode::LVAR_SET);
+    def.Push(sumVar);
+    EmitInt64(def, 7);
+    EmitInt64(def, FIELD_VALUE);
+    def.Push(OpCode::TUPLE);
+    def.Push(Bchir::FLAG_TWO);
+    def.Push(OpCode::LVAR_SET);
+    def.Push(tupleVar);
+
+    auto loopHead = def.NextIndex();
+    def.Push(OpCode::LVAR);
+    def.Push(iVar);
+    EmitInt64(def, LOOP_COUNT);
+    EmitBinOp(def, OpCode::BIN_LT);
+    auto branch = def.NextIndex();
+    def.Push(OpCode::BRANCH);
+    def.Push(Bchir::DUMMY);
+    def.Push(Bchir::DUMMY);
+    def.Set(branch + 1, def.NextIndex());
+
+    def.Push(OpCode::LVAR);
+    def.Push(sumVar);
+    body(def);
+    EmitBinOp(def, OpCode::BIN_ADD);
+    def.Push(OpCode::LVAR_SET);
+    def.Push(sumVar);
+    def.Push(OpCode::LVAR);
+    def.Push(iVar);
+    EmitInt64(def, 1);
+    EmitBinOp(def, OpCode::BIN_ADD);
+    def.Push(OpCode::LVAR_SET);
+    def.Push(iVar);
+    def.Push(OpCode::JUMP);
+    def.Push(loopHead);
+
+    def.Set(branch + Bchir::FLAG_TWO, def.NextIndex());
+    def.Push(OpCode::LVAR);
+    def.Push(sumVar);
+    def.Push(OpCode::EXIT);
+    return def;
+}
+
+void EmitConstBody(Bchir::Definition& def)
+{
+    EmitInt64(def, 1);
+}
+
+void EmitTupleFieldBody(Bchir::Definition& def)
+{
+    def.Push(OpCode::LVAR);
+    def.Push(2); // the tuple
+    def.Push(OpCode::FIELD);
+    def.Push(1);
+}
+
+/** The operation a superinstruction was fused from, or `op` itself. */
+OpCode GetUnfusedOp(OpCode op)
+{
+    switch (op) {
+        case OpCode::LVAR_FIELD:
+            return OpCode::LVAR;
+        case OpCode::BIN_LT_BRANCH:
+            return OpCode::BIN_LT;
+        case OpCode::BIN_GT_BRANCH:
+            return OpCode::BIN_GT;
+        case OpCode::BIN_LE_BRANCH:
+            return OpCode::BIN_LE;
+        case OpCode::BIN_GE_BRANCH:
+            return OpCode::BIN_GE;
+        case OpCode::BIN_NOTEQ_BRANCH:
+            return OpCode::BIN_NOTEQ;
+        case OpCode::BIN_EQUAL_BRANCH:
+            return OpCode::BIN_EQUAL;
+        default:
+            return op;
+    }
+}
+
+/** A loop function linked by BCHIRLinker into its own top-level bytecode. */
+class LinkedLoop {
+public:
+    explicit LinkedLoop(const BodyEmitter& body)
+    {
+        std::vector<Bchir> packages(1);
+        packages[0].AddFunction(LOOP_FUNC_NAME, EmitLoop(body));
+        GlobalOptions opts;
+        BCHIRLinker linker(top);
+        (void)linker.Run(packages, opts);
+        for (auto& [idx, name] : top.GetLinkedByteCode().GetMangledNamesAnnotations()) {
+            if (name == LOOP_FUNC_NAME && static_cast<OpCode>(top.Get(idx)) == OpCode::FRAME) {
+                entry = idx;
+            }
+        }
+    }
+
+    /** The operations of the linked function, in order. */
+    std::vector<OpCode> GetOps() const
+    {
+        std::vector<OpCode> ops;
+        auto idx = entry;
+        while (true) {
+            auto op = static_cast<OpCode>(top.Get(idx));
+            ops.emplace_back(op);
+            if (op == OpCode::EXIT) {
+                return ops;
+            }
+            idx += GetOpCodeArgSize(op) + 1;
+        }
+    }
+
+    /** Turn the superinstructions back into their first operation, for comparing the interpreter without them. */
+    void Unfuse()
+    {
+        auto idx = entry;
+        while (true) {
+            auto op = static_cast<OpCode>(top.Get(idx));
+            if (op == OpCode::EXIT) {
+                return;
+            }
+            top.SetOp(idx, GetUnfusedOp(op));
+            idx += GetOpCodeArgSize(op) + 1;
+        }
+    }
+
+    int64_t Run(const std::string& name, bool report)
+    {
+        DiagnosticEngine diag;
+        std::unordered_map<std::string, void*> dyHandles;
+        BCHIRInterpreter interpreter(top, diag, dyHandles, 0, 0);
+        auto start = std::chrono::steady_clock::now();
+        auto res = interpreter.Run(entry);
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (report) {
+            std::cout << "[BCHIR bench] " << name << ": " << elapsed / static_cast<double>(LOOP_COUNT)
+                      << " ns/iteration" << std::endl;
+        }
+        auto success = std::get_if<ISuccess>(&res);
+        EXPECT_NE(success, nullptr);
+        if (success == nullptr) {
+            return 0;
+        }
+        return IValUtils::Get<IInt64>(success->val).content;
+    }
+
+private:
+    Bchir top;
+    Bchir::ByteCodeIndex entry{0};
+};
+
+bool Contains(const std::vector<OpCode>& ops, OpCode op)
+{
+    return std::find(ops.begin(), ops.end(), op) != ops.end();
+}
+
+void Bench(const std::string& name, const BodyEmitter& body, int64_t expected)
+{
+    LinkedLoop fused(body);
+    EXPECT_EQ(fused.Run(name + " (superinstructions)", true), expected);
+    LinkedLoop plain(body);
+    plain.Unfuse();
+    EXPECT_EQ(plain.Run(name + " (plain)", true), expected);
+}
+} // namespace
+
+TEST(BCHIRLinkerTest, FusesCompareAndBranch)
+{
+    LinkedLoop loop(EmitConstBody);
+    auto ops = loop.GetOps();
+    EXPECT_TRUE(Contains(ops, OpCode::BIN_LT_BRANCH));
+    EXPECT_FALSE(Contains(ops, OpCode::BIN_LT));
+    // The second operation stays in place, so the branch targets are linked as usual.
+    EXPECT_TRUE(Contains(ops, OpCode::BRANCH));
+    EXPECT_EQ(loop.Run("counted loop", false), LOOP_COUNT);
+}
+
+TEST(BCHIRLinkerTest, FusesLocalVarAndField)
+{
+    LinkedLoop loop(EmitTupleFieldBody);
+    auto ops = loop.GetOps();
+    EXPECT_TRUE(Contains(ops, OpCode::LVAR_FIELD));
+    EXPECT_TRUE(Contains(ops, OpCode::FIELD));
+    EXPECT_EQ(loop.Run("tuple field loop", false), LOOP_COUNT * FIELD_VALUE);
+}
+
+TEST(BCHIRLinkerTest, UnfusedCodeRunsTheSame)
+{
+    LinkedLoop loop(EmitTupleFieldBody);
+    loop.Unfuse();
+    auto ops = loop.GetOps();
+    EXPECT_FALSE(Contains(ops, OpCode::LVAR_FIELD));
+    EXPECT_FALSE(Contains(ops, OpCode::BIN_LT_BRANCH));
+    EXPECT_EQ(loop.Run("tuple field loop", false), LOOP_COUNT * FIELD_VALUE);
+}
+
+TEST(BCHIRInterpreterBench, DISABLED_CompareAndBranchLoop)
+{
+    Bench("counted loop", EmitConstBody, LOOP_COUNT);
+}
+
+TEST(BCHIRInterpreterBench, DISABLED_LocalTupleFieldLoop)
+{
+    Bench("tuple field loop", EmitTupleFieldBody, LOOP_COUNT * FIELD_VALUE);
+}
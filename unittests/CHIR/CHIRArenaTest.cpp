@@ -0,0 +1,116 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cangjie/CHIR/CHIRArena.h"
+
+using namespace Cangjie::CHIR;
+
+namespace {
+/** A node whose destructor logs its id. */
+struct LoggedNode {
+    LoggedNode(std::vector<int>& log, int id) : log(log), id(id)
+    {
+    }
+    ~LoggedNode()
+    {
+        log.push_back(id);
+    }
+    std::vector<int>& log;
+    int id;
+};
+
+/** A node whose destructor counts how many times it runs. */
+struct CountedNode {
+    explicit CountedNode(std::atomic<int>& count) : count(count)
+    {
+    }
+    ~CountedNode()
+    {
+        ++count;
+    }
+    std::atomic<int>& count;
+};
+
+/** Construct a node in @p arena the way CHIRBuilder does. */
+template <typename T, typename... Args> T* NewNode(CHIRArena& arena, Args&&... args)
+{
+    T* node = new (arena.Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    arena.AddFinalizer(node, [](void* ptr) { static_cast<T*>(ptr)->~T(); });
+    return node;
+}
+} // namespace
+
+TEST(CHIRArenaTest, AllocationsAreAligned)
+{
+    CHIRArena arena;
+    for (size_t size : {1, 3, 17, 100, 1024 * 1024}) {
+        auto ptr = reinterpret_cast<std::uintptr_t>(arena.Allocate(size));
+        EXPECT_EQ(ptr % alignof(std::max_align_t), 0);
+    }
+    EXPECT_EQ(arena.GetNodesNum(), 5);
+}
+
+TEST(CHIRArenaTest, FinalizersRunInMergeOrder)
+{
+    std::vector<int> log;
+    CHIRArena arena;
+    CHIRArena sub1;
+    CHIRArena sub2;
+    (void)NewNode<LoggedNode>(arena, log, 0);
+    (void)NewNode<LoggedNode>(sub2, log, 3);
+    (void)NewNode<LoggedNode>(sub1, log, 1);
+    (void)NewNode<LoggedNode>(sub1, log, 2);
+    // The nodes of the sub arenas follow the ones of the arena in the order the sub arenas are merged, whatever the
+    // order the nodes were created in.
+    arena.Merge(sub1);
+    arena.Merge(sub2);
+    EXPECT_EQ(arena.GetNodesNum(), 4);
+    EXPECT_EQ(sub1.GetNodesNum(), 0);
+    EXPECT_EQ(sub2.GetNodesNum(), 0);
+    // A merged arena is empty and may be used again.
+    (void)NewNode<LoggedNode>(sub1, log, 4);
+    arena.Merge(sub1);
+    EXPECT_TRUE(log.empty());
+    arena.Release();
+    EXPECT_EQ(log, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(arena.GetNodesNum(), 0);
+}
+
+TEST(CHIRArenaTest, DestructorReleasesNodes)
+{
+    std::vector<int> log;
+    {
+        CHIRArena arena;
+        (void)NewNode<LoggedNode>(arena, log, 0);
+        (void)NewNode<LoggedNode>(arena, log, 1);
+    }
+    EXPECT_EQ(log, (std::vector<int>{0, 1}));
+}
+
+TEST(CHIRArenaTest, ParallelReleaseRunsEachFinalizerOnce)
+{
+    // Enough nodes for the finalizers to be split across threads.
+    constexpr size_t nodeNum = 50000;
+    std::vector<std::atomic<int>> counts(nodeNum);
+    CHIRArena arena;
+    for (auto& count : counts) {
+        (void)NewNode<CountedNode>(arena, count);
+    }
+    arena.Release(4);
+    for (auto& count : counts) {
+        ASSERT_EQ(count.load(), 1);
+    }
+    EXPECT_EQ(arena.GetNodesNum(), 0);
+    // Releasing an empty arena does nothing.
+    arena.Release(4);
+    EXPECT_EQ(counts[0].load(), 1);
+}
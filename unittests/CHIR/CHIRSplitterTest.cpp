@@ -0,0 +1,205 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "CGPkgContext.h"
+#include "CJNative/CHIRSplitter.h"
+#include "cangjie/CHIR/CHIRBuilder.h"
+#include "cangjie/CHIR/CHIRContext.h"
+#include "cangjie/CHIR/Expression/Terminator.h"
+#include "cangjie/CHIR/Package.h"
+#include "cangjie/Frontend/CompilerInstance.h"
+
+using namespace Cangjie;
+using namespace Cangjie::CHIR;
+using namespace Cangjie::CodeGen;
+
+namespace {
+class CHIRSplitterTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        package = builder.CreatePackage("test");
+        chirData.AppendNewPackage(package);
+    }
+
+    Func* CreateFunc(const std::string& name)
+    {
+        auto ty = builder.GetType<FuncType>(std::vector<Type*>{}, builder.GetUnitTy());
+        auto func = builder.CreateFunc(INVALID_LOCATION, ty, name, name, "", "test");
+        body = builder.CreateBlockGroup(*func);
+        func->InitBody(*body);
+        return func;
+    }
+
+    Block* AddBlock()
+    {
+        auto block = builder.CreateBlock(body);
+        if (body->GetEntryBlock() == nullptr) {
+            body->SetEntryBlock(block);
+        }
+        return block;
+    }
+
+    void AddConstants(Block* block, size_t num)
+    {
+        for (size_t i = 0; i < num; ++i) {
+            block->AppendExpression(builder.CreateConstantExpression<BoolLiteral>(builder.GetBoolTy(), block, true));
+        }
+    }
+
+    void AddGoTo(Block* from, Block* to)
+    {
+        from->AppendExpression(builder.CreateTerminator<GoTo>(to, from));
+    }
+
+    void AddBranch(Block* from, Block* trueBlock, Block* falseBlock)
+    {
+        auto cond = builder.CreateConstantExpression<BoolLiteral>(builder.GetBoolTy(), from, true);
+        from->AppendExpression(cond);
+        from->AppendExpression(builder.CreateTerminator<Branch>(cond->GetResult(), trueBlock, falseBlock, from));
+    }
+
+    void AddExit(Block* block)
+    {
+        block->AppendExpression(builder.CreateTerminator<Exit>(block));
+    }
+
+    /** Create a function of a single block, whose estimated cost is @p cost. */
+    Func* CreateFuncOfCost(const std::string& name, size_t cost)
+    {
+        auto func = CreateFunc(name);
+        auto entry = AddBlock();
+        AddConstants(entry, cost - 1);
+        AddExit(entry);
+        return func;
+    }
+
+    /** Create the init functions of the package, which are always there and are put into the main module. */
+    void CreateInitFuncs()
+    {
+        // The literal init function is found by the name of the package init function.
+        package->SetPackageInitFunc(CreateFuncOfCost("_CN4test6<init>iiHv", 1));
+        package->SetPackageLiteralInitFunc(CreateFuncOfCost("_CN4test6<init>ilHv", 1));
+    }
+
+    std::vector<SubCHIRPackage> Split(size_t jobs)
+    {
+        options.aggressiveParallelCompile = jobs;
+        CGPkgContext cgPkgCtx(builder, chirData, options, false, cachedMangleMap);
+        return CHIRSplitter(cgPkgCtx).SplitCHIRPackage();
+    }
+
+    CHIRData chirData;
+    CHIRBuilder builder{chirData.GetCHIRContext()};
+    GlobalOptions options;
+    CachedMangleMap cachedMangleMap;
+    Package* package{nullptr};
+    BlockGroup* body{nullptr};
+};
+} // namespace
+
+TEST_F(CHIRSplitterTest, CostOfStraightLineCode)
+{
+    auto ty = builder.GetType<FuncType>(std::vector<Type*>{}, builder.GetUnitTy());
+    auto callee = builder.CreateFunc(INVALID_LOCATION, ty, "callee", "callee", "", "test");
+    CreateFunc("caller");
+    auto entry = AddBlock();
+    AddConstants(entry, 10);
+    entry->AppendExpression(builder.CreateExpression<Apply>(builder.GetUnitTy(), callee, FuncCallContext{}, entry));
+    AddExit(entry);
+    // An expression costs one unit and a call three.
+    EXPECT_EQ(CHIRSplitter::EstimateCodeGenCost(*body), 14);
+}
+
+TEST_F(CHIRSplitterTest, CostGrowsWithLoopDepth)
+{
+    // entry -> header1 -> ... -> header5, every header leaves its loop through the latch of the enclosing loop.
+    constexpr size_t maxDepth = 5;
+    constexpr size_t headerSize = 10;
+    CreateFunc("loops");
+    auto entry = AddBlock();
+    auto exit = AddBlock();
+    std::vector<Block*> headers{entry};
+    std::vector<Block*> latches{exit};
+    for (size_t depth = 1; depth <= maxDepth; ++depth) {
+        headers.emplace_back(AddBlock());
+        latches.emplace_back(AddBlock());
+    }
+    AddGoTo(entry, headers[1]);
+    for (size_t depth = 1; depth <= maxDepth; ++depth) {
+        AddConstants(headers[depth], headerSize);
+        AddBranch(headers[depth], depth < maxDepth ? headers[depth + 1] : latches[depth], latches[depth - 1]);
+        AddGoTo(latches[depth], headers[depth]);
+    }
+    AddExit(exit);
+    // The entry and the exit cost one unit each. A header and its latch cost the constants, the condition, the
+    // branch and the goto, doubled for each level of loop nesting up to 3.
+    size_t expected = 2;
+    for (size_t depth = 1; depth <= maxDepth; ++depth) {
+        expected += (headerSize + 3) << std::min(depth, static_cast<size_t>(3));
+    }
+    EXPECT_EQ(CHIRSplitter::EstimateCodeGenCost(*body), expected);
+}
+
+TEST_F(CHIRSplitterTest, CostOfIrreducibleLoop)
+{
+    // The loop of left and right has two entries, the entry block is not part of it.
+    CreateFunc("irreducible");
+    auto entry = AddBlock();
+    auto left = AddBlock();
+    auto right = AddBlock();
+    auto exit = AddBlock();
+    AddConstants(entry, 10);
+    AddBranch(entry, left, right);
+    AddBranch(left, right, exit);
+    AddGoTo(right, left);
+    AddExit(exit);
+    // 12 for the entry, 2 * 2 for left and 1 * 2 for right in the loop, and 1 for the exit.
+    EXPECT_EQ(CHIRSplitter::EstimateCodeGenCost(*body), 19);
+}
+
+TEST_F(CHIRSplitterTest, SplitBalancesEstimatedCost)
+{
+    CreateInitFuncs();
+    auto large = CreateFuncOfCost("large", 8000);
+    for (size_t i = 0; i < 4; ++i) {
+        CreateFuncOfCost("small" + std::to_string(i), 2000);
+    }
+    auto subCHIRPackages = Split(2);
+    ASSERT_EQ(subCHIRPackages.size(), 2);
+    // The large function is as costly as the four small ones, so it is alone in its SubCHIRPackage.
+    auto& withLarge = subCHIRPackages[0].chirFuncs.count(large) != 0 ? subCHIRPackages[0] : subCHIRPackages[1];
+    auto& others = &withLarge == &subCHIRPackages[0] ? subCHIRPackages[1] : subCHIRPackages[0];
+    EXPECT_EQ(withLarge.chirFuncs.size(), 1);
+    EXPECT_EQ(withLarge.estimatedCost, 8000);
+    EXPECT_TRUE(others.mainModule);
+    EXPECT_EQ(others.chirFuncs.size(), 6);
+    EXPECT_EQ(others.estimatedCost, 8002);
+}
+
+TEST_F(CHIRSplitterTest, SmallPackageIsNotSplit)
+{
+    CreateInitFuncs();
+    for (size_t i = 0; i < 8; ++i) {
+        CreateFuncOfCost("func" + std::to_string(i), 200);
+    }
+    // A SubCHIRPackage costs at least 2000, the package is split into fewer ones than the jobs.
+    EXPECT_EQ(Split(8).size(), 1);
+    for (size_t i = 0; i < 8; ++i) {
+        CreateFuncOfCost("more" + std::to_string(i), 1000);
+    }
+    auto subCHIRPackages = Split(8);
+    ASSERT_EQ(subCHIRPackages.size(), 4);
+    for (auto& subCHIRPackage : subCHIRPackages) {
+        EXPECT_GE(subCHIRPackage.estimatedCost, 2000);
+    }
+}
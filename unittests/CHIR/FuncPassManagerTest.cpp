@@ -0,0 +1,134 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cangjie/CHIR/CHIRBuilder.h"
+#include "cangjie/CHIR/CHIRContext.h"
+#include "cangjie/CHIR/Expression/Terminator.h"
+#include "cangjie/CHIR/Package.h"
+#include "cangjie/CHIR/Transformation/FuncPassManager.h"
+
+using namespace Cangjie;
+using namespace Cangjie::CHIR;
+
+namespace {
+constexpr size_t FUNC_NUM = 16;
+constexpr size_t THREAD_NUM = 4;
+
+/** A package of functions which only exit, with its own context so that two runs do not share any node. */
+struct TestPackage {
+    TestPackage()
+    {
+        // Owned and freed by the context.
+        package = builder.CreatePackage("test");
+        for (size_t i = 0; i < FUNC_NUM; ++i) {
+            auto name = "f" + std::to_string(i);
+            auto ty = builder.GetType<FuncType>(std::vector<Type*>{}, builder.GetUnitTy());
+            auto func = builder.CreateFunc(INVALID_LOCATION, ty, name, name, "", "test");
+            auto body = builder.CreateBlockGroup(*func);
+            func->InitBody(*body);
+            auto entry = builder.CreateBlock(body);
+            body->SetEntryBlock(entry);
+            entry->AppendExpression(builder.CreateTerminator<Exit>(entry));
+        }
+    }
+
+    /** Run a pass which adds @p num constants to the head of every function, with @p threadNum threads. */
+    void RunAddConstants(size_t threadNum, size_t num)
+    {
+        FuncPassManager manager(builder, threadNum);
+        manager.AddPass([num](Func& func, CHIRBuilder& subBuilder) {
+            auto entry = func.GetBody()->GetEntryBlock();
+            for (size_t i = 0; i < num; ++i) {
+                auto constant = subBuilder.CreateConstantExpression<BoolLiteral>(subBuilder.GetBoolTy(), entry, true);
+                entry->InsertExprIntoHead(*constant);
+            }
+        });
+        manager.Run(*package);
+    }
+
+    std::vector<std::string> Dump() const
+    {
+        std::vector<std::string> funcs;
+        for (auto func : package->GetGlobalFuncs()) {
+            funcs.emplace_back(func->ToString());
+        }
+        return funcs;
+    }
+
+    CHIRContext context;
+    CHIRBuilder builder{context};
+    Package* package{nullptr};
+};
+} // namespace
+
+TEST(FuncPassManagerTest, PassesRunInOrderOnEachFunction)
+{
+    TestPackage pkg;
+    std::mutex mtx;
+    std::vector<std::pair<std::string, size_t>> log; // Function name and pass index.
+    std::set<CHIRBuilder*> subBuilders;
+    FuncPassManager manager(pkg.builder, THREAD_NUM);
+    for (size_t idx = 0; idx < 2; ++idx) {
+        manager.AddPass([&, idx](Func& func, CHIRBuilder& subBuilder) {
+            std::lock_guard<std::mutex> lock(mtx);
+            log.emplace_back(func.GetSrcCodeIdentifier(), idx);
+            (void)subBuilders.emplace(&subBuilder);
+        });
+    }
+    manager.Run(*pkg.package);
+    ASSERT_EQ(log.size(), FUNC_NUM * 2);
+    // The functions are interleaved, but the passes of a function run in the order they were added.
+    for (size_t i = 0; i < FUNC_NUM; ++i) {
+        auto name = "f" + std::to_string(i);
+        auto first = std::find(log.begin(), log.end(), std::make_pair(name, size_t{0}));
+        auto second = std::find(log.begin(), log.end(), std::make_pair(name, size_t{1}));
+        ASSERT_NE(first, log.end());
+        ASSERT_NE(second, log.end());
+        EXPECT_LT(first, second);
+    }
+    // Each function has its own sub builder, which is not the builder of the package.
+    EXPECT_EQ(subBuilders.size(), FUNC_NUM);
+    EXPECT_EQ(subBuilders.count(&pkg.builder), 0);
+}
+
+TEST(FuncPassManagerTest, SerialRunUsesPackageBuilder)
+{
+    TestPackage pkg;
+    std::set<CHIRBuilder*> builders;
+    FuncPassManager manager(pkg.builder, 1);
+    manager.AddPass([&builders](Func&, CHIRBuilder& builder) { (void)builders.emplace(&builder); });
+    manager.Run(*pkg.package);
+    ASSERT_EQ(builders.size(), 1);
+    EXPECT_EQ(*builders.begin(), &pkg.builder);
+}
+
+TEST(FuncPassManagerTest, SubBuildersAreMergedLikeSerialRun)
+{
+    TestPackage serial;
+    TestPackage parallel;
+    auto nodesBefore = serial.context.GetAllNodesNum();
+    ASSERT_EQ(parallel.context.GetAllNodesNum(), nodesBefore);
+    serial.RunAddConstants(1, 3);
+    parallel.RunAddConstants(THREAD_NUM, 3);
+    // The nodes of the sub builders are owned by the context once the run is done, and the IR does not depend on
+    // the number of threads.
+    EXPECT_GT(serial.context.GetAllNodesNum(), nodesBefore);
+    EXPECT_EQ(parallel.context.GetAllNodesNum(), serial.context.GetAllNodesNum());
+    EXPECT_EQ(parallel.Dump(), serial.Dump());
+    // A second run merges again, into the same context.
+    serial.RunAddConstants(1, 1);
+    parallel.RunAddConstants(THREAD_NUM, 1);
+    EXPECT_EQ(parallel.context.GetAllNodesNum(), serial.context.GetAllNodesNum());
+    EXPECT_EQ(parallel.Dump(), serial.Dump());
+}
@@ -0,0 +1,269 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cangjie/CHIR/CHIRBuilder.h"
+#include "cangjie/CHIR/CHIRContext.h"
+#include "cangjie/CHIR/Expression/Terminator.h"
+#include "cangjie/CHIR/Package.h"
+#include "cangjie/CHIR/Transformation/FunctionInline.h"
+#include "cangjie/Utils/FileUtil.h"
+
+using namespace Cangjie;
+using namespace Cangjie::CHIR;
+
+namespace {
+/// What the inliner decided for one call site.
+struct Decision {
+    size_t threshold;
+    size_t loopDepth;
+};
+
+class FunctionInlineTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        // Owned and freed by the context.
+        (void)builder.CreatePackage("test");
+        caller = CreateFunc("caller");
+        body = builder.CreateBlockGroup(*caller);
+        caller->InitBody(*body);
+    }
+    void TearDown() override
+    {
+        (void)FileUtil::RemoveDirectoryRecursively(dir);
+    }
+
+    Func* CreateFunc(const std::string& name)
+    {
+        auto ty = builder.GetType<FuncType>(std::vector<Type*>{}, builder.GetUnitTy());
+        return builder.CreateFunc(INVALID_LOCATION, ty, name, name, "", "test");
+    }
+
+    Block* AddBlock()
+    {
+        auto block = builder.CreateBlock(body);
+        if (body->GetEntryBlock() == nullptr) {
+            body->SetEntryBlock(block);
+        }
+        return block;
+    }
+
+    /** Call a new function @p callee in @p block, the callee is too large to be inlined at any threshold. */
+    void AddCall(Block* block, const std::string& callee)
+    {
+        auto func = CreateFunc(callee);
+        auto group = builder.CreateBlockGroup(*func);
+        func->InitBody(*group);
+        auto entry = builder.CreateBlock(group);
+        group->SetEntryBlock(entry);
+        constexpr size_t calleeSize = 64;
+        for (size_t i = 0; i < calleeSize; ++i) {
+            entry->AppendExpression(builder.CreateConstantExpression<BoolLiteral>(builder.GetBoolTy(), entry, true));
+        }
+        entry->AppendExpression(builder.CreateTerminator<Exit>(entry));
+        block->AppendExpression(builder.CreateExpression<Apply>(builder.GetUnitTy(), func, FuncCallContext{}, block));
+    }
+
+    void AddGoTo(Block* from, Block* to)
+    {
+        from->AppendExpression(builder.CreateTerminator<GoTo>(to, from));
+    }
+
+    void AddBranch(Block* from, Block* trueBlock, Block* falseBlock)
+    {
+        auto cond = builder.CreateConstantExpression<BoolLiteral>(builder.GetBoolTy(), from, true);
+        from->AppendExpression(cond);
+        from->AppendExpression(builder.CreateTerminator<Branch>(cond->GetResult(), trueBlock, falseBlock, from));
+    }
+
+    void AddExit(Block* block)
+    {
+        block->AppendExpression(builder.CreateTerminator<Exit>(block));
+    }
+
+    /**
+     * Build loops nested 5 deep in the caller, which calls `depth<n>` in the header of the loop of depth n and
+     * `depth0` before the loops.
+     */
+    void BuildNestedLoops()
+    {
+        constexpr size_t maxDepth = 5;
+        auto entry = AddBlock();
+        auto exit = AddBlock();
+        std::vector<Block*> headers{entry};
+        std::vector<Block*> latches{exit};
+        for (size_t depth = 1; depth <= maxDepth; ++depth) {
+            headers.emplace_back(AddBlock());
+            latches.emplace_back(AddBlock());
+        }
+        AddCall(entry, "depth0");
+        AddGoTo(entry, headers[1]);
+        for (size_t depth = 1; depth <= maxDepth; ++depth) {
+            AddCall(headers[depth], "depth" + std::to_string(depth));
+            // Enter the next loop, or leave this one through the latch of the enclosing loop.
+            AddBranch(headers[depth], depth < maxDepth ? headers[depth + 1] : latches[depth], latches[depth - 1]);
+            AddGoTo(latches[depth], headers[depth]);
+        }
+        AddExit(exit);
+    }
+
+    /** Run the inliner on the caller and return its decisions by callee, from the remarks. */
+    std::map<std::string, Decision> RunInline(
+        GlobalOptions::OptimizationLevel level = GlobalOptions::OptimizationLevel::O2,
+        const InlineProfile* profile = nullptr)
+    {
+        std::ostringstream remarks;
+        FunctionInline pass(builder, level, false);
+        pass.SetProfile(profile);
+        pass.SetRemarkStream(&remarks);
+        pass.Run(*caller);
+        std::map<std::string, Decision> decisions;
+        std::regex remark(R"re("callee":"(\w+)".*"threshold":(\d+),"loopDepth":(\d+))re");
+        std::istringstream lines(remarks.str());
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::smatch match;
+            if (std::regex_search(line, match, remark)) {
+                decisions[match[1]] = {std::stoul(match[2]), std::stoul(match[3])};
+            }
+        }
+        return decisions;
+    }
+
+    InlineProfile LoadProfile(const std::string& content)
+    {
+        auto path = FileUtil::JoinPath(dir, "inline.profile");
+        EXPECT_TRUE(FileUtil::WriteToFile(path, content));
+        InlineProfile profile;
+        EXPECT_TRUE(profile.Load(path));
+        return profile;
+    }
+
+    std::string dir = "testTempFiles/FunctionInline";
+    CHIRContext context;
+    CHIRBuilder builder{context};
+    Func* caller{nullptr};
+    BlockGroup* body{nullptr};
+};
+} // namespace
+
+TEST_F(FunctionInlineTest, LoopDepthOfNestedLoops)
+{
+    // entry -> outer <-> inner <-> innerBody, inner -> latch -> outer, outer -> exit
+    auto entry = AddBlock();
+    auto outer = AddBlock();
+    auto inner = AddBlock();
+    auto innerBody = AddBlock();
+    auto latch = AddBlock();
+    auto exit = AddBlock();
+    AddCall(entry, "entry");
+    AddGoTo(entry, outer);
+    AddCall(outer, "outer");
+    AddBranch(outer, inner, exit);
+    AddCall(inner, "inner");
+    AddBranch(inner, innerBody, latch);
+    AddCall(innerBody, "innerBody");
+    AddGoTo(innerBody, inner);
+    AddCall(latch, "latch");
+    AddGoTo(latch, outer);
+    AddCall(exit, "exit");
+    AddExit(exit);
+    auto decisions = RunInline();
+    EXPECT_EQ(decisions["entry"].loopDepth, 0);
+    EXPECT_EQ(decisions["outer"].loopDepth, 1);
+    EXPECT_EQ(decisions["inner"].loopDepth, 2);
+    EXPECT_EQ(decisions["innerBody"].loopDepth, 2);
+    EXPECT_EQ(decisions["latch"].loopDepth, 1);
+    EXPECT_EQ(decisions["exit"].loopDepth, 0);
+}
+
+TEST_F(FunctionInlineTest, LoopDepthOfIrreducibleLoop)
+{
+    // The loop of left and right has two entries, neither of them dominates the other.
+    auto entry = AddBlock();
+    auto left = AddBlock();
+    auto right = AddBlock();
+    auto exit = AddBlock();
+    AddCall(entry, "entry");
+    AddBranch(entry, left, right);
+    AddCall(left, "left");
+    AddBranch(left, right, exit);
+    AddCall(right, "right");
+    AddGoTo(right, left);
+    AddCall(exit, "exit");
+    AddExit(exit);
+    auto decisions = RunInline();
+    EXPECT_EQ(decisions["entry"].loopDepth, 0);
+    EXPECT_EQ(decisions["left"].loopDepth, 1);
+    EXPECT_EQ(decisions["right"].loopDepth, 1);
+    EXPECT_EQ(decisions["exit"].loopDepth, 0);
+}
+
+TEST_F(FunctionInlineTest, ThresholdGrowsWithLoopDepth)
+{
+    BuildNestedLoops();
+    auto decisions = RunInline();
+    // 20% more per loop level on top of the base threshold of 24, for at most 3 levels.
+    std::vector<size_t> expected{24, 28, 32, 36, 36, 36};
+    for (size_t depth = 0; depth < expected.size(); ++depth) {
+        auto& decision = decisions["depth" + std::to_string(depth)];
+        EXPECT_EQ(decision.loopDepth, depth);
+        EXPECT_EQ(decision.threshold, expected[depth]) << depth;
+    }
+    // Loops do not raise the threshold when optimizing for size.
+    decisions = RunInline(GlobalOptions::OptimizationLevel::Os);
+    EXPECT_EQ(decisions["depth5"].threshold, 24);
+}
+
+TEST_F(FunctionInlineTest, ThresholdFollowsProfile)
+{
+    BuildNestedLoops();
+    // Call sites with at least 1% of the hottest count are hot.
+    auto profile = LoadProfile("caller depth0 10000\n"
+                               "caller depth1 0\n"
+                               "caller depth2 99\n"
+                               "caller depth3 100\n"
+                               "caller depth5 1\n");
+    auto decisions = RunInline(GlobalOptions::OptimizationLevel::O2, &profile);
+    // A hot call site doubles its threshold, but not beyond the largest callee size which is counted.
+    EXPECT_EQ(decisions["depth0"].threshold, 48);
+    EXPECT_EQ(decisions["depth3"].threshold, 59);
+    // A cold call site is capped at half the base threshold, even in a loop.
+    EXPECT_EQ(decisions["depth1"].threshold, 10);
+    // Warm call sites and call sites missing from the profile keep their threshold.
+    EXPECT_EQ(decisions["depth2"].threshold, 32);
+    EXPECT_EQ(decisions["depth4"].threshold, 36);
+    EXPECT_EQ(decisions["depth5"].threshold, 36);
+}
+
+TEST_F(FunctionInlineTest, ProfileSkipsMalformedLines)
+{
+    auto profile = LoadProfile("# caller callee count\n"
+                               "\n"
+                               "a b 10\n"
+                               "a b 5\n"
+                               "a c\n"
+                               "a d -3\n"
+                               "a e 7x\n"
+                               "a f 8 9\n"
+                               "a g 99999999999999999999\n"
+                               "a h 42\n");
+    EXPECT_EQ(profile.GetCount("a", "b"), 15);
+    EXPECT_EQ(profile.GetCount("a", "h"), 42);
+    for (auto callee : {"c", "d", "e", "f", "g", "missing"}) {
+        EXPECT_FALSE(profile.GetCount("a", callee).has_value()) << callee;
+    }
+    EXPECT_EQ(profile.GetMaxCount(), 42);
+    InlineProfile missing;
+    EXPECT_FALSE(missing.Load(FileUtil::JoinPath(dir, "missing.profile")));
+}
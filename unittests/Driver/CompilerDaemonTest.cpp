@@ -0,0 +1,121 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include "gtest/gtest.h"
+
+#ifndef _WIN32
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "cangjie/Driver/CompilerDaemon.h"
+#include "cangjie/Utils/FileUtil.h"
+
+using namespace Cangjie;
+
+namespace {
+const int MISMATCH_EXIT_CODE = 99;
+const int CONNECT_RETRIES = 500;
+const std::string TEST_ENV_NAME = "CJC_DAEMON_TEST";
+
+/// Exit with the code given as the last argument if the request arrived as it was sent.
+int CheckAndExit(const CompileRequest& request)
+{
+    char cwd[PATH_MAX] = {};
+    if (getcwd(cwd, sizeof(cwd)) == nullptr || FileUtil::GetAbsPath(request.workingDirectory) != std::string(cwd)) {
+        return MISMATCH_EXIT_CODE;
+    }
+    auto value = getenv(TEST_ENV_NAME.c_str());
+    if (value == nullptr || std::string(value) != "1" || request.exePath != "/opt/cangjie/bin/cjc") {
+        return MISMATCH_EXIT_CODE;
+    }
+    return std::stoi(request.args.back());
+}
+
+class CompilerDaemonTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        workDir = FileUtil::GetAbsPath(".").value_or(".");
+        socketPath = "/tmp/cjc-daemon-test-" + std::to_string(getpid()) + ".sock";
+        daemonPid = fork();
+        if (daemonPid == 0) {
+            CompilerDaemon daemon(socketPath, CheckAndExit);
+            _exit(daemon.Serve() ? 0 : 1);
+        }
+        ASSERT_GT(daemonPid, 0);
+    }
+
+    void TearDown() override
+    {
+        if (daemonPid > 0) {
+            (void)kill(daemonPid, SIGTERM);
+            (void)waitpid(daemonPid, nullptr, 0);
+        }
+        (void)unlink(socketPath.c_str());
+    }
+
+    std::optional<int> Compile(const std::string& exitCode) const
+    {
+        CompileRequest request{workDir, "/opt/cangjie/bin/cjc", {"cjc", exitCode}, {{TEST_ENV_NAME, "1"}}};
+        // The daemon may not be listening yet.
+        for (int i = 0; i < CONNECT_RETRIES; ++i) {
+            if (auto ret = CompilerDaemon::Forward(socketPath, request)) {
+                return ret;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return std::nullopt;
+    }
+
+    std::string workDir;
+    std::string socketPath;
+    pid_t daemonPid{-1};
+};
+} // namespace
+
+TEST_F(CompilerDaemonTest, ForwardedRequestReturnsExitCode)
+{
+    EXPECT_EQ(Compile("3"), 3);
+    EXPECT_EQ(Compile("0"), 0);
+}
+
+TEST_F(CompilerDaemonTest, StalledClientDoesNotBlockOthers)
+{
+    ASSERT_EQ(Compile("0"), 0);
+    // A client which connects but never sends its request.
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    (void)strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    int stalledFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(stalledFd, 0);
+    ASSERT_EQ(connect(stalledFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    EXPECT_EQ(Compile("5"), 5);
+    (void)close(stalledFd);
+}
+
+TEST_F(CompilerDaemonTest, StopsAndRemovesSocketOnSigterm)
+{
+    ASSERT_EQ(Compile("0"), 0);
+    ASSERT_EQ(kill(daemonPid, SIGTERM), 0);
+    int status = 0;
+    ASSERT_EQ(waitpid(daemonPid, &status, 0), daemonPid);
+    daemonPid = -1;
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_FALSE(FileUtil::FileExist(socketPath));
+    CompileRequest request{workDir, "/opt/cangjie/bin/cjc", {"cjc", "0"}, {}};
+    EXPECT_FALSE(CompilerDaemon::Forward(socketPath, request).has_value());
+}
+#endif
@@ -0,0 +1,154 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include "gtest/gtest.h"
+
+#ifdef CANGJIE_IN_PROCESS_BACKEND
+#include <map>
+#include <string>
+#include <vector>
+
+#include "llvm/Object/Archive.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "cangjie/Driver/Driver.h"
+#include "cangjie/Utils/FileUtil.h"
+
+using namespace Cangjie;
+
+namespace {
+const std::string SOURCE = R"(package demo
+public func sum(values: Array<Int64>): Int64 {
+    var total = 0
+    for (v in values) {
+        total += v
+    }
+    total
+}
+public class Counter {
+    var count = 0
+    public func inc(): Int64 {
+        count++
+        count
+    }
+}
+)";
+
+/**
+ * The defined symbols and the contents of the code sections of the object files in the static library at @p path,
+ * keyed by the member name and the symbol or section name.
+ */
+std::map<std::string, std::string> ReadLibraryCode(const std::string& path)
+{
+    std::map<std::string, std::string> code;
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer) {
+        return code;
+    }
+    auto archive = llvm::object::Archive::create((*buffer)->getMemBufferRef());
+    if (!archive) {
+        llvm::consumeError(archive.takeError());
+        return code;
+    }
+    llvm::Error err = llvm::Error::success();
+    for (auto& child : (*archive)->children(err)) {
+        auto memberName = child.getName();
+        auto memberRef = child.getMemoryBufferRef();
+        if (!memberName || !memberRef) {
+            llvm::consumeError(memberName.takeError());
+            llvm::consumeError(memberRef.takeError());
+            continue;
+        }
+        auto object = llvm::object::ObjectFile::createObjectFile(*memberRef);
+        if (!object) {
+            llvm::consumeError(object.takeError());
+            continue;
+        }
+        for (auto& section : (*object)->sections()) {
+            auto sectionName = section.getName();
+            auto contents = section.getContents();
+            if (section.isText() && sectionName && contents) {
+                code[memberName->str() + ":section:" + sectionName->str()] = contents->str();
+            } else {
+                llvm::consumeError(sectionName.takeError());
+                llvm::consumeError(contents.takeError());
+            }
+        }
+        for (auto& symbol : (*object)->symbols()) {
+            auto flags = symbol.getFlags();
+            auto symbolName = symbol.getName();
+            if (flags && !(*flags & llvm::object::SymbolRef::SF_Undefined) && symbolName) {
+                code[memberName->str() + ":symbol:" + symbolName->str()] = "";
+            } else {
+                llvm::consumeError(flags.takeError());
+                llvm::consumeError(symbolName.takeError());
+            }
+        }
+    }
+    llvm::consumeError(std::move(err));
+    return code;
+}
+
+class InProcessBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+#ifdef PROJECT_SOURCE_DIR
+        projectPath = PROJECT_SOURCE_DIR;
+#else
+        projectPath = "..";
+#endif
+        (void)FileUtil::RemoveDirectoryRecursively(dir);
+        ASSERT_TRUE(FileUtil::WriteToFile(FileUtil::JoinPath(srcDir, "demo.cj"), SOURCE));
+    }
+    void TearDown() override
+    {
+        (void)FileUtil::RemoveDirectoryRecursively(dir);
+    }
+
+    /** Compile the package into a static library in @p outDir, return the path of the library. */
+    std::string Compile(const std::string& outDir, bool inProcess)
+    {
+        std::vector<std::string> argStrs{
+            "cjc", "--package", srcDir, "--output-type=staticlib", "-O2", "--output-dir", outDir};
+        if (inProcess) {
+            argStrs.emplace_back("--in-process-backend");
+        }
+        DiagnosticEngine diag;
+        Driver driver(argStrs, diag, projectPath + "/output/bin/cjc");
+        driver.driverOptions->customizedSysroot = true;
+        EXPECT_TRUE(driver.ParseArgs() && driver.ExecuteCompilation());
+        // Otherwise the external tools compiled the package again.
+        EXPECT_EQ(driver.driverOptions->frontendOutputsCompiled, inProcess);
+        auto libs = FileUtil::GetAllFilesUnderCurrentPath(outDir, "a");
+        return libs.empty() ? "" : FileUtil::JoinPath(outDir, libs[0]);
+    }
+
+    std::string projectPath;
+    std::string dir = "testTempFiles/InProcessBackend";
+    std::string srcDir = dir + "/src";
+};
+} // namespace
+
+TEST_F(InProcessBackendTest, SameCodeAsExternalTools)
+{
+    auto external = ReadLibraryCode(Compile(FileUtil::JoinPath(dir, "external"), false));
+    auto inProcess = ReadLibraryCode(Compile(FileUtil::JoinPath(dir, "inProcess"), true));
+    ASSERT_FALSE(external.empty());
+    for (auto& [key, contents] : external) {
+        auto it = inProcess.find(key);
+        if (it == inProcess.end()) {
+            ADD_FAILURE() << key << " is missing from the in-process output";
+        } else if (it->second != contents) {
+            ADD_FAILURE() << key << " differs from the output of opt and llc";
+        }
+    }
+    for (auto& [key, contents] : inProcess) {
+        EXPECT_TRUE(external.count(key) != 0) << key << " is only in the in-process output";
+    }
+}
+#endif
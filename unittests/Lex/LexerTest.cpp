@@ -4,14 +4,18 @@
 //
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
+#include <cctype>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "cangjie/Basic/DiagnosticEmitter.h"
 #include "cangjie/Basic/Print.h"
 #include "cangjie/Basic/StringConvertor.h"
+#include "cangjie/Basic/StringPool.h"
 #include "cangjie/Basic/Utils.h"
 #include "cangjie/Lex/Lexer.h"
 
@@ -213,6 +217,84 @@ TEST_F(LexerTest, KeywordTokens)
     }
 }
 
+TEST_F(LexerTest, AllKeywordTokens)
+{
+    for (unsigned char i = 0; i < static_cast<unsigned char>(TokenKind::IDENTIFIER); i++) {
+        std::string text = TOKENS[i];
+        if (text.empty() || !std::isalpha(static_cast<unsigned char>(text[0]))) {
+            continue;
+        }
+        Lexer keywordLexer(text, diag, sm);
+        Token tok = keywordLexer.Next();
+        EXPECT_EQ(tok.kind, static_cast<TokenKind>(i)) << text;
+        EXPECT_EQ(tok.Value(), text);
+    }
+    // The effect handler keywords are identifiers unless enabled.
+    std::string code = "handle performs";
+    Lexer ehDisabledLexer(code, diag, sm);
+    EXPECT_EQ(ehDisabledLexer.Next().kind, TokenKind::IDENTIFIER);
+    Lexer ehEnabledLexer(code, diag, sm);
+    ehEnabledLexer.SetEHEnabled(true);
+    EXPECT_EQ(ehEnabledLexer.Next().kind, TokenKind::HANDLE);
+    EXPECT_EQ(ehEnabledLexer.Next().kind, TokenKind::IDENTIFIER);
+}
+
+TEST_F(LexerTest, TokenValueStorage)
+{
+    std::string code = R"(abc abc "abc" "abc")";
+    Lexer valueLexer(code, diag, sm);
+    Token id1 = valueLexer.Next();
+    Token id2 = valueLexer.Next();
+    Token str1 = valueLexer.Next();
+    Token str2 = valueLexer.Next();
+    // Identifiers are pooled, string literals are not.
+    EXPECT_EQ(&id1.Value(), &id2.Value());
+    EXPECT_EQ(str1.Value(), str2.Value());
+    EXPECT_NE(&str1.Value(), &str2.Value());
+
+    Token copied = str1;
+    EXPECT_EQ(&copied.Value(), &str1.Value());
+    Token moved = std::move(str1);
+    EXPECT_EQ(moved.Value(), "abc");
+    EXPECT_EQ(copied.Value(), "abc");
+    copied.SetValue("def");
+    EXPECT_EQ(moved.Value(), "abc");
+}
+
+TEST_F(LexerTest, TokenValueRelease)
+{
+    auto pooled = StringPool::Size();
+    {
+        std::string code = "uniqueIdentifierOfTokenValueRelease uniqueIdentifierOfTokenValueRelease";
+        Lexer valueLexer(code, diag, sm);
+        Token id1 = valueLexer.Next();
+        Token id2 = valueLexer.Next();
+        EXPECT_EQ(StringPool::Size(), pooled + 1);
+        Token copied = id1;
+        id1.SetValue("other");
+        EXPECT_EQ(copied.Value(), id2.Value());
+    }
+    // Values are freed with their last token, long-running processes do not keep them.
+    EXPECT_EQ(StringPool::Size(), pooled);
+
+    constexpr int threadNum = 8;
+    constexpr int roundNum = 1000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadNum; ++i) {
+        threads.emplace_back([]() {
+            for (int round = 0; round < roundNum; ++round) {
+                Token token(TokenKind::IDENTIFIER, "sharedValue" + std::to_string(round % 10));
+                Token copied = token;
+                EXPECT_EQ(copied.Value(), "sharedValue" + std::to_string(round % 10));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(StringPool::Size(), pooled);
+}
+
 TEST_F(LexerTest, CharTokens)
 {
     // shared test
@@ -0,0 +1,154 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "cangjie/AST/Node.h"
+#include "cangjie/Macro/MacroCache.h"
+#include "cangjie/Macro/MacroCall.h"
+#include "cangjie/Utils/FileUtil.h"
+
+using namespace Cangjie;
+using namespace AST;
+
+class MacroCacheTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        (void)FileUtil::RemoveDirectoryRecursively(dir);
+        ASSERT_TRUE(FileUtil::WriteBufferToASTFile(macroLib, {1, 2, 3}));
+        ASSERT_TRUE(FileUtil::WriteBufferToASTFile(helperLib, {4, 5, 6}));
+    }
+    void TearDown() override
+    {
+        (void)FileUtil::RemoveDirectoryRecursively(dir);
+    }
+
+    /** A successfully evaluated call of macro @p method with a single argument token at @p column. */
+    MacroCall& MakeCall(const std::string& method, int column)
+    {
+        auto& expr = exprs.emplace_back(MakeOwned<MacroExpandExpr>());
+        expr->invocation.args = {Token(TokenKind::IDENTIFIER, "x", Position(1, 1, column), Position(1, 1, column + 1))};
+        expr->invocation.newTokens = {Token(TokenKind::INTEGER_LITERAL, "1", Position(1, 1, 1), Position(1, 1, 2))};
+        auto& call = calls.emplace_back(std::make_unique<MacroCall>(expr.get()));
+        call->libPath = macroLib;
+        call->methodName = method;
+        call->status = MacroEvalStatus::SUCCESS;
+        return *call;
+    }
+
+    MacroCache MakeCache() const
+    {
+        return MacroCache(FileUtil::JoinPath(dir, "cache"), {helperLib});
+    }
+
+    size_t GetEntryNum() const
+    {
+        return FileUtil::GetAllFilesUnderCurrentPath(FileUtil::JoinPath(dir, "cache"), "macro").size();
+    }
+
+    std::string dir = "testTempFiles/MacroCache";
+    std::string macroLib = dir + "/libmacro.so";
+    std::string helperLib = dir + "/libhelper.so";
+    std::vector<OwnedPtr<MacroExpandExpr>> exprs;
+    std::vector<std::unique_ptr<MacroCall>> calls;
+};
+
+TEST_F(MacroCacheTest, LookupReturnsStoredTokens)
+{
+    auto& call = MakeCall("M", 5);
+    MakeCache().Store(call);
+    auto cache = MakeCache();
+    auto tokens = cache.Lookup(call);
+    ASSERT_TRUE(tokens.has_value());
+    ASSERT_EQ(tokens->size(), 1);
+    EXPECT_EQ((*tokens)[0].kind, TokenKind::INTEGER_LITERAL);
+    EXPECT_EQ((*tokens)[0].Value(), "1");
+    EXPECT_EQ(cache.GetHitCount(), 1);
+}
+
+TEST_F(MacroCacheTest, KeyMismatchIsMiss)
+{
+    MakeCache().Store(MakeCall("M", 5));
+    auto cache = MakeCache();
+    // The same argument at another position, and another method of the same library.
+    EXPECT_FALSE(cache.Lookup(MakeCall("M", 6)).has_value());
+    EXPECT_FALSE(cache.Lookup(MakeCall("N", 5)).has_value());
+    EXPECT_EQ(cache.GetHitCount(), 0);
+}
+
+TEST_F(MacroCacheTest, ChangedLibraryIsMiss)
+{
+    auto& call = MakeCall("M", 5);
+    MakeCache().Store(call);
+    ASSERT_TRUE(MakeCache().Lookup(call).has_value());
+    // A rebuilt helper library may change what the macro returns, although the macro library itself is unchanged.
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(helperLib, {7, 8, 9}));
+    EXPECT_FALSE(MakeCache().Lookup(call).has_value());
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(macroLib, {7, 8, 9}));
+    EXPECT_FALSE(MakeCache().Lookup(call).has_value());
+}
+
+TEST_F(MacroCacheTest, CorruptedEntryIsMiss)
+{
+    auto& call = MakeCall("M", 5);
+    MakeCache().Store(call);
+    auto files = FileUtil::GetAllFilesUnderCurrentPath(FileUtil::JoinPath(dir, "cache"), "macro");
+    ASSERT_EQ(files.size(), 1);
+    auto path = FileUtil::JoinPath(FileUtil::JoinPath(dir, "cache"), files[0]);
+    std::vector<uint8_t> entry;
+    std::string failedReason;
+    ASSERT_TRUE(FileUtil::ReadBinaryFileToBuffer(path, entry, failedReason));
+    // Drop the last byte of the tokens, as an interrupted write would.
+    auto truncated = entry;
+    truncated.pop_back();
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, truncated));
+    EXPECT_FALSE(MakeCache().Lookup(call).has_value());
+    // A string size pointing past the end of the entry.
+    auto oversized = entry;
+    constexpr size_t strSizeOffsetFromEnd = 1 + sizeof(uint32_t) * 3 + sizeof(uint16_t) + sizeof(uint32_t);
+    oversized[oversized.size() - strSizeOffsetFromEnd] = 0xff;
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, oversized));
+    EXPECT_FALSE(MakeCache().Lookup(call).has_value());
+    // The entry is written again by the next store.
+    MakeCache().Store(call);
+    EXPECT_TRUE(MakeCache().Lookup(call).has_value());
+}
+
+TEST_F(MacroCacheTest, SkipsCallsUsingCompilerCallback)
+{
+    auto& call = MakeCall("M", 5);
+    MakeCache().Store(call);
+    call.usedCompilerCallback = true;
+    EXPECT_FALSE(MakeCache().Lookup(call).has_value());
+    auto& other = MakeCall("M", 6);
+    other.usedCompilerCallback = true;
+    MakeCache().Store(other);
+    other.usedCompilerCallback = false;
+    EXPECT_FALSE(MakeCache().Lookup(other).has_value());
+}
+
+TEST_F(MacroCacheTest, PruneRemovesUnusedEntries)
+{
+    auto& kept = MakeCall("M", 5);
+    auto& moved = MakeCall("M", 6);
+    {
+        auto cache = MakeCache();
+        cache.Store(kept);
+        cache.Store(moved);
+    }
+    ASSERT_EQ(GetEntryNum(), 2);
+    // The second call moved to another column, its old entry is not used by the next build.
+    auto cache = MakeCache();
+    ASSERT_TRUE(cache.Lookup(kept).has_value());
+    cache.Store(MakeCall("M", 7));
+    cache.Prune();
+    EXPECT_EQ(GetEntryNum(), 2);
+    EXPECT_TRUE(MakeCache().Lookup(kept).has_value());
+    EXPECT_FALSE(MakeCache().Lookup(moved).has_value());
+}
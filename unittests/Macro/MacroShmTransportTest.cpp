@@ -0,0 +1,115 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include "gtest/gtest.h"
+
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fcntl.h>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "cangjie/Macro/MacroShmTransport.h"
+
+using namespace Cangjie;
+using Direction = MacroShmTransport::Direction;
+
+namespace {
+// Several times the capacity of a ring, so that the positions wrap around.
+constexpr size_t STREAM_SIZE = 11 * 1024 * 1024;
+// Not a divisor of the capacity, so that copies are split at the end of the ring.
+constexpr size_t CHUNK_SIZE = 65537;
+
+uint8_t ByteAt(size_t pos)
+{
+    return static_cast<uint8_t>(pos * 31 + pos / 251);
+}
+
+class MacroShmTransportTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        client = MacroShmTransport::Create();
+        ASSERT_NE(client, nullptr);
+        server = MacroShmTransport::Open(dup(client->GetFd()));
+        ASSERT_NE(server, nullptr);
+    }
+
+    std::unique_ptr<MacroShmTransport> client;
+    std::unique_ptr<MacroShmTransport> server;
+};
+} // namespace
+
+TEST_F(MacroShmTransportTest, FdIsCloseOnExec)
+{
+    EXPECT_NE(fcntl(client->GetFd(), F_GETFD) & FD_CLOEXEC, 0);
+    ASSERT_TRUE(client->InheritFdOnExec());
+    EXPECT_EQ(fcntl(client->GetFd(), F_GETFD) & FD_CLOEXEC, 0);
+}
+
+TEST_F(MacroShmTransportTest, StreamWrapsAround)
+{
+    // The writer fills the ring and blocks until the reader frees space, the reader blocks until data arrives.
+    std::thread writer([this]() {
+        std::vector<uint8_t> chunk(CHUNK_SIZE);
+        for (size_t pos = 0; pos < STREAM_SIZE; pos += CHUNK_SIZE) {
+            size_t len = std::min(CHUNK_SIZE, STREAM_SIZE - pos);
+            for (size_t i = 0; i < len; ++i) {
+                chunk[i] = ByteAt(pos + i);
+            }
+            ASSERT_TRUE(client->Write(Direction::CLIENT_TO_SRV, chunk.data(), len));
+        }
+    });
+    std::vector<uint8_t> buf(CHUNK_SIZE - 2);
+    size_t mismatches = 0;
+    for (size_t pos = 0; pos < STREAM_SIZE; pos += buf.size()) {
+        size_t len = std::min(buf.size(), STREAM_SIZE - pos);
+        ASSERT_TRUE(server->Read(Direction::CLIENT_TO_SRV, buf.data(), len));
+        for (size_t i = 0; i < len; ++i) {
+            mismatches += buf[i] != ByteAt(pos + i) ? 1 : 0;
+        }
+    }
+    writer.join();
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_FALSE(server->HasData(Direction::CLIENT_TO_SRV));
+}
+
+TEST_F(MacroShmTransportTest, ReadBlocksUntilWritten)
+{
+    std::atomic_bool done{false};
+    uint32_t value = 0;
+    std::thread reader([this, &done, &value]() {
+        EXPECT_TRUE(server->Read(Direction::SRV_TO_CLIENT, reinterpret_cast<uint8_t*>(&value), sizeof(value)));
+        done.store(true);
+    });
+    // Longer than a wait timeout, the reader must keep waiting while the peer is alive.
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_FALSE(done.load());
+    uint32_t sent = 0x12345678;
+    ASSERT_TRUE(client->Write(Direction::SRV_TO_CLIENT, reinterpret_cast<uint8_t*>(&sent), sizeof(sent)));
+    reader.join();
+    EXPECT_TRUE(done.load());
+    EXPECT_EQ(value, sent);
+}
+
+TEST_F(MacroShmTransportTest, ReadFailsWhenPeerHasGone)
+{
+    std::atomic_bool peerAlive{true};
+    server->SetPeerAlive(&peerAlive);
+    std::thread reader([this]() {
+        uint8_t byte = 0;
+        EXPECT_FALSE(server->Read(Direction::SRV_TO_CLIENT, &byte, 1));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    peerAlive.store(false);
+    reader.join();
+}
+#endif
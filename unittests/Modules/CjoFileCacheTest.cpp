@@ -0,0 +1,104 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cangjie/Modules/CjoFileCache.h"
+#include "cangjie/Utils/FileUtil.h"
+
+using namespace Cangjie;
+
+class CjoFileCacheTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        (void)FileUtil::CreateDirs(dir + "/");
+    }
+    void TearDown() override
+    {
+        (void)FileUtil::RemoveDirectoryRecursively(dir);
+    }
+
+    std::string dir = "testTempFiles/CjoFileCache";
+    std::string path = dir + "/pkg.cjo";
+};
+
+TEST_F(CjoFileCacheTest, ReusesUnchangedFile)
+{
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {1, 2, 3}));
+    std::string failedReason;
+    auto first = CjoFileCache::Instance().Open(path, failedReason);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->Size(), 3U);
+    auto second = CjoFileCache::Instance().Open(path, failedReason);
+    EXPECT_EQ(first, second);
+    auto absPath = FileUtil::GetAbsPath(path).value();
+    auto opened = CjoFileCache::Instance().GetOpenedPaths();
+    EXPECT_EQ(std::count(opened.begin(), opened.end(), absPath), 1);
+}
+
+TEST_F(CjoFileCacheTest, RemapsReplacedFile)
+{
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {1, 2, 3}));
+    std::string failedReason;
+    auto oldFile = CjoFileCache::Instance().Open(path, failedReason);
+    ASSERT_NE(oldFile, nullptr);
+    // A rewritten .cjo file is a new inode with a new size, its stamp no longer matches the cached entry.
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {4, 5, 6, 7}));
+    auto newFile = CjoFileCache::Instance().Open(path, failedReason);
+    ASSERT_NE(newFile, nullptr);
+    EXPECT_NE(oldFile, newFile);
+    ASSERT_EQ(newFile->Size(), 4U);
+    EXPECT_EQ(newFile->Data()[0], 4);
+    // The mapping still held by an earlier user is not affected.
+    ASSERT_EQ(oldFile->Size(), 3U);
+    EXPECT_EQ(oldFile->Data()[0], 1);
+}
+
+TEST_F(CjoFileCacheTest, RejectsMissingAndInvalidFiles)
+{
+    std::string failedReason;
+    EXPECT_EQ(CjoFileCache::Instance().Open(dir + "/missing.cjo", failedReason), nullptr);
+    EXPECT_FALSE(failedReason.empty());
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {1, 2, 3}));
+    EXPECT_FALSE(CjoFileCache::Instance().Preload(path));
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+TEST_F(CjoFileCacheTest, RewriteKeepsFileMode)
+{
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {1, 2, 3}));
+    ASSERT_EQ(chmod(path.c_str(), 0640), 0);
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {4, 5, 6}));
+    struct stat st;
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 07777, 0640);
+}
+
+TEST_F(CjoFileCacheTest, RewriteThroughSymlink)
+{
+    auto target = dir + "/real.cjo";
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(target, {1, 2, 3}));
+    ASSERT_EQ(symlink("real.cjo", path.c_str()), 0);
+    ASSERT_TRUE(FileUtil::WriteBufferToASTFile(path, {4, 5, 6, 7}));
+    // The link is kept and the new content is found through it and in its target.
+    struct stat st;
+    ASSERT_EQ(lstat(path.c_str(), &st), 0);
+    EXPECT_TRUE(S_ISLNK(st.st_mode));
+    std::vector<uint8_t> content;
+    std::string failedReason;
+    ASSERT_TRUE(FileUtil::ReadBinaryFileToBuffer(target, content, failedReason));
+    EXPECT_EQ(content, std::vector<uint8_t>({4, 5, 6, 7}));
+}
+#endif
@@ -10,9 +10,16 @@
  * Generic instantiation related unit tests.
  */
 
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <regex>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -20,6 +27,8 @@
 #define private public
 #include "TestCompilerInstance.h"
 #include "cangjie/AST/Match.h"
+#include "cangjie/AST/Walker.h"
+#include "cangjie/Driver/Driver.h"
 
 using namespace Cangjie;
 using namespace AST;
@@ -82,3 +91,199 @@ protected:
     CompilerInvocation invocation;
     std::unique_ptr<TestCompilerInstance> instance;
 };
+
+namespace {
+const std::string LINKAGE_TEST_CODE = R"(
+    class Counter<T> {
+        static var count: Int64 = 0
+        static func inc(): Int64 {
+            count = count + 1
+            count
+        }
+        func get(): Int64 { 1 }
+    }
+    private func id<T>(a: T): T { a }
+    public func pubId<T>(a: T): T { a }
+    func incVia<T>(): Int64 { Counter<T>.inc() }
+    main(): Int64 {
+        id<Int64>(1) + pubId<Int64>(1) + Counter<Int64>.inc() + incVia<Int64>() + Counter<Int64>().get()
+    }
+)";
+
+std::unordered_map<std::string, Linkage> CollectInstantiatedFuncLinkages(const Package& pkg)
+{
+    std::unordered_map<std::string, Linkage> linkages;
+    for (auto& decl : pkg.genericInstantiatedDecls) {
+        Walker(decl.get(), [&linkages](auto node) {
+            if (auto fd = DynamicCast<FuncDecl*>(node); fd && fd->funcBody) {
+                linkages.emplace(fd->identifier, fd->linkage);
+            }
+            return VisitAction::WALK_CHILDREN;
+        }).Walk();
+    }
+    return linkages;
+}
+
+#if defined(CANGJIE_CODEGEN_CJNATIVE_BACKEND) && !defined(__APPLE__)
+void WriteSource(const std::string& dir, const std::string& code)
+{
+    ASSERT_TRUE(FileUtil::CreateDirs(FileUtil::JoinPath(dir, "")) == 0);
+    std::ofstream(FileUtil::JoinPath(dir, "src.cj")) << code;
+}
+
+bool CompilePackage(const std::string& projectPath, const std::string& dir, const std::string& outDir)
+{
+    std::vector<std::string> argStrs = {"cjc", "--package", dir, "--output-type=staticlib", "--import-path", outDir,
+        "--output-dir", outDir, "--dump-ir"};
+    DiagnosticEngine driverDiag;
+    auto driver = std::make_unique<Driver>(argStrs, driverDiag, projectPath + "/output/bin/cjc");
+    driver->driverOptions->customizedSysroot = true;
+    return driver->ParseArgs() && driver->ExecuteCompilation();
+}
+
+/** Call @p onLine on each line of the final IR dumped for package @p pkgName. */
+void ForEachFinalIRLine(
+    const std::string& outDir, const std::string& pkgName, const std::function<void(const std::string&)>& onLine)
+{
+    for (auto& dir : FileUtil::GetAllDirsUnderCurrentPath(outDir)) {
+        if (dir.find(pkgName + "_IR") == std::string::npos || dir.find("_Final") == std::string::npos) {
+            continue;
+        }
+        for (auto& file : FileUtil::GetAllFilesUnderCurrentPath(dir, "ll")) {
+            std::ifstream in(FileUtil::JoinPath(dir, file));
+            for (std::string line; std::getline(in, line);) {
+                onLine(line);
+            }
+        }
+    }
+}
+
+/** The linkonce_odr or weak_odr functions with a COMDAT of their own name in the final IR of package @p pkgName. */
+std::set<std::string> GetComdatFunctions(const std::string& outDir, const std::string& pkgName)
+{
+    std::set<std::string> comdats;
+    std::set<std::string> functions;
+    const std::regex comdatRe(R"(^\$(\S+) = comdat any)");
+    const std::regex defineRe(R"(^define (linkonce_odr|weak_odr) [^@]*@(\S+?)\(.*\bcomdat\b)");
+    ForEachFinalIRLine(outDir, pkgName, [&](const std::string& line) {
+        std::smatch match;
+        if (std::regex_search(line, match, comdatRe)) {
+            comdats.emplace(match[1]);
+        } else if (std::regex_search(line, match, defineRe)) {
+            functions.emplace(match[2]);
+        }
+    });
+    std::set<std::string> result;
+    for (auto& fn : functions) {
+        if (comdats.count(fn) != 0) {
+            result.emplace(fn);
+        }
+    }
+    return result;
+}
+
+/** The functions declared but not defined in the final IR of package @p pkgName. */
+std::set<std::string> GetDeclaredFunctions(const std::string& outDir, const std::string& pkgName)
+{
+    std::set<std::string> functions;
+    const std::regex declareRe(R"(^declare [^@]*@(\S+?)\()");
+    ForEachFinalIRLine(outDir, pkgName, [&](const std::string& line) {
+        std::smatch match;
+        if (std::regex_search(line, match, declareRe)) {
+            functions.emplace(match[1]);
+        }
+    });
+    return functions;
+}
+#endif
+} // namespace
+
+/**
+ * Instantiated functions are linkonce_odr so that the linker keeps one copy, unless the copy kept would use the static
+ * variables of another package's instantiated type, directly or through calls. The instantiations of exported global
+ * generic functions are weak_odr, other packages may link to them.
+ */
+TEST_F(GenericTest, InstantiatedFuncLinkage)
+{
+    instance = std::make_unique<TestCompilerInstance>(invocation, diag);
+    instance->code = LINKAGE_TEST_CODE;
+    ASSERT_TRUE(instance->Compile(CompileStage::GENERIC_INSTANTIATION));
+    ASSERT_EQ(diag.GetErrorCount(), 0);
+
+    auto linkages = CollectInstantiatedFuncLinkages(*instance->GetSourcePackages()[0]);
+    ASSERT_EQ(linkages.count("id"), 1);
+    EXPECT_EQ(linkages["id"], Linkage::LINKONCE_ODR);
+    ASSERT_EQ(linkages.count("pubId"), 1);
+    EXPECT_EQ(linkages["pubId"], Linkage::WEAK_ODR);
+    ASSERT_EQ(linkages.count("get"), 1);
+    EXPECT_EQ(linkages["get"], Linkage::LINKONCE_ODR);
+    // Counter<Int64>.count is owned by each package instantiating Counter<Int64>.
+    ASSERT_EQ(linkages.count("inc"), 1);
+    EXPECT_EQ(linkages["inc"], Linkage::INTERNAL);
+    ASSERT_EQ(linkages.count("incVia"), 1);
+    EXPECT_EQ(linkages["incVia"], Linkage::INTERNAL);
+}
+
+/** The TypeInfos of instantiated types are internal on Windows, so instantiated functions are not shared there. */
+TEST_F(GenericTest, InstantiatedFuncLinkageOnWindows)
+{
+    invocation.globalOptions.target.os = Cangjie::Triple::OSType::WINDOWS;
+    instance = std::make_unique<TestCompilerInstance>(invocation, diag);
+    instance->code = LINKAGE_TEST_CODE;
+    ASSERT_TRUE(instance->Compile(CompileStage::GENERIC_INSTANTIATION));
+    ASSERT_EQ(diag.GetErrorCount(), 0);
+
+    auto linkages = CollectInstantiatedFuncLinkages(*instance->GetSourcePackages()[0]);
+    ASSERT_FALSE(linkages.empty());
+    for (auto& [name, linkage] : linkages) {
+        EXPECT_EQ(linkage, Linkage::INTERNAL) << name;
+    }
+}
+
+#if defined(CANGJIE_CODEGEN_CJNATIVE_BACKEND) && !defined(__APPLE__)
+/** Two packages instantiating the same generic function emit it under the same COMDAT symbol. */
+TEST_F(GenericTest, InstantiationComdatAcrossPackages)
+{
+    auto outDir = FileUtil::JoinPath(packagePath, "comdat");
+    WriteSource(FileUtil::JoinPath(outDir, "lib"), "package lib\npublic func id<T>(a: T): T { a }\n");
+    for (std::string pkg : {"p1", "p2"}) {
+        WriteSource(FileUtil::JoinPath(outDir, pkg),
+            "package " + pkg + "\nimport lib.*\npublic func f(): Int64 { id<Int64>(1) }\n");
+    }
+    ASSERT_TRUE(CompilePackage(projectPath, FileUtil::JoinPath(outDir, "lib"), outDir));
+    ASSERT_TRUE(CompilePackage(projectPath, FileUtil::JoinPath(outDir, "p1"), outDir));
+    ASSERT_TRUE(CompilePackage(projectPath, FileUtil::JoinPath(outDir, "p2"), outDir));
+
+    auto p1Comdats = GetComdatFunctions(outDir, "p1");
+    auto p2Comdats = GetComdatFunctions(outDir, "p2");
+    std::vector<std::string> shared;
+    std::set_intersection(p1Comdats.begin(), p1Comdats.end(), p2Comdats.begin(), p2Comdats.end(),
+        std::back_inserter(shared));
+    EXPECT_FALSE(shared.empty());
+}
+
+/** A package links to the weak_odr instantiation defined by an imported package instead of emitting it. */
+TEST_F(GenericTest, ReuseInstantiationOfImportedPackage)
+{
+    auto outDir = FileUtil::JoinPath(packagePath, "reuse");
+    WriteSource(FileUtil::JoinPath(outDir, "lib"), "package lib\npublic func id<T>(a: T): T { a }\n");
+    WriteSource(
+        FileUtil::JoinPath(outDir, "mid"), "package mid\nimport lib.*\npublic func g(): Int64 { id<Int64>(1) }\n");
+    WriteSource(FileUtil::JoinPath(outDir, "user"),
+        "package user\nimport lib.*\nimport mid.*\npublic func f(): Int64 { id<Int64>(2) + g() }\n");
+    for (std::string pkg : {"lib", "mid", "user"}) {
+        ASSERT_TRUE(CompilePackage(projectPath, FileUtil::JoinPath(outDir, pkg), outDir));
+    }
+
+    auto midComdats = GetComdatFunctions(outDir, "mid");
+    ASSERT_FALSE(midComdats.empty());
+    auto userComdats = GetComdatFunctions(outDir, "user");
+    auto userDeclared = GetDeclaredFunctions(outDir, "user");
+    size_t reused = 0;
+    for (auto& fn : midComdats) {
+        EXPECT_EQ(userComdats.count(fn), 0) << fn;
+        reused += userDeclared.count(fn);
+    }
+    EXPECT_NE(reused, 0);
+}
+#endif
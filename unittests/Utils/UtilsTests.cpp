@@ -10,10 +10,13 @@
 #include <cstdlib>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #ifdef _WIN32
 #include <process.h>
 #include <windows.h>
 #else
+#include <sys/wait.h>
 #include <unistd.h>
 #endif
 
@@ -22,10 +25,12 @@
 #define private public
 #include "cangjie/AST/Utils.h"
 #include "cangjie/Driver/Toolchains/GCCPathScanner.h"
+#include "cangjie/Utils/FastHash.h"
 #include "cangjie/Utils/FileUtil.h"
 #include "cangjie/Utils/FloatFormat.h"
 #include "cangjie/Utils/ProfileRecorder.h"
 #include "cangjie/Utils/SipHash.h"
+#include "cangjie/Utils/TaskQueue.h"
 #include "cangjie/Utils/Utils.h"
 
 using namespace Cangjie;
@@ -946,6 +951,43 @@ TEST(UtilsTest, SipHash2)
     EXPECT_NE(Utils::SipHash::GetHashValue("bambambombadodo"), Utils::SipHash::GetHashValue("nambambombadodo"));
 }
 
+TEST(UtilsTest, FastHash)
+{
+    EXPECT_EQ(Utils::FastHash::GetHashValue(std::string("123abc")), Utils::FastHash::GetHashValue("123abc"));
+    EXPECT_NE(Utils::FastHash::GetHashValue("define_40020"), Utils::FastHash::GetHashValue("Vefine_40020"));
+    EXPECT_NE(Utils::FastHash::GetHashValue(int32_t(1)), Utils::FastHash::GetHashValue(int64_t(1)));
+    EXPECT_NE(Utils::FastHash::GetHashValue(true), Utils::FastHash::GetHashValue(false));
+    EXPECT_EQ(Utils::FastHash::GetHashValue(std::bitset<16>{789}), Utils::FastHash::GetHashValue(std::bitset<64>{789}));
+    // Strings of every length around the 16 and 32 byte blocks, and the same strings with one byte changed.
+    std::unordered_set<uint64_t> hashes;
+    std::string str;
+    for (size_t i = 0; i < 70; ++i) {
+        EXPECT_TRUE(hashes.emplace(Utils::FastHash::GetHashValue(str)).second);
+        if (!str.empty()) {
+            std::string changed = str;
+            changed[i / 2] ^= 1;
+            EXPECT_TRUE(hashes.emplace(Utils::FastHash::GetHashValue(changed)).second);
+        }
+        str.push_back(static_cast<char>('a' + i % 26));
+    }
+}
+
+TEST(UtilsTest, FastHashIsStable)
+{
+    // The hashes are persisted in the incremental compilation cache, they must not depend on the host or compiler.
+    EXPECT_EQ(Utils::FastHash::GetHashValue(""), 0x262d9cab138422e4);
+    EXPECT_EQ(Utils::FastHash::GetHashValue("123abc"), 0x8a579e27f8c9be78);
+    std::string str;
+    for (size_t i = 0; i < 70; ++i) {
+        str.push_back(static_cast<char>('a' + i % 26));
+    }
+    EXPECT_EQ(Utils::FastHash::GetHashValue(str), 0x220847904ac9f1e7);
+    EXPECT_EQ(Utils::FastHash::GetHashValue(int32_t(-1)), 0xe4f965de5c44d33f);
+    EXPECT_EQ(Utils::FastHash::GetHashValue(uint64_t(1) << 40), 0x47938dad698d45ce);
+    EXPECT_EQ(Utils::FastHash::GetHashValue(1.5), 0x03ab76e9760a3772);
+    EXPECT_EQ(Utils::FastHash::GetHashValue(true), 0x9773aea41186fe34);
+}
+
 TEST(UtilsTest, IsUnderFlowFloat)
 {
     auto underUse = [](const std::string& value) {
@@ -979,3 +1021,151 @@ TEST(UtilsTest, IsUnderFlowFloat)
     // This should not occur in actual calls.
     EXPECT_EQ(underUse("1.0"), false);
 }
+
+TEST(UtilsTest, TaskQueuePriority)
+{
+    // With a single executor, tasks run strictly by priority, and by adding order for equal priorities.
+    TaskQueue taskQueue(1);
+    std::vector<int> order;
+    for (int i = 0; i < 6; ++i) {
+        taskQueue.AddTask<void>([i, &order]() { order.emplace_back(i); }, static_cast<uint64_t>(i % 3));
+    }
+    taskQueue.RunAndWaitForAllTasksCompleted();
+    EXPECT_EQ(order, (std::vector<int>{2, 5, 1, 4, 0, 3}));
+}
+
+TEST(UtilsTest, TaskQueueNestedTasks)
+{
+    constexpr int outerNum = 64;
+    constexpr int innerNum = 16;
+    TaskQueue taskQueue(8);
+    std::vector<TaskResult<int>> results;
+    for (int i = 0; i < outerNum; ++i) {
+        results.emplace_back(taskQueue.AddTask<int>([]() {
+            // A task may wait for its own tasks without exhausting the shared workers.
+            TaskQueue inner(4);
+            std::atomic<int> count{0};
+            for (int j = 0; j < innerNum; ++j) {
+                inner.AddTask<void>([&count]() { ++count; });
+            }
+            inner.RunAndWaitForAllTasksCompleted();
+            return count.load();
+        }));
+    }
+    taskQueue.RunInBackground();
+    taskQueue.WaitForAllTasksCompleted();
+    int sum = 0;
+    for (auto& res : results) {
+        sum += res.get();
+    }
+    EXPECT_EQ(sum, outerNum * innerNum);
+}
+
+TEST(UtilsTest, ThreadPoolHelpsOnlyWaitedGroup)
+{
+    auto& pool = ThreadPool::Get();
+    // Keep every worker busy, so that the waiter is the only thread which can run the other jobs.
+    std::atomic<size_t> blocked{0};
+    std::atomic<size_t> released{0};
+    std::atomic_bool release{false};
+    for (size_t i = 0; i < pool.GetWorkersNum(); ++i) {
+        pool.Submit([&blocked, &released, &release]() {
+            ++blocked;
+            while (!release.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ++released;
+        });
+    }
+    while (blocked.load() < pool.GetWorkersNum()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int group = 0;
+    int foreignGroup = 0;
+    std::atomic_bool foreignRan{false};
+    std::atomic_bool groupRan{false};
+    pool.Submit([&foreignRan]() { foreignRan = true; }, &foreignGroup);
+    pool.Submit([&groupRan]() { groupRan = true; }, &group);
+    pool.HelpUntil([&groupRan]() { return groupRan.load(); }, &group);
+    EXPECT_FALSE(foreignRan.load());
+    release = true;
+    pool.HelpUntil([&foreignRan]() { return foreignRan.load(); }, &foreignGroup);
+    // The blocking jobs refer to this frame.
+    while (released.load() < pool.GetWorkersNum()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+#ifndef _WIN32
+TEST(UtilsTest, TaskQueueAfterFork)
+{
+    // Create the pool of the parent, the child must not use its copy, whose workers do not exist.
+    (void)ThreadPool::Get();
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // The first task only finishes once another executor has run the second one.
+        std::atomic_bool secondRan{false};
+        std::atomic_bool ok{false};
+        TaskQueue taskQueue(2);
+        taskQueue.AddTask<void>([&secondRan, &ok]() {
+            for (int i = 0; i < 5000 && !secondRan.load(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ok = secondRan.load();
+        }, 1);
+        taskQueue.AddTask<void>([&secondRan]() { secondRan = true; }, 0);
+        taskQueue.RunAndWaitForAllTasksCompleted();
+        _exit(ok.load() ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+#endif
+
+TEST(UtilsTest, ProfileRecorderTrace)
+{
+    ProfileRecorder::EnableTrace(true);
+    {
+        ProfileRecorder recorder("Phase", "outer");
+        TraceScope decl("Sema", "decl \"a\"");
+    }
+    TaskQueue taskQueue(2);
+    for (int i = 0; i < 4; ++i) {
+        taskQueue.AddTask<void>([i]() { TraceScope func("CodeGen", "func" + std::to_string(i)); });
+    }
+    taskQueue.RunAndWaitForAllTasksCompleted();
+    std::string trace = ProfileRecorder::GetTraceResult();
+    ProfileRecorder::EnableTrace(false);
+    TraceScope ignored("Sema", "disabled");
+
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+    EXPECT_NE(trace.find(R"({"name":"Phase: outer","cat":"Phase","ph":"X")"), std::string::npos);
+    EXPECT_NE(trace.find(R"({"name":"decl \"a\"","cat":"Sema","ph":"X")"), std::string::npos);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(trace.find("\"func" + std::to_string(i) + "\""), std::string::npos);
+    }
+    EXPECT_NE(trace.find(R"("ph":"M")"), std::string::npos);
+    EXPECT_EQ(trace.find("disabled"), std::string::npos);
+    EXPECT_TRUE(ProfileRecorder::GetTraceResult().empty());
+}
+
+TEST(UtilsTest, ProfileRecorderImbalance)
+{
+    ProfileRecorder::RecordImbalance("imbalance while disabled(%)", {1, 2});
+    ProfileRecorder::Enable(true, ProfileRecorder::Type::TIMER);
+    EXPECT_TRUE(ProfileRecorder::IsEnabled());
+    ProfileRecorder::RecordImbalance("balanced(%)", {5, 5, 5});
+    ProfileRecorder::RecordImbalance("imbalanced(%)", {1, 2, 6});
+    ProfileRecorder::RecordImbalance("idle(%)", {0, 0});
+    std::string result = ProfileRecorder::GetResult(ProfileRecorder::Type::TIMER);
+    ProfileRecorder::Enable(false);
+    EXPECT_FALSE(ProfileRecorder::IsEnabled());
+
+    EXPECT_NE(result.find("\"balanced(%)\": 100"), std::string::npos);
+    // The largest value is twice the average one.
+    EXPECT_NE(result.find("\"imbalanced(%)\": 200"), std::string::npos);
+    EXPECT_NE(result.find("\"idle(%)\": 100"), std::string::npos);
+    EXPECT_EQ(result.find("while disabled"), std::string::npos);
+}